@@ -0,0 +1,138 @@
+#ifndef EE_ALLOCATION_PROFILER_HPP
+#define EE_ALLOCATION_PROFILER_HPP
+
+#include <atomic>
+#include <eepp/config.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace EE {
+
+/** @brief Sampling allocation profiler of the eeNew, eeNewArray, eeMalloc and eeRealloc call
+ * sites.
+ * The eeRealloc calls are counted apart as reallocations, without bytes, the previous size of the
+ * block is unknown.
+ * It's disabled by default, while disabled every allocation only pays a relaxed atomic load.
+ * Once enabled every thread counts its allocations and samples one of every getSampleInterval()
+ * allocations ( in average, the interval is randomized to avoid aliasing with periodic
+ * allocation patterns ) into its own buffer, attributing them to the call site and the stack of
+ * AllocationProfiler::Zone of the thread. The buffers are merged every
+ * getAggregationInterval() frames or when the results are requested. */
+class EE_API AllocationProfiler {
+  public:
+	static constexpr Uint32 MaxZoneDepth = 16;
+
+	/** @brief Names the allocations done in its scope, the zones are the frames of the
+	 * exported stacks. The name must outlive the profiler ( usually a string literal ). */
+	class EE_API Zone {
+	  public:
+		explicit Zone( const char* name );
+
+		~Zone();
+
+	  protected:
+		bool mPushed;
+	};
+
+	/** The estimated allocations of a call site in a stack of zones */
+	struct Site {
+		std::vector<const char*> zones;
+		const char* file;
+		int line;
+		Uint64 allocations;
+		Uint64 bytes;
+		Uint64 reallocations;
+	};
+
+	/** The allocations done by every thread between two endFrame() */
+	struct FrameStats {
+		Uint64 frame;
+		Uint64 allocations;
+		Uint64 bytes;
+		Uint64 reallocations;
+	};
+
+	enum class Weight { Bytes, Allocations };
+
+	static bool isEnabled() { return sEnabled.load( std::memory_order_relaxed ); }
+
+	static void setEnabled( bool enabled );
+
+	/** Sets the average number of allocations between two samples, 1 samples every
+	 * allocation. Default 64. */
+	static void setSampleInterval( Uint32 interval );
+
+	static Uint32 getSampleInterval();
+
+	/** Sets the number of frames between two merges of the thread buffers. Default 60. */
+	static void setAggregationInterval( Uint32 frames );
+
+	static Uint32 getAggregationInterval();
+
+	/** Records an allocation if the profiler is enabled, used by the allocation macros.
+	 * @return ptr */
+	template <typename T>
+	static T* track( T* ptr, const size_t& bytes, const char* file, const int& line ) {
+		if ( isEnabled() )
+			onAllocation( bytes, file, line );
+		return ptr;
+	}
+
+	/** Records a reallocation if the profiler is enabled, used by eeRealloc.
+	 * @return ptr */
+	template <typename T> static T* trackRealloc( T* ptr, const char* file, const int& line ) {
+		if ( isEnabled() )
+			onReallocation( file, line );
+		return ptr;
+	}
+
+	/** Closes a frame: stores the allocations done since the last call and merges the thread
+	 * buffers every getAggregationInterval() frames. Window::display calls it when enabled. */
+	static void endFrame();
+
+	/** Merges the samples of every thread buffer */
+	static void aggregate();
+
+	/** Removes every result */
+	static void reset();
+
+	/** @return The last frames, the oldest first */
+	static std::vector<FrameStats> getFrames();
+
+	/** @return The allocations and bytes done by every thread since enabled or reset */
+	static FrameStats getTotal();
+
+	/** @return The estimated allocations of every site, the biggest in bytes first */
+	static std::vector<Site> getSites();
+
+	/** @return The estimated bytes allocated by every subsystem. The subsystem is the directory
+	 * after "src/eepp/" of the call site file ( "ui", "graphics", ... ) or its parent
+	 * directory. */
+	static std::map<std::string, Uint64> getBytesPerSubsystem();
+
+	/** @return The subsystem of a source file path */
+	static std::string getSubsystem( const char* file );
+
+	/** @return The samples in the folded stacks format read by flamegraph.pl, speedscope and
+	 * similar tools: one "zone;zone;subsystem;file:line weight" line for every site. */
+	static std::string getFolded( const Weight& weight = Weight::Bytes );
+
+	/** Writes getFolded() to a file */
+	static bool exportFolded( const std::string& path, const Weight& weight = Weight::Bytes );
+
+	/** Writes a summary to the log: the allocations per frame, the bytes of every subsystem and
+	 * the biggest sites */
+	static void logReport( const size_t& maxSites = 20 );
+
+  protected:
+	static std::atomic<bool> sEnabled;
+
+	static void onAllocation( const size_t& bytes, const char* file, const int& line );
+
+	static void onReallocation( const char* file, const int& line );
+};
+
+} // namespace EE
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef EE_CORE_CORE_HPP
 #define EE_CORE_CORE_HPP
 
+#include <eepp/core/allocationprofiler.hpp>
 #include <eepp/core/containers.hpp>
 #include <eepp/core/debug.hpp>
 #include <eepp/core/memorymanager.hpp>
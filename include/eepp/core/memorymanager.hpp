@@ -5,6 +5,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <eepp/config.hpp>
+#include <eepp/core/allocationprofiler.hpp>
 #include <string>
 #include <unordered_map>
 
@@ -71,35 +72,45 @@ class EE_API MemoryManager {
 #endif
 
 #ifdef EE_MEMORY_MANAGER
-#define eeNewTracked( classType, constructor )                       \
-	(classType*)EE::MemoryManager::addPointer( EE::AllocatedPointer( \
-		new classType constructor, __FILE__, __LINE__, sizeof( classType ), true ) )
-
-#define eeNew( classType, constructor )                              \
-	(classType*)EE::MemoryManager::addPointer( EE::AllocatedPointer( \
-		new classType constructor, __FILE__, __LINE__, sizeof( classType ) ) )
+#define eeNewTracked( classType, constructor )                                                   \
+	(classType*)EE::MemoryManager::addPointer( EE::AllocatedPointer(                             \
+		EE::AllocationProfiler::track( new classType constructor, sizeof( classType ), __FILE__, \
+									   __LINE__ ),                                               \
+		__FILE__, __LINE__, sizeof( classType ), true ) )
+
+#define eeNew( classType, constructor )                                                          \
+	(classType*)EE::MemoryManager::addPointer( EE::AllocatedPointer(                             \
+		EE::AllocationProfiler::track( new classType constructor, sizeof( classType ), __FILE__, \
+									   __LINE__ ),                                               \
+		__FILE__, __LINE__, sizeof( classType ) ) )
 
 #define eeNewInPlace( place, classType, constructor )                                     \
 	(classType*)EE::MemoryManager::addPointerInPlace(                                     \
 		place, EE::AllocatedPointer( new place classType constructor, __FILE__, __LINE__, \
 									 sizeof( classType ) ) )
 
-#define eeNewArray( classType, amount )                              \
-	(classType*)EE::MemoryManager::addPointer( EE::AllocatedPointer( \
-		new classType[amount], __FILE__, __LINE__, amount * sizeof( classType ) ) )
+#define eeNewArray( classType, amount )                                                         \
+	(classType*)EE::MemoryManager::addPointer( EE::AllocatedPointer(                            \
+		EE::AllocationProfiler::track( new classType[amount], ( amount ) * sizeof( classType ), \
+									   __FILE__, __LINE__ ),                                    \
+		__FILE__, __LINE__, amount * sizeof( classType ) ) )
 
 #define eeMalloc( amount )                                                                      \
-	EE::MemoryManager::addPointer( EE::AllocatedPointer( EE::MemoryManager::allocate( amount ), \
-														 __FILE__, __LINE__, amount ) )
+	EE::MemoryManager::addPointer( EE::AllocatedPointer(                                        \
+		EE::AllocationProfiler::track( EE::MemoryManager::allocate( amount ), amount, __FILE__, \
+									   __LINE__ ),                                              \
+		__FILE__, __LINE__, amount ) )
 
 #if defined( __GNUC__ ) && __GNUC__ >= 12
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuse-after-free"
 #endif
-#define eeRealloc( ptr, amount )                                                           \
-	EE::MemoryManager::reallocPointer(                                                     \
-		ptr, EE::AllocatedPointer( EE::MemoryManager::reallocate( ptr, amount ), __FILE__, \
-								   __LINE__, amount ) )
+#define eeRealloc( ptr, amount )                                                     \
+	EE::MemoryManager::reallocPointer(                                               \
+		ptr, EE::AllocatedPointer( EE::AllocationProfiler::trackRealloc(             \
+									   EE::MemoryManager::reallocate( ptr, amount ), \
+									   __FILE__, __LINE__ ),                         \
+								   __FILE__, __LINE__, amount ) )
 #if defined( __GNUC__ ) && __GNUC__ >= 12
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuse-after-free"
@@ -141,17 +152,23 @@ class EE_API MemoryManager {
 
 #else
 
-#define eeNewTracked( classType, constructor ) new classType constructor
+#define eeNewTracked( classType, constructor ) eeNew( classType, constructor )
 
-#define eeNew( classType, constructor ) new classType constructor
+#define eeNew( classType, constructor )                                                      \
+	EE::AllocationProfiler::track( new classType constructor, sizeof( classType ), __FILE__, \
+								   __LINE__ )
 
 #define eeNewInPlace( place, classType, constructor ) new place classType constructor
 
-#define eeNewArray( classType, amount ) new classType[amount]
+#define eeNewArray( classType, amount )                                                     \
+	EE::AllocationProfiler::track( new classType[amount], ( amount ) * sizeof( classType ), \
+								   __FILE__, __LINE__ )
 
-#define eeMalloc( amount ) malloc( amount )
+#define eeMalloc( amount )                                                        \
+	EE::AllocationProfiler::track( malloc( amount ), amount, __FILE__, __LINE__ )
 
-#define eeRealloc( ptr, amount ) realloc( ptr, amount )
+#define eeRealloc( ptr, amount ) \
+	EE::AllocationProfiler::trackRealloc( realloc( ptr, amount ), __FILE__, __LINE__ )
 
 #define eeDelete( data ) delete data
 
@@ -24,6 +24,7 @@
 #include <eepp/graphics/ninepatch.hpp>
 #include <eepp/graphics/ninepatchmanager.hpp>
 #include <eepp/graphics/particle.hpp>
+#include <eepp/graphics/particlepool.hpp>
 #include <eepp/graphics/particlesystem.hpp>
 #include <eepp/graphics/pixeldensity.hpp>
 #include <eepp/graphics/primitives.hpp>
@@ -0,0 +1,91 @@
+#ifndef EE_GRAPHICS_PARTICLEPOOL_HPP
+#define EE_GRAPHICS_PARTICLEPOOL_HPP
+
+#include <eepp/graphics/base.hpp>
+#include <eepp/graphics/batchrenderer.hpp>
+#include <eepp/graphics/particle.hpp>
+#include <vector>
+
+namespace EE { namespace Graphics {
+
+/** @brief The particles of a particle system stored as a structure of arrays.
+ * Every attribute of the alive particles is kept packed in its own array, so the integration
+ * runs over contiguous floats that the compiler can vectorize, the dead particles are removed
+ * swapping them with the last one, and the vertices are written directly into a buffer. */
+class EE_API ParticlePool {
+  public:
+	ParticlePool();
+
+	/** Reserves the space for the given number of particles */
+	void reserve( const size_t& capacity );
+
+	/** Removes every particle */
+	void clear();
+
+	/** @return The number of alive particles */
+	size_t size() const { return mCount; }
+
+	/** Adds a particle at the end of the pool and returns its index */
+	size_t add( const Particle& particle );
+
+	/** Replaces the particle at index */
+	void set( const size_t& index, const Particle& particle );
+
+	/** Copies the particle at index to particle */
+	void get( const size_t& index, Particle& particle ) const;
+
+	/** Removes the particle at index moving the last particle to its place. The particles are not
+	 * kept in order. */
+	void remove( const size_t& index );
+
+	/** Moves every particle: the position by its speed, the speed by its acceleration and the
+	 * alpha by its decay, clamped to 0 */
+	void integrate( const Float& time );
+
+	/** Finds the first particle with its alpha at 0 starting from index.
+	 * @return The index of the particle or size() if there's none */
+	size_t findDead( size_t index ) const;
+
+	const Uint32& getId( const size_t& index ) const { return mId[index]; }
+
+	const Float& getX( const size_t& index ) const { return mX[index]; }
+
+	const Float& getY( const size_t& index ) const { return mY[index]; }
+
+	const Float& getAlpha( const size_t& index ) const { return mA[index]; }
+
+	/** @return The number of vertices that emitQuads writes for every particle */
+	static Uint32 getQuadVertexCount( bool triangles ) { return triangles ? 6 : 4; }
+
+	/** Writes a quad of size x size centered in every particle, in the same vertex order as
+	 * BatchRenderer::batchQuad, as two triangles if triangles is true.
+	 * @param vertex The buffer, with space for size() * getQuadVertexCount( triangles ) vertices
+	 * @return The number of vertices written */
+	Uint32 emitQuads( VertexData* vertex, const Float& size, bool triangles ) const;
+
+	/** Writes a vertex for every particle, to render them as point sprites.
+	 * @param vertex The buffer, with space for size() vertices
+	 * @return The number of vertices written */
+	Uint32 emitPoints( VertexData* vertex ) const;
+
+  protected:
+	size_t mCount;
+	std::vector<Float> mX;
+	std::vector<Float> mY;
+	std::vector<Float> mXSpeed;
+	std::vector<Float> mYSpeed;
+	std::vector<Float> mXAcc;
+	std::vector<Float> mYAcc;
+	std::vector<Float> mR;
+	std::vector<Float> mG;
+	std::vector<Float> mB;
+	std::vector<Float> mA;
+	std::vector<Float> mAlphaDecay;
+	std::vector<Uint32> mId;
+
+	void resize( const size_t& capacity );
+};
+
+}} // namespace EE::Graphics
+
+#endif
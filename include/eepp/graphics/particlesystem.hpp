@@ -4,6 +4,7 @@
 #include <eepp/graphics/base.hpp>
 #include <eepp/graphics/blendmode.hpp>
 #include <eepp/graphics/particle.hpp>
+#include <eepp/graphics/particlepool.hpp>
 
 #include <eepp/system/time.hpp>
 using namespace EE::System;
@@ -153,8 +154,13 @@ class EE_API ParticleSystem {
 	/** Set The Acceleration of the effect */
 	void setAcceleration( const Vector2f& acc );
 
+	/** @return The alive particles of the effect */
+	const ParticlePool& getPool() const;
+
   private:
-	Particle* mParticle;
+	ParticlePool mPool;
+	Particle mParticle;
+	std::vector<VertexData> mVertices;
 	Uint32 mPCount;
 	const Texture* mTexture;
 	Uint32 mPLeft;
@@ -185,6 +191,9 @@ class EE_API ParticleSystem {
 
 	virtual void reset( Particle* P );
 
+	/** Resets the particle at index of the pool from its current state */
+	void resetParticle( const size_t& index );
+
 	ParticleCallback mPC;
 };
 
@@ -6,6 +6,7 @@
 #include <eepp/network/ipaddress.hpp>
 #include <eepp/network/tcpsocket.hpp>
 #include <eepp/network/uri.hpp>
+#include <eepp/system/clock.hpp>
 #include <eepp/system/lock.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/thread.hpp>
@@ -267,6 +268,10 @@ class EE_API Http : NonCopyable {
 		/** @return The request Method */
 		const Method& getMethod() const;
 
+		/** @return True if the request method is idempotent ( GET, HEAD, PUT, DELETE and
+		 * OPTIONS ), so it can be sent again when the connection closes before the response */
+		bool isIdempotent() const;
+
 		/** @return If SSL certificate validation is enabled */
 		const bool& getValidateCertificate() const;
 
@@ -503,6 +508,29 @@ class EE_API Http : NonCopyable {
 	/** @return Is a proxy is need to be used */
 	bool isProxied() const;
 
+	/** Sets the maximum number of connections that the async requests open to the host. It's also
+	 * the maximum number of idle connections kept to be reused. Default: 6. */
+	void setMaxConnections( const size_t& maxConnections );
+
+	/** @return The maximum number of connections that the async requests open to the host */
+	const size_t& getMaxConnections() const;
+
+	/** Sets the time that an idle connection is kept open to be reused by the next request.
+	 * Time::Zero disables the keep-alive connections. Default: 30 seconds. */
+	void setIdleTimeout( const Time& idleTimeout );
+
+	/** @return The time that an idle connection is kept open to be reused */
+	const Time& getIdleTimeout() const;
+
+	/** Sets the maximum number of async requests sent through a connection before receiving their
+	 * responses ( HTTP pipelining ). Only GET and HEAD requests are pipelined, and only on
+	 * connections that the server already kept alive. Default: 1 ( disabled ). */
+	void setPipeliningDepth( const size_t& depth );
+
+	/** @return The maximum number of async requests sent through a connection before receiving
+	 * their responses */
+	const size_t& getPipeliningDepth() const;
+
 	/** Helper class to build the body of a multipart/form-data request. */
 	class EE_API MultipartEntitiesBuilder {
 	  public:
@@ -647,10 +675,14 @@ class EE_API Http : NonCopyable {
 	/** It will try to get the proxy from the environment variables. */
 	static URI getEnvProxyURI();
 
-	/** Set the thread pool to consume for async requests, otherwise it will use its own */
+	/** Set the thread pool to consume for the async requests that can't be run by the client event
+	 * loop ( HTTPS requests ), otherwise it will use its own */
 	static void setThreadPool( std::shared_ptr<ThreadPool> pool );
 
   private:
+	class ResponseParser;
+	class AsyncExecutor;
+
 	class AsyncRequest : public Thread {
 	  public:
 		AsyncRequest( Http* http, const AsyncResponseCallback& cb, Http::Request request,
@@ -708,12 +740,18 @@ class EE_API Http : NonCopyable {
 
 		void setKeepAlive( const bool& isKeepAlive );
 
+		/** @return The time since the connection finished its last request */
+		Time getIdleTime() const;
+
+		void resetIdleTime();
+
 	  protected:
 		TcpSocket* mSocket;
 		bool mIsConnected;
 		bool mIsTunneled;
 		bool mIsSSL;
 		bool mIsKeepAlive;
+		Clock mIdleClock;
 	};
 
 	friend class AsyncRequest;
@@ -726,10 +764,34 @@ class EE_API Http : NonCopyable {
 	bool mIsSSL;
 	bool mHostSolved;
 	URI mProxy;
+	std::vector<HttpConnection*> mIdleConnections; ///< Keep-alive connections ready to be reused
+	Mutex mIdleConnectionsMutex;
+	AsyncExecutor* mAsyncExecutor{ NULL }; ///< Event loop of the plain HTTP async requests
+	Mutex mAsyncExecutorMutex;
+	size_t mMaxConnections{ 6 };
+	size_t mPipeliningDepth{ 1 };
+	Time mIdleTimeout{ Seconds( 30 ) };
 
 	void removeOldThreads();
 
-	Request prepareFields( const Http::Request& request );
+	Request prepareFields( const Http::Request& request, bool keepAlive );
+
+	bool solveHost();
+
+	HttpConnection* createConnection( const Http::Request& request, const Time& timeout );
+
+	/** @return An idle keep-alive connection to the host or NULL */
+	HttpConnection* acquireConnection();
+
+	/** Keeps the connection to be reused if it's still alive, otherwise destroys it */
+	void releaseConnection( HttpConnection* connection );
+
+	void clearIdleConnections();
+
+	/** @return True if the request can be run by the event loop instead of a thread */
+	bool isAsyncExecutorRequest( const Http::Request& request ) const;
+
+	AsyncExecutor* getAsyncExecutor();
 };
 
 }} // namespace EE::Network
@@ -805,4 +867,8 @@ Http::getAsync(
 		}
 	}, "http://www.google.com" );
 @endcode
+
+The connections are kept alive and reused by the following requests to the same host. The
+async requests of plain HTTP clients are run by a single event loop per client, that sends them
+through up to getMaxConnections() connections and optionally pipelines them.
 */
@@ -3,13 +3,15 @@
 
 #include <eepp/core.hpp>
 #include <eepp/system/time.hpp>
+#include <vector>
 using namespace EE::System;
 
 namespace EE { namespace Network {
 
 class Socket;
 
-/** Multiplexer that allows to read from multiple sockets */
+/** Multiplexer that allows to read from multiple sockets
+**  It uses epoll on Linux and Android, poll on the other POSIX platforms and select on Windows. */
 class EE_API SocketSelector {
   public:
 	/** @brief Default constructor */
@@ -68,6 +70,15 @@ class EE_API SocketSelector {
 	**  @see IsReady */
 	bool isReady( Socket& socket ) const;
 
+	/** @brief Get the sockets that are ready to receive data
+	**  This function must be used after a call to Wait. It allows to
+	**  iterate only the ready sockets, instead of testing every socket
+	**  with isReady. The list is valid until the next call to Wait, Clear,
+	**  or until a ready socket is removed.
+	**  @return The sockets ready to read
+	**  @see Wait, IsReady */
+	const std::vector<Socket*>& getReadySockets() const;
+
 	/** @brief Overload of assignment operator
 	**  @param right Instance to assign
 	**  @return Reference to self */
@@ -147,17 +158,17 @@ while (running) {
 				 // Error, we won't get a new connection, delete the socket
 				 delete client;
 			 }
-		 } else {
-			 // The listener socket is not ready, test all other sockets (the clients)
-			 for (std::vector<TcpSocket*>::iterator it = clients.begin(); it != clients.end(); ++it) {
-				 TcpSocket& client = **it;
-				 if (selector.isReady(client)) {
-					 // The client has sent some data, we can receive it
-					 Packet packet;
-					 if (client.Receive(packet) == Socket::Done) {
-						 ...
-					 }
-				 }
+		 }
+
+		 // Iterate only the ready sockets (the listener is also in the list)
+		 for (Socket* socket : selector.getReadySockets()) {
+			 if (socket == &listener)
+				 continue;
+			 // The client has sent some data, we can receive it
+			 TcpSocket& client = *static_cast<TcpSocket*>(socket);
+			 Packet packet;
+			 if (client.receive(packet) == Socket::Done) {
+				 ...
 			 }
 		 }
 	 }
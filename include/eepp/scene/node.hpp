@@ -26,6 +26,7 @@ namespace EE { namespace Scene {
 class Action;
 class ActionManager;
 class SceneNode;
+class NodeSpatialIndex;
 }} // namespace EE::Scene
 using namespace EE::Scene;
 
@@ -429,6 +430,13 @@ class EE_API Node : public Transformable {
 
 	virtual Node* overFind( const Vector2f& Point );
 
+	/** Enables a uniform grid index over the world bounds of the direct childs of the node, so
+	 * overFind only tests the childs that can contain the point. Useful for containers with
+	 * many childs ( big grids, maps, etc ). */
+	void setSpatialIndexEnabled( bool enabled, const Float& cellSize = 64.f );
+
+	bool isSpatialIndexEnabled() const;
+
 	/** This removes the node from its parent. Never use this unless you know what you are doing. */
 	void detach();
 
@@ -470,6 +478,7 @@ class EE_API Node : public Transformable {
 	Uint32 mNodeFlags;
 	BlendMode mBlend;
 	Uint32 mNumCallBacks;
+	NodeSpatialIndex* mSpatialIndex;
 
 	mutable Polygon2f mPoly;
 	mutable Rectf mWorldBounds;
@@ -588,6 +597,8 @@ class EE_API Node : public Transformable {
 
 	void setDirty();
 
+	void setPolygonDirty();
+
 	void setChildsDirty();
 
 	void clipSmartEnable( const Int32& x, const Int32& y, const Uint32& Width, const Uint32& Height,
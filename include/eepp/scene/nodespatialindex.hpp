@@ -0,0 +1,72 @@
+#ifndef EE_SCENE_NODESPATIALINDEX_HPP
+#define EE_SCENE_NODESPATIALINDEX_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/containers.hpp>
+#include <eepp/math/rect.hpp>
+#include <eepp/math/vector2.hpp>
+#include <vector>
+using namespace EE::Math;
+
+namespace EE { namespace Scene {
+
+class Node;
+
+/** A uniform grid over the world bounds of the direct childs of a node.
+ * Used by Node::overFind to only test the childs that can contain the queried point.
+ * Childs report their world polygon changes to the index, and the grid is refreshed lazily
+ * on the next query. */
+class EE_API NodeSpatialIndex {
+  public:
+	static NodeSpatialIndex* New( Node* container, const Float& cellSize = 64.f );
+
+	NodeSpatialIndex( Node* container, const Float& cellSize = 64.f );
+
+	/** Marks the world bounds of a child as outdated. */
+	void invalidate( Node* child );
+
+	/** Drops the whole index ( childs were added, removed or reordered ). */
+	void invalidateAll();
+
+	/** @return The topmost child that contains the point ( as in Node::overFind ), or NULL. */
+	Node* overFind( const Vector2f& point );
+
+	const Float& getCellSize() const;
+
+	void setCellSize( const Float& cellSize );
+
+  protected:
+	struct Entry {
+		Node* node{ nullptr };
+		Rectf bounds;
+		Rect cells;
+		bool dirty{ true };
+		bool large{ false };
+	};
+
+	Node* mContainer;
+	Float mCellSize;
+	bool mNeedsRebuild{ true };
+	std::vector<Entry> mEntries;
+	std::vector<Uint32> mDirty;
+	std::vector<Uint32> mLarge;
+	std::vector<Uint32> mCandidates;
+	UnorderedMap<Node*, Uint32> mNodeEntry;
+	UnorderedMap<Uint64, std::vector<Uint32>> mCells;
+
+	void rebuild();
+
+	void refresh();
+
+	void insert( const Uint32& entryIndex );
+
+	void remove( const Uint32& entryIndex );
+
+	Rect getCellRange( const Rectf& bounds ) const;
+
+	static Uint64 getCellKey( const Int32& x, const Int32& y );
+};
+
+}} // namespace EE::Scene
+
+#endif
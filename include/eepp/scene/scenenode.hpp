@@ -104,6 +104,8 @@ class EE_API SceneNode : public Node {
 
 	const bool& getUpdateAllChilds() const;
 
+	/** When disabled only the nodes subscribed to scheduled updates are updated every frame
+	 * ( see Node::subscribeScheduledUpdate ), idle trees are not visited. */
 	void setUpdateAllChilds( const bool& updateAllChilds );
 
 	const Float& getDPI() const;
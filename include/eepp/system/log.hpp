@@ -1,14 +1,20 @@
 #ifndef EECLOG_H
 #define EECLOG_H
 
+#include <atomic>
+#include <condition_variable>
 #include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/singleton.hpp>
 #include <eepp/system/sys.hpp>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace EE { namespace System {
 
+class Thread;
+
 /** @brief The reader interface is useful if you want to keep track of what is write in the log, for
  * example for a console. */
 class LogReaderInterface {
@@ -83,7 +89,7 @@ class EE_API Log : protected Mutex {
 			return;
 		auto result = String::format(
 			format, FormatArg<std::decay_t<Args>>::get( std::forward<Args>( args ) )... );
-		write( logLevelWithTimestamp( level, result, true ) );
+		writel( level, result );
 	}
 
 	/** @brief Writes a formated string to the log */
@@ -95,9 +101,29 @@ class EE_API Log : protected Mutex {
 		write( "\n" );
 	}
 
-	/** @returns A reference of the current writed log. */
+	/** @returns A reference of the current writed log. In async mode it contains the texts
+	 * already processed by the flusher thread, see flush(). */
 	const std::string& getBuffer() const;
 
+	/** @return The maximum size in bytes of the log kept in memory */
+	size_t getKeepLogMaxSize() const;
+
+	/** Sets the maximum size in bytes of the log kept in memory, when exceeded the oldest lines
+	 * are discarded. */
+	void setKeepLogMaxSize( size_t maxSize );
+
+	/** @return True if the log is written by the flusher thread */
+	bool isAsync() const;
+
+	/** @brief Enables or disables the async mode.
+	 * In async mode every thread queues its texts in its own lock-free ring buffer, and a
+	 * background thread formats the timestamps and writes the texts in batches to the memory
+	 * log, the readers, the stdout and the log file. The readers are called from that thread. */
+	void setAsync( bool async );
+
+	/** @brief Waits until the texts written before the call are processed by the flusher thread */
+	void flush();
+
 	/** @returns If the log Writes are outputed to stdout. */
 	const bool& isLoggingToStdOut() const;
 
@@ -208,6 +234,8 @@ class EE_API Log : protected Mutex {
 	}
 
   protected:
+	struct AsyncRing;
+
 	Log();
 
 	Log( const std::string& logPath, const LogLevel& level, bool stdOutLog, bool liveWrite );
@@ -221,6 +249,20 @@ class EE_API Log : protected Mutex {
 	LogLevel mLogLevelThreshold{ getDefaultLogLevel() };
 	IOStreamFile* mFS;
 	std::vector<LogReaderInterface*> mReaders;
+	size_t mKeepLogMaxSize{ 8 * EE_1MB };
+	std::atomic<bool> mAsync{ false };
+	std::atomic<bool> mFlusherRunning{ false };
+	std::atomic<bool> mFlusherWakeUp{ false };
+	Uint64 mGeneration{ 0 };
+	Thread* mFlusher{ nullptr };
+	std::vector<std::shared_ptr<AsyncRing>> mRings;
+	std::mutex mRingsMutex;
+	std::mutex mConsumeMutex;
+	std::mutex mFlushMutex;
+	std::condition_variable mFlushCond;
+	std::condition_variable mFlushedCond;
+	Uint64 mFlushRequest{ 0 };
+	Uint64 mFlushDone{ 0 };
 
 	void openFS();
 
@@ -228,6 +270,23 @@ class EE_API Log : protected Mutex {
 
 	void writeToReaders( const std::string_view& text );
 
+	void keepLog( const std::string_view& text, bool newLine );
+
+	void writeToStdOut( const std::string_view& text );
+
+	void push( const LogLevel* level, const std::string_view& text, bool newLine );
+
+	AsyncRing* getThreadRing();
+
+	void wakeUpFlusher();
+
+	void flusherFunc();
+
+	/** Writes the queued texts of every thread in order, the callers are serialized */
+	void consumeRings();
+
+	void stopFlusher();
+
 	std::string logLevelWithTimestamp( const LogLevel& level, const std::string_view& text,
 									   bool appendNewLine );
 };
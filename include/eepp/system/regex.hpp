@@ -2,6 +2,7 @@
 #define EE_SYSTEM_REGEX
 
 #include <eepp/core/containers.hpp>
+#include <eepp/system/mutex.hpp>
 #include <eepp/system/patternmatcher.hpp>
 #include <eepp/system/singleton.hpp>
 
@@ -16,7 +17,8 @@ class EE_API RegExCache {
 
 	void setEnabled( bool enabled );
 
-	void insert( std::string_view, Uint32 options, void* cache );
+	/** @return False if the pattern was already cached ( by another thread ). */
+	bool insert( std::string_view, Uint32 options, void* cache );
 
 	void* find( const std::string_view&, Uint32 options );
 
@@ -24,6 +26,7 @@ class EE_API RegExCache {
 
   protected:
 	bool mEnabled{ true };
+	Mutex mMutex;
 	UnorderedMap<String::HashType, void*> mCache;
 };
 
@@ -9,13 +9,43 @@
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/thread.hpp>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace EE { namespace System {
 
+/** Every worker thread owns a queue per priority, the tasks are pushed to the queue of the worker
+ * that submits them ( or distributed among the workers when submitted from other threads ) and the
+ * idle workers steal the tasks from the other queues. A worker always takes the highest priority
+ * task available in any queue. */
 class EE_API ThreadPool : NonCopyable {
   public:
+	enum class Priority : Uint8 {
+		High,	///< Latency sensitive work, e.g. the work the user is waiting for
+		Normal, ///< Default priority
+		Low,	///< Bulk work, e.g. a project search
+	};
+
+	/** Cooperative cancellation flag shared by its copies. The queued tasks of a cancelled token
+	 * are discarded, the running ones are expected to check isCancelled() and return early. */
+	class EE_API CancellationToken {
+	  public:
+		CancellationToken();
+
+		void cancel();
+
+		bool isCancelled() const;
+
+	  protected:
+		friend class ThreadPool;
+
+		std::shared_ptr<std::atomic<bool>> mCancelled;
+	};
+
 	static std::shared_ptr<ThreadPool> createShared( Uint32 numThreads,
 													 bool terminateOnClose = false );
 
@@ -33,6 +63,50 @@ class EE_API ThreadPool : NonCopyable {
 		const std::function<void( const Uint64& )>& doneCallback = []( const Uint64& ) {},
 		const Uint64& tag = 0 );
 
+	Uint64 run( const std::function<void()>& func, Priority priority,
+				const std::function<void( const Uint64& )>& doneCallback = nullptr,
+				const Uint64& tag = 0, const CancellationToken* token = nullptr );
+
+	/** Runs the function in the pool and returns its result as a future. If the task is removed
+	 * or cancelled before it runs the future throws std::future_error ( broken_promise ). */
+	template <typename F, typename R = std::invoke_result_t<std::decay_t<F>>>
+	std::future<R> async( F&& func, Priority priority = Priority::Normal, const Uint64& tag = 0,
+						  const CancellationToken* token = nullptr ) {
+		auto task = std::make_shared<std::packaged_task<R()>>( std::forward<F>( func ) );
+		std::future<R> future( task->get_future() );
+		run( [task] { ( *task )(); }, priority, nullptr, tag, token );
+		return future;
+	}
+
+	/** Calls func( begin, end ) for the consecutive ranges of up to grainSize indexes that cover
+	 * [first, last). The calling thread processes ranges too, so it can be called from a pool task,
+	 * and it returns when all the ranges are processed ( or skipped after the token is cancelled ).
+	 */
+	void parallelFor( size_t first, size_t last, size_t grainSize,
+					  const std::function<void( size_t begin, size_t end )>& func,
+					  Priority priority = Priority::High,
+					  const CancellationToken* token = nullptr );
+
+	/** Maps every range of parallelFor to a partial result with map( begin, end ) and reduces
+	 * them in the ranges order with reduce( accumulated, partial ), starting from identity. */
+	template <typename T, typename Map, typename Reduce>
+	T parallelReduce( size_t first, size_t last, size_t grainSize, T identity, const Map& map,
+					  const Reduce& reduce, Priority priority = Priority::High ) {
+		if ( last <= first )
+			return identity;
+		grainSize = grainSize > 0 ? grainSize : 1;
+		std::vector<T> partials( ( last - first + grainSize - 1 ) / grainSize, identity );
+		parallelFor(
+			first, last, grainSize,
+			[&]( size_t begin, size_t end ) {
+				partials[( begin - first ) / grainSize] = map( begin, end );
+			},
+			priority );
+		for ( auto& partial : partials )
+			identity = reduce( std::move( identity ), std::move( partial ) );
+		return identity;
+	}
+
 	Uint32 numThreads() const;
 
 	bool terminateOnClose() const;
@@ -48,22 +122,45 @@ class EE_API ThreadPool : NonCopyable {
 	bool removeWithTag( const Uint64& tag );
 
   private:
+	static constexpr size_t PriorityCount = 3;
+
 	struct Work {
+		enum State : Uint8 { Queued, Taken, Removed };
 		Uint64 id{ 0 };
-		const std::function<void()> func;
-		const std::function<void( const Uint64& )> callback;
+		std::function<void()> func;
+		std::function<void( const Uint64& )> callback;
 		Uint64 tag{ 0 };
+		std::shared_ptr<std::atomic<bool>> cancelled;
+		std::atomic<Uint8> state{ Queued };
+	};
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<Work*> queues[PriorityCount];
 	};
 
-	void threadFunc();
+	void threadFunc( size_t index );
+
+	Work* pop( size_t index );
+
+	Work* take( Worker& worker, size_t priority, bool front );
+
+	void untag( Work* work );
 
 	std::vector<std::unique_ptr<Thread>> mThreads;
-	std::deque<std::unique_ptr<Work>> mWork;
-	std::atomic<Uint64> mLastWorkId;
-	bool mShuttingDown = false;
+	std::vector<std::unique_ptr<Worker>> mWorkers;
+	std::atomic<Uint64> mLastWorkId{ 0 };
+	std::atomic<size_t> mNextWorker{ 0 };
+	/** Tasks queued by priority, it never exceeds the tasks in the queues */
+	std::atomic<Int64> mPending[PriorityCount];
+	std::atomic<int> mSleeping{ 0 };
+	std::atomic<bool> mShuttingDown{ false };
 	bool mTerminateOnClose = false;
-	mutable std::mutex mMutex;
+	std::mutex mSleepMutex;
 	std::condition_variable mWorkAvailable;
+	/** The queued tasks with a tag, so they can be found without scanning the queues */
+	std::unordered_map<Uint64, std::vector<Work*>> mTagged;
+	std::mutex mTaggedMutex;
 };
 
 }} // namespace EE::System
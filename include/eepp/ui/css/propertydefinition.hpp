@@ -220,6 +220,7 @@ enum class PropertyId : Uint32 {
 	RowValign = String::hash( "row-valign" ),
 	TextOverflow = String::hash( "text-overflow" ),
 	CheckMode = String::hash( "check-mode" ),
+	RenderLayer = String::hash( "render-layer" ),
 };
 
 enum class PropertyType : Uint32 {
@@ -404,9 +404,25 @@ class EE_API TextDocument {
 						   FindReplaceType type = FindReplaceType::Normal,
 						   TextRange restrictRange = TextRange(), size_t maxResults = 0 );
 
+	typedef std::function<void( SearchResults&& )> FindAllResultsCb;
+
+	/** Searches all the matches splitting the document in line ranges between the threads of the
+	 * pool. The calling thread also searches, so it can be called from a thread of the same pool.
+	 * The results of each line range are streamed through onResults as soon as they are found (
+	 * from any thread and in any order ), the complete sorted results are returned at the end.
+	 * It can be cancelled with stopActiveFindAll. */
+	SearchResults findAllParallel( std::shared_ptr<ThreadPool> pool, const String& text,
+								   bool caseSensitive = true, bool wholeWord = false,
+								   FindReplaceType type = FindReplaceType::Normal,
+								   TextRange restrictRange = TextRange(),
+								   const FindAllResultsCb& onResults = nullptr );
+
+	/** Replaces all the matches in a single undoable change. If a pool is provided big documents
+	 * are searched splitting the lines in ranges between the threads of the pool. */
 	int replaceAll( const String& text, const String& replace, const bool& caseSensitive = true,
 					const bool& wholeWord = false, FindReplaceType type = FindReplaceType::Normal,
-					TextRange restrictRange = TextRange() );
+					TextRange restrictRange = TextRange(),
+					std::shared_ptr<ThreadPool> pool = nullptr );
 
 	TextPosition replaceSelection( const String& replace );
 
@@ -756,6 +772,20 @@ class EE_API TextDocument {
 						 UndoStackContainer& undoStack, const Time& time,
 						 bool fromUndoRedo = false );
 
+	/** Replaces the complete lines [fromLine, fromLine + numLines) with text ( that must end with a
+	 * new line ), recording a single undo command.
+	 * @return The number of lines of the new text. */
+	Int64 replaceLines( Int64 fromLine, Int64 numLines, const String& text,
+						UndoStackContainer& undoStack, const Time& time );
+
+	SearchResults findAllInRange( const String& text, bool caseSensitive, bool wholeWord,
+								  FindReplaceType type, TextRange range, Int64 lastStartLine,
+								  bool* stopFlag );
+
+	int replaceAllSequential( const String& text, const String& replace,
+							  const bool& caseSensitive, const bool& wholeWord,
+							  FindReplaceType type, TextRange restrictRange );
+
 	void appendLineIfLastLine( const size_t& cursorIdx, Int64 line );
 
 	void guessIndentType();
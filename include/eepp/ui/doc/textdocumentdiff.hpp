@@ -0,0 +1,149 @@
+#ifndef EE_UI_DOC_TEXTDOCUMENTDIFF_HPP
+#define EE_UI_DOC_TEXTDOCUMENTDIFF_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/ui/doc/textdocument.hpp>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/**
+ * Line diff between a TextDocument and a base version of it ( usually the file at HEAD ).
+ * Lines are compared with the Myers algorithm by the id of their text in the base, found by their
+ * hashes and confirmed by the text. The document edits only mark the modified lines, and the
+ * hunks are recomputed lazily, only for the region around the edits.
+ */
+class EE_API TextDocumentDiff : public TextDocument::Client {
+  public:
+	enum class ChangeType { Added, Removed, Modified };
+
+	struct Hunk {
+		Int64 oldStart{ 0 };
+		Int64 oldCount{ 0 };
+		/** For removed lines it's the line that follows the removed lines */
+		Int64 newStart{ 0 };
+		Int64 newCount{ 0 };
+
+		ChangeType type() const {
+			return oldCount == 0	? ChangeType::Added
+				   : newCount == 0 ? ChangeType::Removed
+								   : ChangeType::Modified;
+		}
+
+		bool operator==( const Hunk& other ) const {
+			return oldStart == other.oldStart && oldCount == other.oldCount &&
+				   newStart == other.newStart && newCount == other.newCount;
+		}
+	};
+
+	/** The lines of a text, where the equal lines share the same id. The distinct texts are
+	 * kept, so two lines with the same hash are still told apart. */
+	class EE_API Lines {
+	  public:
+		/** The id of the lines that are not found, never equal to the id of a line */
+		static constexpr Uint32 NoLine = 0xFFFFFFFF;
+
+		Lines() = default;
+
+		/** Splits the UTF-8 text in lines, as TextDocument does ( ending with the line break ). */
+		explicit Lines( std::string_view text );
+
+		size_t size() const;
+
+		/** @return The id of every line */
+		const std::vector<Uint32>& getIds() const;
+
+		/** @return The id of the line text ( with its line break ) or NoLine. */
+		Uint32 find( const String& line, const String::HashType& hash ) const;
+
+	  protected:
+		friend class TextDocumentDiff;
+
+		std::vector<Uint32> mIds;
+		std::vector<String> mTexts;
+		/** The next text with the same hash, by id */
+		std::vector<Uint32> mNextSameHash;
+		std::unordered_map<String::HashType, Uint32> mFirstByHash;
+	};
+
+	/** @return The hunks needed to transform oldLines into newLines. */
+	static std::vector<Hunk> diff( const Lines& oldLines, const Lines& newLines );
+
+	explicit TextDocumentDiff( TextDocument* doc );
+
+	~TextDocumentDiff();
+
+	TextDocument* getDocument() const;
+
+	void setBase( std::string_view text );
+
+	/** Sets the lines of the base, useful to split the base in another thread. */
+	void setBase( Lines&& lines );
+
+	bool hasBase() const;
+
+	void clearBase();
+
+	/** @return The hunks sorted by line, updated with the last document modifications. */
+	const std::vector<Hunk>& getHunks();
+
+	/** @return The hunk at the document line or nullptr. Removed lines are reported in the line
+	 * before the removal. */
+	const Hunk* getLineHunk( Int64 line );
+
+	/** @return The first line of the next change after the line or -1. */
+	Int64 nextChange( Int64 line );
+
+	/** @return The first line of the previous change before the line or -1. */
+	Int64 prevChange( Int64 line );
+
+  protected:
+	TextDocument* mDoc;
+	Lines mBase;
+	std::vector<Hunk> mHunks;
+	bool mHasBase{ false };
+	bool mFullDirty{ true };
+	/* modified document lines ( inclusive ) since the last update, mDirtyFrom < 0 if none */
+	Int64 mDirtyFrom{ -1 };
+	Int64 mDirtyTo{ -1 };
+
+	void update();
+
+	void markDirty( Int64 fromLine, Int64 toLine );
+
+	/** @return The id of the document line in the base, Lines::NoLine if not in the base */
+	Uint32 docLineId( Int64 line ) const;
+
+	virtual void onDocumentTextChanged( const DocumentContentChange& ) {}
+
+	virtual void onDocumentUndoRedo( const TextDocument::UndoRedo& ) {}
+
+	virtual void onDocumentCursorChange( const TextPosition& ) {}
+
+	virtual void onDocumentSelectionChange( const TextRange& ) {}
+
+	virtual void onDocumentLineCountChange( const size_t&, const size_t& ) {}
+
+	virtual void onDocumentLineChanged( const Int64& lineIndex );
+
+	virtual void onDocumentSaved( TextDocument* ) {}
+
+	virtual void onDocumentClosed( TextDocument* );
+
+	virtual void onDocumentDirtyOnFileSystem( TextDocument* ) {}
+
+	virtual void onDocumentMoved( TextDocument* ) {}
+
+	virtual void onDocumentReset( TextDocument* );
+
+	virtual void onDocumentLoaded( TextDocument* );
+
+	virtual void onDocumentLineMove( const Int64& fromLine, const Int64& toLine,
+									 const Int64& numLines );
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif
@@ -14,7 +14,7 @@ namespace EE { namespace UI { namespace Doc {
 class TextDocument;
 class TextUndoCommand;
 
-enum class TextUndoCommandType { Insert = 1, Remove = 2, Selection = 3 };
+enum class TextUndoCommandType { Insert = 1, Remove = 2, Selection = 3, ReplaceLines = 4 };
 
 using UndoStackContainer = std::deque<TextUndoCommand*>;
 
@@ -71,6 +71,9 @@ class EE_API TextUndoStack {
 	void pushSelection( UndoStackContainer& undoStack, const size_t& cursorIdx,
 						const TextRanges& selection, const Time& time );
 
+	void pushReplaceLines( UndoStackContainer& undoStack, const Int64& line, const Int64& numLines,
+						   const String& text, const Time& time );
+
 	UndoStackContainer& getUndoStackContainer();
 
 	UndoStackContainer& getRedoStackContainer();
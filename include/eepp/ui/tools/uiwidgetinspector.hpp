@@ -20,6 +20,9 @@ class EE_API UIWidgetInspector {
 							 std::function<void()> drawBoxesToggle = std::function<void()>(),
 							 std::function<void()> drawDebugDataToggle = std::function<void()>() );
 
+	/** Opens a window with the results of the AllocationProfiler, refreshed every second */
+	static void openAllocationProfiler( UISceneNode* sceneNode );
+
   protected:
 	static void checkWidgetPick( UISceneNode* sceneNode, UITreeView* widgetTree,
 								 bool wasHighlightOver, UITableView* tableView );
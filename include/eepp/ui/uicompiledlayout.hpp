@@ -0,0 +1,94 @@
+#ifndef EE_UI_UICOMPILEDLAYOUT_HPP
+#define EE_UI_UICOMPILEDLAYOUT_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/string.hpp>
+#include <eepp/system/iostream.hpp>
+#include <eepp/system/md5.hpp>
+#include <eepp/ui/css/stylesheetproperty.hpp>
+#include <string>
+#include <vector>
+
+using namespace EE::System;
+
+namespace pugi {
+class xml_node;
+}
+
+namespace EE { namespace UI {
+
+/** A XML layout compiled into a compact binary form.
+ * Tag names, attribute names, attribute values and texts are interned into a string table, and
+ * the element tree is stored in pre-order, so the UISceneNode can instantiate the widgets
+ * without parsing the XML again. The attributes are also parsed into style sheet properties
+ * when the layout is compiled or loaded, so they are not parsed again on every instantiation (
+ * the properties must be registered before ). */
+class EE_API UICompiledLayout {
+  public:
+	static constexpr Uint32 NoString = 0xFFFFFFFF;
+
+	struct Attribute {
+		Uint32 name;
+		Uint32 value;
+	};
+
+	struct Element {
+		Uint32 tag;
+		Uint32 text;
+		Uint32 firstAttribute;
+		Uint32 attributeCount;
+		/** Number of descendants of the element. The first child ( if any ) is the next element,
+		 * and the next sibling is at index + subtreeSize + 1. */
+		Uint32 subtreeSize;
+	};
+
+	/** Compiles the node and all its next siblings ( as loaded by UISceneNode::loadLayoutNodes ).
+	 */
+	static UICompiledLayout compile( const pugi::xml_node& node );
+
+	UICompiledLayout();
+
+	bool isEmpty() const;
+
+	bool loadFromStream( IOStream& stream );
+
+	bool loadFromMemory( const void* buffer, size_t bufferSize );
+
+	bool loadFromFile( const std::string& path );
+
+	bool saveToStream( IOStream& stream ) const;
+
+	bool saveToFile( const std::string& path ) const;
+
+	/** Rebuilds the XML subtree of the element into the parent node. */
+	void toXml( const Uint32& elementIndex, pugi::xml_node& parent ) const;
+
+	const std::vector<std::string>& getStrings() const;
+
+	const std::string& getString( const Uint32& id ) const;
+
+	const std::vector<Attribute>& getAttributes() const;
+
+	/** @return The inline properties of the attribute, with the shorthands already expanded.
+	 * Empty if the attribute name is not a property or shorthand. */
+	const std::vector<CSS::StyleSheetProperty>& getProperties( const Uint32& attributeIndex ) const;
+
+	const std::vector<Element>& getElements() const;
+
+	const MD5::Digest& getSourceHash() const;
+
+	void setSourceHash( const MD5::Digest& sourceHash );
+
+  protected:
+	std::vector<std::string> mStrings;
+	std::vector<Attribute> mAttributes;
+	std::vector<Element> mElements;
+	MD5::Digest mSourceHash;
+	std::vector<std::vector<CSS::StyleSheetProperty>> mProperties;
+
+	void parseProperties();
+};
+
+}} // namespace EE::UI
+
+#endif
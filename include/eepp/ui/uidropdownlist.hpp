@@ -26,6 +26,8 @@ class EE_API UIDropDownList : public UITextInput {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void setTheme( UITheme* Theme );
 
 	UIListBox* getListBox() const;
@@ -21,6 +21,8 @@ class EE_API UIImage : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void draw();
 
 	virtual void setAlpha( const Float& alpha );
@@ -11,6 +11,8 @@ class EE_API UILayout : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual const Sizef& getSize() const;
 
 	virtual void updateLayout();
@@ -19,6 +19,8 @@ class EE_API UILoader : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void draw();
 
 	virtual void scheduledUpdate( const Time& time );
@@ -38,6 +38,8 @@ class EE_API UIPushButton : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void setTheme( UITheme* Theme );
 
 	virtual UIPushButton* setIcon( Drawable* icon, bool ownIt = false );
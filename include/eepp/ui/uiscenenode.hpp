@@ -22,6 +22,7 @@ class UIWindow;
 class UIWidget;
 class UILayout;
 class UIIcon;
+class UICompiledLayout;
 
 enum class ColorSchemePreference { Light, Dark };
 
@@ -45,6 +46,10 @@ class EE_API UISceneNode : public SceneNode {
 
 	virtual void update( const Time& elapsed );
 
+	virtual void draw();
+
+	virtual void invalidate( Node* invalidator );
+
 	void setTranslator( Translator translator );
 
 	const Translator& getTranslator() const;
@@ -79,6 +84,23 @@ class EE_API UISceneNode : public SceneNode {
 	UIWidget* loadLayoutFromPack( Pack* pack, const std::string& FilePackPath,
 								  Node* parent = NULL );
 
+	UIWidget* loadLayoutFromCompiled( const UICompiledLayout& layout, Node* parent = NULL,
+									  const Uint32& marker = 0 );
+
+	/** When enabled the layouts loaded from files, strings, memory or streams are compiled once
+	 * and instantiated from its compiled form, keyed by the MD5 hash of the layout source. */
+	void setLayoutCacheEnabled( bool enabled );
+
+	bool isLayoutCacheEnabled() const;
+
+	/** If set, the compiled layouts are also stored in this directory, so they can be reused
+	 * between runs. */
+	void setLayoutCachePath( const std::string& path );
+
+	const std::string& getLayoutCachePath() const;
+
+	void clearLayoutCache();
+
 	void setStyleSheet( const CSS::StyleSheet& styleSheet, bool loadStyle = true );
 
 	void setStyleSheet( const std::string& inlineStyleSheet );
@@ -169,6 +191,26 @@ class EE_API UISceneNode : public SceneNode {
 
 	CSS::MediaFeatures getMediaFeatures() const;
 
+	/** Sets the maximum memory ( in bytes ) used by the widgets render layers ( see
+	 * UIWidget::setRenderLayer ). Layers that don't fit in the budget are drawn directly. */
+	void setRenderLayersMemoryBudget( const size_t& budget );
+
+	const size_t& getRenderLayersMemoryBudget() const;
+
+	const size_t& getRenderLayersMemoryUsage() const;
+
+	/** @return The number of render layers that reused its cached drawing in the last frame. */
+	const Uint32& getRenderLayersHits() const;
+
+	/** @return The number of render layers that redrew its content in the last frame. */
+	const Uint32& getRenderLayersMisses() const;
+
+	/** Highlights the render layers boxes, green if the cached drawing was reused in the frame
+	 * and red if it was redrawn. */
+	void setHighlightRenderLayers( bool highlight );
+
+	bool getHighlightRenderLayers() const;
+
   protected:
 	friend class EE::UI::UIWindow;
 	friend class EE::UI::UIWidget;
@@ -195,6 +237,14 @@ class EE_API UISceneNode : public SceneNode {
 	Node* mCurParent{ nullptr };
 	Uint32 mCurOnSizeChangeListener{ 0 };
 	std::shared_ptr<ThreadPool> mThreadPool;
+	bool mLayoutCacheEnabled{ false };
+	std::string mLayoutCachePath;
+	UnorderedMap<std::string, std::shared_ptr<UICompiledLayout>> mLayoutCache;
+	size_t mRenderLayersMemoryBudget{ 64 * 1024 * 1024 };
+	size_t mRenderLayersMemoryUsage{ 0 };
+	Uint32 mRenderLayersHits{ 0 };
+	Uint32 mRenderLayersMisses{ 0 };
+	bool mHighlightRenderLayers{ false };
 
 	virtual void resizeNode( EE::Window::Window* win );
 
@@ -238,7 +288,23 @@ class EE_API UISceneNode : public SceneNode {
 
 	std::vector<UIWidget*> loadNode( pugi::xml_node node, Node* parent, const Uint32& marker );
 
+	std::vector<UIWidget*>
+	loadCompiledNode( const UICompiledLayout& layout, const Uint32& begin, const Uint32& end,
+					  Node* parent, const Uint32& marker,
+					  UnorderedMap<Uint32, std::function<UIWidget*()>>& creators );
+
+	std::shared_ptr<UICompiledLayout> getCompiledLayout( const char* buffer, size_t bufferSize );
+
+	UIWidget* loadLayoutFromCache( const char* buffer, size_t bufferSize, Node* parent,
+								   const Uint32& marker );
+
 	void setTheme( UITheme* theme, Node* to );
+
+	bool requestRenderLayerMemory( const size_t& size );
+
+	void releaseRenderLayerMemory( const size_t& size );
+
+	void onRenderLayerDraw( bool cacheHit );
 };
 
 }} // namespace EE::UI
@@ -31,6 +31,8 @@ class EE_API UIScrollBar : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void setValue( Float val, const bool& emmitEvent = true );
 
 	const Float& getValue() const;
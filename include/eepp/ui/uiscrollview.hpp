@@ -19,6 +19,8 @@ class EE_API UIScrollView : public UITouchDraggableWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	void setVerticalScrollMode( const ScrollBarMode& Mode );
 
 	const ScrollBarMode& getVerticalScrollMode() const;
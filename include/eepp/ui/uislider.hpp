@@ -28,6 +28,8 @@ class EE_API UISlider : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void setTheme( UITheme* Theme );
 
 	virtual void setValue( Float val, bool emmitEvent = true );
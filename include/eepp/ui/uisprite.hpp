@@ -22,6 +22,8 @@ class EE_API UISprite : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void draw();
 
 	virtual void scheduledUpdate( const Time& time );
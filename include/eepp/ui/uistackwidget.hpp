@@ -15,6 +15,8 @@ class EE_API UIStackWidget : public UIWidget {
 
 	UIWidget* getActiveWidget() const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
   protected:
 	UIWidget* mActiveWidget{ nullptr };
 
@@ -23,6 +23,8 @@ class EE_API UITextView : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void draw();
 
 	Graphics::Font* getFont() const;
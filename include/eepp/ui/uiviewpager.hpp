@@ -19,6 +19,8 @@ class EE_API UIViewPager : public UIWidget {
 
 	virtual bool isType( const Uint32& type ) const;
 
+	virtual bool loadsOnlyXmlAttributes() const;
+
 	virtual void onChildCountChange( Node* child, const bool& removed );
 
 	const UIOrientation& getOrientation() const;
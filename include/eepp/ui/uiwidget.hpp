@@ -10,6 +10,10 @@ namespace pugi {
 class xml_node;
 }
 
+namespace EE { namespace Graphics {
+class FrameBuffer;
+}} // namespace EE::Graphics
+
 namespace EE { namespace UI { namespace CSS {
 class PropertyDefinition;
 }}} // namespace EE::UI::CSS
@@ -20,6 +24,7 @@ namespace EE { namespace UI {
 
 class UITooltip;
 class UIStyle;
+class UICompiledLayout;
 
 class EE_API UIWidget : public UINode {
   public:
@@ -113,6 +118,17 @@ class EE_API UIWidget : public UINode {
 
 	virtual void loadFromXmlNode( const pugi::xml_node& node );
 
+	/** @return True if loadFromXmlNode only applies the attributes of the node ( and its text,
+	 * that the compiled layouts always load from the XML node ). The compiled layouts apply the
+	 * attributes of these widgets with loadFromCompiledLayout, without rebuilding the XML node.
+	 * False by default: widgets opt in, and a subclass that overrides loadFromXmlNode to read
+	 * anything else must return false. */
+	virtual bool loadsOnlyXmlAttributes() const;
+
+	/** Applies the attributes of a compiled layout element, equivalent to the UIWidget
+	 * implementation of loadFromXmlNode. */
+	void loadFromCompiledLayout( const UICompiledLayout& layout, const Uint32& elementIndex );
+
 	void notifyLayoutAttrChange();
 
 	void notifyLayoutAttrChangeParent();
@@ -283,6 +299,23 @@ class EE_API UIWidget : public UINode {
 
 	String i18n( const std::string& str, const String& defaultValue );
 
+	/** Caches the drawing of the widget and its childs in a frame buffer, that is reused until
+	 * the widget or any of its childs invalidates its drawing. Intended for complex widgets that
+	 * rarely change. The cached drawing is clipped to the widget box. Widgets that already
+	 * manage their own invalidation ( windows and tab widgets ) ignore it.
+	 * Also available as the "render-layer" CSS property. */
+	void setRenderLayer( bool renderLayer );
+
+	bool isRenderLayer() const;
+
+	/** @return The render layer frame buffer. NULL if the render layer is not enabled, or if it
+	 * didn't fit in the UISceneNode render layers memory budget. */
+	FrameBuffer* getRenderLayerFrameBuffer() const;
+
+	virtual bool isDrawInvalidator() const;
+
+	virtual void invalidate( Node* invalidator );
+
   protected:
 	friend class UIManager;
 	friend class UISceneNode;
@@ -308,9 +341,20 @@ class EE_API UIWidget : public UINode {
 	std::vector<std::string> mClasses;
 	std::vector<std::string> mPseudoClasses;
 	String mTooltipText;
+	FrameBuffer* mRenderLayer{ nullptr };
+	size_t mRenderLayerMemory{ 0 };
+	Vector2i mRenderLayerPos;
+	bool mRenderLayerEnabled{ false };
+	bool mRenderLayerFailed{ false };
 
 	explicit UIWidget( const std::string& tag );
 
+	virtual void nodeDraw();
+
+	virtual void matrixSet();
+
+	virtual void matrixUnset();
+
 	void updatePseudoClasses();
 
 	virtual void onChildCountChange( Node* child, const bool& removed );
@@ -373,6 +417,10 @@ class EE_API UIWidget : public UINode {
 
 	bool checkPropertyDefinition( const StyleSheetProperty& property );
 
+	void loadInlineAttribute( const std::string& name, const std::string& value );
+
+	void loadInlineProperty( const StyleSheetProperty& property );
+
 	Vector2f getTooltipPosition();
 
 	void createStyle();
@@ -382,6 +430,14 @@ class EE_API UIWidget : public UINode {
 	void disableCSSAnimations();
 
 	void reloadFontFamily();
+
+	void createRenderLayer();
+
+	void destroyRenderLayer();
+
+	void invalidateRenderLayer();
+
+	void drawRenderLayer();
 };
 
 }} // namespace EE::UI
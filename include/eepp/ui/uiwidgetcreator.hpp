@@ -17,6 +17,10 @@ class EE_API UIWidgetCreator {
 
 	static UIWidget* createFromName( const std::string& widgetName );
 
+	/** @return The function that creates the widget, or an empty function if the widget name is
+	 * not registered. Allows to resolve the widget name once and create many instances. */
+	static RegisterWidgetCb getWidgetCreator( const std::string& widgetName );
+
 	static void addCustomWidgetCallback( const std::string& widgetName, const CustomWidgetCb& cb );
 
 	static void removeCustomWidgetCallback( const std::string& widgetName );
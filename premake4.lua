@@ -1635,7 +1635,13 @@ solution "eepp"
 		kind "ConsoleApp"
 		targetdir("./bin/unit_tests")
 		language "C++"
-		files { "src/tests/unit_tests/*.cpp" }
+		files { "src/tests/unit_tests/*.cpp", "src/tools/ecode/plugins/lsp/lspmessageframer.cpp",
+			"src/tools/ecode/plugins/git/gitchangedetector.cpp",
+			"src/tools/ecode/plugins/autocomplete/linesymbolsindex.cpp" }
+		includedirs { "src/modules/eterm/include/" }
+		links { "eterm-static" }
+		eepp_module_maps_add()
+		eepp_module_physics_add()
 		build_link_configuration( "eepp-unit_tests", true )
 
 if os.isfile("external_projects.lua") then
@@ -1473,7 +1473,13 @@ workspace "eepp"
 		kind "ConsoleApp"
 		targetdir(_MAIN_SCRIPT_DIR .. "/bin/unit_tests")
 		language "C++"
-		files { "src/tests/unit_tests/*.cpp" }
+		files { "src/tests/unit_tests/*.cpp", "src/tools/ecode/plugins/lsp/lspmessageframer.cpp",
+			"src/tools/ecode/plugins/git/gitchangedetector.cpp",
+			"src/tools/ecode/plugins/autocomplete/linesymbolsindex.cpp" }
+		incdirs { "src/modules/eterm/include/" }
+		links { "eterm-static" }
+		eepp_module_maps_add()
+		eepp_module_physics_add()
 		build_link_configuration( "eepp-unit_tests", true )
 
 if os.isfile("external_projects.lua") then
@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <eepp/core/allocationprofiler.hpp>
+#include <eepp/core/string.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/log.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace EE::System;
+
+namespace EE {
+
+namespace {
+
+struct SiteKey {
+	std::array<const char*, AllocationProfiler::MaxZoneDepth> zones;
+	Uint32 depth;
+	const char* file;
+	int line;
+
+	bool operator==( const SiteKey& other ) const {
+		return file == other.file && line == other.line && depth == other.depth &&
+			   std::equal( zones.begin(), zones.begin() + depth, other.zones.begin() );
+	}
+};
+
+struct SiteKeyHash {
+	size_t operator()( const SiteKey& key ) const {
+		size_t hash = std::hash<const void*>()( key.file ) ^ ( (size_t)key.line * 2654435761u );
+		for ( Uint32 i = 0; i < key.depth; i++ )
+			hash = hash * 31 + std::hash<const void*>()( key.zones[i] );
+		return hash;
+	}
+};
+
+struct SiteCounts {
+	Uint64 allocations{ 0 };
+	Uint64 bytes{ 0 };
+	Uint64 reallocations{ 0 };
+};
+
+typedef std::unordered_map<SiteKey, SiteCounts, SiteKeyHash> SiteMap;
+
+/** The counters of a thread. The totals are written only by its thread, the samples are guarded
+ * by the mutex, that the thread only takes on the sampled allocations. */
+struct ThreadBuffer {
+	std::atomic<Uint64> allocations{ 0 };
+	std::atomic<Uint64> bytes{ 0 };
+	std::atomic<Uint64> reallocations{ 0 };
+	std::mutex mutex;
+	SiteMap sites;
+	std::array<const char*, AllocationProfiler::MaxZoneDepth> zones;
+	Uint32 depth{ 0 };
+	Int64 countdown{ 0 };
+	Uint32 random{ 2463534242u };
+
+	/** @return The allocations until the next sample, uniform in [1, 2 * interval - 1] */
+	Int64 nextCountdown( const Uint32& interval ) {
+		if ( interval <= 1 )
+			return 1;
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return 1 + random % ( 2 * interval - 1 );
+	}
+};
+
+static constexpr size_t MaxFrames = 300;
+
+static std::atomic<Uint32> sSampleInterval{ 64 };
+static std::atomic<Uint32> sAggregationInterval{ 60 };
+// Lock order: sBuffersMutex, ThreadBuffer::mutex, sResultsMutex
+static std::mutex sBuffersMutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> sBuffers;
+static AllocationProfiler::FrameStats sRetired{ 0, 0, 0, 0 };
+static std::mutex sResultsMutex;
+static SiteMap sSites;
+static std::deque<AllocationProfiler::FrameStats> sFrames;
+static AllocationProfiler::FrameStats sBase{ 0, 0, 0, 0 };
+static AllocationProfiler::FrameStats sLastFrameTotal{ 0, 0, 0, 0 };
+static Uint64 sFrame = 0;
+
+static ThreadBuffer* getThreadBuffer() {
+	static thread_local std::shared_ptr<ThreadBuffer> buffer;
+
+	if ( !buffer ) {
+		buffer = std::make_shared<ThreadBuffer>();
+		buffer->countdown = buffer->nextCountdown( sSampleInterval );
+		std::lock_guard<std::mutex> lock( sBuffersMutex );
+		sBuffers.push_back( buffer );
+	}
+
+	return buffer.get();
+}
+
+static void merge( SiteMap& sites, const SiteMap& from ) {
+	for ( const auto& site : from ) {
+		SiteCounts& counts = sites[site.first];
+		counts.allocations += site.second.allocations;
+		counts.bytes += site.second.bytes;
+		counts.reallocations += site.second.reallocations;
+	}
+}
+
+/** Only the thread of the buffer writes its totals, a load and a store are enough */
+static void add( std::atomic<Uint64>& counter, const Uint64& value ) {
+	counter.store( counter.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+}
+
+/** Counts the allocation or reallocation in its site if it's the one sampled */
+static void sample( ThreadBuffer* buffer, const size_t& bytes, bool reallocation, const char* file,
+					const int& line ) {
+	if ( --buffer->countdown > 0 )
+		return;
+
+	// Every sample stands for sSampleInterval allocations in average
+	Uint32 interval = sSampleInterval.load( std::memory_order_relaxed );
+	buffer->countdown = buffer->nextCountdown( interval );
+
+	SiteKey key;
+	key.depth = eemin<Uint32>( buffer->depth, AllocationProfiler::MaxZoneDepth );
+	std::copy( buffer->zones.begin(), buffer->zones.begin() + key.depth, key.zones.begin() );
+	key.file = file;
+	key.line = line;
+
+	std::lock_guard<std::mutex> lock( buffer->mutex );
+	SiteCounts& counts = buffer->sites[key];
+	if ( reallocation ) {
+		counts.reallocations += interval;
+	} else {
+		counts.allocations += interval;
+		counts.bytes += (Uint64)bytes * interval;
+	}
+}
+
+/** Sums the totals of every thread and releases the buffers of the finished threads.
+ * sBuffersMutex must be locked. */
+static AllocationProfiler::FrameStats sumTotals() {
+	AllocationProfiler::FrameStats total = sRetired;
+
+	for ( auto it = sBuffers.begin(); it != sBuffers.end(); ) {
+		ThreadBuffer* buffer = it->get();
+		Uint64 allocations = buffer->allocations.load( std::memory_order_relaxed );
+		Uint64 bytes = buffer->bytes.load( std::memory_order_relaxed );
+		Uint64 reallocations = buffer->reallocations.load( std::memory_order_relaxed );
+		total.allocations += allocations;
+		total.bytes += bytes;
+		total.reallocations += reallocations;
+
+		if ( it->use_count() == 1 ) {
+			std::lock_guard<std::mutex> lock( sResultsMutex );
+			merge( sSites, buffer->sites );
+			sRetired.allocations += allocations;
+			sRetired.bytes += bytes;
+			sRetired.reallocations += reallocations;
+			it = sBuffers.erase( it );
+		} else {
+			++it;
+		}
+	}
+
+	return total;
+}
+
+static std::string getFileName( const char* file ) {
+	std::string path( file );
+	std::replace( path.begin(), path.end(), '\\', '/' );
+	return FileSystem::fileNameFromPath( path );
+}
+
+} // namespace
+
+std::atomic<bool> AllocationProfiler::sEnabled{ false };
+
+AllocationProfiler::Zone::Zone( const char* name ) : mPushed( isEnabled() ) {
+	if ( mPushed ) {
+		ThreadBuffer* buffer = getThreadBuffer();
+		// The zones deeper than MaxZoneDepth are attributed to the deepest stored zone
+		if ( buffer->depth < MaxZoneDepth )
+			buffer->zones[buffer->depth] = name;
+		buffer->depth++;
+	}
+}
+
+AllocationProfiler::Zone::~Zone() {
+	if ( mPushed )
+		getThreadBuffer()->depth--;
+}
+
+void AllocationProfiler::setEnabled( bool enabled ) {
+	sEnabled.store( enabled, std::memory_order_relaxed );
+}
+
+void AllocationProfiler::setSampleInterval( Uint32 interval ) {
+	sSampleInterval = eemax<Uint32>( 1, interval );
+}
+
+Uint32 AllocationProfiler::getSampleInterval() {
+	return sSampleInterval;
+}
+
+void AllocationProfiler::setAggregationInterval( Uint32 frames ) {
+	sAggregationInterval = eemax<Uint32>( 1, frames );
+}
+
+Uint32 AllocationProfiler::getAggregationInterval() {
+	return sAggregationInterval;
+}
+
+void AllocationProfiler::onAllocation( const size_t& bytes, const char* file, const int& line ) {
+	ThreadBuffer* buffer = getThreadBuffer();
+	add( buffer->allocations, 1 );
+	add( buffer->bytes, bytes );
+	sample( buffer, bytes, false, file, line );
+}
+
+void AllocationProfiler::onReallocation( const char* file, const int& line ) {
+	ThreadBuffer* buffer = getThreadBuffer();
+	add( buffer->reallocations, 1 );
+	sample( buffer, 0, true, file, line );
+}
+
+void AllocationProfiler::endFrame() {
+	bool doAggregate;
+	{
+		std::lock_guard<std::mutex> lock( sBuffersMutex );
+		FrameStats total = sumTotals();
+		std::lock_guard<std::mutex> resultsLock( sResultsMutex );
+		sFrames.push_back( { sFrame++, total.allocations - sLastFrameTotal.allocations,
+							 total.bytes - sLastFrameTotal.bytes,
+							 total.reallocations - sLastFrameTotal.reallocations } );
+		if ( sFrames.size() > MaxFrames )
+			sFrames.pop_front();
+		sLastFrameTotal = total;
+		doAggregate = sFrame % sAggregationInterval == 0;
+	}
+
+	if ( doAggregate )
+		aggregate();
+}
+
+void AllocationProfiler::aggregate() {
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	{
+		std::lock_guard<std::mutex> lock( sBuffersMutex );
+		buffers = sBuffers;
+	}
+
+	SiteMap sites;
+	for ( auto& buffer : buffers ) {
+		// Swap the samples out so the thread is blocked only for the swap
+		SiteMap bufferSites;
+		{
+			std::lock_guard<std::mutex> lock( buffer->mutex );
+			bufferSites.swap( buffer->sites );
+		}
+		merge( sites, bufferSites );
+	}
+
+	std::lock_guard<std::mutex> lock( sResultsMutex );
+	merge( sSites, sites );
+}
+
+void AllocationProfiler::reset() {
+	std::lock_guard<std::mutex> lock( sBuffersMutex );
+	for ( auto& buffer : sBuffers ) {
+		std::lock_guard<std::mutex> bufferLock( buffer->mutex );
+		buffer->sites.clear();
+	}
+
+	// The totals are only written by their threads, they are kept and counted from here
+	FrameStats total = sumTotals();
+	std::lock_guard<std::mutex> resultsLock( sResultsMutex );
+	sSites.clear();
+	sFrames.clear();
+	sFrame = 0;
+	sBase = total;
+	sLastFrameTotal = total;
+}
+
+std::vector<AllocationProfiler::FrameStats> AllocationProfiler::getFrames() {
+	std::lock_guard<std::mutex> lock( sResultsMutex );
+	return std::vector<FrameStats>( sFrames.begin(), sFrames.end() );
+}
+
+AllocationProfiler::FrameStats AllocationProfiler::getTotal() {
+	std::lock_guard<std::mutex> lock( sBuffersMutex );
+	FrameStats total = sumTotals();
+	std::lock_guard<std::mutex> resultsLock( sResultsMutex );
+	return { sFrame, total.allocations - sBase.allocations, total.bytes - sBase.bytes,
+			 total.reallocations - sBase.reallocations };
+}
+
+std::vector<AllocationProfiler::Site> AllocationProfiler::getSites() {
+	aggregate();
+
+	std::vector<Site> sites;
+	{
+		std::lock_guard<std::mutex> lock( sResultsMutex );
+		sites.reserve( sSites.size() );
+		for ( const auto& site : sSites ) {
+			sites.push_back( { std::vector<const char*>( site.first.zones.begin(),
+														 site.first.zones.begin() +
+															 site.first.depth ),
+							   site.first.file, site.first.line, site.second.allocations,
+							   site.second.bytes, site.second.reallocations } );
+		}
+	}
+
+	std::sort( sites.begin(), sites.end(), []( const Site& a, const Site& b ) {
+		return a.bytes != b.bytes ? a.bytes > b.bytes : a.allocations > b.allocations;
+	} );
+	return sites;
+}
+
+std::map<std::string, Uint64> AllocationProfiler::getBytesPerSubsystem() {
+	std::map<std::string, Uint64> subsystems;
+	for ( const auto& site : getSites() )
+		subsystems[getSubsystem( site.file )] += site.bytes;
+	return subsystems;
+}
+
+std::string AllocationProfiler::getSubsystem( const char* file ) {
+	std::string path( file );
+	std::replace( path.begin(), path.end(), '\\', '/' );
+
+	for ( const std::string_view root : { "src/eepp/", "include/eepp/" } ) {
+		size_t pos = path.rfind( root );
+		if ( pos != std::string::npos ) {
+			pos += root.size();
+			size_t end = path.find( '/', pos );
+			if ( end != std::string::npos )
+				return path.substr( pos, end - pos );
+		}
+	}
+
+	size_t end = path.find_last_of( '/' );
+	if ( end == std::string::npos || end == 0 )
+		return "unknown";
+
+	size_t start = path.find_last_of( '/', end - 1 );
+	start = start == std::string::npos ? 0 : start + 1;
+	return path.substr( start, end - start );
+}
+
+std::string AllocationProfiler::getFolded( const Weight& weight ) {
+	std::string folded;
+
+	for ( const auto& site : getSites() ) {
+		Uint64 value = weight == Weight::Bytes ? site.bytes : site.allocations;
+
+		// The sites that only reallocate have no weight
+		if ( 0 == value )
+			continue;
+
+		for ( const auto& zone : site.zones ) {
+			folded += zone;
+			folded += ';';
+		}
+
+		folded += getSubsystem( site.file ) + ";" + getFileName( site.file ) + ":" +
+				  String::toString( site.line ) + " " + String::toString( value ) + "\n";
+	}
+
+	return folded;
+}
+
+bool AllocationProfiler::exportFolded( const std::string& path, const Weight& weight ) {
+	return FileSystem::fileWrite( path, getFolded( weight ) );
+}
+
+void AllocationProfiler::logReport( const size_t& maxSites ) {
+	FrameStats total = getTotal();
+	std::vector<FrameStats> frames = getFrames();
+	Uint64 frameAllocations = 0;
+	Uint64 peakAllocations = 0;
+
+	for ( const auto& frame : frames ) {
+		frameAllocations += frame.allocations;
+		peakAllocations = eemax( peakAllocations, frame.allocations );
+	}
+
+	Log::info( "Allocation profiler: %llu allocations, %s, %llu reallocations in %llu frames",
+			   (unsigned long long)total.allocations,
+			   FileSystem::sizeToString( total.bytes ).c_str(),
+			   (unsigned long long)total.reallocations, (unsigned long long)total.frame );
+
+	if ( !frames.empty() ) {
+		Log::info( "  Allocations per frame in the last %zu frames: %.1f average, %llu peak",
+				   frames.size(), (double)frameAllocations / frames.size(),
+				   (unsigned long long)peakAllocations );
+	}
+
+	for ( const auto& subsystem : getBytesPerSubsystem() ) {
+		Log::info( "  Subsystem %s: %s", subsystem.first.c_str(),
+				   FileSystem::sizeToString( subsystem.second ).c_str() );
+	}
+
+	std::vector<Site> sites = getSites();
+	for ( size_t i = 0; i < sites.size() && i < maxSites; i++ ) {
+		Log::info( "  %s:%d: %llu allocations, %s, %llu reallocations",
+				   getFileName( sites[i].file ).c_str(), sites[i].line,
+				   (unsigned long long)sites[i].allocations,
+				   FileSystem::sizeToString( sites[i].bytes ).c_str(),
+				   (unsigned long long)sites[i].reallocations );
+	}
+}
+
+} // namespace EE
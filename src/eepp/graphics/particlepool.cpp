@@ -0,0 +1,176 @@
+#include <eepp/graphics/particlepool.hpp>
+
+namespace EE { namespace Graphics {
+
+ParticlePool::ParticlePool() : mCount( 0 ) {}
+
+void ParticlePool::reserve( const size_t& capacity ) {
+	if ( capacity > mX.size() )
+		resize( capacity );
+}
+
+void ParticlePool::resize( const size_t& capacity ) {
+	mX.resize( capacity );
+	mY.resize( capacity );
+	mXSpeed.resize( capacity );
+	mYSpeed.resize( capacity );
+	mXAcc.resize( capacity );
+	mYAcc.resize( capacity );
+	mR.resize( capacity );
+	mG.resize( capacity );
+	mB.resize( capacity );
+	mA.resize( capacity );
+	mAlphaDecay.resize( capacity );
+	mId.resize( capacity );
+}
+
+void ParticlePool::clear() {
+	mCount = 0;
+}
+
+size_t ParticlePool::add( const Particle& particle ) {
+	if ( mCount == mX.size() )
+		resize( eemax<size_t>( 16, mCount * 2 ) );
+
+	set( mCount, particle );
+	return mCount++;
+}
+
+void ParticlePool::set( const size_t& index, const Particle& particle ) {
+	const ColorAf& color = particle.getColor();
+	mX[index] = particle.getX();
+	mY[index] = particle.getY();
+	mXSpeed[index] = particle.getXSpeed();
+	mYSpeed[index] = particle.getYSpeed();
+	mXAcc[index] = particle.getXAcc();
+	mYAcc[index] = particle.getYAcc();
+	mR[index] = color.r;
+	mG[index] = color.g;
+	mB[index] = color.b;
+	mA[index] = color.a;
+	mAlphaDecay[index] = particle.getAlphaDecay();
+	mId[index] = particle.getId();
+}
+
+void ParticlePool::get( const size_t& index, Particle& particle ) const {
+	particle.reset( mX[index], mY[index], mXSpeed[index], mYSpeed[index], mXAcc[index],
+					mYAcc[index], particle.getSize() );
+	particle.setColor( ColorAf( mR[index], mG[index], mB[index], mA[index] ),
+					   mAlphaDecay[index] );
+	particle.setId( mId[index] );
+}
+
+void ParticlePool::remove( const size_t& index ) {
+	size_t last = --mCount;
+
+	if ( index == last )
+		return;
+
+	mX[index] = mX[last];
+	mY[index] = mY[last];
+	mXSpeed[index] = mXSpeed[last];
+	mYSpeed[index] = mYSpeed[last];
+	mXAcc[index] = mXAcc[last];
+	mYAcc[index] = mYAcc[last];
+	mR[index] = mR[last];
+	mG[index] = mG[last];
+	mB[index] = mB[last];
+	mA[index] = mA[last];
+	mAlphaDecay[index] = mAlphaDecay[last];
+	mId[index] = mId[last];
+}
+
+void ParticlePool::integrate( const Float& time ) {
+	// Every attribute is updated in its own loop without branches, so the compiler can vectorize
+	// every one of them
+	Float* x = mX.data();
+	Float* y = mY.data();
+	Float* xSpeed = mXSpeed.data();
+	Float* ySpeed = mYSpeed.data();
+	const Float* xAcc = mXAcc.data();
+	const Float* yAcc = mYAcc.data();
+	Float* a = mA.data();
+	const Float* alphaDecay = mAlphaDecay.data();
+	const size_t count = mCount;
+
+	for ( size_t i = 0; i < count; i++ )
+		x[i] = x[i] + xSpeed[i] * time;
+
+	for ( size_t i = 0; i < count; i++ )
+		y[i] = y[i] + ySpeed[i] * time;
+
+	for ( size_t i = 0; i < count; i++ )
+		xSpeed[i] = xSpeed[i] + xAcc[i] * time;
+
+	for ( size_t i = 0; i < count; i++ )
+		ySpeed[i] = ySpeed[i] + yAcc[i] * time;
+
+	for ( size_t i = 0; i < count; i++ ) {
+		const Float alpha = a[i] - alphaDecay[i] * time;
+		a[i] = alpha < 0.f ? 0.f : alpha;
+	}
+}
+
+size_t ParticlePool::findDead( size_t index ) const {
+	while ( index < mCount && mA[index] > 0.f )
+		index++;
+
+	return index;
+}
+
+/** Writes a vertex. Color construction and assignment are not inlined, the packed value is
+ * assigned instead. */
+static inline void setVertex( VertexData& vertex, const Float& x, const Float& y, const Float& u,
+							  const Float& v, const tColor<Uint8>& color ) {
+	vertex.pos.x = x;
+	vertex.pos.y = y;
+	vertex.tex.x = u;
+	vertex.tex.y = v;
+	vertex.color.assign( color );
+}
+
+Uint32 ParticlePool::emitQuads( VertexData* vertex, const Float& size, bool triangles ) const {
+	const Float hsize = size * 0.5f;
+
+	for ( size_t i = 0; i < mCount; i++ ) {
+		const Float left = mX[i] - hsize;
+		const Float top = mY[i] - hsize;
+		const Float right = left + size;
+		const Float bottom = top + size;
+		const tColor<Uint8> color(
+			static_cast<Uint8>( mR[i] * 255 ), static_cast<Uint8>( mG[i] * 255 ),
+			static_cast<Uint8>( mB[i] * 255 ), static_cast<Uint8>( mA[i] * 255 ) );
+
+		if ( triangles ) {
+			setVertex( vertex[0], left, bottom, 0, 1, color );
+			setVertex( vertex[1], left, top, 0, 0, color );
+			setVertex( vertex[2], right, top, 1, 0, color );
+			setVertex( vertex[3], left, bottom, 0, 1, color );
+			setVertex( vertex[4], right, bottom, 1, 1, color );
+			setVertex( vertex[5], right, top, 1, 0, color );
+			vertex += 6;
+		} else {
+			setVertex( vertex[0], left, top, 0, 0, color );
+			setVertex( vertex[1], left, bottom, 0, 1, color );
+			setVertex( vertex[2], right, bottom, 1, 1, color );
+			setVertex( vertex[3], right, top, 1, 0, color );
+			vertex += 4;
+		}
+	}
+
+	return mCount * getQuadVertexCount( triangles );
+}
+
+Uint32 ParticlePool::emitPoints( VertexData* vertex ) const {
+	for ( size_t i = 0; i < mCount; i++ ) {
+		const tColor<Uint8> color(
+			static_cast<Uint8>( mR[i] * 255 ), static_cast<Uint8>( mG[i] * 255 ),
+			static_cast<Uint8>( mB[i] * 255 ), static_cast<Uint8>( mA[i] * 255 ) );
+
+		setVertex( vertex[i], mX[i], mY[i], 0, 0, color );
+	}
+
+	return mCount;
+}
+
+}} // namespace EE::Graphics
@@ -12,7 +12,6 @@ using namespace EE::Window;
 namespace EE { namespace Graphics {
 
 ParticleSystem::ParticleSystem() :
-	mParticle( NULL ),
 	mPCount( 0 ),
 	mTexture( 0 ),
 	mPLeft( 0 ),
@@ -34,16 +33,14 @@ ParticleSystem::ParticleSystem() :
 	mUsed( false ),
 	mPointsSup( false ) {}
 
-ParticleSystem::~ParticleSystem() {
-	eeSAFE_DELETE_ARRAY( mParticle );
-}
+ParticleSystem::~ParticleSystem() {}
 
 void ParticleSystem::create( const ParticleEffect& Effect, const Uint32& NumParticles,
 							 const Uint32& TexId, const Vector2f& Pos, const Float& PartSize,
 							 const bool& AnimLoop, const Uint32& NumLoops, const ColorAf& Color,
 							 const Vector2f& Pos2, const Float& AlphaDecay, const Vector2f& Speed,
 							 const Vector2f& Acc ) {
-	mPointsSup = GLi->pointSpriteSupported();
+	mPointsSup = NULL != GLi && GLi->pointSpriteSupported();
 	mEffect = Effect;
 	mPos = Pos;
 	mPCount = NumParticles;
@@ -77,21 +74,32 @@ void ParticleSystem::create( const ParticleEffect& Effect, const Uint32& NumPart
 void ParticleSystem::begin() {
 	mPLeft = mPCount;
 
-	eeSAFE_DELETE_ARRAY( mParticle );
-
-	mParticle = eeNewArray( Particle, mPCount );
+	mPool.clear();
+	mPool.reserve( mPCount );
 
-	Particle* P;
+	// The vertices are written directly in the buffer, it holds the quads of every particle
+	mVertices.resize( mPCount * ParticlePool::getQuadVertexCount( true ) );
 
 	for ( Uint32 i = 0; i < mPCount; i++ ) {
-		P = &mParticle[i];
-		P->setUsed( true );
-		P->setId( i + 1 );
+		Particle P;
+		P.setUsed( true );
+		P.setId( i + 1 );
+
+		reset( &P );
 
-		reset( P );
+		mPool.add( P );
 	}
 }
 
+void ParticleSystem::resetParticle( const size_t& index ) {
+	mPool.get( index, mParticle );
+	mParticle.setUsed( true );
+
+	reset( &mParticle );
+
+	mPool.set( index, mParticle );
+}
+
 void ParticleSystem::setCallbackReset( const ParticleCallback& pc ) {
 	mPC = pc;
 }
@@ -317,54 +325,48 @@ void ParticleSystem::reset( Particle* P ) {
 }
 
 void ParticleSystem::draw() {
-	if ( !mUsed )
+	if ( !mUsed || 0 == mPool.size() )
 		return;
 
+	// The batched vertices go first, the particles are rendered directly from its own buffer
+	GlobalBatchRenderer::instance()->draw();
+
 	BlendMode::setMode( mBlend );
 
-	if ( mPointsSup ) {
-		if ( NULL != mTexture ) {
-			const_cast<Texture*>( mTexture )->bind();
-		} else {
-			GLi->disable( GL_TEXTURE_2D );
-			GLi->disableClientState( GL_TEXTURE_COORD_ARRAY );
-		}
+	bool triangles = !GLi->quadsSupported();
+	Uint32 numVertex = mPointsSup ? mPool.emitPoints( mVertices.data() )
+								  : mPool.emitQuads( mVertices.data(), mSize, triangles );
+	Uint32 alloc = sizeof( VertexData ) * numVertex;
+	char* vertex = reinterpret_cast<char*>( mVertices.data() );
 
+	if ( NULL != mTexture ) {
+		const_cast<Texture*>( mTexture )->bind();
+		GLi->texCoordPointer( 2, GL_FP, sizeof( VertexData ), vertex + sizeof( Vector2f ), alloc );
+	} else {
+		GLi->disable( GL_TEXTURE_2D );
+		GLi->disableClientState( GL_TEXTURE_COORD_ARRAY );
+	}
+
+	if ( mPointsSup ) {
 		GLi->enable( GL_POINT_SPRITE );
 		GLi->pointSize( mSize );
+	}
 
-		Uint32 alloc = mPCount * sizeof( Particle );
+	GLi->vertexPointer( 2, GL_FP, sizeof( VertexData ), vertex, alloc );
+	GLi->colorPointer( 4, GL_UNSIGNED_BYTE, sizeof( VertexData ),
+					   vertex + sizeof( Vector2f ) + sizeof( Vector2f ), alloc );
 
-		GLi->colorPointer( 4, GL_FP, sizeof( Particle ),
-						   reinterpret_cast<char*>( &mParticle[0] ) + sizeof( Float ) * 2, alloc );
-		GLi->vertexPointer( 2, GL_FP, sizeof( Particle ), reinterpret_cast<char*>( &mParticle[0] ),
-							alloc );
+	PrimitiveType mode =
+		mPointsSup ? PRIMITIVE_POINTS : ( triangles ? PRIMITIVE_TRIANGLES : PRIMITIVE_QUADS );
 
-		GLi->drawArrays( GL_POINTS, 0, (int)mPCount );
+	GLi->drawArrays( mode, 0, numVertex );
 
+	if ( mPointsSup )
 		GLi->disable( GL_POINT_SPRITE );
+
+	if ( NULL == mTexture ) {
 		GLi->enable( GL_TEXTURE_2D );
 		GLi->enableClientState( GL_TEXTURE_COORD_ARRAY );
-	} else {
-		Particle* P;
-
-		BatchRenderer* BR = GlobalBatchRenderer::instance();
-		BR->setTexture( mTexture );
-		BR->setBlendMode( mBlend );
-		BR->quadsBegin();
-
-		for ( Uint32 i = 0; i < mPCount; i++ ) {
-			P = &mParticle[i];
-
-			if ( P->isUsed() ) {
-				BR->quadsSetColor( Color(
-					static_cast<Uint8>( P->r() * 255 ), static_cast<Uint8>( P->g() * 255 ),
-					static_cast<Uint8>( P->b() * 255 ), static_cast<Uint8>( P->a() * 255 ) ) );
-				BR->batchQuad( P->getX() - mHSize, P->getY() - mHSize, mSize, mSize );
-			}
-		}
-
-		BR->drawOpt();
 	}
 }
 
@@ -376,35 +378,30 @@ void ParticleSystem::update( const System::Time& time ) {
 	if ( !mUsed )
 		return;
 
-	Particle* P;
+	mPool.integrate( time.asMilliseconds() * mTime );
 
-	for ( Uint32 i = 0; i < mPCount; i++ ) {
-		P = &mParticle[i];
-
-		if ( P->isUsed() || P->a() > 0.f ) {
-			P->update( time.asMilliseconds() * mTime );
-
-			// If not alive
-			if ( P->a() <= 0.f ) {
-				if ( !mLoop ) {			 // If not loop
-					if ( mLoops == 1 ) { // If left only one loop
-						P->setUsed( false );
-						mPLeft--;
-					} else { // more than one
-						if ( i == 0 )
-							if ( mLoops > 0 )
-								mLoops--;
-
-						reset( P );
-					}
-
-					if ( mPLeft == 0 ) // Last mParticle?
-						mUsed = false;
-				} else {
-					reset( P );
-				}
+	// Only the particles that died in this update are visited
+	size_t i = mPool.findDead( 0 );
+
+	while ( i < mPool.size() ) {
+		if ( !mLoop && mLoops == 1 ) {
+			// Last loop, the particle is replaced by the last one, that is checked next
+			mPool.remove( i );
+			mPLeft--;
+
+			if ( mPLeft == 0 ) {
+				mUsed = false;
+				break;
 			}
+		} else {
+			if ( !mLoop && mPool.getId( i ) == 1 && mLoops > 0 )
+				mLoops--;
+
+			resetParticle( i );
+			i++;
 		}
+
+		i = mPool.findDead( i );
 	}
 }
 
@@ -417,8 +414,25 @@ void ParticleSystem::reuse() {
 	mLoop = true;
 	mLoops = 0;
 
-	for ( Uint32 i = 0; i < mPCount; i++ )
-		mParticle[i].setUsed( true );
+	if ( mPool.size() == mPCount )
+		return;
+
+	// The removed particles are added back dead, so they're reset in the next update
+	std::vector<bool> alive( mPCount + 1, false );
+
+	for ( size_t i = 0; i < mPool.size(); i++ )
+		alive[mPool.getId( i )] = true;
+
+	for ( Uint32 id = 1; id <= mPCount; id++ ) {
+		if ( !alive[id] ) {
+			Particle P;
+			P.setColor( ColorAf( 1.f, 1.f, 1.f, 0.f ), 0.f );
+			P.setId( id );
+			mPool.add( P );
+		}
+	}
+
+	mPLeft = mPCount;
 }
 
 void ParticleSystem::kill() {
@@ -509,4 +523,8 @@ void ParticleSystem::setAcceleration( const Vector2f& acc ) {
 	mAcc = acc;
 }
 
+const ParticlePool& ParticleSystem::getPool() const {
+	return mPool;
+}
+
 }} // namespace EE::Graphics
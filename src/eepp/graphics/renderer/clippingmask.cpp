@@ -152,6 +152,8 @@ void ClippingMask::setScissorsClipped( const std::vector<Rectf>& scissorsClipped
 		EE::Window::Window* window = Engine::instance()->getCurrentWindow();
 		GLi->scissor( r.Left, window->getHeight() - r.Bottom, r.getWidth(), r.getHeight() );
 		GLi->enable( GL_SCISSOR_TEST );
+	} else {
+		GLi->disable( GL_SCISSOR_TEST );
 	}
 }
 
@@ -166,6 +168,8 @@ void ClippingMask::setPlanesClipped( const std::vector<Rectf>& planesClipped ) {
 		Rectf r( mPlanesClipped.back() );
 
 		GLi->clip2DPlaneEnable( r.Left, r.Top, r.getWidth(), r.getHeight() );
+	} else {
+		GLi->clip2DPlaneDisable();
 	}
 }
 
@@ -1,14 +1,13 @@
 #include <algorithm>
 #include <cctype>
 #include <eepp/network/http.hpp>
-#include <eepp/network/http/httpstreamchunked.hpp>
+#include <eepp/network/http/httpasyncexecutor.hpp>
+#include <eepp/network/http/httpresponseparser.hpp>
 #include <eepp/network/ssl/sslsocket.hpp>
 #include <eepp/network/uri.hpp>
-#include <eepp/system/compression.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/iostreamfile.hpp>
-#include <eepp/system/iostreaminflate.hpp>
 #include <eepp/system/iostreamstring.hpp>
 #include <eepp/system/sys.hpp>
 #include <iostream>
@@ -21,7 +20,6 @@
 #endif
 
 using namespace EE::Network::SSL;
-using namespace EE::Network::Private;
 
 namespace EE { namespace Network {
 
@@ -125,6 +123,11 @@ const Http::Request::Method& Http::Request::getMethod() const {
 	return mMethod;
 }
 
+bool Http::Request::isIdempotent() const {
+	return mMethod == Get || mMethod == Head || mMethod == Put || mMethod == Delete ||
+		   mMethod == Options;
+}
+
 const bool& Http::Request::getValidateCertificate() const {
 	return mValidateCertificate;
 }
@@ -627,6 +630,8 @@ Http::Http( const std::string& host, unsigned short port, bool useSSL, URI proxy
 
 Http::~Http() {
 	// First we wait to finish any request pending
+	eeSAFE_DELETE( mAsyncExecutor );
+
 	for ( auto&& itt : mThreads ) {
 		itt->wait();
 	}
@@ -639,6 +644,8 @@ Http::~Http() {
 	HttpConnection* connection = mConnection;
 
 	eeSAFE_DELETE( connection );
+
+	clearIdleConnections();
 }
 
 void Http::setHost( const std::string& host, unsigned short port, bool useSSL, URI proxy ) {
@@ -688,6 +695,9 @@ void Http::setHost( const std::string& host, unsigned short port, bool useSSL, U
 		eeSAFE_DELETE( connection );
 		mConnection = NULL;
 	}
+
+	if ( !sameHost )
+		clearIdleConnections();
 }
 
 Http::Response Http::sendRequest( const Http::Request& request, Time timeout ) {
@@ -709,58 +719,29 @@ static bool sendProgress( const Http& http, const Http::Request& request,
 Http::Response Http::downloadRequest( const Http::Request& request, IOStream& writeTo,
 									  Time timeout ) {
 	// Solve the host IP only when the request starts.
-	if ( !mHostSolved ) {
-		if ( !mProxy.empty() ) {
-			mHost = IpAddress( mProxy.getHost() );
-		} else {
-			mHost = IpAddress( mHostName );
-		}
-		mHostSolved = true;
-	}
-
-	if ( 0 == mHost.toInteger() ) {
+	if ( !solveHost() ) {
 		return Response();
 	}
 
 	if ( NULL == mConnection ) {
-		HttpConnection* connection = eeNew( HttpConnection, () );
-		TcpSocket* socket = NULL;
-
-		// If the http client is proxied and the end host use SSL
-		// We need to create an HTTP Tunnel against the proxy server
-		if ( isProxied() && mIsSSL && SSLSocket::isSupported() ) {
-			socket = SSLSocket::New( mHostName, request.getValidateCertificate(),
-									 request.getValidateHostname() );
+		HttpConnection* connection = acquireConnection();
 
-			connection->setSSL( true );
-		} else {
-			bool isSSL = !isProxied()
-							 ? mIsSSL
-							 : ( SSLSocket::isSupported() && mProxy.getScheme() == "https" );
-
-			socket = isSSL ? SSLSocket::New( mHostName, request.getValidateCertificate(),
-											 request.getValidateHostname() )
-						   : TcpSocket::New();
-
-			connection->setSSL( isSSL );
-		}
-
-		if ( timeout != Time::Zero ) {
-			socket->setReceiveTimeout( timeout );
-			socket->setSendTimeout( timeout );
-		}
-
-		connection->setSocket( socket );
-
-		mConnection = connection;
+		mConnection = NULL != connection ? connection : createConnection( request, timeout );
 	}
 
+	// Close the connection if it was idle for too long, the server probably closed it
+	if ( mConnection->isConnected() && mConnection->getIdleTime() >= mIdleTimeout )
+		mConnection->disconnect();
+
 	// First make sure that the request is valid -- add missing mandatory fields
-	Request toSend( prepareFields( request ) );
+	Request toSend( prepareFields( request, mConnection->isKeepAlive() ) );
 
 	// Prepare the response
 	Response received;
 
+	// A reused connection can be closed by the server at any moment
+	bool reused = mConnection->isConnected();
+
 	// If not connected, try to connect to the server
 	if ( !mConnection->isConnected() ) {
 		// We need to create an HTTP Tunnel?
@@ -867,7 +848,8 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 		}
 
 		if ( !requestStr.empty() ) {
-			Socket::Status status;
+			Socket::Status status = Socket::Error;
+			ResponseParser parser( received, writeTo, toSend.getMethod() == Request::Head );
 
 			// Send it through the socket
 			if ( mConnection->getSocket()->send( requestStr.c_str(), requestStr.size() ) ==
@@ -877,219 +859,89 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 				}
 
 				// Wait for the server's response
-				std::size_t currentTotalBytes = 0;
-				std::size_t len = 0;
 				std::size_t readed = 0;
-				char* eol = NULL; // end of line
-				char* bol = NULL; // beginning of line
-				char buffer[PACKET_BUFFER_SIZE + 1];
-				bool isnheader = false;
-				bool chunked = false;
-				bool compressed = false;
-				Uint64 contentLength = 0;
-				std::string headerBuffer;
-				HttpStreamChunked* chunkedStream = NULL;
-				IOStreamInflate* inflateStream = NULL;
-				IOStream* bufferStream = NULL;
+				char buffer[PACKET_BUFFER_SIZE];
 
-				while ( !request.isCancelled() &&
+				while ( !request.isCancelled() && !parser.isComplete() &&
 						( status = mConnection->getSocket()->receive( buffer, PACKET_BUFFER_SIZE,
 																	  readed ) ) == Socket::Done ) {
-					char* readBuffer = buffer;
-
-					// If we didn't receive the header yet, we will try to find the end of the
-					// header
-					if ( !isnheader ) {
-						// calculate combined length of unprocessed data and new data
-						len += readed;
-
-						// NULL terminate buffer for string functions
-						readBuffer[len] = '\0';
-
-						// process each line in buffer looking for header break
-						bol = readBuffer;
-
-						while ( !isnheader && ( eol = strchr( bol, '\n' ) ) != NULL ) {
-							// update bol based upon the value of eol
-							bol = eol + 1;
-
-							// test if end of headers has been reached
-							if ( 0 == strncmp( bol, "\r\n", 2 ) || 0 == strncmp( bol, "\n", 1 ) ) {
-								// note that end of headers has been reached
-								isnheader = true;
-
-								// update the value of bol to reflect the beginning of the line
-								// immediately after the headers
-								if ( bol[0] != '\n' )
-									bol += 1;
-
-								bol += 1;
-
-								// calculate the amount of data remaining in the buffer
-								len = readed - ( bol - readBuffer );
-
-								// Fill the header buffer
-								headerBuffer.append( readBuffer, ( bol - readBuffer ) );
-
-								if ( !headerBuffer.empty() ) {
-									// Build the Response object from the received data
-									received.parse( headerBuffer );
-
-									// Check if the response is chunked
-									chunked = received.getField( "transfer-encoding" ) == "chunked";
-
-									// Check if the content is compressed
-									std::string encoding( received.getField( "content-encoding" ) );
-									compressed = encoding == "gzip" || encoding == "deflate";
-
-									if ( compressed ) {
-										Compression::Mode compressionMode =
-											"gzip" == encoding ? Compression::MODE_GZIP
-															   : Compression::MODE_DEFLATE;
-
-										inflateStream =
-											IOStreamInflate::New( writeTo, compressionMode );
-									}
-
-									if ( chunked ) {
-										IOStream& writeToStream =
-											compressed ? *inflateStream : writeTo;
-										chunkedStream =
-											eeNew( HttpStreamChunked, ( writeToStream ) );
-									}
-
-									bufferStream = chunked
-													   ? chunkedStream
-													   : ( compressed ? inflateStream : &writeTo );
-
-									// Get the content length
-									if ( !received.getField( "content-length" ).empty() ) {
-										if ( !String::fromString(
-												 contentLength,
-												 received.getField( "content-length" ) ) )
-											contentLength = 0;
-									}
-
-									if ( received.getField( "connection" ) == "closed" ) {
-										mConnection->setConnected( false );
-										mConnection->setTunneled( false );
-									}
-
-									// If a redirection is requested, and requests follows
-									// redirections, send a new request to the redirection location.
-									if ( ( received.getStatus() == Response::MovedPermanently ||
-										   received.getStatus() == Response::MovedTemporarily ) &&
-										 request.getFollowRedirect() ) {
-
-										// Only continue redirecting if less than 10 redirections
-										// were done
-										if ( request.mRedirectionCount <
-											 request.getMaxRedirects() ) {
-											std::string location( received.getField( "location" ) );
-											URI uri( location );
-
-											// Close the connection
-											if ( !mConnection->isKeepAlive() )
-												mConnection->disconnect();
-
-											eeSAFE_DELETE( chunkedStream );
-											eeSAFE_DELETE( inflateStream );
-
-											Http::Request newRequest( request );
-											newRequest.setUri( uri.getPathAndQuery() );
-
-											request.mRedirectionCount++;
-											newRequest.mRedirectionCount =
-												request.mRedirectionCount;
-
-											// Same host, expects a path in the same domain
-											if ( uri.getHost().empty() ||
-												 uri.getHost() == getHost() ) {
-												return downloadRequest( newRequest, writeTo,
-																		timeout );
-											} else {
-												// New host, we need to solve the host
-												Http http( uri.getHost(), uri.getPort(),
-														   uri.getScheme() == "https" ? true
-																					  : false );
-												return http.downloadRequest( newRequest, writeTo,
-																			 timeout );
-											}
-										}
-									}
-
-									if ( !sendProgress( *this, request, received,
-														Request::HeaderReceived, contentLength,
-														0 ) ) {
-										request.mCancel = true;
-									}
-
-									// Move the readBuffer to the starting point
-									// of the file buffer
-									if ( len > 0 ) {
-										readBuffer = bol;
-										readed = len;
-									} else {
-										readed = 0;
-									}
-
-									headerBuffer.clear();
-								}
+					std::size_t consumed = 0;
+
+					if ( !parser.isHeaderReceived() ) {
+						consumed = parser.parse( buffer, readed );
+
+						if ( !parser.isHeaderReceived() )
+							continue;
+
+						// If a redirection is requested, and requests follows redirections, send a
+						// new request to the redirection location.
+						if ( ( received.getStatus() == Response::MovedPermanently ||
+							   received.getStatus() == Response::MovedTemporarily ) &&
+							 request.getFollowRedirect() &&
+							 request.mRedirectionCount < request.getMaxRedirects() ) {
+							std::string location( received.getField( "location" ) );
+							URI uri( location );
+
+							// The body of the redirection is not read, so the connection can't
+							// be reused
+							mConnection->disconnect();
+
+							Http::Request newRequest( request );
+							newRequest.setUri( uri.getPathAndQuery() );
+
+							request.mRedirectionCount++;
+							newRequest.mRedirectionCount = request.mRedirectionCount;
+
+							// Same host, expects a path in the same domain
+							if ( uri.getHost().empty() || uri.getHost() == getHost() ) {
+								return downloadRequest( newRequest, writeTo, timeout );
+							} else {
+								// New host, we need to solve the host
+								Http http( uri.getHost(), uri.getPort(),
+										   uri.getScheme() == "https" ? true : false );
+								return http.downloadRequest( newRequest, writeTo, timeout );
 							}
 						}
 
-						if ( !isnheader ) {
-							headerBuffer.append( readBuffer, ( bol - readBuffer ) );
-						}
-					}
-
-					if ( isnheader ) {
-						currentTotalBytes += readed;
-
-						if ( readed > 0 )
-							bufferStream->write( readBuffer, readed );
-
-						if ( !sendProgress( *this, request, received, Request::ContentReceived,
-											contentLength, currentTotalBytes ) ) {
+						if ( !sendProgress( *this, request, received, Request::HeaderReceived,
+											parser.getContentLength(), 0 ) ) {
 							request.mCancel = true;
 							break;
 						}
-
-						// If the response is compressed and the stream ended means that we received
-						// the message. So we can skip the socket receive call.
-						if ( ( compressed && NULL != inflateStream && !inflateStream->isOpen() ) ||
-							 ( contentLength > 0 && contentLength == currentTotalBytes ) ) {
-							break;
-						}
 					}
-				}
 
-				if ( chunked && NULL != chunkedStream &&
-					 !chunkedStream->getHeaderBuffer().empty() ) {
-					headerBuffer.append( chunkedStream->getHeaderBuffer() );
-				}
+					if ( consumed < readed )
+						parser.parse( buffer + consumed, readed - consumed );
 
-				if ( !headerBuffer.empty() ) {
-					std::istringstream in( headerBuffer );
-					received.parseFields( in );
+					if ( !sendProgress( *this, request, received, Request::ContentReceived,
+										parser.getContentLength(), parser.getBodyReceived() ) ) {
+						request.mCancel = true;
+						break;
+					}
 				}
 
-				if ( status == Socket::Status::Disconnected ) {
-					mConnection->setConnected( false );
-					mConnection->setTunneled( false );
-				}
+				if ( status == Socket::Disconnected || status == Socket::Error )
+					parser.close();
+			}
 
-				eeSAFE_DELETE( chunkedStream );
-				eeSAFE_DELETE( inflateStream );
-			} else {
-				mConnection->setConnected( false );
-				mConnection->setTunneled( false );
+			// The server closed the reused connection before answering, retry with a new one.
+			// The server might have processed the request, so only if it's safe to repeat it.
+			if ( reused && !parser.hasData() && status != Socket::NotReady &&
+				 !request.isCancelled() && request.isIdempotent() ) {
+				mConnection->disconnect();
+				return downloadRequest( request, writeTo, timeout );
 			}
+
+			// The connection is reusable only if the complete response was read
+			if ( !parser.isComplete() || !parser.isKeepAlive() )
+				mConnection->disconnect();
 		}
 
 		// Close the connection
 		if ( !mConnection->isKeepAlive() )
 			mConnection->disconnect();
+		else
+			mConnection->resetIdleTime();
 	}
 
 	return received;
@@ -1153,9 +1005,8 @@ void Http::AsyncRequest::run() {
 		eeSAFE_DELETE( mStream );
 	}
 
-	// The Async Request destroys the socket used to create the request
-	HttpConnection* connection = mHttp->mConnection;
-	eeSAFE_DELETE( connection );
+	// The connection goes back to the client, the thread could not be used again by it
+	mHttp->releaseConnection( mHttp->mConnection );
 	mHttp->mConnection = NULL;
 
 	mRunning = false;
@@ -1183,7 +1034,7 @@ void Http::removeOldThreads() {
 	}
 }
 
-Http::Request Http::prepareFields( const Http::Request& request ) {
+Http::Request Http::prepareFields( const Http::Request& request, bool keepAlive ) {
 	Request toSend( request );
 
 	if ( !toSend.hasField( "User-Agent" ) )
@@ -1207,7 +1058,7 @@ Http::Request Http::prepareFields( const Http::Request& request ) {
 		toSend.setField( "Content-Type", "application/x-www-form-urlencoded" );
 
 	if ( ( toSend.mMajorVersion * 10 + toSend.mMinorVersion >= 11 ) &&
-		 !toSend.hasField( "Connection" ) && ( !mConnection || !mConnection->isKeepAlive() ) ) {
+		 !toSend.hasField( "Connection" ) && !keepAlive ) {
 		toSend.setField( "Connection", "close" );
 	}
 
@@ -1239,6 +1090,135 @@ bool Http::isProxied() const {
 	return !mProxy.empty();
 }
 
+void Http::setMaxConnections( const size_t& maxConnections ) {
+	mMaxConnections = eemax<size_t>( maxConnections, 1 );
+}
+
+const size_t& Http::getMaxConnections() const {
+	return mMaxConnections;
+}
+
+void Http::setIdleTimeout( const Time& idleTimeout ) {
+	mIdleTimeout = idleTimeout;
+
+	if ( mIdleTimeout == Time::Zero )
+		clearIdleConnections();
+}
+
+const Time& Http::getIdleTimeout() const {
+	return mIdleTimeout;
+}
+
+void Http::setPipeliningDepth( const size_t& depth ) {
+	mPipeliningDepth = eemax<size_t>( depth, 1 );
+}
+
+const size_t& Http::getPipeliningDepth() const {
+	return mPipeliningDepth;
+}
+
+bool Http::solveHost() {
+	if ( !mHostSolved ) {
+		if ( !mProxy.empty() ) {
+			mHost = IpAddress( mProxy.getHost() );
+		} else {
+			mHost = IpAddress( mHostName );
+		}
+		mHostSolved = true;
+	}
+
+	return 0 != mHost.toInteger();
+}
+
+Http::HttpConnection* Http::createConnection( const Http::Request& request, const Time& timeout ) {
+	HttpConnection* connection = eeNew( HttpConnection, () );
+	TcpSocket* socket = NULL;
+
+	// If the http client is proxied and the end host use SSL
+	// We need to create an HTTP Tunnel against the proxy server
+	if ( isProxied() && mIsSSL && SSLSocket::isSupported() ) {
+		socket = SSLSocket::New( mHostName, request.getValidateCertificate(),
+								 request.getValidateHostname() );
+
+		connection->setSSL( true );
+	} else {
+		bool isSSL = !isProxied() ? mIsSSL
+								  : ( SSLSocket::isSupported() && mProxy.getScheme() == "https" );
+
+		socket = isSSL ? SSLSocket::New( mHostName, request.getValidateCertificate(),
+										 request.getValidateHostname() )
+					   : TcpSocket::New();
+
+		connection->setSSL( isSSL );
+	}
+
+	if ( timeout != Time::Zero ) {
+		socket->setReceiveTimeout( timeout );
+		socket->setSendTimeout( timeout );
+	}
+
+	connection->setSocket( socket );
+	connection->setKeepAlive( mIdleTimeout != Time::Zero );
+
+	return connection;
+}
+
+Http::HttpConnection* Http::acquireConnection() {
+	Lock l( mIdleConnectionsMutex );
+
+	while ( !mIdleConnections.empty() ) {
+		HttpConnection* connection = mIdleConnections.back();
+		mIdleConnections.pop_back();
+
+		if ( connection->isConnected() && connection->getIdleTime() < mIdleTimeout )
+			return connection;
+
+		eeDelete( connection );
+	}
+
+	return NULL;
+}
+
+void Http::releaseConnection( HttpConnection* connection ) {
+	if ( NULL == connection )
+		return;
+
+	Lock l( mIdleConnectionsMutex );
+
+	if ( connection->isConnected() && connection->isKeepAlive() && mIdleTimeout != Time::Zero &&
+		 mIdleConnections.size() < mMaxConnections ) {
+		connection->resetIdleTime();
+		mIdleConnections.push_back( connection );
+	} else {
+		eeDelete( connection );
+	}
+}
+
+void Http::clearIdleConnections() {
+	Lock l( mIdleConnectionsMutex );
+
+	for ( HttpConnection* connection : mIdleConnections )
+		eeDelete( connection );
+
+	mIdleConnections.clear();
+}
+
+bool Http::isAsyncExecutorRequest( const Http::Request& request ) const {
+	// SSL sockets do their own buffering and handshakes, so they keep using a thread per request
+	return !mIsSSL && !( isProxied() && mProxy.getScheme() == "https" ) && !request.isContinue();
+}
+
+Http::AsyncExecutor* Http::getAsyncExecutor() {
+	Lock l( mAsyncExecutorMutex );
+
+	if ( NULL == mAsyncExecutor ) {
+		mAsyncExecutor = eeNew( AsyncExecutor, ( this ) );
+		mAsyncExecutor->launch();
+	}
+
+	return mAsyncExecutor;
+}
+
 #if EE_PLATFORM == EE_PLATFORM_EMSCRIPTEN
 struct WGetAsyncRequest {
 	Http* http;
@@ -1309,6 +1289,11 @@ void Http::sendAsyncRequest( const Http::AsyncResponseCallback& cb, const Http::
 								 emscripten_async_wget2_got_data,
 								 emscripten_async_wget2_got_error_data, NULL );
 #else
+	if ( isAsyncExecutorRequest( request ) ) {
+		getAsyncExecutor()->push( cb, request, timeout );
+		return;
+	}
+
 	if ( sGlobalThreadPool ) {
 		sGlobalThreadPool->run( [this, cb, request, timeout] {
 			AsyncRequest asyncRequest( this, cb, request, timeout );
@@ -1338,6 +1323,11 @@ void Http::downloadAsyncRequest( const Http::AsyncResponseCallback& cb,
 								 emscripten_async_wget2_got_data,
 								 emscripten_async_wget2_got_error_data, NULL );
 #else
+	if ( isAsyncExecutorRequest( request ) ) {
+		getAsyncExecutor()->push( cb, request, timeout, &writeTo );
+		return;
+	}
+
 	if ( sGlobalThreadPool ) {
 		sGlobalThreadPool->run( [this, cb, request, &writeTo, timeout] {
 			AsyncRequest asyncRequest( this, cb, request, writeTo, timeout );
@@ -1367,6 +1357,11 @@ void Http::downloadAsyncRequest( const Http::AsyncResponseCallback& cb,
 							emscripten_async_wget2_got_file, emscripten_async_wget2_got_error_file,
 							NULL );
 #else
+	if ( isAsyncExecutorRequest( request ) ) {
+		getAsyncExecutor()->push( cb, request, timeout, NULL, writePath );
+		return;
+	}
+
 	if ( sGlobalThreadPool ) {
 		sGlobalThreadPool->run( [this, cb, request, writePath, timeout] {
 			AsyncRequest asyncRequest( this, cb, request, writePath, timeout );
@@ -1411,7 +1406,11 @@ Http::HttpConnection::HttpConnection() :
 	mIsKeepAlive( false ) {}
 
 Http::HttpConnection::HttpConnection( TcpSocket* socket ) :
-	mSocket( socket ), mIsConnected( false ), mIsTunneled( false ), mIsSSL( false ) {}
+	mSocket( socket ),
+	mIsConnected( false ),
+	mIsTunneled( false ),
+	mIsSSL( false ),
+	mIsKeepAlive( false ) {}
 
 Http::HttpConnection::~HttpConnection() {
 	eeSAFE_DELETE( mSocket );
@@ -1430,6 +1429,7 @@ void Http::HttpConnection::disconnect() {
 		mSocket->disconnect();
 
 	mIsConnected = false;
+	mIsTunneled = false;
 }
 
 const bool& Http::HttpConnection::isConnected() const {
@@ -1464,6 +1464,14 @@ void Http::HttpConnection::setKeepAlive( const bool& isKeepAlive ) {
 	mIsKeepAlive = isKeepAlive;
 }
 
+Time Http::HttpConnection::getIdleTime() const {
+	return mIdleClock.getElapsedTime();
+}
+
+void Http::HttpConnection::resetIdleTime() {
+	mIdleClock.restart();
+}
+
 Http::Pool& Http::Pool::getGlobal() {
 	return sGlobalHttpPool;
 }
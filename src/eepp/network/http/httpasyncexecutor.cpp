@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <eepp/network/http/httpasyncexecutor.hpp>
+#include <eepp/network/http/httpresponseparser.hpp>
+#include <eepp/system/iostreamfile.hpp>
+#include <iostream>
+
+namespace EE { namespace Network {
+
+#define ASYNC_BUFFER_SIZE ( 16384 )
+
+static bool canPipeline( const Http::Request& request ) {
+	return request.getMethod() == Http::Request::Get || request.getMethod() == Http::Request::Head;
+}
+
+Http::AsyncExecutor::AsyncExecutor( Http* http ) : mHttp( http ), mBuffer( ASYNC_BUFFER_SIZE ) {
+	// A datagram sent to itself wakes up the loop when new requests arrive
+	if ( mWakeUp.bind( Socket::AnyPort, IpAddress::LocalHost ) == Socket::Done ) {
+		mWakeUp.setBlocking( false );
+		mSelector.add( mWakeUp );
+		mHasWakeUp = true;
+	}
+}
+
+Http::AsyncExecutor::~AsyncExecutor() {
+	mStop = true;
+	wakeUp();
+	wait();
+}
+
+void Http::AsyncExecutor::push( const AsyncResponseCallback& cb, const Http::Request& request,
+								const Time& timeout, IOStream* writeTo,
+								const std::string& writePath ) {
+	Task* task = eeNew( Task, () );
+	task->cb = cb;
+	task->request = request;
+	task->timeout = timeout;
+
+	if ( !writePath.empty() ) {
+		task->stream = IOStreamFile::New( writePath, "wb" );
+		task->streamOwned = true;
+		task->writePath = writePath;
+	} else {
+		task->stream = writeTo;
+	}
+
+	{
+		Lock l( mMutex );
+		mIncoming.push_back( task );
+	}
+
+	wakeUp();
+}
+
+void Http::AsyncExecutor::wakeUp() {
+	if ( mHasWakeUp && !mWakeUpSent.exchange( true ) ) {
+		char data = 0;
+		mWakeUp.send( &data, 1, IpAddress::LocalHost, mWakeUp.getLocalPort() );
+	}
+}
+
+void Http::AsyncExecutor::run() {
+	while ( true ) {
+		{
+			Lock l( mMutex );
+			mPending.insert( mPending.end(), mIncoming.begin(), mIncoming.end() );
+			mIncoming.clear();
+		}
+
+		dispatch();
+
+		releaseIdleConnections();
+
+		if ( mStop && mPending.empty() && mConnections.empty() )
+			break;
+
+		Time timeout = getWaitTimeout();
+
+		// Without the wake up socket the new requests are polled
+		if ( !mHasWakeUp && ( timeout == Time::Zero || timeout > Milliseconds( 10 ) ) )
+			timeout = Milliseconds( 10 );
+
+		if ( mSelector.wait( timeout ) ) {
+			// Closing a connection modifies the selector ready sockets
+			std::vector<Socket*> readySockets( mSelector.getReadySockets() );
+
+			for ( Socket* socket : readySockets ) {
+				if ( socket == &mWakeUp ) {
+					char data[64];
+					std::size_t received;
+					IpAddress address;
+					unsigned short port;
+					mWakeUpSent = false;
+
+					while ( mWakeUp.receive( data, sizeof( data ), received, address, port ) ==
+							Socket::Done ) {
+					}
+					continue;
+				}
+
+				auto found = std::find_if(
+					mConnections.begin(), mConnections.end(),
+					[socket]( Connection* c ) { return c->connection->getSocket() == socket; } );
+
+				if ( found != mConnections.end() )
+					receive( *found );
+			}
+		}
+
+		checkTimeouts();
+	}
+}
+
+void Http::AsyncExecutor::dispatch() {
+	while ( !mPending.empty() ) {
+		Task* task = mPending.front();
+		Connection* target = NULL;
+
+		for ( Connection* connection : mConnections ) {
+			if ( connection->tasks.empty() ) {
+				target = connection;
+				break;
+			}
+		}
+
+		if ( NULL == target && mConnections.size() < mHttp->getMaxConnections() ) {
+			target = openConnection( task );
+
+			if ( NULL == target ) {
+				mPending.pop_front();
+				finish( task );
+				continue;
+			}
+		}
+
+		// Pipeline the request through the less busy connection
+		if ( NULL == target && mHttp->getPipeliningDepth() > 1 && canPipeline( task->request ) ) {
+			for ( Connection* connection : mConnections ) {
+				if ( connection->keptAlive &&
+					 connection->tasks.size() < mHttp->getPipeliningDepth() &&
+					 ( NULL == target || connection->tasks.size() < target->tasks.size() ) &&
+					 std::all_of( connection->tasks.begin(), connection->tasks.end(),
+								  []( Task* task ) { return canPipeline( task->request ); } ) ) {
+					target = connection;
+				}
+			}
+		}
+
+		if ( NULL == target )
+			break;
+
+		mPending.pop_front();
+		send( target, task );
+	}
+}
+
+Http::AsyncExecutor::Connection* Http::AsyncExecutor::openConnection( Task* task ) {
+	if ( !mHttp->solveHost() )
+		return NULL;
+
+	HttpConnection* httpConnection = mHttp->acquireConnection();
+	bool keptAlive = NULL != httpConnection;
+
+	if ( NULL == httpConnection ) {
+		httpConnection = mHttp->createConnection( task->request, task->timeout );
+
+		// The connection is blocking, the responses are the ones read without blocking the loop
+		if ( httpConnection->getSocket()->connect(
+				 mHttp->mHost, mHttp->isProxied() ? mHttp->mProxy.getPort() : mHttp->mPort,
+				 task->timeout ) != Socket::Done ) {
+			eeDelete( httpConnection );
+			return NULL;
+		}
+
+		httpConnection->setConnected( true );
+		progress( task, Request::Connected, 0, 0 );
+	}
+
+	Connection* connection = eeNew( Connection, () );
+	connection->connection = httpConnection;
+	connection->keptAlive = keptAlive;
+	mConnections.push_back( connection );
+	mSelector.add( *httpConnection->getSocket() );
+	return connection;
+}
+
+void Http::AsyncExecutor::send( Connection* connection, Task* task ) {
+	if ( task->request.isCancelled() ) {
+		finish( task );
+		return;
+	}
+
+	Request toSend( mHttp->prepareFields( task->request, connection->connection->isKeepAlive() ) );
+	std::string requestStr = toSend.prepare( *mHttp );
+
+	if ( task->request.isVerbose() ) {
+		std::cout << "Request:" << std::endl;
+		std::cout << requestStr << std::endl;
+	}
+
+	task->response = Response();
+	task->body.clear();
+	IOStream& writeTo = NULL != task->stream ? *task->stream : task->body;
+	task->parser = eeNew( ResponseParser, ( task->response, writeTo,
+											task->request.getMethod() == Request::Head ) );
+	task->clock.restart();
+	connection->tasks.push_back( task );
+
+	if ( connection->connection->getSocket()->send( requestStr.c_str(), requestStr.size() ) !=
+		 Socket::Done ) {
+		closeConnection( connection );
+		return;
+	}
+
+	progress( task, Request::Sent, 0, 0 );
+
+	if ( task->request.isCancelled() && connection->tasks.front() == task )
+		cancel( connection );
+}
+
+void Http::AsyncExecutor::receive( Connection* connection ) {
+	std::size_t received = 0;
+
+	if ( connection->connection->getSocket()->receive( mBuffer.data(), mBuffer.size(),
+													   received ) != Socket::Done ) {
+		closeConnection( connection );
+		return;
+	}
+
+	const char* data = mBuffer.data();
+
+	while ( received > 0 ) {
+		// Data that does not belong to any request, the connection state is unknown
+		if ( connection->tasks.empty() ) {
+			closeConnection( connection );
+			return;
+		}
+
+		Task* task = connection->tasks.front();
+		ResponseParser* parser = task->parser;
+		bool hadHeader = parser->isHeaderReceived();
+		std::size_t consumed = parser->parse( data, received );
+		data += consumed;
+		received -= consumed;
+		task->clock.restart();
+
+		if ( !hadHeader && parser->isHeaderReceived() ) {
+			if ( redirect( connection, task ) )
+				return;
+
+			progress( task, Request::HeaderReceived, parser->getContentLength(), 0 );
+		} else if ( hadHeader ) {
+			progress( task, Request::ContentReceived, parser->getContentLength(),
+					  parser->getBodyReceived() );
+		}
+
+		if ( task->request.isCancelled() ) {
+			cancel( connection );
+			return;
+		}
+
+		if ( parser->isComplete() ) {
+			bool keepAlive = parser->isKeepAlive();
+			connection->tasks.pop_front();
+			finish( task );
+
+			if ( !keepAlive ) {
+				closeConnection( connection );
+				return;
+			}
+
+			connection->keptAlive = true;
+			connection->connection->resetIdleTime();
+		}
+	}
+}
+
+bool Http::AsyncExecutor::redirect( Connection* connection, Task* task ) {
+	Http::Request& request = task->request;
+	Http::Response::Status status = task->response.getStatus();
+
+	if ( ( status != Response::MovedPermanently && status != Response::MovedTemporarily ) ||
+		 !request.getFollowRedirect() || request.mRedirectionCount >= request.getMaxRedirects() )
+		return false;
+
+	URI uri( task->response.getField( "location" ) );
+	request.setUri( uri.getPathAndQuery() );
+	request.mRedirectionCount++;
+	connection->tasks.pop_front();
+	eeSAFE_DELETE( task->parser );
+
+	// Same host, expects a path in the same domain
+	if ( uri.getHost().empty() || uri.getHost() == mHttp->getHostName() ) {
+		mPending.push_front( task );
+	} else {
+		// New host, the request continues in its client
+		Http* http = Http::Pool::getGlobal().get( uri, mHttp->getProxy() );
+
+		if ( task->streamOwned ) {
+			eeSAFE_DELETE( task->stream );
+			http->downloadAsyncRequest( task->cb, request, task->writePath, task->timeout );
+		} else if ( NULL != task->stream ) {
+			http->downloadAsyncRequest( task->cb, request, *task->stream, task->timeout );
+		} else {
+			http->sendAsyncRequest( task->cb, request, task->timeout );
+		}
+
+		eeDelete( task );
+	}
+
+	// The body of the redirection is not read, so the connection can't be reused
+	closeConnection( connection );
+	return true;
+}
+
+void Http::AsyncExecutor::cancel( Connection* connection ) {
+	Task* task = connection->tasks.front();
+	connection->tasks.pop_front();
+	finish( task );
+	closeConnection( connection );
+}
+
+void Http::AsyncExecutor::closeConnection( Connection* connection ) {
+	mSelector.remove( *connection->connection->getSocket() );
+
+	// The response delimited by the connection close is complete now
+	if ( !connection->tasks.empty() ) {
+		Task* task = connection->tasks.front();
+		task->parser->close();
+
+		if ( task->parser->isComplete() ) {
+			connection->tasks.pop_front();
+			finish( task );
+		}
+	}
+
+	// The requests without any response are sent again once, if it's safe to do it. The server
+	// might have processed them, even through a reused connection, so only the idempotent ones.
+	for ( auto it = connection->tasks.rbegin(); it != connection->tasks.rend(); ++it ) {
+		Task* task = *it;
+
+		if ( !task->retried && !task->parser->hasData() && !task->request.isCancelled() &&
+			 task->request.isIdempotent() ) {
+			task->retried = true;
+			eeSAFE_DELETE( task->parser );
+			mPending.push_front( task );
+		} else {
+			finish( task );
+		}
+	}
+
+	connection->tasks.clear();
+	mConnections.erase( std::find( mConnections.begin(), mConnections.end(), connection ) );
+	eeDelete( connection->connection );
+	eeDelete( connection );
+}
+
+void Http::AsyncExecutor::releaseIdleConnections() {
+	if ( !mPending.empty() )
+		return;
+
+	for ( std::size_t i = 0; i < mConnections.size(); ) {
+		Connection* connection = mConnections[i];
+
+		if ( connection->tasks.empty() ) {
+			mSelector.remove( *connection->connection->getSocket() );
+			mConnections.erase( mConnections.begin() + i );
+			mHttp->releaseConnection( connection->connection );
+			eeDelete( connection );
+		} else {
+			i++;
+		}
+	}
+}
+
+void Http::AsyncExecutor::checkTimeouts() {
+	for ( std::size_t i = 0; i < mConnections.size(); ) {
+		Connection* connection = mConnections[i];
+		Task* task = !connection->tasks.empty() ? connection->tasks.front() : NULL;
+
+		if ( NULL != task && task->timeout != Time::Zero &&
+			 task->clock.getElapsedTime() >= task->timeout ) {
+			// The request timed out, so it's not sent again
+			task->retried = true;
+			closeConnection( connection );
+		} else {
+			i++;
+		}
+	}
+}
+
+Time Http::AsyncExecutor::getWaitTimeout() const {
+	Time timeout = Time::Zero;
+
+	for ( Connection* connection : mConnections ) {
+		if ( connection->tasks.empty() || connection->tasks.front()->timeout == Time::Zero )
+			continue;
+
+		Task* task = connection->tasks.front();
+		Time remaining = eemax( task->timeout - task->clock.getElapsedTime(), Milliseconds( 1 ) );
+
+		if ( timeout == Time::Zero || remaining < timeout )
+			timeout = remaining;
+	}
+
+	return timeout;
+}
+
+void Http::AsyncExecutor::progress( Task* task, const Http::Request::Status& status,
+									const Uint64& totalBytes, const Uint64& currentBytes ) {
+	const Request::ProgressCallback& cb = task->request.getProgressCallback();
+
+	if ( cb && !cb( *mHttp, task->request, task->response, status, totalBytes, currentBytes ) )
+		task->request.mCancel = true;
+}
+
+void Http::AsyncExecutor::finish( Task* task ) {
+	eeSAFE_DELETE( task->parser );
+
+	if ( NULL == task->stream )
+		task->response.mBody = task->body.getStream();
+
+	task->cb( *mHttp, task->request, task->response );
+
+	if ( task->streamOwned )
+		eeSAFE_DELETE( task->stream );
+
+	eeDelete( task );
+}
+
+}} // namespace EE::Network
@@ -0,0 +1,97 @@
+#ifndef EE_NETWORK_HTTPASYNCEXECUTOR_HPP
+#define EE_NETWORK_HTTPASYNCEXECUTOR_HPP
+
+#include <atomic>
+#include <deque>
+#include <eepp/network/http.hpp>
+#include <eepp/network/socketselector.hpp>
+#include <eepp/network/udpsocket.hpp>
+#include <eepp/system/iostreamstring.hpp>
+
+namespace EE { namespace Network {
+
+/** Event loop that runs the async requests of a plain HTTP client in a single thread.
+ * The requests are queued and dispatched over a limited number of keep-alive connections, and the
+ * responses of all the connections are read as they arrive, waiting on a SocketSelector. */
+class Http::AsyncExecutor : public Thread {
+  public:
+	explicit AsyncExecutor( Http* http );
+
+	/** Waits until all the queued requests are finished */
+	~AsyncExecutor();
+
+	/** Queues the request. The response is written to writeTo or to writePath if provided,
+	 * otherwise to the response body. */
+	void push( const AsyncResponseCallback& cb, const Http::Request& request, const Time& timeout,
+			   IOStream* writeTo = NULL, const std::string& writePath = "" );
+
+  protected:
+	struct Task {
+		AsyncResponseCallback cb;
+		Http::Request request;
+		Time timeout;
+		Clock clock; ///< Time since the last activity of the request
+		IOStream* stream{ NULL };
+		bool streamOwned{ false };
+		std::string writePath;
+		IOStreamString body;
+		Http::Response response;
+		ResponseParser* parser{ NULL };
+		bool retried{ false };
+	};
+
+	struct Connection {
+		HttpConnection* connection{ NULL };
+		std::deque<Task*> tasks; ///< Requests sent waiting for their response, in order
+		bool keptAlive{ false }; ///< The server already kept the connection alive
+	};
+
+	Http* mHttp;
+	Mutex mMutex;
+	std::vector<Task*> mIncoming;
+	std::deque<Task*> mPending;
+	std::vector<Connection*> mConnections;
+	SocketSelector mSelector;
+	UdpSocket mWakeUp;
+	bool mHasWakeUp{ false };
+	std::atomic<bool> mWakeUpSent{ false };
+	std::atomic<bool> mStop{ false };
+	std::vector<char> mBuffer;
+
+	virtual void run();
+
+	void wakeUp();
+
+	void dispatch();
+
+	Connection* openConnection( Task* task );
+
+	void send( Connection* connection, Task* task );
+
+	void receive( Connection* connection );
+
+	bool redirect( Connection* connection, Task* task );
+
+	/** Finishes the first request of the connection and closes it */
+	void cancel( Connection* connection );
+
+	/** Closes the connection, the requests without response are queued again */
+	void closeConnection( Connection* connection );
+
+	/** Returns the unused connections to the client, so any request can reuse them */
+	void releaseIdleConnections();
+
+	void checkTimeouts();
+
+	/** @return The time until the next request timeout, Time::Zero if none */
+	Time getWaitTimeout() const;
+
+	void progress( Task* task, const Http::Request::Status& status, const Uint64& totalBytes,
+				   const Uint64& currentBytes );
+
+	void finish( Task* task );
+};
+
+}} // namespace EE::Network
+
+#endif // EE_NETWORK_HTTPASYNCEXECUTOR_HPP
@@ -0,0 +1,246 @@
+#include <eepp/network/http/httpresponseparser.hpp>
+#include <eepp/system/iostreaminflate.hpp>
+#include <sstream>
+
+namespace EE { namespace Network {
+
+Http::ResponseParser::ResponseParser( Http::Response& response, IOStream& writeTo,
+									  bool isHeadRequest ) :
+	mResponse( response ),
+	mWriteTo( writeTo ),
+	mStream( &writeTo ),
+	mIsHeadRequest( isHeadRequest ) {}
+
+Http::ResponseParser::~ResponseParser() {
+	eeSAFE_DELETE( mInflate );
+}
+
+std::size_t Http::ResponseParser::parse( const char* data, std::size_t size ) {
+	std::size_t consumed = 0;
+
+	if ( size > 0 )
+		mHasData = true;
+
+	while ( consumed < size && mState != State::Complete ) {
+		const char* cur = data + consumed;
+		std::size_t left = size - consumed;
+		std::size_t read = 0;
+
+		switch ( mState ) {
+			case State::Header: {
+				consumed += parseHeader( cur, left );
+
+				// Informational responses are skipped, the final response header follows them
+				if ( mState != State::Header )
+					return consumed;
+
+				continue;
+			}
+			case State::Body: {
+				read = mHasContentLength
+						   ? static_cast<std::size_t>( eemin<Uint64>( left, mRemaining ) )
+						   : left;
+				mStream->write( cur, read );
+
+				if ( mHasContentLength ) {
+					mRemaining -= read;
+
+					if ( 0 == mRemaining )
+						complete();
+				}
+				break;
+			}
+			case State::ChunkSize: {
+				if ( readLine( cur, left, read ) ) {
+					std::string length( String::trim( String::trim(
+						mBuffer.substr( 0, mBuffer.find_first_of( ";\r\n" ) ) ), '\t' ) );
+					mBuffer.clear();
+
+					if ( !String::fromString( mRemaining, length, 16 ) ) {
+						mKeepAlive = false;
+						complete();
+					} else {
+						mState = 0 == mRemaining ? State::Trailer : State::ChunkData;
+					}
+				}
+				break;
+			}
+			case State::ChunkData: {
+				read = static_cast<std::size_t>( eemin<Uint64>( left, mRemaining ) );
+				mStream->write( cur, read );
+				mRemaining -= read;
+
+				if ( 0 == mRemaining )
+					mState = State::ChunkDataEnd;
+				break;
+			}
+			case State::ChunkDataEnd: {
+				if ( readLine( cur, left, read ) ) {
+					mBuffer.clear();
+					mState = State::ChunkSize;
+				}
+				break;
+			}
+			case State::Trailer: {
+				if ( readLine( cur, left, read ) ) {
+					if ( mBuffer == "\r\n" || mBuffer == "\n" ) {
+						if ( !mTrailer.empty() ) {
+							std::istringstream in( mTrailer );
+							mResponse.parseFields( in );
+						}
+
+						complete();
+					} else {
+						mTrailer += mBuffer;
+					}
+
+					mBuffer.clear();
+				}
+				break;
+			}
+			case State::Complete:
+				break;
+		}
+
+		consumed += read;
+		mBodyReceived += read;
+	}
+
+	return consumed;
+}
+
+void Http::ResponseParser::close() {
+	if ( State::Body == mState && !mHasContentLength ) {
+		complete();
+	} else if ( State::Complete != mState ) {
+		mKeepAlive = false;
+		eeSAFE_DELETE( mInflate );
+	}
+}
+
+bool Http::ResponseParser::isHeaderReceived() const {
+	return State::Header != mState;
+}
+
+bool Http::ResponseParser::isComplete() const {
+	return State::Complete == mState;
+}
+
+bool Http::ResponseParser::isKeepAlive() const {
+	return mKeepAlive;
+}
+
+bool Http::ResponseParser::hasData() const {
+	return mHasData;
+}
+
+const Uint64& Http::ResponseParser::getContentLength() const {
+	return mContentLength;
+}
+
+const Uint64& Http::ResponseParser::getBodyReceived() const {
+	return mBodyReceived;
+}
+
+std::size_t Http::ResponseParser::parseHeader( const char* data, std::size_t size ) {
+	std::size_t prevSize = mBuffer.size();
+	std::size_t pos = prevSize >= 2 ? prevSize - 2 : 0;
+	std::size_t end = std::string::npos;
+
+	mBuffer.append( data, size );
+
+	// The header ends with an empty line
+	while ( ( pos = mBuffer.find( '\n', pos ) ) != std::string::npos ) {
+		if ( pos + 1 < mBuffer.size() && mBuffer[pos + 1] == '\n' ) {
+			end = pos + 2;
+			break;
+		}
+
+		if ( pos + 2 < mBuffer.size() && mBuffer[pos + 1] == '\r' && mBuffer[pos + 2] == '\n' ) {
+			end = pos + 3;
+			break;
+		}
+
+		pos++;
+	}
+
+	if ( std::string::npos == end )
+		return size;
+
+	mBuffer.resize( end );
+	onHeader();
+	return end - prevSize;
+}
+
+bool Http::ResponseParser::readLine( const char* data, std::size_t size, std::size_t& consumed ) {
+	const char* eol = static_cast<const char*>( memchr( data, '\n', size ) );
+	consumed = NULL != eol ? eol - data + 1 : size;
+	mBuffer.append( data, consumed );
+	return NULL != eol;
+}
+
+void Http::ResponseParser::onHeader() {
+	mResponse.parse( mBuffer );
+	mBuffer.clear();
+
+	Response::Status status = mResponse.getStatus();
+
+	if ( Response::InvalidResponse == status ) {
+		complete();
+		return;
+	}
+
+	int code = static_cast<int>( status );
+
+	if ( code >= 100 && code < 200 && code != 101 )
+		return;
+
+	std::string connection( String::toLower( mResponse.getField( "connection" ) ) );
+
+	if ( mResponse.getMajorHttpVersion() * 10 + mResponse.getMinorHttpVersion() >= 11 ) {
+		mKeepAlive = connection != "close";
+	} else {
+		mKeepAlive = connection == "keep-alive";
+	}
+
+	std::string encoding( String::toLower( mResponse.getField( "content-encoding" ) ) );
+
+	if ( encoding == "gzip" || encoding == "deflate" ) {
+		mInflate = IOStreamInflate::New(
+			mWriteTo, "gzip" == encoding ? Compression::MODE_GZIP : Compression::MODE_DEFLATE );
+		mStream = mInflate;
+	}
+
+	const std::string& contentLength = mResponse.getField( "content-length" );
+	mHasContentLength =
+		!contentLength.empty() && String::fromString( mContentLength, contentLength );
+
+	if ( !mHasContentLength )
+		mContentLength = 0;
+
+	if ( mIsHeadRequest || code < 200 || Response::NoContent == status ||
+		 Response::NotModified == status ) {
+		complete();
+	} else if ( String::contains( String::toLower( mResponse.getField( "transfer-encoding" ) ),
+								  "chunked" ) ) {
+		mState = State::ChunkSize;
+	} else if ( mHasContentLength ) {
+		mRemaining = mContentLength;
+		mState = State::Body;
+
+		if ( 0 == mRemaining )
+			complete();
+	} else {
+		// The body ends when the server closes the connection
+		mKeepAlive = false;
+		mState = State::Body;
+	}
+}
+
+void Http::ResponseParser::complete() {
+	eeSAFE_DELETE( mInflate );
+	mStream = &mWriteTo;
+	mState = State::Complete;
+}
+
+}} // namespace EE::Network
@@ -0,0 +1,76 @@
+#ifndef EE_NETWORK_HTTPRESPONSEPARSER_HPP
+#define EE_NETWORK_HTTPRESPONSEPARSER_HPP
+
+#include <eepp/network/http.hpp>
+
+namespace EE { namespace System {
+class IOStreamInflate;
+}} // namespace EE::System
+
+namespace EE { namespace Network {
+
+/** Incremental parser of a HTTP response.
+ * It consumes exactly the bytes of one response, so the data that follows it in a keep-alive
+ * connection is left for the next response. */
+class Http::ResponseParser {
+  public:
+	ResponseParser( Http::Response& response, IOStream& writeTo, bool isHeadRequest );
+
+	~ResponseParser();
+
+	/** Parses the data received. The parsing stops after the header and after the end of the
+	 * response, so the caller can act on them.
+	 * @return The number of bytes consumed. */
+	std::size_t parse( const char* data, std::size_t size );
+
+	/** Informs that the connection was closed. Completes the responses delimited by the
+	 * connection close. */
+	void close();
+
+	bool isHeaderReceived() const;
+
+	bool isComplete() const;
+
+	/** @return True if the connection can be reused once the response is complete. */
+	bool isKeepAlive() const;
+
+	/** @return True if any byte of the response was received. */
+	bool hasData() const;
+
+	/** @return The content length reported by the server, 0 if unknown. */
+	const Uint64& getContentLength() const;
+
+	/** @return The number of bytes of the body received ( including the chunks information ). */
+	const Uint64& getBodyReceived() const;
+
+  protected:
+	enum class State { Header, Body, ChunkSize, ChunkData, ChunkDataEnd, Trailer, Complete };
+
+	Http::Response& mResponse;
+	IOStream& mWriteTo;
+	IOStream* mStream;
+	IOStreamInflate* mInflate{ nullptr };
+	State mState{ State::Header };
+	std::string mBuffer;
+	std::string mTrailer;
+	Uint64 mContentLength{ 0 };
+	Uint64 mRemaining{ 0 };
+	Uint64 mBodyReceived{ 0 };
+	bool mHasContentLength{ false };
+	bool mIsHeadRequest;
+	bool mKeepAlive{ false };
+	bool mHasData{ false };
+
+	std::size_t parseHeader( const char* data, std::size_t size );
+
+	/** Appends data to the line buffer until the line ends. @return True if the line ended. */
+	bool readLine( const char* data, std::size_t size, std::size_t& consumed );
+
+	void onHeader();
+
+	void complete();
+};
+
+}} // namespace EE::Network
+
+#endif // EE_NETWORK_HTTPRESPONSEPARSER_HPP
@@ -3,8 +3,19 @@
 #include <eepp/network/socket.hpp>
 #include <eepp/network/socketselector.hpp>
 #include <eepp/system/log.hpp>
+#include <unordered_map>
 #include <utility>
 
+#if EE_PLATFORM == EE_PLATFORM_LINUX || EE_PLATFORM == EE_PLATFORM_ANDROID
+#define EE_SOCKETSELECTOR_EPOLL
+#include <cerrno>
+#include <sys/epoll.h>
+#elif defined( EE_PLATFORM_POSIX )
+#define EE_SOCKETSELECTOR_POLL
+#include <cerrno>
+#include <poll.h>
+#endif
+
 #if EE_PLATFORM == EE_PLATFORM_HAIKU
 #include <sys/select.h>
 #endif
@@ -16,11 +27,204 @@
 
 namespace EE { namespace Network {
 
+#if defined( EE_SOCKETSELECTOR_EPOLL ) || defined( EE_SOCKETSELECTOR_POLL )
+
+struct SocketSelector::SocketSelectorImpl {
+	struct Entry {
+		Socket* socket;
+		std::size_t index;	 ///< Index in the pollfd list ( poll backend )
+		Uint64 readyStamp{ 0 }; ///< Wait stamp when the socket was reported as ready
+	};
+
+	std::unordered_map<SocketHandle, Entry> Sockets; ///< All the sockets by handle
+	std::vector<Socket*> ReadySockets;				 ///< Sockets ready after the last wait
+	Uint64 WaitStamp{ 0 };							 ///< Incremented after every wait
+#ifdef EE_SOCKETSELECTOR_EPOLL
+	int EpollFd{ -1 };
+	std::vector<epoll_event> Events;
+#else
+	std::vector<pollfd> PollFds;
+#endif
+
+	SocketSelectorImpl() { reset(); }
+
+	SocketSelectorImpl( const SocketSelectorImpl& copy ) {
+		reset();
+		for ( const auto& entry : copy.Sockets )
+			add( entry.first, entry.second.socket );
+	}
+
+	~SocketSelectorImpl() {
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		if ( EpollFd != -1 )
+			::close( EpollFd );
+#endif
+	}
+
+	void reset() {
+		Sockets.clear();
+		ReadySockets.clear();
+		WaitStamp++;
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		if ( EpollFd != -1 )
+			::close( EpollFd );
+		EpollFd = epoll_create1( EPOLL_CLOEXEC );
+		if ( EpollFd == -1 )
+			Log::error( "SocketSelector: epoll_create1 failed with errno %d", errno );
+#else
+		PollFds.clear();
+#endif
+	}
+
+	void add( SocketHandle handle, Socket* socket ) {
+		auto found = Sockets.find( handle );
+		if ( found != Sockets.end() ) {
+			found->second.socket = socket;
+#ifdef EE_SOCKETSELECTOR_EPOLL
+			// A closed descriptor is removed from the epoll set, the handle could be reused
+			epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.fd = handle;
+			epoll_ctl( EpollFd, EPOLL_CTL_ADD, handle, &event );
+#endif
+			return;
+		}
+
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = handle;
+		if ( epoll_ctl( EpollFd, EPOLL_CTL_ADD, handle, &event ) == -1 && errno != EEXIST ) {
+			Log::error( "SocketSelector: the socket can't be added to the selector, errno %d",
+						errno );
+			return;
+		}
+		Sockets[handle] = { socket, 0 };
+#else
+		Sockets[handle] = { socket, PollFds.size() };
+		PollFds.push_back( { handle, POLLIN, 0 } );
+#endif
+	}
+
+	void remove( SocketHandle handle ) {
+		auto found = Sockets.find( handle );
+		if ( found == Sockets.end() )
+			return;
+
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		epoll_event event{};
+		epoll_ctl( EpollFd, EPOLL_CTL_DEL, handle, &event );
+#else
+		// Swap with the last descriptor to keep the list packed
+		std::size_t index = found->second.index;
+		if ( index != PollFds.size() - 1 ) {
+			PollFds[index] = PollFds.back();
+			Sockets[PollFds[index].fd].index = index;
+		}
+		PollFds.pop_back();
+#endif
+
+		Socket* socket = found->second.socket;
+		if ( found->second.readyStamp == WaitStamp )
+			ReadySockets.erase( std::remove( ReadySockets.begin(), ReadySockets.end(), socket ),
+								ReadySockets.end() );
+		Sockets.erase( found );
+	}
+
+	void setReady( SocketHandle handle ) {
+		auto found = Sockets.find( handle );
+		if ( found != Sockets.end() && found->second.readyStamp != WaitStamp ) {
+			found->second.readyStamp = WaitStamp;
+			ReadySockets.push_back( found->second.socket );
+		}
+	}
+
+	bool wait( Time timeout ) {
+		WaitStamp++;
+		ReadySockets.clear();
+
+		// Rounded up, so short timeouts don't end up in a busy loop
+		int timeoutMs = timeout != Time::Zero
+							? static_cast<int>( ( timeout.asMicroseconds() + 999 ) / 1000 )
+							: -1;
+
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		Events.resize( std::max<std::size_t>( Sockets.size(), 1 ) );
+		int count = epoll_wait( EpollFd, Events.data(), static_cast<int>( Events.size() ),
+								timeoutMs );
+
+		for ( int i = 0; i < count; i++ ) {
+			// Errors and hang ups are reported as readable, as select does
+			if ( Events[i].events & ( EPOLLIN | EPOLLERR | EPOLLHUP ) )
+				setReady( Events[i].data.fd );
+		}
+#else
+		int count = poll( PollFds.data(), static_cast<nfds_t>( PollFds.size() ), timeoutMs );
+
+		for ( std::size_t i = 0; count > 0 && i < PollFds.size(); i++ ) {
+			if ( PollFds[i].revents & ( POLLIN | POLLERR | POLLHUP ) )
+				setReady( PollFds[i].fd );
+		}
+#endif
+
+		return !ReadySockets.empty();
+	}
+
+	bool isReady( SocketHandle handle ) const {
+		auto found = Sockets.find( handle );
+		return found != Sockets.end() && found->second.readyStamp == WaitStamp;
+	}
+};
+
+SocketSelector::SocketSelector() : mImpl( eeNew( SocketSelectorImpl, () ) ) {}
+
+SocketSelector::SocketSelector( const SocketSelector& copy ) :
+	mImpl( eeNew( SocketSelectorImpl, ( *copy.mImpl ) ) ) {}
+
+SocketSelector::~SocketSelector() {
+	eeSAFE_DELETE( mImpl );
+}
+
+void SocketSelector::add( Socket& socket ) {
+	SocketHandle handle = socket.getHandle();
+
+	if ( handle != Private::SocketImpl::invalidSocket() )
+		mImpl->add( handle, &socket );
+}
+
+void SocketSelector::remove( Socket& socket ) {
+	SocketHandle handle = socket.getHandle();
+
+	if ( handle != Private::SocketImpl::invalidSocket() )
+		mImpl->remove( handle );
+}
+
+void SocketSelector::clear() {
+	mImpl->reset();
+}
+
+bool SocketSelector::wait( Time timeout ) {
+	return mImpl->wait( timeout );
+}
+
+bool SocketSelector::isReady( Socket& socket ) const {
+	SocketHandle handle = socket.getHandle();
+
+	if ( handle != Private::SocketImpl::invalidSocket() )
+		return mImpl->isReady( handle );
+
+	return false;
+}
+
+#else
+
 struct SocketSelector::SocketSelectorImpl {
 	fd_set AllSockets;	 ///< Set containing all the sockets handles
 	fd_set SocketsReady; ///< Set containing handles of the sockets that are ready
 	int MaxSocket;		 ///< Maximum socket handle
 	int SocketCount;	 ///< Number of socket handles
+	std::unordered_map<SocketHandle, Socket*> Sockets; ///< All the sockets by handle
+	std::vector<Socket*> ReadySockets;				   ///< Sockets ready after the last wait
 };
 
 SocketSelector::SocketSelector() : mImpl( eeNew( SocketSelectorImpl, () ) ) {
@@ -61,6 +265,7 @@ void SocketSelector::add( Socket& socket ) {
 #endif
 
 		FD_SET( handle, &mImpl->AllSockets );
+		mImpl->Sockets[handle] = &socket;
 	}
 }
 
@@ -80,6 +285,10 @@ void SocketSelector::remove( Socket& socket ) {
 
 		FD_CLR( handle, &mImpl->AllSockets );
 		FD_CLR( handle, &mImpl->SocketsReady );
+		mImpl->Sockets.erase( handle );
+		mImpl->ReadySockets.erase( std::remove( mImpl->ReadySockets.begin(),
+												mImpl->ReadySockets.end(), &socket ),
+								   mImpl->ReadySockets.end() );
 	}
 }
 
@@ -89,6 +298,8 @@ void SocketSelector::clear() {
 
 	mImpl->MaxSocket = 0;
 	mImpl->SocketCount = 0;
+	mImpl->Sockets.clear();
+	mImpl->ReadySockets.clear();
 }
 
 bool SocketSelector::wait( Time timeout ) {
@@ -99,12 +310,20 @@ bool SocketSelector::wait( Time timeout ) {
 
 	// Initialize the set that will contain the sockets that are ready
 	mImpl->SocketsReady = mImpl->AllSockets;
+	mImpl->ReadySockets.clear();
 
 	// Wait until one of the sockets is ready for reading, or timeout is reached
 	// The first parameter is ignored on Windows
 	int count = select( mImpl->MaxSocket + 1, &mImpl->SocketsReady, NULL, NULL,
 						timeout != Time::Zero ? &time : NULL );
 
+	if ( count > 0 ) {
+		for ( const auto& socket : mImpl->Sockets ) {
+			if ( FD_ISSET( socket.first, &mImpl->SocketsReady ) )
+				mImpl->ReadySockets.push_back( socket.second );
+		}
+	}
+
 	return count > 0;
 }
 
@@ -123,6 +342,12 @@ bool SocketSelector::isReady( Socket& socket ) const {
 	return false;
 }
 
+#endif
+
+const std::vector<Socket*>& SocketSelector::getReadySockets() const {
+	return mImpl->ReadySockets;
+}
+
 SocketSelector& SocketSelector::operator=( const SocketSelector& right ) {
 	SocketSelector temp( right );
 
@@ -4,6 +4,7 @@
 #include <eepp/scene/action.hpp>
 #include <eepp/scene/actionmanager.hpp>
 #include <eepp/scene/node.hpp>
+#include <eepp/scene/nodespatialindex.hpp>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/scene/scenenode.hpp>
 
@@ -27,6 +28,7 @@ Node::Node() :
 	mNodeFlags( NODE_FLAG_POSITION_DIRTY | NODE_FLAG_POLYGON_DIRTY ),
 	mBlend( BlendMode::Alpha() ),
 	mNumCallBacks( 0 ),
+	mSpatialIndex( NULL ),
 	mVisible( true ),
 	mEnabled( true ),
 	mAlpha( 255.f ) {}
@@ -43,6 +45,9 @@ Node::~Node() {
 			mSceneNode->removeMouseOverNode( this );
 	}
 
+	// Avoid updating the index while the childs are being removed.
+	eeSAFE_DELETE( mSpatialIndex );
+
 	childDeleteAll();
 
 	if ( NULL != mParentNode )
@@ -135,7 +140,7 @@ Node* Node::setPosition( const Float& x, const Float& y ) {
 
 void Node::setInternalSize( const Sizef& size ) {
 	mSize = size;
-	mNodeFlags |= NODE_FLAG_POLYGON_DIRTY;
+	setPolygonDirty();
 	updateCenter();
 	sendCommonEvent( Event::OnSizeChange );
 	invalidateDraw();
@@ -652,6 +657,9 @@ void Node::childAdd( Node* node ) {
 
 	eeASSERT( !( NULL == mChildLast && NULL != mChild ) );
 
+	if ( NULL != mSpatialIndex )
+		mSpatialIndex->invalidateAll();
+
 	onChildCountChange( node, false );
 }
 
@@ -706,6 +714,9 @@ void Node::childAddAt( Node* node, Uint32 index ) {
 
 	eeASSERT( !( NULL == mChildLast && NULL != mChild ) );
 
+	if ( NULL != mSpatialIndex )
+		mSpatialIndex->invalidateAll();
+
 	onChildCountChange( node, false );
 }
 
@@ -738,6 +749,9 @@ void Node::childRemove( Node* node ) {
 
 	eeASSERT( !( NULL == mChildLast && NULL != mChild ) );
 
+	if ( NULL != mSpatialIndex )
+		mSpatialIndex->invalidateAll();
+
 	onChildCountChange( node, true );
 }
 
@@ -977,18 +991,22 @@ Node* Node::overFind( const Vector2f& point ) {
 			writeNodeFlag( NODE_FLAG_MOUSEOVER_ME_OR_CHILD, 1 );
 			mSceneNode->addMouseOverNode( this );
 
-			Node* child = mChildLast;
+			if ( NULL != mSpatialIndex ) {
+				pOver = mSpatialIndex->overFind( point );
+			} else {
+				Node* child = mChildLast;
 
-			while ( NULL != child ) {
-				Node* childOver = child->overFind( point );
+				while ( NULL != child ) {
+					Node* childOver = child->overFind( point );
 
-				if ( NULL != childOver ) {
-					pOver = childOver;
+					if ( NULL != childOver ) {
+						pOver = childOver;
 
-					break; // Search from top to bottom, so the first over will be the topmost
-				}
+						break; // Search from top to bottom, so the first over will be the topmost
+					}
 
-				child = child->mPrev;
+					child = child->mPrev;
+				}
 			}
 
 			if ( NULL == pOver )
@@ -999,6 +1017,22 @@ Node* Node::overFind( const Vector2f& point ) {
 	return pOver;
 }
 
+void Node::setSpatialIndexEnabled( bool enabled, const Float& cellSize ) {
+	if ( enabled ) {
+		if ( NULL == mSpatialIndex ) {
+			mSpatialIndex = NodeSpatialIndex::New( this, cellSize );
+		} else {
+			mSpatialIndex->setCellSize( cellSize );
+		}
+	} else {
+		eeSAFE_DELETE( mSpatialIndex );
+	}
+}
+
+bool Node::isSpatialIndexEnabled() const {
+	return NULL != mSpatialIndex;
+}
+
 void Node::detach() {
 	if ( mParentNode ) {
 		mParentNode->childRemove( this );
@@ -1359,11 +1393,20 @@ void Node::setDirty() {
 	if ( ( mNodeFlags & NODE_FLAG_POSITION_DIRTY ) && ( mNodeFlags & NODE_FLAG_POLYGON_DIRTY ) )
 		return;
 
-	mNodeFlags |= NODE_FLAG_POSITION_DIRTY | NODE_FLAG_POLYGON_DIRTY;
+	mNodeFlags |= NODE_FLAG_POSITION_DIRTY;
+
+	setPolygonDirty();
 
 	setChildsDirty();
 }
 
+void Node::setPolygonDirty() {
+	mNodeFlags |= NODE_FLAG_POLYGON_DIRTY;
+
+	if ( NULL != mParentNode && NULL != mParentNode->mSpatialIndex )
+		mParentNode->mSpatialIndex->invalidate( this );
+}
+
 void Node::setChildsDirty() {
 	Node* ChildLoop = mChild;
 
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <eepp/scene/node.hpp>
+#include <eepp/scene/nodespatialindex.hpp>
+
+namespace EE { namespace Scene {
+
+// Childs covering more cells than this are kept in a separate list that is always tested.
+static constexpr Int64 MAX_CELLS_PER_ENTRY = 1024;
+
+NodeSpatialIndex* NodeSpatialIndex::New( Node* container, const Float& cellSize ) {
+	return eeNew( NodeSpatialIndex, ( container, cellSize ) );
+}
+
+NodeSpatialIndex::NodeSpatialIndex( Node* container, const Float& cellSize ) :
+	mContainer( container ), mCellSize( eemax( cellSize, 1.f ) ) {}
+
+void NodeSpatialIndex::invalidate( Node* child ) {
+	if ( mNeedsRebuild )
+		return;
+
+	auto it = mNodeEntry.find( child );
+
+	if ( it == mNodeEntry.end() ) {
+		mNeedsRebuild = true;
+		return;
+	}
+
+	Entry& entry = mEntries[it->second];
+
+	if ( !entry.dirty ) {
+		entry.dirty = true;
+		mDirty.push_back( it->second );
+	}
+}
+
+void NodeSpatialIndex::invalidateAll() {
+	mNeedsRebuild = true;
+}
+
+const Float& NodeSpatialIndex::getCellSize() const {
+	return mCellSize;
+}
+
+void NodeSpatialIndex::setCellSize( const Float& cellSize ) {
+	if ( cellSize != mCellSize ) {
+		mCellSize = eemax( cellSize, 1.f );
+		mNeedsRebuild = true;
+	}
+}
+
+Uint64 NodeSpatialIndex::getCellKey( const Int32& x, const Int32& y ) {
+	return ( static_cast<Uint64>( static_cast<Uint32>( x ) ) << 32 ) | static_cast<Uint32>( y );
+}
+
+Rect NodeSpatialIndex::getCellRange( const Rectf& bounds ) const {
+	return Rect( (int)eefloor( bounds.Left / mCellSize ), (int)eefloor( bounds.Top / mCellSize ),
+				 (int)eefloor( bounds.Right / mCellSize ),
+				 (int)eefloor( bounds.Bottom / mCellSize ) );
+}
+
+void NodeSpatialIndex::insert( const Uint32& entryIndex ) {
+	Entry& entry = mEntries[entryIndex];
+	entry.bounds = entry.node->getWorldBounds();
+	entry.cells = getCellRange( entry.bounds );
+	entry.dirty = false;
+
+	Int64 count = static_cast<Int64>( entry.cells.Right - entry.cells.Left + 1 ) *
+				  static_cast<Int64>( entry.cells.Bottom - entry.cells.Top + 1 );
+
+	if ( count > MAX_CELLS_PER_ENTRY ) {
+		entry.large = true;
+		mLarge.push_back( entryIndex );
+		return;
+	}
+
+	entry.large = false;
+
+	for ( Int32 y = entry.cells.Top; y <= entry.cells.Bottom; ++y )
+		for ( Int32 x = entry.cells.Left; x <= entry.cells.Right; ++x )
+			mCells[getCellKey( x, y )].push_back( entryIndex );
+}
+
+void NodeSpatialIndex::remove( const Uint32& entryIndex ) {
+	Entry& entry = mEntries[entryIndex];
+
+	if ( entry.large ) {
+		auto it = std::find( mLarge.begin(), mLarge.end(), entryIndex );
+		if ( it != mLarge.end() )
+			mLarge.erase( it );
+		entry.large = false;
+		return;
+	}
+
+	for ( Int32 y = entry.cells.Top; y <= entry.cells.Bottom; ++y ) {
+		for ( Int32 x = entry.cells.Left; x <= entry.cells.Right; ++x ) {
+			auto cellIt = mCells.find( getCellKey( x, y ) );
+
+			if ( cellIt == mCells.end() )
+				continue;
+
+			auto& cell = cellIt->second;
+			auto it = std::find( cell.begin(), cell.end(), entryIndex );
+
+			if ( it != cell.end() ) {
+				*it = cell.back();
+				cell.pop_back();
+			}
+
+			if ( cell.empty() )
+				mCells.erase( cellIt );
+		}
+	}
+}
+
+void NodeSpatialIndex::rebuild() {
+	mEntries.clear();
+	mDirty.clear();
+	mLarge.clear();
+	mCells.clear();
+	mNodeEntry.clear();
+
+	Node* child = mContainer->getFirstChild();
+
+	while ( NULL != child ) {
+		Entry entry;
+		entry.node = child;
+		mNodeEntry[child] = static_cast<Uint32>( mEntries.size() );
+		mEntries.emplace_back( std::move( entry ) );
+		child = child->getNextNode();
+	}
+
+	for ( Uint32 i = 0; i < mEntries.size(); ++i )
+		insert( i );
+
+	mNeedsRebuild = false;
+}
+
+void NodeSpatialIndex::refresh() {
+	if ( mNeedsRebuild ) {
+		rebuild();
+		return;
+	}
+
+	if ( mDirty.empty() )
+		return;
+
+	// Usually the container moved, rebuilding is cheaper than moving every entry.
+	if ( mDirty.size() > mEntries.size() / 2 ) {
+		rebuild();
+		return;
+	}
+
+	std::vector<Uint32> dirty;
+	dirty.swap( mDirty );
+
+	for ( const auto& entryIndex : dirty ) {
+		remove( entryIndex );
+		insert( entryIndex );
+	}
+}
+
+Node* NodeSpatialIndex::overFind( const Vector2f& point ) {
+	refresh();
+
+	mCandidates.clear();
+
+	auto cellIt = mCells.find(
+		getCellKey( (Int32)eefloor( point.x / mCellSize ), (Int32)eefloor( point.y / mCellSize ) ) );
+
+	if ( cellIt != mCells.end() ) {
+		for ( const auto& entryIndex : cellIt->second ) {
+			if ( mEntries[entryIndex].bounds.contains( point ) )
+				mCandidates.push_back( entryIndex );
+		}
+	}
+
+	for ( const auto& entryIndex : mLarge ) {
+		if ( mEntries[entryIndex].bounds.contains( point ) )
+			mCandidates.push_back( entryIndex );
+	}
+
+	// Search from top to bottom, the last child in the list is the topmost.
+	std::sort( mCandidates.begin(), mCandidates.end(), std::greater<Uint32>() );
+
+	for ( const auto& entryIndex : mCandidates ) {
+		Node* childOver = mEntries[entryIndex].node->overFind( point );
+
+		if ( NULL != childOver )
+			return childOver;
+	}
+
+	return NULL;
+}
+
+}} // namespace EE::Scene
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <eepp/core/allocationprofiler.hpp>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/scene/scenenode.hpp>
 #include <eepp/ui/uiscenenode.hpp>
@@ -39,12 +40,14 @@ size_t SceneManager::count() const {
 }
 
 void SceneManager::draw() {
+	AllocationProfiler::Zone zone( "SceneManager::draw" );
 	for ( auto& sceneNode : mSceneNodes ) {
 		sceneNode->draw();
 	}
 }
 
 void SceneManager::update( const Time& elapsed ) {
+	AllocationProfiler::Zone zone( "SceneManager::update" );
 	for ( auto& sceneNode : mSceneNodes ) {
 		sceneNode->update( elapsed );
 	}
@@ -1,7 +1,11 @@
 #include <algorithm>
+#include <chrono>
 #include <cstdarg>
+#include <ctime>
 #include <eepp/system/log.hpp>
+#include <eepp/system/thread.hpp>
 #include <iostream>
+#include <thread>
 
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
 #include <android/log.h>
@@ -21,6 +25,33 @@ namespace EE { namespace System {
 
 SINGLETON_DECLARE_IMPLEMENTATION( Log )
 
+/** Texts queued by a thread in async mode. Only that thread writes the records and moves the head,
+ * only the consumer reads them and moves the tail. */
+struct Log::AsyncRing {
+	struct Record {
+		Int64 order{ 0 }; ///< Steady clock time, to merge the texts of every thread in order
+		time_t time{ 0 }; ///< Formatted by the consumer
+		LogLevel level{ LogLevel::Info };
+		bool timestamp{ false };
+		bool newLine{ false };
+		std::string text;
+	};
+
+	static constexpr Uint64 Capacity = 1024;
+
+	explicit AsyncRing( Uint64 generation ) : generation( generation ) {}
+
+	const Uint64 generation;
+	std::atomic<Uint64> head{ 0 };
+	std::atomic<Uint64> tail{ 0 };
+	Record records[Capacity];
+};
+
+/** Identifies every Log instance, so the rings of a destroyed Log are not reused */
+static std::atomic<Uint64> sLogGeneration{ 0 };
+
+static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds( 50 );
+
 std::unordered_map<std::string, LogLevel> Log::getMapFlag() {
 	return { { "debug", LogLevel::Debug },	 { "info", LogLevel::Info },
 			 { "notice", LogLevel::Notice }, { "warning", LogLevel::Warning },
@@ -51,7 +82,12 @@ Log* Log::create( const LogLevel& level, bool stdOutLog, bool liveWrite ) {
 	return ms_singleton;
 }
 
-Log::Log() : mSave( false ), mStdOutEnabled( false ), mLiveWrite( false ), mFS( NULL ) {
+Log::Log() :
+	mSave( false ),
+	mStdOutEnabled( false ),
+	mLiveWrite( false ),
+	mFS( NULL ),
+	mGeneration( ++sLogGeneration ) {
 	writel( LogLevel::Info, "eepp initialized" );
 }
 
@@ -61,7 +97,8 @@ Log::Log( const std::string& logPath, const LogLevel& level, bool stdOutLog, boo
 	mStdOutEnabled( stdOutLog ),
 	mLiveWrite( liveWrite ),
 	mLogLevelThreshold( level ),
-	mFS( NULL ) {
+	mFS( NULL ),
+	mGeneration( ++sLogGeneration ) {
 	writel( LogLevel::Info, "eepp initialized" );
 }
 
@@ -73,6 +110,47 @@ void Log::setKeepLog( bool keepLog ) {
 	mKeepLog = keepLog;
 }
 
+size_t Log::getKeepLogMaxSize() const {
+	return mKeepLogMaxSize;
+}
+
+void Log::setKeepLogMaxSize( size_t maxSize ) {
+	mKeepLogMaxSize = maxSize;
+}
+
+bool Log::isAsync() const {
+	return mAsync;
+}
+
+void Log::setAsync( bool async ) {
+	if ( async == mAsync )
+		return;
+
+	if ( async ) {
+		mFlusherRunning = true;
+		mFlusher = eeNew( Thread, ( &Log::flusherFunc, this ) );
+		mFlusher->launch();
+		mAsync = true;
+	} else {
+		mAsync = false;
+		stopFlusher();
+	}
+}
+
+void Log::flush() {
+	if ( !mFlusherRunning ) {
+		consumeRings();
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock( mFlushMutex );
+	Uint64 request = ++mFlushRequest;
+	mFlushCond.notify_one();
+	mFlushedCond.wait( lock, [this, request] {
+		return mFlushDone >= request || !mFlusherRunning;
+	} );
+}
+
 const std::string& Log::getFilePath() const {
 	return mFilePath;
 }
@@ -87,6 +165,9 @@ void Log::setFilePath( const std::string& filePath ) {
 Log::~Log() {
 	writel( LogLevel::Info, "eepp stoped\n" );
 
+	mAsync = false;
+	stopFlusher();
+
 	if ( mSave && !mLiveWrite && mKeepLog ) {
 		openFS();
 
@@ -115,27 +196,18 @@ void Log::save( const std::string& filepath ) {
 }
 
 void Log::write( const std::string_view& text ) {
-	if ( mKeepLog ) {
-		lock();
-		mData += text;
-		unlock();
+	if ( mAsync ) {
+		push( nullptr, text, false );
+		return;
 	}
 
+	if ( mKeepLog )
+		keepLog( text, false );
+
 	writeToReaders( text );
 
-	if ( mStdOutEnabled ) {
-#if EE_PLATFORM == EE_PLATFORM_ANDROID
-		__android_log_print( ANDROID_LOG_INFO, "eepp", "%s", text.data() );
-#elif defined( EE_COMPILER_MSVC )
-#ifdef UNICODE
-		OutputDebugString( String::fromUtf8( text ).toWideString().c_str() );
-#else
-		OutputDebugString( text.c_str() );
-#endif
-#else
-		std::cout << text << std::flush;
-#endif
-	}
+	if ( mStdOutEnabled )
+		writeToStdOut( text );
 
 	if ( mLiveWrite ) {
 		openFS();
@@ -174,18 +246,25 @@ std::string Log::logLevelWithTimestamp( const LogLevel& level, const std::string
 }
 
 void Log::write( const LogLevel& level, const std::string_view& text ) {
-	if ( level >= mLogLevelThreshold )
+	if ( level < mLogLevelThreshold )
+		return;
+
+	if ( mAsync ) {
+		push( &level, text, false );
+	} else {
 		write( logLevelWithTimestamp( level, text, false ) );
+	}
 }
 
 void Log::writel( const std::string_view& text ) {
-	if ( mKeepLog ) {
-		lock();
-		mData += text;
-		mData += "\n";
-		unlock();
+	if ( mAsync ) {
+		push( nullptr, text, true );
+		return;
 	}
 
+	if ( mKeepLog )
+		keepLog( text, true );
+
 	writeToReaders( text );
 	writeToReaders( "\n" );
 
@@ -216,8 +295,206 @@ void Log::writel( const std::string_view& text ) {
 }
 
 void Log::writel( const LogLevel& level, const std::string_view& text ) {
-	if ( level >= mLogLevelThreshold )
+	if ( level < mLogLevelThreshold )
+		return;
+
+	if ( mAsync ) {
+		push( &level, text, true );
+	} else {
 		write( logLevelWithTimestamp( level, text, true ) );
+	}
+}
+
+void Log::keepLog( const std::string_view& text, bool newLine ) {
+	lock();
+	mData += text;
+	if ( newLine )
+		mData += '\n';
+
+	// Discards the oldest lines, a quarter of the limit at once to not move the data every time
+	if ( mData.size() > mKeepLogMaxSize ) {
+		size_t cut = mData.size() - mKeepLogMaxSize * 3 / 4;
+		size_t lineEnd = mData.find( '\n', cut );
+		mData.erase( 0, lineEnd != std::string::npos ? lineEnd + 1 : cut );
+	}
+	unlock();
+}
+
+void Log::writeToStdOut( const std::string_view& text ) {
+#if EE_PLATFORM == EE_PLATFORM_ANDROID
+	__android_log_print( ANDROID_LOG_INFO, "eepp", "%.*s", (int)text.size(), text.data() );
+#elif defined( EE_COMPILER_MSVC )
+#ifdef UNICODE
+	OutputDebugString( String::fromUtf8( text ).toWideString().c_str() );
+#else
+	OutputDebugString( std::string( text ).c_str() );
+#endif
+#else
+	std::cout << text << std::flush;
+#endif
+}
+
+Log::AsyncRing* Log::getThreadRing() {
+	static thread_local std::shared_ptr<AsyncRing> ring;
+
+	if ( !ring || ring->generation != mGeneration ) {
+		ring = std::make_shared<AsyncRing>( mGeneration );
+		std::lock_guard<std::mutex> lock( mRingsMutex );
+		mRings.push_back( ring );
+	}
+
+	return ring.get();
+}
+
+void Log::wakeUpFlusher() {
+	mFlusherWakeUp = true;
+	mFlushCond.notify_one();
+}
+
+void Log::push( const LogLevel* level, const std::string_view& text, bool newLine ) {
+	AsyncRing* ring = getThreadRing();
+	Uint64 head = ring->head.load( std::memory_order_relaxed );
+
+	// Full, wait for the flusher or do its work if it was stopped meanwhile
+	while ( head - ring->tail.load( std::memory_order_acquire ) >= AsyncRing::Capacity ) {
+		if ( mFlusherRunning ) {
+			wakeUpFlusher();
+			std::this_thread::yield();
+		} else {
+			consumeRings();
+		}
+	}
+
+	auto& record = ring->records[head % AsyncRing::Capacity];
+	record.order = std::chrono::steady_clock::now().time_since_epoch().count();
+	record.timestamp = level != nullptr;
+	if ( level != nullptr ) {
+		record.level = *level;
+		record.time = std::time( nullptr );
+	}
+	record.newLine = newLine;
+	record.text.assign( text.data(), text.size() );
+	ring->head.store( head + 1, std::memory_order_release );
+
+	if ( !mFlusherRunning ) {
+		consumeRings();
+	} else if ( head + 1 - ring->tail.load( std::memory_order_relaxed ) >=
+				AsyncRing::Capacity / 2 ) {
+		wakeUpFlusher();
+	}
+}
+
+void Log::flusherFunc() {
+	while ( mFlusherRunning ) {
+		Uint64 request;
+		{
+			std::unique_lock<std::mutex> lock( mFlushMutex );
+			mFlushCond.wait_for( lock, FLUSH_INTERVAL, [this] {
+				return mFlusherWakeUp || !mFlusherRunning || mFlushRequest != mFlushDone;
+			} );
+			mFlusherWakeUp = false;
+			request = mFlushRequest;
+		}
+
+		consumeRings();
+
+		{
+			std::lock_guard<std::mutex> lock( mFlushMutex );
+			mFlushDone = request;
+		}
+		mFlushedCond.notify_all();
+	}
+}
+
+void Log::stopFlusher() {
+	if ( nullptr == mFlusher )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock( mFlushMutex );
+		mFlusherRunning = false;
+	}
+	mFlushCond.notify_one();
+	mFlusher->wait();
+	eeSAFE_DELETE( mFlusher );
+
+	consumeRings();
+	mFlushedCond.notify_all();
+}
+
+void Log::consumeRings() {
+	std::lock_guard<std::mutex> consumeLock( mConsumeMutex );
+	std::vector<std::shared_ptr<AsyncRing>> rings;
+	{
+		std::lock_guard<std::mutex> lock( mRingsMutex );
+		// The rings of the finished threads are released once empty
+		mRings.erase( std::remove_if( mRings.begin(), mRings.end(),
+									  []( const std::shared_ptr<AsyncRing>& ring ) {
+										  return ring.use_count() == 1 &&
+												 ring->head == ring->tail;
+									  } ),
+					  mRings.end() );
+		rings = mRings;
+	}
+
+	std::vector<Uint64> heads( rings.size() );
+	std::vector<AsyncRing::Record*> records;
+	for ( size_t i = 0; i < rings.size(); i++ ) {
+		heads[i] = rings[i]->head.load( std::memory_order_acquire );
+		for ( Uint64 pos = rings[i]->tail.load( std::memory_order_relaxed ); pos < heads[i];
+			  pos++ )
+			records.push_back( &rings[i]->records[pos % AsyncRing::Capacity] );
+	}
+
+	if ( records.empty() )
+		return;
+
+	std::stable_sort( records.begin(), records.end(),
+					  []( const AsyncRing::Record* a, const AsyncRing::Record* b ) {
+						  return a->order < b->order;
+					  } );
+
+	std::string batch;
+	time_t lastTime = -1;
+	char date[64] = { 0 };
+	for ( auto* record : records ) {
+		if ( record->timestamp ) {
+			if ( record->time != lastTime ) {
+				lastTime = record->time;
+				strftime( date, sizeof( date ), "%Y-%m-%d %X", localtime( &lastTime ) );
+			}
+			batch += date;
+			batch += " - ";
+			batch += logLevelToString( record->level );
+			batch += ": ";
+		}
+		batch += record->text;
+		if ( record->newLine )
+			batch += '\n';
+
+		// The records keep their capacity to not allocate again, except for the big texts
+		if ( record->text.capacity() > 4 * EE_1KB )
+			std::string().swap( record->text );
+	}
+
+	for ( size_t i = 0; i < rings.size(); i++ )
+		rings[i]->tail.store( heads[i], std::memory_order_release );
+
+	if ( mKeepLog )
+		keepLog( batch, false );
+
+	writeToReaders( batch );
+
+	if ( mStdOutEnabled )
+		writeToStdOut( batch );
+
+	if ( mLiveWrite ) {
+		openFS();
+
+		mFS->write( batch.data(), batch.size() );
+
+		mFS->flush();
+	}
 }
 
 void Log::openFS() {
@@ -1,3 +1,4 @@
+#include <eepp/system/lock.hpp>
 #include <eepp/system/regex.hpp>
 #include <pcre2.h>
 
@@ -9,16 +10,19 @@ RegExCache::~RegExCache() {
 	clear();
 }
 
-void RegExCache::insert( std::string_view key, Uint32 options, void* cache ) {
-	mCache.insert( { hashCombine( String::hash( key ), options ), cache } );
+bool RegExCache::insert( std::string_view key, Uint32 options, void* cache ) {
+	Lock l( mMutex );
+	return mCache.insert( { hashCombine( String::hash( key ), options ), cache } ).second;
 }
 
 void* RegExCache::find( const std::string_view& key, Uint32 options ) {
+	Lock l( mMutex );
 	auto it = mCache.find( hashCombine( String::hash( key ), options ) );
 	return ( it != mCache.end() ) ? it->second : nullptr;
 }
 
 void RegExCache::clear() {
+	Lock l( mMutex );
 	for ( auto& cache : mCache )
 		pcre2_code_free( reinterpret_cast<pcre2_code*>( cache.second ) );
 	mCache.clear();
@@ -70,8 +74,7 @@ RegEx::RegEx( const std::string_view& pattern, Options options, bool useCache )
 		// 								  std::to_string( rc ) );
 		mValid = false;
 	} else if ( useCache && RegExCache::instance()->isEnabled() ) {
-		RegExCache::instance()->insert( pattern, options, mCompiledPattern );
-		mCached = true;
+		mCached = RegExCache::instance()->insert( pattern, options, mCompiledPattern );
 	}
 }
 
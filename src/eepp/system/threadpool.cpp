@@ -3,6 +3,22 @@
 
 namespace EE { namespace System {
 
+/** The pool and the worker index of the current thread, so the tasks submitted from a worker are
+ * pushed to its own queue. */
+static thread_local const ThreadPool* sCurrentPool = nullptr;
+static thread_local size_t sCurrentWorker = 0;
+
+ThreadPool::CancellationToken::CancellationToken() :
+	mCancelled( std::make_shared<std::atomic<bool>>( false ) ) {}
+
+void ThreadPool::CancellationToken::cancel() {
+	*mCancelled = true;
+}
+
+bool ThreadPool::CancellationToken::isCancelled() const {
+	return *mCancelled;
+}
+
 std::shared_ptr<ThreadPool> ThreadPool::createShared( Uint32 numThreads, bool terminateOnClose ) {
 	std::shared_ptr<ThreadPool> pool( new ThreadPool( numThreads, terminateOnClose ) );
 	return pool;
@@ -19,15 +35,21 @@ ThreadPool* ThreadPool::createRaw( Uint32 numThreads, bool terminateOnClose ) {
 
 ThreadPool::ThreadPool( Uint32 numThreads, bool terminateOnClose ) :
 	mTerminateOnClose( terminateOnClose ) {
+	for ( auto& pending : mPending )
+		pending = 0;
+
+	for ( Uint32 i = 0; i < numThreads; ++i )
+		mWorkers.emplace_back( std::make_unique<Worker>() );
+
 	for ( Uint32 i = 0; i < numThreads; ++i ) {
-		mThreads.emplace_back( std::make_unique<Thread>( &ThreadPool::threadFunc, this ) );
+		mThreads.emplace_back( std::make_unique<Thread>( [this, i] { threadFunc( i ); } ) );
 		mThreads.back()->launch();
 	}
 }
 
 ThreadPool::~ThreadPool() {
 	{
-		std::unique_lock<std::mutex> lock( mMutex );
+		std::unique_lock<std::mutex> lock( mSleepMutex );
 		mShuttingDown = true;
 	}
 
@@ -40,30 +62,107 @@ ThreadPool::~ThreadPool() {
 			t->wait();
 		}
 	}
+
+	for ( auto& worker : mWorkers ) {
+		for ( auto& queue : worker->queues ) {
+			for ( Work* work : queue )
+				delete work;
+		}
+	}
+}
+
+ThreadPool::Work* ThreadPool::take( Worker& worker, size_t priority, bool front ) {
+	std::unique_lock<std::mutex> lock( worker.mutex );
+	auto& queue = worker.queues[priority];
+	if ( queue.empty() )
+		return nullptr;
+
+	Work* work;
+	if ( front ) {
+		work = queue.front();
+		queue.pop_front();
+	} else {
+		work = queue.back();
+		queue.pop_back();
+	}
+	mPending[priority]--;
+	return work;
+}
+
+ThreadPool::Work* ThreadPool::pop( size_t index ) {
+	size_t count = mWorkers.size();
+
+	for ( size_t priority = 0; priority < PriorityCount; priority++ ) {
+		if ( mPending[priority] <= 0 )
+			continue;
+
+		// The own queue in order, then steal the newest tasks of the other workers
+		if ( Work* work = take( *mWorkers[index], priority, true ) )
+			return work;
+
+		for ( size_t i = 1; i < count; i++ ) {
+			if ( Work* work = take( *mWorkers[( index + i ) % count], priority, false ) )
+				return work;
+		}
+	}
+
+	return nullptr;
 }
 
-void ThreadPool::threadFunc() {
+void ThreadPool::threadFunc( size_t index ) {
+	sCurrentPool = this;
+	sCurrentWorker = index;
+
 	while ( true ) {
-		std::unique_ptr<Work> work;
-		{
-			std::unique_lock<std::mutex> lock( mMutex );
+		Work* work = pop( index );
 
-			mWorkAvailable.wait( lock, [this]() { return !mWork.empty() || mShuttingDown; } );
+		if ( nullptr == work ) {
+			std::unique_lock<std::mutex> lock( mSleepMutex );
+			mSleeping++;
+			mWorkAvailable.wait( lock, [this]() {
+				return mShuttingDown || mPending[0] > 0 || mPending[1] > 0 || mPending[2] > 0;
+			} );
+			mSleeping--;
 
-			if ( mShuttingDown && mWork.empty() ) {
+			if ( mShuttingDown && mPending[0] <= 0 && mPending[1] <= 0 && mPending[2] <= 0 )
 				return;
-			}
 
-			work = std::move( mWork.front() );
-			mWork.pop_front();
+			continue;
 		}
 
-		work->func();
+		Uint8 queued = Work::Queued;
+		bool run = work->state.compare_exchange_strong( queued, Work::Taken ) &&
+				   ( !work->cancelled || !*work->cancelled );
+
+		if ( work->tag != 0 )
+			untag( work );
+
+		if ( run ) {
+			work->func();
 
-		if ( work->callback != nullptr ) {
-			work->callback( work->id );
+			if ( work->callback != nullptr )
+				work->callback( work->id );
 		}
+
+		delete work;
+	}
+}
+
+void ThreadPool::untag( Work* work ) {
+	std::unique_lock<std::mutex> lock( mTaggedMutex );
+	auto it = mTagged.find( work->tag );
+	if ( it == mTagged.end() )
+		return;
+
+	auto& works = it->second;
+	auto found = std::find( works.begin(), works.end(), work );
+	if ( found != works.end() ) {
+		*found = works.back();
+		works.pop_back();
 	}
+
+	if ( works.empty() )
+		mTagged.erase( it );
 }
 
 bool ThreadPool::terminateOnClose() const {
@@ -75,61 +174,160 @@ void ThreadPool::setTerminateOnClose( bool terminateOnClose ) {
 }
 
 bool ThreadPool::existsIdInQueue( const Uint64& id ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	return std::any_of( mWork.begin(), mWork.end(),
-						[id]( const std::unique_ptr<Work>& work ) { return work->id == id; } );
+	for ( auto& worker : mWorkers ) {
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		for ( const auto& queue : worker->queues ) {
+			if ( std::any_of( queue.begin(), queue.end(), [id]( const Work* work ) {
+					 return work->id == id && work->state == Work::Queued;
+				 } ) )
+				return true;
+		}
+	}
+	return false;
 }
 
 bool ThreadPool::existsTagInQueue( const Uint64& tag ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	return std::any_of( mWork.begin(), mWork.end(),
-						[tag]( const std::unique_ptr<Work>& work ) { return work->tag == tag; } );
+	std::unique_lock<std::mutex> lock( mTaggedMutex );
+	auto it = mTagged.find( tag );
+	return it != mTagged.end() &&
+		   std::any_of( it->second.begin(), it->second.end(),
+						[]( const Work* work ) { return work->state == Work::Queued; } );
 }
 
 bool ThreadPool::removeId( const Uint64& id ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	for ( auto it = mWork.begin(); it != mWork.end(); ++it ) {
-		if ( it->get()->id == id ) {
-			mWork.erase( it );
-			return true;
+	// The removed tasks stay in the queues until a worker discards them
+	for ( auto& worker : mWorkers ) {
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		for ( const auto& queue : worker->queues ) {
+			for ( Work* work : queue ) {
+				Uint8 queued = Work::Queued;
+				if ( work->id == id )
+					return work->state.compare_exchange_strong( queued, Work::Removed );
+			}
 		}
 	}
 	return false;
 }
 
 bool ThreadPool::removeWithTag( const Uint64& tag ) {
-	std::vector<Uint64> ids;
-	{
-		std::unique_lock<std::mutex> lock( mMutex );
-		for ( const auto& work : mWork )
-			if ( work->tag == tag )
-				ids.emplace_back( work->id );
+	std::unique_lock<std::mutex> lock( mTaggedMutex );
+	auto it = mTagged.find( tag );
+	if ( it == mTagged.end() )
+		return false;
+
+	bool removed = false;
+	for ( Work* work : it->second ) {
+		Uint8 queued = Work::Queued;
+		removed |= work->state.compare_exchange_strong( queued, Work::Removed );
 	}
-	for ( const auto& id : ids )
-		removeId( id );
-	return !ids.empty();
+	mTagged.erase( it );
+	return removed;
 }
 
 Uint64 ThreadPool::run( const std::function<void()>& func,
 						const std::function<void( const Uint64& )>& doneCallback,
 						const Uint64& tag ) {
+	return run( func, Priority::Normal, doneCallback, tag );
+}
+
+Uint64 ThreadPool::run( const std::function<void()>& func, Priority priority,
+						const std::function<void( const Uint64& )>& doneCallback,
+						const Uint64& tag, const CancellationToken* token ) {
 	Uint64 id = ++mLastWorkId;
-	{
-		std::unique_lock<std::mutex> lock( mMutex );
 
-		if ( mShuttingDown )
-			return id;
+	if ( mShuttingDown || mWorkers.empty() )
+		return id;
+
+	Work* work = new Work();
+	work->id = id;
+	work->func = func;
+	work->callback = doneCallback;
+	work->tag = tag;
+	if ( token )
+		work->cancelled = token->mCancelled;
+
+	if ( tag != 0 ) {
+		std::unique_lock<std::mutex> lock( mTaggedMutex );
+		mTagged[tag].push_back( work );
+	}
 
-		mWork.emplace_back( new Work{ id, func, doneCallback, tag } );
+	size_t index = sCurrentPool == this ? sCurrentWorker : mNextWorker++ % mWorkers.size();
+	size_t queue = static_cast<size_t>( priority );
+	{
+		Worker& worker = *mWorkers[index];
+		std::unique_lock<std::mutex> lock( worker.mutex );
+		worker.queues[queue].push_back( work );
 	}
+	mPending[queue]++;
 
-	mWorkAvailable.notify_one();
+	if ( mSleeping > 0 ) {
+		{ std::unique_lock<std::mutex> lock( mSleepMutex ); }
+		mWorkAvailable.notify_one();
+	}
 
 	return id;
 }
 
+void ThreadPool::parallelFor( size_t first, size_t last, size_t grainSize,
+							  const std::function<void( size_t, size_t )>& func,
+							  Priority priority, const CancellationToken* token ) {
+	if ( last <= first )
+		return;
+
+	grainSize = grainSize > 0 ? grainSize : 1;
+
+	struct Job {
+		std::function<void( size_t, size_t )> func;
+		std::shared_ptr<std::atomic<bool>> cancelled;
+		size_t first;
+		size_t last;
+		size_t grainSize;
+		size_t ranges;
+		std::atomic<size_t> next{ 0 };
+		size_t done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	auto job = std::make_shared<Job>();
+	job->func = func;
+	job->first = first;
+	job->last = last;
+	job->grainSize = grainSize;
+	job->ranges = ( last - first + grainSize - 1 ) / grainSize;
+	if ( token )
+		job->cancelled = token->mCancelled;
+
+	// The helpers that start after all the ranges were taken return without calling func
+	auto work = [job] {
+		size_t range;
+		size_t processed = 0;
+		while ( ( range = job->next++ ) < job->ranges ) {
+			if ( !job->cancelled || !*job->cancelled ) {
+				size_t begin = job->first + range * job->grainSize;
+				job->func( begin, std::min( begin + job->grainSize, job->last ) );
+			}
+			processed++;
+		}
+		if ( processed > 0 ) {
+			std::lock_guard<std::mutex> l( job->mutex );
+			job->done += processed;
+			if ( job->done == job->ranges )
+				job->finished.notify_all();
+		}
+	};
+
+	size_t helpers = std::min<size_t>( numThreads(), job->ranges - 1 );
+	for ( size_t i = 0; i < helpers; i++ )
+		run( work, priority );
+
+	work();
+
+	std::unique_lock<std::mutex> l( job->mutex );
+	job->finished.wait( l, [&job] { return job->done == job->ranges; } );
+}
+
 Uint32 ThreadPool::numThreads() const {
-	std::unique_lock<std::mutex> lock( mMutex );
 	return mShuttingDown ? 0 : static_cast<Uint32>( mThreads.size() );
 }
 
@@ -10,10 +10,13 @@
 #include <eepp/system/packmanager.hpp>
 #include <eepp/system/regex.hpp>
 #include <eepp/system/scopedop.hpp>
+#include <eepp/system/sys.hpp>
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/doc/syntaxhighlighter.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/window/engine.hpp>
+#include <condition_variable>
+#include <mutex>
 
 using namespace std::literals;
 
@@ -1334,6 +1337,67 @@ size_t TextDocument::remove( const size_t& cursorIdx, TextRange range,
 	return linesRemoved;
 }
 
+Int64 TextDocument::replaceLines( Int64 fromLine, Int64 numLines, const String& text,
+								  UndoStackContainer& undoStack, const Time& time ) {
+	eeASSERT( fromLine >= 0 && numLines > 0 &&
+			  fromLine + numLines <= static_cast<Int64>( mLines.size() ) );
+	eeASSERT( !text.empty() && text.back() == '\n' );
+
+	mModificationId++;
+
+	size_t lineCount = mLines.size();
+	Int64 toLine = fromLine + numLines - 1;
+	String oldText;
+	for ( Int64 i = fromLine; i <= toLine; i++ )
+		oldText.append( mLines[i].getText() );
+
+	std::vector<TextDocumentLine> newLines;
+	size_t start = 0;
+	size_t end;
+	while ( ( end = text.find( '\n', start ) ) != String::InvalidPos ) {
+		newLines.emplace_back( text.substr( start, end - start + 1 ) );
+		start = end + 1;
+	}
+
+	Int64 newCount = static_cast<Int64>( newLines.size() );
+	Int64 linesAdd = newCount - numLines;
+
+	mUndoStack.pushSelection( undoStack, 0, mSelection, time );
+	mUndoStack.pushReplaceLines( undoStack, fromLine, newCount, oldText, time );
+
+	DocumentContentChange change{
+		{ { fromLine, 0 }, { toLine, static_cast<Int64>( mLines[toLine].size() ) - 1 } },
+		text.substr( 0, text.size() - 1 ) };
+
+	// Splice the lines moving the tail of the document only once
+	Int64 common = eemin( numLines, newCount );
+	for ( Int64 i = 0; i < common; i++ )
+		mLines[fromLine + i] = std::move( newLines[i] );
+	if ( linesAdd > 0 ) {
+		mLines.insert( mLines.begin() + fromLine + numLines,
+					   std::make_move_iterator( newLines.begin() + common ),
+					   std::make_move_iterator( newLines.end() ) );
+	} else if ( linesAdd < 0 ) {
+		mLines.erase( mLines.begin() + fromLine + newCount, mLines.begin() + fromLine + numLines );
+	}
+
+	for ( auto& sel : mSelection )
+		sel = sanitizeRange( sel );
+
+	if ( linesAdd != 0 )
+		mHighlighter->moveHighlight( fromLine, toLine, linesAdd );
+
+	// Always notified so the clients recompute every modified line at once
+	notifiyDocumenLineMove( fromLine, toLine, linesAdd );
+	notifyTextChanged( change );
+	notifyLineChanged( fromLine );
+
+	if ( lineCount != mLines.size() )
+		notifyLineCountChanged( lineCount, mLines.size() );
+
+	return newCount;
+}
+
 TextPosition TextDocument::positionOffset( TextPosition position, int columnOffset,
 										   bool sanitizeInput ) const {
 	if ( sanitizeInput )
@@ -2914,11 +2978,346 @@ TextDocument::SearchResults TextDocument::findAll( const String& text, bool case
 	return all;
 }
 
+// Lines searched by each task of findAllParallel.
+static constexpr Int64 FIND_ALL_CHUNK_LINES = 4096;
+
+// Conservatively detects the patterns that could match a new line without containing one: escapes
+// and classes that include it ( \n, \s, \W, %s, %c, ... ), negated sets, the dot of the Lua
+// patterns and the PCRE dot-all option.
+static bool patternCanMatchNewLine( const String& text,
+									const TextDocument::FindReplaceType& type ) {
+	if ( type == TextDocument::FindReplaceType::RegEx ) {
+		static const String escapes( "nrsDWRvVHxcpPe0" );
+		for ( size_t i = 0; i + 1 < text.size(); i++ ) {
+			if ( text[i] == '\\' ) {
+				if ( escapes.find( text[i + 1] ) != String::InvalidPos )
+					return true;
+				i++;
+			} else if ( text[i] == '[' && text[i + 1] == '^' ) {
+				return true;
+			} else if ( text[i] == '(' && text[i + 1] == '?' ) {
+				for ( size_t f = i + 2; f < text.size() && String::isLetter( text[f] ); f++ )
+					if ( text[f] == 's' )
+						return true;
+			}
+		}
+	} else if ( type == TextDocument::FindReplaceType::LuaPattern ) {
+		for ( size_t i = 0; i < text.size(); i++ ) {
+			if ( text[i] == '.' || ( text[i] == '[' && i + 1 < text.size() && text[i + 1] == '^' ) )
+				return true;
+			if ( text[i] == '%' && i + 1 < text.size() ) {
+				String::StringBaseType c = text[++i];
+				if ( c == 's' || c == 'c' || ( c >= 'A' && c <= 'Z' && c != 'S' && c != 'C' ) )
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+TextDocument::SearchResults TextDocument::findAllInRange( const String& text, bool caseSensitive,
+														  bool wholeWord, FindReplaceType type,
+														  TextRange range, Int64 lastStartLine,
+														  bool* stopFlag ) {
+	SearchResults all;
+	TextDocument::SearchResult found;
+	TextPosition from = range.start();
+	do {
+		found = find( text, from, caseSensitive, wholeWord, type, range );
+		if ( !found.isValid() || found.result.start().line() > lastStartLine ||
+			 ( !all.empty() && all.back() == found ) )
+			break;
+		from = found.result.end();
+		all.push_back( found );
+	} while ( !*stopFlag && from < range.end() );
+	if ( !all.empty() )
+		all.setSorted();
+	return all;
+}
+
+TextDocument::SearchResults
+TextDocument::findAllParallel( std::shared_ptr<ThreadPool> pool, const String& text,
+							   bool caseSensitive, bool wholeWord, FindReplaceType type,
+							   TextRange restrictRange, const FindAllResultsCb& onResults ) {
+	if ( text.empty() )
+		return {};
+
+	TextRange range( startOfDoc(), endOfDoc() );
+	if ( restrictRange.isValid() )
+		range = sanitizeRange( restrictRange.normalized() );
+
+	Int64 numLines = range.end().line() - range.start().line() + 1;
+
+	// The line ranges only overlap by the new lines of the pattern, the patterns that could match
+	// other new lines are searched serially.
+	if ( !pool || pool->numThreads() == 0 || numLines <= FIND_ALL_CHUNK_LINES ||
+		 patternCanMatchNewLine( text, type ) ) {
+		SearchResults all( findAll( text, caseSensitive, wholeWord, type, restrictRange ) );
+		if ( onResults && !all.empty() )
+			onResults( SearchResults( all ) );
+		return all;
+	}
+
+	if ( type == FindReplaceType::RegEx )
+		RegExCache::instance();
+
+	std::vector<TextRange> ranges;
+	std::vector<Int64> lastStartLines;
+
+	// Each chunk searches the matches starting in its lines, multi-line patterns can end in the
+	// following lines.
+	Int64 extraLines = std::count( text.begin(), text.end(), '\n' );
+	for ( Int64 line = range.start().line(); line <= range.end().line();
+		  line += FIND_ALL_CHUNK_LINES ) {
+		Int64 lastStartLine = eemin( line + FIND_ALL_CHUNK_LINES - 1, range.end().line() );
+		Int64 endLine = eemin( lastStartLine + extraLines, range.end().line() );
+		TextPosition start( line, line == range.start().line() ? range.start().column() : 0 );
+		TextPosition end( endLine, endLine == range.end().line()
+									   ? range.end().column()
+									   : static_cast<Int64>( mLines[endLine].size() ) );
+		ranges.push_back( { start, end } );
+		lastStartLines.push_back( lastStartLine );
+	}
+	std::vector<SearchResults> results( ranges.size() );
+
+	auto stopFlagUP = std::make_unique<bool>( false );
+	bool* stopFlag = stopFlagUP.get();
+	{
+		Lock l( mStopFlagsMutex );
+		mStopFlags.insert( { stopFlag, std::move( stopFlagUP ) } );
+	}
+
+	pool->parallelFor( 0, ranges.size(), 1, [&]( size_t chunk, size_t ) {
+		if ( *stopFlag )
+			return;
+		results[chunk] = findAllInRange( text, caseSensitive, wholeWord, type, ranges[chunk],
+										 lastStartLines[chunk], stopFlag );
+		if ( onResults && !results[chunk].empty() )
+			onResults( SearchResults( results[chunk] ) );
+	} );
+
+	SearchResults all;
+	for ( size_t chunk = 0; chunk < results.size() && !*stopFlag; chunk++ ) {
+		const SearchResults& res = results[chunk];
+		size_t first = 0;
+
+		// A match of the previous chunk crossed the boundary and overlaps with the first matches
+		// of this chunk, search again from its end until both results agree.
+		if ( !all.empty() && !res.empty() && res[0].result.start() < all.back().result.end() ) {
+			TextPosition from = all.back().result.end();
+			while ( true ) {
+				while ( first < res.size() && res[first].result.start() < from )
+					first++;
+				auto found = find( text, from, caseSensitive, wholeWord, type, range );
+				if ( !found.isValid() || found.result.end() <= from ||
+					 ( first < res.size() && found.result.start() >= res[first].result.start() ) ||
+					 ( first == res.size() &&
+					   found.result.start().line() > lastStartLines[chunk] ) )
+					break;
+				all.push_back( found );
+				from = found.result.end();
+			}
+		}
+
+		all.insert( all.end(), res.begin() + first, res.end() );
+	}
+
+	if ( !all.empty() )
+		all.setSorted();
+
+	{
+		Lock l( mStopFlagsMutex );
+		mStopFlags.erase( stopFlag );
+	}
+
+	return all;
+}
+
+// Documents with less lines than this are searched in the calling thread.
+static constexpr Int64 PARALLEL_FIND_MIN_LINES = 8192;
+
+struct LineMatch {
+	Int64 line;
+	Int64 start;
+	Int64 end;
+	std::vector<PatternMatcher::Range> captures;
+};
+
+static void findLineMatches( const std::vector<TextDocumentLine>& lines, const String& text,
+							 const TextDocument::FindReplaceType& type, bool caseSensitive,
+							 bool wholeWord, const TextRange& range, Int64 fromLine, Int64 toLine,
+							 std::vector<LineMatch>& matches ) {
+	// Case insensitive patterns are managed at the pattern level
+	bool toLower = !caseSensitive && type == TextDocument::FindReplaceType::Normal;
+
+	for ( Int64 i = fromLine; i <= toLine; i++ ) {
+		const String& lineText = lines[i].getText();
+		String lowerText;
+		if ( toLower )
+			lowerText = String::toLower( lineText );
+		const String& str = toLower ? lowerText : lineText;
+		Int64 col = i == range.start().line() ? range.start().column() : 0;
+		Int64 endCol = i == range.end().line() ? eemin<Int64>( range.end().column(), str.size() )
+											   : static_cast<Int64>( str.size() );
+
+		while ( col < endCol ) {
+			FindTypeResult res = findType( str.substr( col, endCol - col ), text, type, col,
+										   caseSensitive );
+			if ( String::StringType::npos == res.start )
+				break;
+
+			Int64 start = col + res.start;
+			Int64 end = col + res.end;
+
+			if ( start == end || ( wholeWord && !String::isWholeWord( lineText, text, start ) ) ) {
+				col = start + 1;
+				continue;
+			}
+
+			matches.push_back( { i, start, end, std::move( res.captures ) } );
+			col = end;
+		}
+	}
+}
+
 int TextDocument::replaceAll( const String& text, const String& replace, const bool& caseSensitive,
-							  const bool& wholeWord, FindReplaceType type,
-							  TextRange restrictRange ) {
+							  const bool& wholeWord, FindReplaceType type, TextRange restrictRange,
+							  std::shared_ptr<ThreadPool> pool ) {
 	if ( text.empty() )
 		return 0;
+
+	// Multi-line searches keep replacing one match at a time
+	if ( text.find( '\n' ) != String::InvalidPos )
+		return replaceAllSequential( text, replace, caseSensitive, wholeWord, type,
+									 restrictRange );
+
+	TextRange range( startOfDoc(),
+					 TextPosition( mLines.size() - 1, mLines[mLines.size() - 1].size() ) );
+	if ( restrictRange.isValid() )
+		range = sanitizeRange( restrictRange.normalized() );
+
+	String search( text );
+	if ( !caseSensitive && type == FindReplaceType::Normal )
+		search.toLower();
+
+	// Collect all the matches first, splitting the lines in chunks between the pool threads.
+	Int64 numLines = range.end().line() - range.start().line() + 1;
+	if ( type == FindReplaceType::RegEx )
+		RegExCache::instance();
+
+	std::vector<std::vector<LineMatch>> chunks;
+
+	if ( !pool || pool->numThreads() == 0 || numLines < PARALLEL_FIND_MIN_LINES ) {
+		chunks.resize( 1 );
+		findLineMatches( mLines, search, type, caseSensitive, wholeWord, range,
+						 range.start().line(), range.end().line(), chunks[0] );
+	} else {
+		chunks.resize( ( numLines + FIND_ALL_CHUNK_LINES - 1 ) / FIND_ALL_CHUNK_LINES );
+		pool->parallelFor( 0, chunks.size(), 1, [&]( size_t chunk, size_t ) {
+			Int64 fromLine = range.start().line() + chunk * FIND_ALL_CHUNK_LINES;
+			Int64 toLine = eemin( fromLine + FIND_ALL_CHUNK_LINES - 1, range.end().line() );
+			findLineMatches( mLines, search, type, caseSensitive, wholeWord, range, fromLine,
+							 toLine, chunks[chunk] );
+		} );
+	}
+
+	size_t count = 0;
+	for ( const auto& chunk : chunks )
+		count += chunk.size();
+
+	if ( count == 0 )
+		return 0;
+
+	std::vector<std::pair<String, int>> captureRefs; // $1 $2 ...
+	if ( type == FindReplaceType::LuaPattern || type == FindReplaceType::RegEx ) {
+		std::string replaceUtf8( replace.toUtf8() );
+		LuaPattern ptrn( "$%d+"sv );
+		PatternMatcher::Range match;
+		int offset = 0;
+		while ( captureRefs.size() < MAX_CAPTURES && ptrn.matches( replaceUtf8, &match, offset ) ) {
+			int num;
+			std::string ref( replaceUtf8.substr( match.start, match.end - match.start ) );
+			if ( String::fromString( num, ref.substr( 1 ) ) && num > 0 )
+				captureRefs.emplace_back( String::fromUtf8( ref ), num );
+			offset = match.end;
+		}
+	}
+
+	// Rebuild all the lines between the first and the last match in a single pass
+	Int64 firstLine = -1;
+	Int64 lastLine = -1;
+	for ( const auto& chunk : chunks ) {
+		if ( chunk.empty() )
+			continue;
+		if ( firstLine == -1 )
+			firstLine = chunk.front().line;
+		lastLine = chunk.back().line;
+	}
+
+	String newText;
+	Int64 col = 0;
+	Int64 curLine = firstLine;
+
+	for ( const auto& chunk : chunks ) {
+		for ( const auto& match : chunk ) {
+			while ( curLine < match.line ) {
+				const String& lineText = mLines[curLine].getText();
+				newText.append( lineText, col, lineText.size() - col );
+				col = 0;
+				curLine++;
+			}
+
+			const String& lineText = mLines[curLine].getText();
+			newText.append( lineText, col, match.start - col );
+
+			if ( !captureRefs.empty() && captureRefs.size() <= match.captures.size() ) {
+				String finalReplace( replace );
+				for ( const auto& ref : captureRefs ) {
+					if ( ref.second - 1 < static_cast<int>( match.captures.size() ) ) {
+						const auto& capture = match.captures[ref.second - 1];
+						finalReplace.replaceAll(
+							ref.first,
+							lineText.substr( capture.start, capture.end - capture.start ) );
+					}
+				}
+				newText.append( finalReplace );
+			} else {
+				newText.append( replace );
+			}
+
+			col = match.end;
+		}
+	}
+
+	const String& lastLineText = mLines[lastLine].getText();
+	newText.append( lastLineText, col, lastLineText.size() - col );
+
+	// A match consumed the last new line, the next line is merged into the block
+	if ( newText.empty() || newText.back() != '\n' ) {
+		if ( lastLine + 1 < static_cast<Int64>( mLines.size() ) ) {
+			lastLine++;
+			newText.append( mLines[lastLine].getText() );
+		} else {
+			newText.append( 1, '\n' );
+		}
+	}
+
+	bool wasRunningTransaction = isRunningTransaction();
+	if ( !wasRunningTransaction )
+		setRunningTransaction( true );
+	TextPosition startedPosition = getSelection().start();
+	mUndoStack.clearRedoStack();
+	replaceLines( firstLine, lastLine - firstLine + 1, newText, mUndoStack.getUndoStackContainer(),
+				  mTimer.getElapsedTime() );
+	if ( !wasRunningTransaction )
+		setRunningTransaction( false );
+	setSelection( startedPosition );
+	return static_cast<int>( count );
+}
+
+int TextDocument::replaceAllSequential( const String& text, const String& replace,
+										const bool& caseSensitive, const bool& wholeWord,
+										FindReplaceType type, TextRange restrictRange ) {
 	bool wasRunningTransaction = isRunningTransaction();
 	if ( !wasRunningTransaction )
 		setRunningTransaction( true );
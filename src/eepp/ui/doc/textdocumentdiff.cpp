@@ -0,0 +1,474 @@
+#include <eepp/ui/doc/textdocumentdiff.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace EE { namespace UI { namespace Doc {
+
+namespace {
+
+struct DiffContext {
+	const Uint32* a;
+	const Uint32* b;
+	std::vector<char> changedA;
+	std::vector<char> changedB;
+	std::vector<Int64> forward;
+	std::vector<Int64> backward;
+	/* both indexed by diagonal ( i1 - i2 ), from -nb - 1 to na + 1 */
+	Int64* kvdf;
+	Int64* kvdb;
+	Int64 maxCost;
+};
+
+struct DiffRange {
+	Int64 off1;
+	Int64 lim1;
+	Int64 off2;
+	Int64 lim2;
+};
+
+} // namespace
+
+static constexpr Int64 DIFF_LINE_MAX = std::numeric_limits<Int64>::max();
+
+// Middle snake of the Myers linear space algorithm. When the edit cost grows over maxCost the
+// furthest reaching path is taken as the split point, the result might not be minimal then.
+static void diffSplit( DiffContext& ctx, const DiffRange& r, Int64& spl1, Int64& spl2 ) {
+	const Uint32* ha1 = ctx.a;
+	const Uint32* ha2 = ctx.b;
+	Int64* kvdf = ctx.kvdf;
+	Int64* kvdb = ctx.kvdb;
+	Int64 dmin = r.off1 - r.lim2, dmax = r.lim1 - r.off2;
+	Int64 fmid = r.off1 - r.off2, bmid = r.lim1 - r.lim2;
+	bool odd = ( ( fmid - bmid ) & 1 ) != 0;
+	Int64 fmin = fmid, fmax = fmid;
+	Int64 bmin = bmid, bmax = bmid;
+	Int64 d, i1, i2;
+
+	kvdf[fmid] = r.off1;
+	kvdb[bmid] = r.lim1;
+
+	for ( Int64 ec = 1;; ec++ ) {
+		if ( fmin > dmin )
+			kvdf[--fmin - 1] = -1;
+		else
+			++fmin;
+		if ( fmax < dmax )
+			kvdf[++fmax + 1] = -1;
+		else
+			--fmax;
+
+		for ( d = fmax; d >= fmin; d -= 2 ) {
+			i1 = kvdf[d - 1] >= kvdf[d + 1] ? kvdf[d - 1] + 1 : kvdf[d + 1];
+			i2 = i1 - d;
+			for ( ; i1 < r.lim1 && i2 < r.lim2 && ha1[i1] == ha2[i2]; i1++, i2++ )
+				;
+			kvdf[d] = i1;
+			if ( odd && bmin <= d && d <= bmax && kvdb[d] <= i1 ) {
+				spl1 = i1;
+				spl2 = i2;
+				return;
+			}
+		}
+
+		if ( bmin > dmin )
+			kvdb[--bmin - 1] = DIFF_LINE_MAX;
+		else
+			++bmin;
+		if ( bmax < dmax )
+			kvdb[++bmax + 1] = DIFF_LINE_MAX;
+		else
+			--bmax;
+
+		for ( d = bmax; d >= bmin; d -= 2 ) {
+			i1 = kvdb[d - 1] < kvdb[d + 1] ? kvdb[d - 1] : kvdb[d + 1] - 1;
+			i2 = i1 - d;
+			for ( ; i1 > r.off1 && i2 > r.off2 && ha1[i1 - 1] == ha2[i2 - 1]; i1--, i2-- )
+				;
+			kvdb[d] = i1;
+			if ( !odd && fmin <= d && d <= fmax && i1 <= kvdf[d] ) {
+				spl1 = i1;
+				spl2 = i2;
+				return;
+			}
+		}
+
+		if ( ec >= ctx.maxCost ) {
+			Int64 fbest = -1, fbest1 = -1;
+			for ( d = fmax; d >= fmin; d -= 2 ) {
+				i1 = std::min( kvdf[d], r.lim1 );
+				i2 = i1 - d;
+				if ( r.lim2 < i2 ) {
+					i1 = r.lim2 + d;
+					i2 = r.lim2;
+				}
+				if ( fbest < i1 + i2 ) {
+					fbest = i1 + i2;
+					fbest1 = i1;
+				}
+			}
+
+			Int64 bbest = DIFF_LINE_MAX, bbest1 = DIFF_LINE_MAX;
+			for ( d = bmax; d >= bmin; d -= 2 ) {
+				i1 = std::max( r.off1, kvdb[d] );
+				i2 = i1 - d;
+				if ( i2 < r.off2 ) {
+					i1 = r.off2 + d;
+					i2 = r.off2;
+				}
+				if ( i1 + i2 < bbest ) {
+					bbest = i1 + i2;
+					bbest1 = i1;
+				}
+			}
+
+			if ( ( r.lim1 + r.lim2 ) - bbest < fbest - ( r.off1 + r.off2 ) ) {
+				spl1 = fbest1;
+				spl2 = fbest - fbest1;
+			} else {
+				spl1 = bbest1;
+				spl2 = bbest - bbest1;
+			}
+			return;
+		}
+	}
+}
+
+static std::vector<TextDocumentDiff::Hunk> diffIds( const Uint32* a, Int64 na, const Uint32* b,
+													Int64 nb ) {
+	std::vector<TextDocumentDiff::Hunk> hunks;
+	DiffContext ctx;
+	ctx.a = a;
+	ctx.b = b;
+	ctx.changedA.resize( na, 0 );
+	ctx.changedB.resize( nb, 0 );
+	ctx.maxCost = std::max<Int64>( 256, std::sqrt( static_cast<double>( na + nb ) ) );
+
+	std::vector<DiffRange> ranges;
+	ranges.push_back( { 0, na, 0, nb } );
+
+	while ( !ranges.empty() ) {
+		DiffRange r = ranges.back();
+		ranges.pop_back();
+
+		for ( ; r.off1 < r.lim1 && r.off2 < r.lim2 && a[r.off1] == b[r.off2]; r.off1++, r.off2++ )
+			;
+		for ( ; r.off1 < r.lim1 && r.off2 < r.lim2 && a[r.lim1 - 1] == b[r.lim2 - 1];
+			  r.lim1--, r.lim2-- )
+			;
+
+		if ( r.off1 == r.lim1 ) {
+			std::fill( ctx.changedB.begin() + r.off2, ctx.changedB.begin() + r.lim2, 1 );
+		} else if ( r.off2 == r.lim2 ) {
+			std::fill( ctx.changedA.begin() + r.off1, ctx.changedA.begin() + r.lim1, 1 );
+		} else {
+			if ( ctx.forward.empty() ) {
+				ctx.forward.resize( na + nb + 3 );
+				ctx.backward.resize( na + nb + 3 );
+				ctx.kvdf = ctx.forward.data() + nb + 1;
+				ctx.kvdb = ctx.backward.data() + nb + 1;
+			}
+			Int64 spl1 = 0, spl2 = 0;
+			diffSplit( ctx, r, spl1, spl2 );
+			ranges.push_back( { spl1, r.lim1, spl2, r.lim2 } );
+			ranges.push_back( { r.off1, spl1, r.off2, spl2 } );
+		}
+	}
+
+	Int64 i = 0, j = 0;
+	while ( i < na || j < nb ) {
+		if ( ( i < na && ctx.changedA[i] ) || ( j < nb && ctx.changedB[j] ) ) {
+			TextDocumentDiff::Hunk hunk;
+			hunk.oldStart = i;
+			hunk.newStart = j;
+			while ( i < na && ctx.changedA[i] )
+				i++;
+			while ( j < nb && ctx.changedB[j] )
+				j++;
+			hunk.oldCount = i - hunk.oldStart;
+			hunk.newCount = j - hunk.newStart;
+			hunks.emplace_back( hunk );
+		} else {
+			i++;
+			j++;
+		}
+	}
+
+	return hunks;
+}
+
+TextDocumentDiff::Lines::Lines( std::string_view text ) {
+	size_t start = 0;
+	while ( true ) {
+		size_t end = text.find( '\n', start );
+		std::string_view line(
+			text.substr( start, end == std::string_view::npos ? end : end - start ) );
+		if ( !line.empty() && line.back() == '\r' )
+			line.remove_suffix( 1 );
+		String str( String::fromUtf8( line ) );
+		str.push_back( '\n' );
+		String::HashType hash = str.getHash();
+		Uint32 id = find( str, hash );
+		if ( id == NoLine ) {
+			id = static_cast<Uint32>( mTexts.size() );
+			auto first = mFirstByHash.find( hash );
+			mNextSameHash.push_back( first != mFirstByHash.end() ? first->second : NoLine );
+			mFirstByHash[hash] = id;
+			mTexts.emplace_back( std::move( str ) );
+		}
+		mIds.push_back( id );
+		if ( end == std::string_view::npos )
+			break;
+		start = end + 1;
+	}
+}
+
+size_t TextDocumentDiff::Lines::size() const {
+	return mIds.size();
+}
+
+const std::vector<Uint32>& TextDocumentDiff::Lines::getIds() const {
+	return mIds;
+}
+
+Uint32 TextDocumentDiff::Lines::find( const String& line, const String::HashType& hash ) const {
+	auto first = mFirstByHash.find( hash );
+	if ( first == mFirstByHash.end() )
+		return NoLine;
+	// Different lines can share a hash, the text decides.
+	for ( Uint32 id = first->second; id != NoLine; id = mNextSameHash[id] ) {
+		if ( mTexts[id] == line )
+			return id;
+	}
+	return NoLine;
+}
+
+std::vector<TextDocumentDiff::Hunk> TextDocumentDiff::diff( const Lines& oldLines,
+															const Lines& newLines ) {
+	// The new lines are identified by the ids of the old ones, as the document lines are
+	std::vector<Uint32> oldIds( newLines.mTexts.size() );
+	for ( size_t id = 0; id < newLines.mTexts.size(); id++ ) {
+		oldIds[id] = oldLines.find( newLines.mTexts[id], newLines.mTexts[id].getHash() );
+	}
+
+	std::vector<Uint32> ids( newLines.size() );
+	for ( size_t i = 0; i < ids.size(); i++ )
+		ids[i] = oldIds[newLines.mIds[i]];
+
+	return diffIds( oldLines.mIds.data(), oldLines.size(), ids.data(), ids.size() );
+}
+
+TextDocumentDiff::TextDocumentDiff( TextDocument* doc ) : mDoc( doc ) {
+	mDoc->registerClient( this );
+}
+
+TextDocumentDiff::~TextDocumentDiff() {
+	mDoc->unregisterClient( this );
+}
+
+TextDocument* TextDocumentDiff::getDocument() const {
+	return mDoc;
+}
+
+void TextDocumentDiff::setBase( std::string_view text ) {
+	setBase( Lines( text ) );
+}
+
+void TextDocumentDiff::setBase( Lines&& lines ) {
+	mBase = std::move( lines );
+	mHasBase = true;
+	mFullDirty = true;
+}
+
+bool TextDocumentDiff::hasBase() const {
+	return mHasBase;
+}
+
+void TextDocumentDiff::clearBase() {
+	mBase = {};
+	mHunks.clear();
+	mHasBase = false;
+	mFullDirty = true;
+}
+
+const std::vector<TextDocumentDiff::Hunk>& TextDocumentDiff::getHunks() {
+	update();
+	return mHunks;
+}
+
+static Int64 hunkAnchor( const TextDocumentDiff::Hunk& hunk ) {
+	return hunk.newCount == 0 ? std::max<Int64>( hunk.newStart - 1, 0 ) : hunk.newStart;
+}
+
+const TextDocumentDiff::Hunk* TextDocumentDiff::getLineHunk( Int64 line ) {
+	update();
+	auto it = std::upper_bound( mHunks.begin(), mHunks.end(), line,
+								[]( Int64 line, const Hunk& hunk ) {
+									return line < hunkAnchor( hunk );
+								} );
+	if ( it == mHunks.begin() )
+		return nullptr;
+	--it;
+	if ( it->newCount == 0 )
+		return hunkAnchor( *it ) == line ? &*it : nullptr;
+	return line < it->newStart + it->newCount ? &*it : nullptr;
+}
+
+Int64 TextDocumentDiff::nextChange( Int64 line ) {
+	update();
+	for ( const auto& hunk : mHunks ) {
+		if ( hunkAnchor( hunk ) > line )
+			return hunkAnchor( hunk );
+	}
+	return -1;
+}
+
+Int64 TextDocumentDiff::prevChange( Int64 line ) {
+	update();
+	for ( auto it = mHunks.rbegin(); it != mHunks.rend(); ++it ) {
+		if ( hunkAnchor( *it ) < line )
+			return hunkAnchor( *it );
+	}
+	return -1;
+}
+
+Uint32 TextDocumentDiff::docLineId( Int64 line ) const {
+	const TextDocumentLine& docLine = mDoc->line( line );
+	return mBase.find( docLine.getText(), docLine.getHash() );
+}
+
+void TextDocumentDiff::markDirty( Int64 fromLine, Int64 toLine ) {
+	if ( mDirtyFrom < 0 ) {
+		mDirtyFrom = fromLine;
+		mDirtyTo = toLine;
+	} else {
+		mDirtyFrom = std::min( mDirtyFrom, fromLine );
+		mDirtyTo = std::max( mDirtyTo, toLine );
+	}
+}
+
+void TextDocumentDiff::update() {
+	if ( !mHasBase ) {
+		mFullDirty = false;
+		mDirtyFrom = mDirtyTo = -1;
+		return;
+	}
+
+	Int64 newSize = mDoc->linesCount();
+	std::vector<Uint32> lines;
+
+	if ( !mFullDirty && mDirtyFrom >= 0 ) {
+		// Only the region between the unmodified hunks around the edits is compared again.
+		// Lines outside the region are equal to the base, shifted by the previous hunks.
+		auto lo = []( const Hunk& hunk ) { return hunk.newStart; };
+		auto hi = []( const Hunk& hunk ) {
+			return hunk.newCount == 0 ? hunk.newStart : hunk.newStart + hunk.newCount - 1;
+		};
+		Int64 ws = eeclamp<Int64>( mDirtyFrom, 0, newSize - 1 );
+		Int64 we = eeclamp<Int64>( mDirtyTo, ws, newSize - 1 );
+		size_t first = 0;
+		while ( first < mHunks.size() && hi( mHunks[first] ) < ws - 1 )
+			first++;
+		size_t last = first;
+		while ( last < mHunks.size() && lo( mHunks[last] ) <= we + 1 ) {
+			ws = std::min( ws, lo( mHunks[last] ) );
+			we = std::max( we, hi( mHunks[last] ) );
+			last++;
+		}
+		while ( first > 0 && hi( mHunks[first - 1] ) >= ws - 1 ) {
+			first--;
+			ws = std::min( ws, lo( mHunks[first] ) );
+		}
+		ws = std::max<Int64>( ws, 0 );
+		Int64 wend = std::min( we + 1, newSize );
+
+		Int64 os = ws;
+		if ( first > 0 ) {
+			const Hunk& prev = mHunks[first - 1];
+			os = prev.oldStart + prev.oldCount + ( ws - ( prev.newStart + prev.newCount ) );
+		}
+		Int64 oend = static_cast<Int64>( mBase.size() ) - ( newSize - wend );
+		if ( last < mHunks.size() )
+			oend = mHunks[last].oldStart - ( mHunks[last].newStart - wend );
+
+		if ( os >= 0 && os <= oend && oend <= static_cast<Int64>( mBase.size() ) ) {
+			lines.resize( wend - ws );
+			for ( Int64 i = ws; i < wend; i++ )
+				lines[i - ws] = docLineId( i );
+
+			auto hunks =
+				diffIds( mBase.getIds().data() + os, oend - os, lines.data(), lines.size() );
+			for ( auto& hunk : hunks ) {
+				hunk.oldStart += os;
+				hunk.newStart += ws;
+			}
+
+			hunks.insert( hunks.begin(), mHunks.begin(), mHunks.begin() + first );
+			hunks.insert( hunks.end(), mHunks.begin() + last, mHunks.end() );
+			mHunks = std::move( hunks );
+			mDirtyFrom = mDirtyTo = -1;
+			return;
+		}
+
+		mFullDirty = true;
+	}
+
+	if ( mFullDirty ) {
+		lines.resize( newSize );
+		for ( Int64 i = 0; i < newSize; i++ )
+			lines[i] = docLineId( i );
+		mHunks = diffIds( mBase.getIds().data(), mBase.size(), lines.data(), lines.size() );
+		mFullDirty = false;
+		mDirtyFrom = mDirtyTo = -1;
+	}
+}
+
+void TextDocumentDiff::onDocumentLineChanged( const Int64& lineIndex ) {
+	if ( !mFullDirty )
+		markDirty( lineIndex, lineIndex );
+}
+
+void TextDocumentDiff::onDocumentLineMove( const Int64& fromLine, const Int64& toLine,
+										   const Int64& numLines ) {
+	if ( mFullDirty )
+		return;
+
+	// Lines [fromLine, toLine] were replaced by [fromLine, toLine + numLines]
+	Int64 newTo = toLine + numLines;
+	auto map = [toLine, numLines, newTo]( Int64 line ) {
+		return std::max<Int64>( line > toLine ? line + numLines : std::min( line, newTo ), 0 );
+	};
+
+	for ( auto& hunk : mHunks ) {
+		if ( hunk.newCount == 0 ) {
+			hunk.newStart = map( hunk.newStart );
+		} else {
+			Int64 lo = map( hunk.newStart );
+			Int64 hi = map( hunk.newStart + hunk.newCount - 1 );
+			hunk.newStart = lo;
+			hunk.newCount = hi - lo + 1;
+		}
+	}
+
+	if ( mDirtyFrom >= 0 ) {
+		mDirtyFrom = map( mDirtyFrom );
+		mDirtyTo = map( mDirtyTo );
+	}
+
+	markDirty( std::max<Int64>( std::min( fromLine, newTo ), 0 ), std::max( fromLine, newTo ) );
+}
+
+void TextDocumentDiff::onDocumentClosed( TextDocument* ) {
+	clearBase();
+}
+
+void TextDocumentDiff::onDocumentReset( TextDocument* ) {
+	mFullDirty = true;
+}
+
+void TextDocumentDiff::onDocumentLoaded( TextDocument* ) {
+	mFullDirty = true;
+}
+
+}}} // namespace EE::UI::Doc
@@ -127,6 +127,41 @@ class TextUndoCommandSelection : public TextUndoCommand {
 	size_t mCursorIdx;
 };
 
+/** Replaces a block of complete lines, used by the batched operations to record a single command
+ * instead of one insert and one remove per modification. */
+class TextUndoCommandReplaceLines : public TextUndoCommand {
+  public:
+	TextUndoCommandReplaceLines( const Uint64& id, const Int64& line, const Int64& numLines,
+								 const String& text, const Time& timestamp );
+
+	const Int64& getLine() const;
+
+	const Int64& getNumLines() const;
+
+	const String& getText() const;
+
+	json toJSON() {
+		auto j = baseJSON();
+		j["line"] = mLine;
+		j["numLines"] = mNumLines;
+		j["text"] = mText.toUtf8();
+		return j;
+	}
+
+	static TextUndoCommandReplaceLines* fromJSON( json j, Uint64 id ) {
+		auto timestamp = Time::fromString( j["timestamp"].get<std::string>() );
+		auto line = j["line"].get<Int64>();
+		auto numLines = j["numLines"].get<Int64>();
+		auto text = String::fromUtf8( j["text"].get<std::string>() );
+		return eeNew( TextUndoCommandReplaceLines, ( id, line, numLines, text, timestamp ) );
+	}
+
+  protected:
+	Int64 mLine;
+	Int64 mNumLines;
+	String mText;
+};
+
 TextUndoCommand::TextUndoCommand( const Uint64& id, const TextUndoCommandType& type,
 								  const Time& timestamp ) :
 	mId( id ), mType( type ), mTimestamp( timestamp ) {}
@@ -194,6 +229,27 @@ size_t TextUndoCommandSelection::getCursorIdx() const {
 	return mCursorIdx;
 }
 
+TextUndoCommandReplaceLines::TextUndoCommandReplaceLines( const Uint64& id, const Int64& line,
+														  const Int64& numLines,
+														  const String& text,
+														  const Time& timestamp ) :
+	TextUndoCommand( id, TextUndoCommandType::ReplaceLines, timestamp ),
+	mLine( line ),
+	mNumLines( numLines ),
+	mText( text ) {}
+
+const Int64& TextUndoCommandReplaceLines::getLine() const {
+	return mLine;
+}
+
+const Int64& TextUndoCommandReplaceLines::getNumLines() const {
+	return mNumLines;
+}
+
+const String& TextUndoCommandReplaceLines::getText() const {
+	return mText;
+}
+
 TextUndoStack::TextUndoStack( TextDocument* owner, const Uint32& maxStackSize ) :
 	mDoc( owner ),
 	mMaxStackSize( maxStackSize ),
@@ -250,6 +306,13 @@ void TextUndoStack::pushSelection( UndoStackContainer& undoStack, const size_t&
 								( ++mChangeIdCounter, cursorIdx, selection, time ) ) );
 }
 
+void TextUndoStack::pushReplaceLines( UndoStackContainer& undoStack, const Int64& line,
+									 const Int64& numLines, const String& text,
+									 const Time& time ) {
+	pushUndo( undoStack, eeNew( TextUndoCommandReplaceLines,
+								( ++mChangeIdCounter, line, numLines, text, time ) ) );
+}
+
 void TextUndoStack::popUndo( UndoStackContainer& undoStack, UndoStackContainer& redoStack ) {
 	if ( undoStack.empty() )
 		return;
@@ -276,6 +339,12 @@ void TextUndoStack::popUndo( UndoStackContainer& undoStack, UndoStackContainer&
 			mDoc->resetSelection( selection->getSelection() );
 			break;
 		}
+		case TextUndoCommandType::ReplaceLines: {
+			TextUndoCommandReplaceLines* replace = static_cast<TextUndoCommandReplaceLines*>( cmd );
+			mDoc->replaceLines( replace->getLine(), replace->getNumLines(), replace->getText(),
+								redoStack, cmd->getTimestamp() );
+			break;
+		}
 	}
 
 	eeSAFE_DELETE( cmd );
@@ -365,6 +434,10 @@ void TextUndoStack::fromJSON( const std::string& jsonString ) {
 					pushUndo( mRedoStack,
 							  TextUndoCommandSelection::fromJSON( jobj, ++mChangeIdCounter ) );
 					break;
+				case TextUndoCommandType::ReplaceLines:
+					pushUndo( mRedoStack,
+							  TextUndoCommandReplaceLines::fromJSON( jobj, ++mChangeIdCounter ) );
+					break;
 			}
 		}
 	} catch ( const json::exception& e ) {
@@ -532,7 +532,7 @@ int UIDocFindReplace::replaceAll( TextSearchParams& search, const String& replac
 	}
 
 	int count = mDoc->replaceAll( txt, repl, search.caseSensitive, search.wholeWord, search.type,
-								  search.range );
+								  search.range, getUISceneNode()->getThreadPool() );
 	mDoc->setSelection( startedPosition );
 	return count;
 }
@@ -1,5 +1,9 @@
+#include <eepp/core/allocationprofiler.hpp>
 #include <eepp/scene/scenemanager.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/sys.hpp>
 #include <eepp/ui/models/csspropertiesmodel.hpp>
+#include <eepp/ui/models/itemlistmodel.hpp>
 #include <eepp/ui/models/widgettreemodel.hpp>
 #include <eepp/ui/tools/uiwidgetinspector.hpp>
 #include <eepp/ui/uicheckbox.hpp>
@@ -13,6 +17,7 @@
 using namespace EE::Window;
 using namespace EE::UI::Models;
 using namespace EE::Scene;
+using namespace EE::System;
 
 namespace EE { namespace UI { namespace Tools {
 
@@ -37,6 +42,7 @@ UIWindow* UIWidgetInspector::create( UISceneNode* sceneNode, const Float& menuIc
 			<PushButton id="widget-tree-search-collapse" layout_width="wrap_content" layout_height="18dp" tooltip='@string(collapse_all, "Collapse All")' margin-left="8dp" icon="menu-fold" text-as-fallback="true" />
 			<PushButton id="widget-tree-search-expand" layout_width="wrap_content" layout_height="18dp" tooltip='@string(expand_all, "Expand All")' margin-left="8dp" icon="menu-unfold" text-as-fallback="true" />
 			<PushButton id="open-texture-viewer" lh="18dp" text="@string(texture_viewer, Texture Viewer)" margin-left="8dp" />
+			<PushButton id="open-allocation-profiler" lh="18dp" text="@string(allocation_profiler, Allocation Profiler)" margin-left="8dp" />
 		</hbox>
 		<Splitter layout_width="match_parent" lh="fixed" lw8="1" splitter-partition="50%">
 			<treeview lw="fixed" lh="mp" />
@@ -148,6 +154,10 @@ UIWindow* UIWidgetInspector::create( UISceneNode* sceneNode, const Float& menuIc
 		win->center()->runOnMainThread( [win] { win->toFront(); }, Milliseconds( 1 ) );
 	} );
 
+	cont->find<UIPushButton>( "open-allocation-profiler" )->onClick( [sceneNode]( auto ) {
+		openAllocationProfiler( sceneNode );
+	} );
+
 	uiWin->center();
 
 	Uint32 winCb = sceneNode->addEventListener( Event::OnWindowAdded, [sceneNode, uiWin](
@@ -172,6 +182,93 @@ UIWindow* UIWidgetInspector::create( UISceneNode* sceneNode, const Float& menuIc
 	return uiWin;
 }
 
+static void refreshAllocationProfiler( UITableView* tableView, UITextView* frameText ) {
+	static constexpr size_t MaxSites = 500;
+	std::vector<std::vector<std::string>> rows;
+
+	for ( const auto& site : AllocationProfiler::getSites() ) {
+		if ( rows.size() == MaxSites )
+			break;
+
+		std::string zones;
+		for ( const auto& zone : site.zones )
+			zones += zones.empty() ? zone : std::string( ";" ) + zone;
+
+		rows.push_back( { FileSystem::fileNameFromPath( site.file ) + ":" +
+							  String::toString( site.line ),
+						  AllocationProfiler::getSubsystem( site.file ), zones,
+						  String::toString( site.allocations ),
+						  FileSystem::sizeToString( site.bytes ),
+						  String::toString( site.reallocations ) } );
+	}
+
+	auto model = ItemVectorListOwnerModel<std::string>::create( 6, rows );
+	model->setColumnName( 0, "Site" );
+	model->setColumnName( 1, "Subsystem" );
+	model->setColumnName( 2, "Zones" );
+	model->setColumnName( 3, "Allocations" );
+	model->setColumnName( 4, "Bytes" );
+	model->setColumnName( 5, "Reallocations" );
+	tableView->setModel( model );
+
+	auto frames = AllocationProfiler::getFrames();
+	auto total = AllocationProfiler::getTotal();
+	frameText->setText( String::format(
+		"Last frame: %llu allocations, %s. Total: %llu allocations, %s",
+		frames.empty() ? 0ull : (unsigned long long)frames.back().allocations,
+		FileSystem::sizeToString( frames.empty() ? 0 : frames.back().bytes ).c_str(),
+		(unsigned long long)total.allocations, FileSystem::sizeToString( total.bytes ).c_str() ) );
+}
+
+void UIWidgetInspector::openAllocationProfiler( UISceneNode* sceneNode ) {
+	static const auto PROFILER_LAYOUT = R"xml(
+	<window layout_width="800dp" layout_height="500dp" winflags="default|maximize|shadow" window-title="@string(allocation_profiler, Allocation Profiler)">
+		<vbox lw="mp" lh="mp">
+			<hbox lw="wc" lh="wc">
+				<CheckBox id="allocation-profiler-enabled" text="@string(enabled, Enabled)" lg="center" />
+				<PushButton id="allocation-profiler-reset" lh="18dp" text="@string(reset, Reset)" margin-left="8dp" />
+				<PushButton id="allocation-profiler-log" lh="18dp" text="@string(log_report, Log Report)" margin-left="8dp" />
+				<PushButton id="allocation-profiler-export" lh="18dp" text="@string(export_flame_graph, Export Flame Graph)" margin-left="8dp" />
+				<TextView id="allocation-profiler-frame" margin-left="8dp" lg="center" />
+			</hbox>
+			<TableView lw="mp" lh="0" lw8="1" />
+		</vbox>
+	</window>
+	)xml";
+	UIWidget* win = sceneNode->loadLayoutFromString( PROFILER_LAYOUT );
+	UITableView* tableView = win->findByType<UITableView>( UI_TYPE_TABLEVIEW );
+	tableView->setAutoColumnsWidth( true );
+	tableView->setHeadersVisible( true );
+	UITextView* frameText = win->find<UITextView>( "allocation-profiler-frame" );
+
+	win->find<UICheckBox>( "allocation-profiler-enabled" )
+		->setChecked( AllocationProfiler::isEnabled() )
+		->addEventListener( Event::OnValueChange, []( const Event* event ) {
+			AllocationProfiler::setEnabled( event->getNode()->asType<UICheckBox>()->isChecked() );
+		} );
+
+	win->find<UIPushButton>( "allocation-profiler-reset" )
+		->onClick( [tableView, frameText]( auto ) {
+			AllocationProfiler::reset();
+			refreshAllocationProfiler( tableView, frameText );
+		} );
+
+	win->find<UIPushButton>( "allocation-profiler-log" )->onClick( []( auto ) {
+		AllocationProfiler::logReport();
+	} );
+
+	win->find<UIPushButton>( "allocation-profiler-export" )->onClick( []( auto ) {
+		std::string path( Sys::getTempPath() + "allocations.folded" );
+		if ( AllocationProfiler::exportFolded( path ) )
+			Log::info( "Allocation profile exported to: %s", path.c_str() );
+	} );
+
+	refreshAllocationProfiler( tableView, frameText );
+	win->setInterval( [tableView, frameText] { refreshAllocationProfiler( tableView, frameText ); },
+					  Seconds( 1 ) );
+	win->center()->runOnMainThread( [win] { win->toFront(); }, Milliseconds( 1 ) );
+}
+
 void UIWidgetInspector::checkWidgetPick( UISceneNode* sceneNode, UITreeView* widgetTree,
 										 bool wasHighlightOver, UITableView* tableView ) {
 	Input* input = sceneNode->getWindow()->getInput();
@@ -3267,23 +3267,42 @@ void UICodeEditor::updateHighlightWordCache() {
 						mHighlightWordProcessing++;
 						mDoc->stopActiveFindAll();
 
-						auto wordCache = mDoc->findAll(
+						// Show the matches as they are found, the previous highlights are kept
+						// until the first batch arrives.
+						bool firstBatch = true;
+						auto wordCache = mDoc->findAllParallel(
+							getUISceneNode()->getThreadPool(),
 							mHighlightWord.escapeSequences ? String::unescape( mHighlightWord.text )
 														   : mHighlightWord.text,
 							mHighlightWord.caseSensitive, mHighlightWord.wholeWord,
-							mHighlightWord.type, mHighlightWord.range );
+							mHighlightWord.type, mHighlightWord.range,
+							[this, &firstBatch]( TextDocument::SearchResults&& batch ) {
+								{
+									Lock l( mHighlightWordCacheMutex );
+									if ( firstBatch ) {
+										mHighlightWordCache = TextRanges();
+										firstBatch = false;
+									}
+									for ( const auto& res : batch )
+										mHighlightWordCache.push_back( res.result );
+								}
+								runOnMainThread( [this] { invalidateDraw(); } );
+							} );
 
 						{
 							Lock l( mHighlightWordCacheMutex );
 							mHighlightWordCache = wordCache.ranges();
 						}
 
+						runOnMainThread( [this] { invalidateDraw(); } );
+
 						Log::info( "Document search triggered in document: \"%s\", searched for "
 								   "\"%s\" and took %.2f ms",
 								   mDoc->getFilename().c_str(),
 								   mHighlightWord.text.toUtf8().c_str(),
 								   docSearch.getElapsedTime().asMilliseconds() );
 					},
+					ThreadPool::Priority::High,
 					[this]( const auto& ) { mHighlightWordProcessing--; }, tag );
 			},
 			Milliseconds( 16 ), tag );
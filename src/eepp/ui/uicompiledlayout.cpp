@@ -0,0 +1,317 @@
+#include <eepp/core/containers.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreamfile.hpp>
+#include <eepp/system/iostreammemory.hpp>
+#include <eepp/ui/css/shorthanddefinition.hpp>
+#include <eepp/ui/css/stylesheetselectorrule.hpp>
+#include <eepp/ui/css/stylesheetspecification.hpp>
+#include <eepp/ui/uicompiledlayout.hpp>
+#define PUGIXML_HEADER_ONLY
+#include <pugixml/pugixml.hpp>
+
+namespace EE { namespace UI {
+
+#define EE_COMPILED_LAYOUT_MAGIC ( ( 'E' << 0 ) | ( 'E' << 8 ) | ( 'C' << 16 ) | ( 'L' << 24 ) )
+#define HDR_COMPILED_LAYOUT_VERSION 1
+
+#pragma pack( push, 1 )
+
+struct sCompiledLayoutHdr {
+	Uint32 Magic;
+	Uint32 Version;
+	Uint8 Hash[16];
+	Uint32 StringCount;
+	Uint32 AttributeCount;
+	Uint32 ElementCount;
+};
+
+#pragma pack( pop )
+
+namespace {
+
+class LayoutCompiler {
+  public:
+	LayoutCompiler( std::vector<std::string>& strings,
+					std::vector<UICompiledLayout::Attribute>& attributes,
+					std::vector<UICompiledLayout::Element>& elements ) :
+		mStrings( strings ), mAttributes( attributes ), mElements( elements ) {}
+
+	void compile( const pugi::xml_node& node ) {
+		Uint32 index = static_cast<Uint32>( mElements.size() );
+		UICompiledLayout::Element element;
+		element.tag = intern( node.name() );
+		element.text = UICompiledLayout::NoString;
+		element.firstAttribute = static_cast<Uint32>( mAttributes.size() );
+		element.attributeCount = 0;
+		element.subtreeSize = 0;
+
+		for ( pugi::xml_attribute attr = node.first_attribute(); attr;
+			  attr = attr.next_attribute() ) {
+			mAttributes.push_back( { intern( attr.name() ), intern( attr.value() ) } );
+			element.attributeCount++;
+		}
+
+		if ( !node.text().empty() )
+			element.text = intern( node.text().get() );
+
+		mElements.push_back( element );
+
+		for ( pugi::xml_node child = node.first_child(); child; child = child.next_sibling() ) {
+			if ( child.type() == pugi::node_element )
+				compile( child );
+		}
+
+		mElements[index].subtreeSize = static_cast<Uint32>( mElements.size() ) - index - 1;
+	}
+
+  protected:
+	std::vector<std::string>& mStrings;
+	std::vector<UICompiledLayout::Attribute>& mAttributes;
+	std::vector<UICompiledLayout::Element>& mElements;
+	UnorderedMap<std::string, Uint32> mStringIds;
+
+	Uint32 intern( const char* str ) {
+		std::string string( str );
+		auto it = mStringIds.find( string );
+		if ( it != mStringIds.end() )
+			return it->second;
+		Uint32 id = static_cast<Uint32>( mStrings.size() );
+		mStringIds[string] = id;
+		mStrings.emplace_back( std::move( string ) );
+		return id;
+	}
+};
+
+template <typename T> static bool readValue( IOStream& stream, T& value ) {
+	return stream.read( reinterpret_cast<char*>( &value ), sizeof( T ) ) == sizeof( T );
+}
+
+template <typename T> static bool writeValue( IOStream& stream, const T& value ) {
+	return stream.write( reinterpret_cast<const char*>( &value ), sizeof( T ) ) == sizeof( T );
+}
+
+} // namespace
+
+UICompiledLayout UICompiledLayout::compile( const pugi::xml_node& node ) {
+	UICompiledLayout layout;
+	LayoutCompiler compiler( layout.mStrings, layout.mAttributes, layout.mElements );
+
+	for ( pugi::xml_node widget = node; widget; widget = widget.next_sibling() ) {
+		if ( widget.type() == pugi::node_element )
+			compiler.compile( widget );
+	}
+
+	layout.parseProperties();
+
+	return layout;
+}
+
+UICompiledLayout::UICompiledLayout() {
+	mSourceHash.fill( 0 );
+}
+
+bool UICompiledLayout::isEmpty() const {
+	return mElements.empty();
+}
+
+bool UICompiledLayout::loadFromStream( IOStream& stream ) {
+	if ( !stream.isOpen() )
+		return false;
+
+	sCompiledLayoutHdr hdr;
+
+	if ( !readValue( stream, hdr ) || hdr.Magic != EE_COMPILED_LAYOUT_MAGIC ||
+		 hdr.Version != HDR_COMPILED_LAYOUT_VERSION )
+		return false;
+
+	// Reject corrupted headers before allocating anything.
+	ios_size remaining = stream.getSize() - stream.tell();
+	ios_size attributesSize = (ios_size)hdr.AttributeCount * (ios_size)sizeof( Attribute );
+	ios_size elementsSize = (ios_size)hdr.ElementCount * (ios_size)sizeof( Element );
+
+	if ( (ios_size)hdr.StringCount * (ios_size)sizeof( Uint32 ) + attributesSize + elementsSize >
+		 remaining )
+		return false;
+
+	std::vector<std::string> strings( hdr.StringCount );
+
+	for ( auto& string : strings ) {
+		Uint32 length = 0;
+
+		if ( !readValue( stream, length ) || length > remaining )
+			return false;
+
+		string.resize( length );
+
+		if ( length && stream.read( string.data(), length ) != length )
+			return false;
+	}
+
+	std::vector<Attribute> attributes( hdr.AttributeCount );
+	std::vector<Element> elements( hdr.ElementCount );
+
+	if ( attributesSize &&
+		 stream.read( reinterpret_cast<char*>( attributes.data() ), attributesSize ) !=
+			 attributesSize )
+		return false;
+
+	if ( elementsSize &&
+		 stream.read( reinterpret_cast<char*>( elements.data() ), elementsSize ) != elementsSize )
+		return false;
+
+	for ( const auto& attribute : attributes ) {
+		if ( attribute.name >= strings.size() || attribute.value >= strings.size() )
+			return false;
+	}
+
+	for ( size_t i = 0; i < elements.size(); ++i ) {
+		const Element& element = elements[i];
+		if ( element.tag >= strings.size() ||
+			 ( element.text != NoString && element.text >= strings.size() ) ||
+			 (Uint64)element.firstAttribute + element.attributeCount > attributes.size() ||
+			 (Uint64)i + element.subtreeSize >= elements.size() )
+			return false;
+	}
+
+	mStrings = std::move( strings );
+	mAttributes = std::move( attributes );
+	mElements = std::move( elements );
+	memcpy( mSourceHash.data(), hdr.Hash, sizeof( hdr.Hash ) );
+	parseProperties();
+
+	return true;
+}
+
+bool UICompiledLayout::loadFromMemory( const void* buffer, size_t bufferSize ) {
+	IOStreamMemory stream( (const char*)buffer, bufferSize );
+	return loadFromStream( stream );
+}
+
+bool UICompiledLayout::loadFromFile( const std::string& path ) {
+	if ( !FileSystem::fileExists( path ) )
+		return false;
+	IOStreamFile stream( path );
+	return loadFromStream( stream );
+}
+
+bool UICompiledLayout::saveToStream( IOStream& stream ) const {
+	if ( !stream.isOpen() )
+		return false;
+
+	sCompiledLayoutHdr hdr;
+	hdr.Magic = EE_COMPILED_LAYOUT_MAGIC;
+	hdr.Version = HDR_COMPILED_LAYOUT_VERSION;
+	memcpy( hdr.Hash, mSourceHash.data(), sizeof( hdr.Hash ) );
+	hdr.StringCount = static_cast<Uint32>( mStrings.size() );
+	hdr.AttributeCount = static_cast<Uint32>( mAttributes.size() );
+	hdr.ElementCount = static_cast<Uint32>( mElements.size() );
+
+	if ( !writeValue( stream, hdr ) )
+		return false;
+
+	for ( const auto& string : mStrings ) {
+		Uint32 length = static_cast<Uint32>( string.size() );
+
+		if ( !writeValue( stream, length ) ||
+			 ( length && stream.write( string.data(), length ) != length ) )
+			return false;
+	}
+
+	ios_size attributesSize = (ios_size)( mAttributes.size() * sizeof( Attribute ) );
+	ios_size elementsSize = (ios_size)( mElements.size() * sizeof( Element ) );
+
+	if ( attributesSize &&
+		 stream.write( reinterpret_cast<const char*>( mAttributes.data() ), attributesSize ) !=
+			 attributesSize )
+		return false;
+
+	if ( elementsSize &&
+		 stream.write( reinterpret_cast<const char*>( mElements.data() ), elementsSize ) !=
+			 elementsSize )
+		return false;
+
+	return true;
+}
+
+bool UICompiledLayout::saveToFile( const std::string& path ) const {
+	IOStreamFile stream( path, "wb" );
+	return saveToStream( stream );
+}
+
+void UICompiledLayout::toXml( const Uint32& elementIndex, pugi::xml_node& parent ) const {
+	const Element& element = mElements[elementIndex];
+	pugi::xml_node node = parent.append_child( mStrings[element.tag].c_str() );
+
+	for ( Uint32 i = 0; i < element.attributeCount; ++i ) {
+		const Attribute& attribute = mAttributes[element.firstAttribute + i];
+		node.append_attribute( mStrings[attribute.name].c_str() )
+			.set_value( mStrings[attribute.value].c_str() );
+	}
+
+	if ( element.text != NoString )
+		node.append_child( pugi::node_pcdata ).set_value( mStrings[element.text].c_str() );
+
+	Uint32 end = elementIndex + element.subtreeSize + 1;
+
+	for ( Uint32 child = elementIndex + 1; child < end;
+		  child += mElements[child].subtreeSize + 1 )
+		toXml( child, node );
+}
+
+const std::vector<std::string>& UICompiledLayout::getStrings() const {
+	return mStrings;
+}
+
+const std::string& UICompiledLayout::getString( const Uint32& id ) const {
+	return mStrings[id];
+}
+
+const std::vector<UICompiledLayout::Attribute>& UICompiledLayout::getAttributes() const {
+	return mAttributes;
+}
+
+const std::vector<CSS::StyleSheetProperty>&
+UICompiledLayout::getProperties( const Uint32& attributeIndex ) const {
+	return mProperties[attributeIndex];
+}
+
+const std::vector<UICompiledLayout::Element>& UICompiledLayout::getElements() const {
+	return mElements;
+}
+
+const MD5::Digest& UICompiledLayout::getSourceHash() const {
+	return mSourceHash;
+}
+
+void UICompiledLayout::setSourceHash( const MD5::Digest& sourceHash ) {
+	mSourceHash = sourceHash;
+}
+
+void UICompiledLayout::parseProperties() {
+	CSS::StyleSheetSpecification* specification = CSS::StyleSheetSpecification::instance();
+	mProperties.clear();
+	mProperties.resize( mAttributes.size() );
+
+	for ( size_t i = 0; i < mAttributes.size(); ++i ) {
+		const std::string& name = mStrings[mAttributes[i].name];
+		const std::string& value = mStrings[mAttributes[i].value];
+		String::HashType nameHash( String::hash( String::toLower( String::trim( name ) ) ) );
+
+		// Not a property, UIWidget::loadInlineAttribute reports it if it's ever applied
+		if ( NULL == specification->getProperty( nameHash ) &&
+			 NULL == specification->getShorthand( nameHash ) )
+			continue;
+
+		// The same properties that UIWidget::loadInlineAttribute creates
+		CSS::StyleSheetProperty prop( name, value, false,
+									  CSS::StyleSheetSelectorRule::SpecificityInline );
+
+		if ( prop.getShorthandDefinition() != NULL ) {
+			mProperties[i] = prop.getShorthandDefinition()->parse( value );
+		} else {
+			mProperties[i].emplace_back( std::move( prop ) );
+		}
+	}
+}
+
+}} // namespace EE::UI
@@ -74,6 +74,11 @@ bool UIDropDownList::isType( const Uint32& type ) const {
 	return UIDropDownList::getType() == type ? true : UITextInput::isType( type );
 }
 
+bool UIDropDownList::loadsOnlyXmlAttributes() const {
+	// The list items are read from the node
+	return false;
+}
+
 void UIDropDownList::setTheme( UITheme* Theme ) {
 	UIWidget::setTheme( Theme );
 
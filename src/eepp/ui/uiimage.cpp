@@ -44,6 +44,10 @@ bool UIImage::isType( const Uint32& type ) const {
 	return UIImage::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UIImage::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 UIImage* UIImage::setDrawable( Drawable* drawable, bool ownIt ) {
 	if ( drawable == mDrawable )
 		return this;
@@ -53,6 +53,10 @@ bool UILayout::isType( const Uint32& type ) const {
 	return UILayout::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UILayout::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 const Sizef& UILayout::getSize() const {
 	if ( mDirtyLayout )
 		const_cast<UILayout*>( this )->updateLayout();
@@ -38,6 +38,10 @@ bool UILoader::isType( const Uint32& type ) const {
 	return UILoader::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UILoader::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UILoader::draw() {
 	UIWidget::draw();
 
@@ -149,7 +149,7 @@ void UINode::setInternalSize( const Sizef& size ) {
 	if ( s != mDpSize ) {
 		mDpSize = size;
 		mSize = PixelDensity::dpToPx( s );
-		mNodeFlags |= NODE_FLAG_POLYGON_DIRTY;
+		setPolygonDirty();
 		updateCenter();
 		sendCommonEvent( Event::OnSizeChange );
 		invalidateDraw();
@@ -169,7 +169,7 @@ void UINode::setInternalPixelsSize( const Sizef& size ) {
 	if ( s != mSize ) {
 		mDpSize = PixelDensity::pxToDp( s ).ceil();
 		mSize = s;
-		mNodeFlags |= NODE_FLAG_POLYGON_DIRTY;
+		setPolygonDirty();
 		updateCenter();
 		sendCommonEvent( Event::OnSizeChange );
 		invalidateDraw();
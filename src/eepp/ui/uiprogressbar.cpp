@@ -87,6 +87,10 @@ bool UIProgressBar::isType( const Uint32& type ) const {
 	return UIProgressBar::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UIProgressBar::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UIProgressBar::scheduledUpdate( const Time& time ) {
 	if ( NULL == mFiller->mFillerSkin )
 		return;
@@ -111,6 +111,10 @@ bool UIPushButton::isType( const Uint32& type ) const {
 	return UIPushButton::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UIPushButton::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UIPushButton::onAutoSize() {
 	if ( ( ( mFlags & UI_AUTO_SIZE ) && 0 == getSize().getHeight() ) ||
 		 mHeightPolicy == SizePolicy::WrapContent ) {
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <eepp/core/allocationprofiler.hpp>
 #include <eepp/core/string.hpp>
 #include <eepp/graphics/fontmanager.hpp>
 #include <eepp/graphics/fonttruetype.hpp>
@@ -8,10 +9,12 @@
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/functionstring.hpp>
+#include <eepp/system/md5.hpp>
 #include <eepp/system/packmanager.hpp>
 #include <eepp/system/virtualfilesystem.hpp>
 #include <eepp/ui/css/mediaquery.hpp>
 #include <eepp/ui/css/stylesheetparser.hpp>
+#include <eepp/ui/uicompiledlayout.hpp>
 #include <eepp/ui/uieventdispatcher.hpp>
 #include <eepp/ui/uiiconthememanager.hpp>
 #include <eepp/ui/uilayout.hpp>
@@ -307,6 +310,180 @@ std::vector<UIWidget*> UISceneNode::loadNode( pugi::xml_node node, Node* parent,
 	return rootWidgets;
 }
 
+std::vector<UIWidget*>
+UISceneNode::loadCompiledNode( const UICompiledLayout& layout, const Uint32& begin,
+							   const Uint32& end, Node* parent, const Uint32& marker,
+							   UnorderedMap<Uint32, std::function<UIWidget*()>>& creators ) {
+	std::vector<UIWidget*> rootWidgets;
+	const auto& elements = layout.getElements();
+
+	if ( NULL == parent )
+		parent = this;
+
+	// Tag names are resolved only once per load.
+	auto getCreator = [&layout, &creators]( const Uint32& tag ) -> std::function<UIWidget*()>& {
+		auto it = creators.find( tag );
+		if ( it == creators.end() )
+			it = creators
+					 .insert( { tag, UIWidgetCreator::getWidgetCreator( layout.getString( tag ) ) } )
+					 .first;
+		return it->second;
+	};
+
+	for ( Uint32 i = begin; i < end; i += elements[i].subtreeSize + 1 ) {
+		const UICompiledLayout::Element& element = elements[i];
+		auto& creator = getCreator( element.tag );
+		UIWidget* uiwidget = creator ? creator() : NULL;
+		Uint32 childsEnd = i + element.subtreeSize + 1;
+
+		if ( NULL != uiwidget ) {
+			rootWidgets.push_back( uiwidget );
+
+			uiwidget->setParent( parent );
+
+			// Only the widgets that just apply the attributes skip the XML node, any other
+			// widget ( custom ones included ) receives a XML node rebuilt from the compiled
+			// element in its loadFromXmlNode.
+			bool needsXmlNode = element.text != UICompiledLayout::NoString ||
+								!uiwidget->loadsOnlyXmlAttributes();
+
+			for ( Uint32 child = i + 1; child < childsEnd && !needsXmlNode;
+				  child += elements[child].subtreeSize + 1 ) {
+				needsXmlNode = !getCreator( elements[child].tag ) &&
+							   String::toLower( layout.getString( elements[child].tag ) ) != "style";
+			}
+
+			if ( needsXmlNode ) {
+				pugi::xml_document doc;
+				layout.toXml( i, doc );
+				uiwidget->loadFromXmlNode( doc.first_child() );
+			} else {
+				uiwidget->loadFromCompiledLayout( layout, i );
+			}
+
+			if ( element.subtreeSize )
+				loadCompiledNode( layout, i + 1, childsEnd, uiwidget, marker, creators );
+
+			uiwidget->onWidgetCreated();
+		} else if ( String::toLower( layout.getString( element.tag ) ) == "style" &&
+					element.text != UICompiledLayout::NoString ) {
+			CSS::StyleSheetParser parser;
+
+			if ( parser.loadFromString( std::string_view{ layout.getString( element.text ) } ) ) {
+				parser.getStyleSheet().setMarker( marker );
+				combineStyleSheet( parser.getStyleSheet(), false );
+			}
+		}
+	}
+
+	return rootWidgets;
+}
+
+UIWidget* UISceneNode::loadLayoutFromCompiled( const UICompiledLayout& layout, Node* parent,
+											   const Uint32& marker ) {
+	if ( layout.isEmpty() )
+		return NULL;
+
+	Clock clock;
+	UISceneNode* prevUISceneNode = SceneManager::instance()->getUISceneNode();
+	SceneManager::instance()->setCurrentUISceneNode( this );
+	mIsLoading = true;
+
+	UnorderedMap<Uint32, std::function<UIWidget*()>> creators;
+	std::vector<UIWidget*> widgets =
+		loadCompiledNode( layout, 0, static_cast<Uint32>( layout.getElements().size() ),
+						  NULL != parent ? parent : this, marker, creators );
+
+	for ( auto& widget : widgets )
+		widget->reloadStyle( true, true, true );
+
+	mIsLoading = false;
+	SceneManager::instance()->setCurrentUISceneNode( prevUISceneNode );
+
+	if ( mVerbose ) {
+		Log::debug( "UISceneNode::loadLayoutFromCompiled loaded in: %.2f ms",
+					clock.getElapsedTime().asMilliseconds() );
+	}
+
+	return widgets.empty() ? NULL : widgets[0];
+}
+
+void UISceneNode::setLayoutCacheEnabled( bool enabled ) {
+	mLayoutCacheEnabled = enabled;
+}
+
+bool UISceneNode::isLayoutCacheEnabled() const {
+	return mLayoutCacheEnabled;
+}
+
+void UISceneNode::setLayoutCachePath( const std::string& path ) {
+	mLayoutCachePath = path;
+
+	if ( !mLayoutCachePath.empty() ) {
+		FileSystem::dirAddSlashAtEnd( mLayoutCachePath );
+
+		if ( !FileSystem::fileExists( mLayoutCachePath ) )
+			FileSystem::makeDir( mLayoutCachePath, true );
+	}
+}
+
+const std::string& UISceneNode::getLayoutCachePath() const {
+	return mLayoutCachePath;
+}
+
+void UISceneNode::clearLayoutCache() {
+	mLayoutCache.clear();
+}
+
+std::shared_ptr<UICompiledLayout> UISceneNode::getCompiledLayout( const char* buffer,
+																   size_t bufferSize ) {
+	MD5::Result hash( MD5::fromMemory( (const Uint8*)buffer, bufferSize ) );
+	std::string key( hash.toHexString() );
+
+	auto it = mLayoutCache.find( key );
+
+	if ( it != mLayoutCache.end() )
+		return it->second;
+
+	auto layout = std::make_shared<UICompiledLayout>();
+	std::string cachePath;
+
+	if ( !mLayoutCachePath.empty() ) {
+		cachePath = mLayoutCachePath + key + ".eecl";
+
+		if ( layout->loadFromFile( cachePath ) && layout->getSourceHash() == hash.digest ) {
+			mLayoutCache[key] = layout;
+			return layout;
+		}
+	}
+
+	pugi::xml_document doc;
+	pugi::xml_parse_result result = doc.load_buffer( buffer, bufferSize );
+
+	if ( !result ) {
+		Log::error( "Couldn't compile UI Layout" );
+		Log::error( "Error description: %s", result.description() );
+		Log::error( "Error offset: %d", result.offset );
+		return nullptr;
+	}
+
+	*layout = UICompiledLayout::compile( doc.first_child() );
+	layout->setSourceHash( hash.digest );
+
+	if ( !cachePath.empty() && !layout->saveToFile( cachePath ) )
+		Log::warning( "Couldn't write compiled UI Layout cache: %s", cachePath.c_str() );
+
+	mLayoutCache[key] = layout;
+
+	return layout;
+}
+
+UIWidget* UISceneNode::loadLayoutFromCache( const char* buffer, size_t bufferSize, Node* parent,
+											const Uint32& marker ) {
+	std::shared_ptr<UICompiledLayout> layout( getCompiledLayout( buffer, bufferSize ) );
+	return layout ? loadLayoutFromCompiled( *layout, parent, marker ) : NULL;
+}
+
 UIWidget* UISceneNode::loadLayoutNodes( pugi::xml_node node, Node* parent, const Uint32& marker ) {
 	Clock clock;
 	UISceneNode* prevUISceneNode = SceneManager::instance()->getUISceneNode();
@@ -426,6 +603,15 @@ void UISceneNode::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool )
 UIWidget* UISceneNode::loadLayoutFromFile( const std::string& layoutPath, Node* parent,
 										   const Uint32& marker ) {
 	if ( FileSystem::fileExists( layoutPath ) ) {
+		if ( mLayoutCacheEnabled ) {
+			std::string data;
+			if ( !FileSystem::fileGet( layoutPath, data ) ) {
+				Log::error( "Couldn't load UI Layout: %s", layoutPath.c_str() );
+				return NULL;
+			}
+			return loadLayoutFromCache( data.data(), data.size(), parent, marker );
+		}
+
 		pugi::xml_document doc;
 		pugi::xml_parse_result result = doc.load_file( layoutPath.c_str() );
 
@@ -450,6 +636,9 @@ UIWidget* UISceneNode::loadLayoutFromFile( const std::string& layoutPath, Node*
 
 UIWidget* UISceneNode::loadLayoutFromString( const char* layoutString, Node* parent,
 											 const Uint32& marker ) {
+	if ( mLayoutCacheEnabled )
+		return loadLayoutFromCache( layoutString, strlen( layoutString ), parent, marker );
+
 	pugi::xml_document doc;
 	pugi::xml_parse_result result = doc.load_string( layoutString );
 
@@ -471,6 +660,9 @@ UIWidget* UISceneNode::loadLayoutFromString( const std::string& layoutString, No
 
 UIWidget* UISceneNode::loadLayoutFromMemory( const void* buffer, Int32 bufferSize, Node* parent,
 											 const Uint32& marker ) {
+	if ( mLayoutCacheEnabled )
+		return loadLayoutFromCache( (const char*)buffer, bufferSize, parent, marker );
+
 	pugi::xml_document doc;
 	pugi::xml_parse_result result = doc.load_buffer( buffer, bufferSize );
 
@@ -494,6 +686,9 @@ UIWidget* UISceneNode::loadLayoutFromStream( IOStream& stream, Node* parent,
 	TScopedBuffer<char> scopedBuffer( bufferSize );
 	stream.read( scopedBuffer.get(), scopedBuffer.length() );
 
+	if ( mLayoutCacheEnabled )
+		return loadLayoutFromCache( scopedBuffer.get(), scopedBuffer.length(), parent, marker );
+
 	pugi::xml_document doc;
 	pugi::xml_parse_result result = doc.load_buffer( scopedBuffer.get(), scopedBuffer.length() );
 
@@ -772,6 +967,7 @@ void UISceneNode::setIsLoading( bool isLoading ) {
 
 void UISceneNode::updateDirtyLayouts() {
 	if ( !mDirtyLayouts.empty() ) {
+		AllocationProfiler::Zone zone( "UISceneNode::updateDirtyLayouts" );
 		Clock clock;
 		mUpdatingLayouts = true;
 
@@ -789,6 +985,7 @@ void UISceneNode::updateDirtyLayouts() {
 
 void UISceneNode::updateDirtyStyles() {
 	if ( !mDirtyStyle.empty() ) {
+		AllocationProfiler::Zone zone( "UISceneNode::updateDirtyStyles" );
 		Clock clock;
 		for ( auto& node : mDirtyStyle ) {
 			node->reloadStyle( true, false, false );
@@ -802,6 +999,7 @@ void UISceneNode::updateDirtyStyles() {
 
 void UISceneNode::updateDirtyStyleStates() {
 	if ( !mDirtyStyleState.empty() ) {
+		AllocationProfiler::Zone zone( "UISceneNode::updateDirtyStyleStates" );
 		Clock clock;
 		for ( auto& node : mDirtyStyleState ) {
 			node->reportStyleStateChangeRecursive( mDirtyStyleStateCSSAnimations[node] );
@@ -1007,7 +1205,7 @@ void UISceneNode::setInternalPixelsSize( const Sizef& size ) {
 	if ( s != mSize ) {
 		mDpSize = PixelDensity::pxToDp( s ).ceil();
 		mSize = s;
-		mNodeFlags |= NODE_FLAG_POLYGON_DIRTY;
+		setPolygonDirty();
 		updateCenter();
 		sendCommonEvent( Event::OnSizeChange );
 		invalidateDraw();
@@ -1098,4 +1296,69 @@ void UISceneNode::setMaxInvalidationDepth( const Uint32& maxInvalidationDepth )
 	mMaxInvalidationDepth = maxInvalidationDepth;
 }
 
+void UISceneNode::draw() {
+	mRenderLayersHits = 0;
+	mRenderLayersMisses = 0;
+
+	SceneNode::draw();
+}
+
+void UISceneNode::invalidate( Node* invalidator ) {
+	// A render layer that invalidates its own drawing must also redraw its frame buffer.
+	if ( NULL != invalidator && invalidator != this && invalidator->isWidget() )
+		static_cast<UIWidget*>( invalidator )->invalidateRenderLayer();
+
+	SceneNode::invalidate( invalidator );
+}
+
+void UISceneNode::setRenderLayersMemoryBudget( const size_t& budget ) {
+	mRenderLayersMemoryBudget = budget;
+}
+
+const size_t& UISceneNode::getRenderLayersMemoryBudget() const {
+	return mRenderLayersMemoryBudget;
+}
+
+const size_t& UISceneNode::getRenderLayersMemoryUsage() const {
+	return mRenderLayersMemoryUsage;
+}
+
+const Uint32& UISceneNode::getRenderLayersHits() const {
+	return mRenderLayersHits;
+}
+
+const Uint32& UISceneNode::getRenderLayersMisses() const {
+	return mRenderLayersMisses;
+}
+
+void UISceneNode::setHighlightRenderLayers( bool highlight ) {
+	if ( highlight != mHighlightRenderLayers ) {
+		mHighlightRenderLayers = highlight;
+		invalidateDraw();
+	}
+}
+
+bool UISceneNode::getHighlightRenderLayers() const {
+	return mHighlightRenderLayers;
+}
+
+bool UISceneNode::requestRenderLayerMemory( const size_t& size ) {
+	if ( mRenderLayersMemoryUsage + size > mRenderLayersMemoryBudget )
+		return false;
+	mRenderLayersMemoryUsage += size;
+	return true;
+}
+
+void UISceneNode::releaseRenderLayerMemory( const size_t& size ) {
+	mRenderLayersMemoryUsage -= eemin( size, mRenderLayersMemoryUsage );
+}
+
+void UISceneNode::onRenderLayerDraw( bool cacheHit ) {
+	if ( cacheHit ) {
+		mRenderLayersHits++;
+	} else {
+		mRenderLayersMisses++;
+	}
+}
+
 }} // namespace EE::UI
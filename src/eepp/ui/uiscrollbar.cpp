@@ -83,6 +83,10 @@ bool UIScrollBar::isType( const Uint32& type ) const {
 	return UIScrollBar::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UIScrollBar::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UIScrollBar::setTheme( UITheme* Theme ) {
 	UIWidget::setTheme( Theme );
 
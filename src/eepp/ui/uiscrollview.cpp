@@ -45,6 +45,10 @@ bool UIScrollView::isType( const Uint32& type ) const {
 	return UIScrollView::getType() == type ? true : UITouchDraggableWidget::isType( type );
 }
 
+bool UIScrollView::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UIScrollView::onSizeChange() {
 	containerUpdate();
 	UIWidget::onSizeChange();
@@ -99,6 +99,10 @@ bool UISlider::isType( const Uint32& type ) const {
 	return UISlider::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UISlider::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UISlider::setTheme( UITheme* Theme ) {
 	UIWidget::setTheme( Theme );
 
@@ -33,6 +33,10 @@ bool UISprite::isType( const Uint32& type ) const {
 	return UISprite::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UISprite::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 Uint32 UISprite::deallocSprite() {
 	return mNodeFlags & NODE_FLAG_FREE_USE;
 }
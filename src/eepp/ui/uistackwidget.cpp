@@ -44,6 +44,10 @@ UIWidget* UIStackWidget::getActiveWidget() const {
 	return mActiveWidget;
 }
 
+bool UIStackWidget::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UIStackWidget::onSizeChange() {
 	UIWidget::onSizeChange();
 	if ( mActiveWidget )
@@ -31,6 +31,10 @@ bool UITextureRegion::isType( const Uint32& type ) const {
 	return UITextureRegion::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UITextureRegion::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 UITextureRegion* UITextureRegion::setTextureRegion( Graphics::TextureRegion* TextureRegion ) {
 	mTextureRegion = TextureRegion;
 
@@ -74,6 +74,10 @@ bool UITextView::isType( const Uint32& type ) const {
 	return UITextView::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UITextView::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UITextView::draw() {
 	if ( mVisible && 0.f != mAlpha ) {
 		UINode::draw();
@@ -49,6 +49,10 @@ bool UIViewPager::isType( const Uint32& type ) const {
 	return UIViewPager::getType() == type ? true : UIWidget::isType( type );
 }
 
+bool UIViewPager::loadsOnlyXmlAttributes() const {
+	return true;
+}
+
 void UIViewPager::onChildCountChange( Node* child, const bool& removed ) {
 	if ( !removed && child != mContainer ) {
 		child->setParent( mContainer );
@@ -1,4 +1,9 @@
 #include <algorithm>
+#include <eepp/graphics/framebuffer.hpp>
+#include <eepp/graphics/globalbatchrenderer.hpp>
+#include <eepp/graphics/primitives.hpp>
+#include <eepp/graphics/renderer/renderer.hpp>
+#include <eepp/graphics/textureregion.hpp>
 #include <eepp/scene/actions/actions.hpp>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/ui/css/shorthanddefinition.hpp>
@@ -7,6 +12,7 @@
 #include <eepp/ui/css/stylesheetspecification.hpp>
 #include <eepp/ui/css/transitiondefinition.hpp>
 #include <eepp/ui/uiborderdrawable.hpp>
+#include <eepp/ui/uicompiledlayout.hpp>
 #include <eepp/ui/uieventdispatcher.hpp>
 #include <eepp/ui/uinodedrawable.hpp>
 #include <eepp/ui/uiscenenode.hpp>
@@ -68,6 +74,13 @@ UIWidget::~UIWidget() {
 		mUISceneNode->onWidgetDelete( this );
 	eeSAFE_DELETE( mStyle );
 	eeSAFE_DELETE( mTooltip );
+
+	if ( NULL != mRenderLayer ) {
+		eeSAFE_DELETE( mRenderLayer );
+
+		if ( NULL != mUISceneNode )
+			mUISceneNode->releaseRenderLayerMemory( mRenderLayerMemory );
+	}
 }
 
 Uint32 UIWidget::getType() const {
@@ -541,6 +554,11 @@ void UIWidget::onSizeChange() {
 	if ( mForeground != NULL )
 		mForeground->invalidate();
 
+	if ( mRenderLayerEnabled ) {
+		mRenderLayerFailed = false;
+		createRenderLayer();
+	}
+
 	notifyLayoutAttrChange();
 }
 
@@ -1396,7 +1414,8 @@ std::vector<PropertyId> UIWidget::getPropertiesImplemented() const {
 			 PropertyId::BorderSmooth,
 			 PropertyId::BackgroundSmooth,
 			 PropertyId::Focusable,
-			 PropertyId::ForegroundSmooth };
+			 PropertyId::ForegroundSmooth,
+			 PropertyId::RenderLayer };
 }
 
 std::string UIWidget::getPropertyString( const std::string& property ) const {
@@ -1555,6 +1574,8 @@ std::string UIWidget::getPropertyString( const PropertyDefinition* propertyDef,
 					   : "false";
 		case PropertyId::Focusable:
 			return isTabFocusable() ? "true" : "false";
+		case PropertyId::RenderLayer:
+			return isRenderLayer() ? "true" : "false";
 		default:
 			break;
 	}
@@ -1967,6 +1988,9 @@ bool UIWidget::applyProperty( const StyleSheetProperty& attribute ) {
 				unsetFlags( UI_TAB_FOCUSABLE );
 			}
 			break;
+		case PropertyId::RenderLayer:
+			setRenderLayer( attribute.asBool() );
+			break;
 		default:
 			attributeSet = false;
 			break;
@@ -1980,28 +2004,59 @@ void UIWidget::loadFromXmlNode( const pugi::xml_node& node ) {
 
 	for ( pugi::xml_attribute_iterator ait = node.attributes_begin(); ait != node.attributes_end();
 		  ++ait ) {
-		// Create a property without triming its value
-		StyleSheetProperty prop( ait->name(), ait->value(), false,
-								 StyleSheetSelectorRule::SpecificityInline );
+		loadInlineAttribute( ait->name(), ait->value() );
+	}
 
-		if ( prop.getShorthandDefinition() != NULL ) {
-			auto properties = prop.getShorthandDefinition()->parse( ait->value() );
+	endAttributesTransaction();
+}
 
-			for ( auto& property : properties ) {
-				if ( NULL != mStyle )
-					mStyle->setStyleSheetProperty( property );
-				applyProperty( property );
-			}
+bool UIWidget::loadsOnlyXmlAttributes() const {
+	return false;
+}
+
+void UIWidget::loadFromCompiledLayout( const UICompiledLayout& layout,
+									   const Uint32& elementIndex ) {
+	const UICompiledLayout::Element& element = layout.getElements()[elementIndex];
+	const auto& attributes = layout.getAttributes();
+
+	beginAttributesTransaction();
+
+	for ( Uint32 i = element.firstAttribute; i < element.firstAttribute + element.attributeCount;
+		  ++i ) {
+		const auto& properties = layout.getProperties( i );
+
+		if ( properties.empty() ) {
+			loadInlineAttribute( layout.getString( attributes[i].name ),
+								 layout.getString( attributes[i].value ) );
 		} else {
-			if ( NULL != mStyle )
-				mStyle->setStyleSheetProperty( prop );
-			applyProperty( prop );
+			for ( const auto& property : properties )
+				loadInlineProperty( property );
 		}
 	}
 
 	endAttributesTransaction();
 }
 
+void UIWidget::loadInlineAttribute( const std::string& name, const std::string& value ) {
+	// Create a property without triming its value
+	StyleSheetProperty prop( name, value, false, StyleSheetSelectorRule::SpecificityInline );
+
+	if ( prop.getShorthandDefinition() != NULL ) {
+		auto properties = prop.getShorthandDefinition()->parse( value );
+
+		for ( auto& property : properties )
+			loadInlineProperty( property );
+	} else {
+		loadInlineProperty( prop );
+	}
+}
+
+void UIWidget::loadInlineProperty( const StyleSheetProperty& property ) {
+	if ( NULL != mStyle )
+		mStyle->setStyleSheetProperty( property );
+	applyProperty( property );
+}
+
 std::string UIWidget::getLayoutWidthPolicyString() const {
 	SizePolicy rules = getLayoutWidthPolicy();
 
@@ -2263,4 +2318,210 @@ void UIWidget::onFocusNextWidget() {
 	}
 }
 
+void UIWidget::setRenderLayer( bool renderLayer ) {
+	if ( renderLayer == mRenderLayerEnabled || isType( UI_TYPE_WINDOW ) ||
+		 isType( UI_TYPE_TABWIDGET ) )
+		return;
+
+	mRenderLayerEnabled = renderLayer;
+	mRenderLayerFailed = false;
+
+	if ( mRenderLayerEnabled ) {
+		createRenderLayer();
+	} else {
+		destroyRenderLayer();
+	}
+
+	invalidateDraw();
+}
+
+bool UIWidget::isRenderLayer() const {
+	return mRenderLayerEnabled;
+}
+
+FrameBuffer* UIWidget::getRenderLayerFrameBuffer() const {
+	return mRenderLayer;
+}
+
+bool UIWidget::isDrawInvalidator() const {
+	return NULL != mRenderLayer;
+}
+
+void UIWidget::invalidate( Node* invalidator ) {
+	if ( NULL != mRenderLayer ) {
+		writeNodeFlag( NODE_FLAG_VIEW_DIRTY, 1 );
+
+		// A nested layer that invalidates its own drawing reaches its parent layer.
+		if ( NULL != invalidator && invalidator != this && invalidator->isWidget() )
+			static_cast<UIWidget*>( invalidator )->invalidateRenderLayer();
+
+		if ( NULL != mNodeDrawInvalidator && mNodeDrawInvalidator != this )
+			mNodeDrawInvalidator->invalidate( this );
+	} else {
+		UINode::invalidate( invalidator );
+	}
+}
+
+void UIWidget::invalidateRenderLayer() {
+	if ( NULL != mRenderLayer )
+		writeNodeFlag( NODE_FLAG_VIEW_DIRTY, 1 );
+}
+
+static size_t getRenderLayerMemorySize( const Sizei& size ) {
+	// RGBA texture plus the stencil buffer.
+	return static_cast<size_t>( size.getWidth() ) * static_cast<size_t>( size.getHeight() ) * 5;
+}
+
+void UIWidget::createRenderLayer() {
+	if ( NULL == mUISceneNode )
+		return;
+
+	Sizei size( eemax( 1, (int)eeceil( mSize.getWidth() ) ),
+				eemax( 1, (int)eeceil( mSize.getHeight() ) ) );
+
+	if ( NULL != mRenderLayer && mRenderLayer->getSize() == size )
+		return;
+
+	size_t memory = getRenderLayerMemorySize( size );
+
+	mUISceneNode->releaseRenderLayerMemory( mRenderLayerMemory );
+	mRenderLayerMemory = 0;
+
+	if ( !mUISceneNode->requestRenderLayerMemory( memory ) ) {
+		// Retried on the next resize or draw, memory may have been released by then.
+		destroyRenderLayer();
+		return;
+	}
+
+	mRenderLayerMemory = memory;
+
+	if ( NULL != mRenderLayer ) {
+		mRenderLayer->resize( size.getWidth(), size.getHeight() );
+	} else {
+		mRenderLayer = FrameBuffer::New( size.getWidth(), size.getHeight(), true, false, false, 4,
+										 mUISceneNode->getWindow() );
+
+		// Frame buffer failed to create? Don't retry until the size changes.
+		if ( NULL == mRenderLayer || !mRenderLayer->created() ) {
+			destroyRenderLayer();
+			mRenderLayerFailed = true;
+			return;
+		}
+
+		writeNodeFlag( NODE_FLAG_FRAME_BUFFER, 1 );
+		updateDrawInvalidator( true );
+	}
+
+	writeNodeFlag( NODE_FLAG_VIEW_DIRTY, 1 );
+}
+
+void UIWidget::destroyRenderLayer() {
+	bool hadRenderLayer = NULL != mRenderLayer;
+
+	eeSAFE_DELETE( mRenderLayer );
+
+	if ( NULL != mUISceneNode )
+		mUISceneNode->releaseRenderLayerMemory( mRenderLayerMemory );
+
+	mRenderLayerMemory = 0;
+
+	if ( hadRenderLayer ) {
+		writeNodeFlag( NODE_FLAG_FRAME_BUFFER, 0 );
+		updateDrawInvalidator( true );
+	}
+}
+
+void UIWidget::nodeDraw() {
+	if ( mRenderLayerEnabled && NULL == mRenderLayer && !mRenderLayerFailed && mVisible )
+		createRenderLayer();
+
+	if ( NULL == mRenderLayer ) {
+		UINode::nodeDraw();
+		return;
+	}
+
+	if ( !mVisible )
+		return;
+
+	if ( mNodeFlags & NODE_FLAG_POSITION_DIRTY )
+		updateScreenPos();
+
+	if ( mNodeFlags & NODE_FLAG_POLYGON_DIRTY )
+		updateWorldPolygon();
+
+	// A position change can bring into the viewport childs that weren't drawn in the layer.
+	bool cacheHit = NULL != mSceneNode && mSceneNode->usesInvalidation() &&
+					!( mNodeFlags & NODE_FLAG_VIEW_DIRTY ) && mRenderLayerPos == mScreenPosi;
+
+	if ( !cacheHit ) {
+		ClippingMask* clippingMask = GLi->getClippingMask();
+		std::vector<Rectf> scissors( clippingMask->getScissorsClipped() );
+		std::vector<Rectf> planes( clippingMask->getPlanesClipped() );
+
+		GlobalBatchRenderer::instance()->draw();
+
+		// The parent clipping is in screen coordinates, it's applied when the layer is drawn.
+		if ( !scissors.empty() )
+			clippingMask->setScissorsClipped( {} );
+
+		if ( !planes.empty() )
+			clippingMask->setPlanesClipped( {} );
+
+		mRenderLayer->bind();
+
+		mRenderLayer->clear();
+
+		GLi->pushMatrix();
+		GLi->translatef( -mScreenPosi.x, -mScreenPosi.y, 0.f );
+
+		UINode::nodeDraw();
+
+		GlobalBatchRenderer::instance()->draw();
+
+		GLi->popMatrix();
+
+		mRenderLayer->unbind();
+
+		if ( !scissors.empty() )
+			clippingMask->setScissorsClipped( scissors );
+
+		if ( !planes.empty() )
+			clippingMask->setPlanesClipped( planes );
+
+		mRenderLayerPos = mScreenPosi;
+
+		writeNodeFlag( NODE_FLAG_VIEW_DIRTY, 0 );
+	}
+
+	drawRenderLayer();
+
+	mUISceneNode->onRenderLayerDraw( cacheHit );
+
+	if ( mUISceneNode->getHighlightRenderLayers() ) {
+		Primitives P;
+		P.setFillMode( DRAW_LINE );
+		P.setBlendMode( getBlendMode() );
+		P.setColor( cacheHit ? Color::Green : Color::Red );
+		P.setLineWidth( PixelDensity::dpToPx( 1 ) );
+		P.drawRectangle( getScreenBounds() );
+	}
+}
+
+void UIWidget::drawRenderLayer() {
+	Rect r( 0, 0, mSize.getWidth(), mSize.getHeight() );
+	TextureRegion textureRegion( mRenderLayer->getTexture(), r, r.getSize().asFloat() );
+	textureRegion.draw( mScreenPosi.x, mScreenPosi.y, Color::White, getRotation(), getScale() );
+}
+
+void UIWidget::matrixSet() {
+	// The rotation and scale of a render layer are applied when the layer is drawn.
+	if ( NULL == mRenderLayer )
+		UINode::matrixSet();
+}
+
+void UIWidget::matrixUnset() {
+	if ( NULL == mRenderLayer )
+		UINode::matrixUnset();
+}
+
 }} // namespace EE::UI
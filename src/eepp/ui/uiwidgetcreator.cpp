@@ -136,6 +136,27 @@ UIWidget* UIWidgetCreator::createFromName( const std::string& widgetName ) {
 	return NULL;
 }
 
+UIWidgetCreator::RegisterWidgetCb
+UIWidgetCreator::getWidgetCreator( const std::string& widgetName ) {
+	createBaseWidgetList();
+
+	std::string lwidgetName( String::toLower( widgetName ) );
+
+	auto registeredIt = registeredWidget.find( lwidgetName );
+
+	if ( registeredIt != registeredWidget.end() )
+		return registeredIt->second;
+
+	auto callbackIt = widgetCallback.find( lwidgetName );
+
+	if ( callbackIt != widgetCallback.end() ) {
+		CustomWidgetCb cb( callbackIt->second );
+		return [cb, lwidgetName]() { return cb( lwidgetName ); };
+	}
+
+	return {};
+}
+
 void UIWidgetCreator::addCustomWidgetCallback( const std::string& widgetName,
 											   const UIWidgetCreator::CustomWidgetCb& cb ) {
 	widgetCallback[String::toLower( widgetName )] = cb;
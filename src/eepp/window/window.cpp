@@ -1,4 +1,5 @@
 #include <SOIL2/src/SOIL2/SOIL2.h>
+#include <eepp/core/allocationprofiler.hpp>
 #include <eepp/graphics/globalbatchrenderer.hpp>
 #include <eepp/graphics/renderer/openglext.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
@@ -422,6 +423,9 @@ void Window::display( bool clear ) {
 
 	calculateFps();
 
+	if ( AllocationProfiler::isEnabled() )
+		AllocationProfiler::endFrame();
+
 	mFrameData.FPS.RenderClock.restart();
 }
 
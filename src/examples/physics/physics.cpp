@@ -552,6 +552,75 @@ void demo4Destroy() {
 	destroyDemo();
 }
 
+std::shared_ptr<ThreadPool> mStepPool;
+Clock mStepClock;
+Time mStepTime;
+
+void demo5Create() {
+	PhysicsManager::DrawSpaceOptions* DSO = PhysicsManager::instance()->getDrawOptions();
+	DSO->DrawBBs = false;
+	DSO->DrawShapes = true;
+	DSO->DrawShapesBorders = false;
+	DSO->CollisionPointSize = 0;
+	DSO->BodyPointSize = 0;
+	DSO->LineThickness = 0;
+
+	createJointAndBody();
+
+	mWindow->setTitle( "eepp - Physics - 10000 bodies stepped in parallel" );
+
+	Shape::resetShapeIdCounter();
+
+	mSpace = Space::New();
+	mSpace->setIterations( 5 );
+	mSpace->setGravity( cVectNew( 0, 100 ) );
+
+	// Every platform holds an independent pile of bodies, the piles are solved in parallel
+	if ( !mStepPool )
+		mStepPool = ThreadPool::createShared( eemax( 2u, std::thread::hardware_concurrency() ) );
+
+	mSpace->setThreadPool( mStepPool );
+
+	Body* statiBody = mSpace->getStaticBody();
+	int piles = 50;
+	cpFloat pileWidth = mWindow->getWidth() / (cpFloat)( piles / 2 );
+
+	for ( int p = 0; p < piles; p++ ) {
+		cpFloat x = ( p % ( piles / 2 ) ) * pileWidth;
+		cpFloat y = ( p < piles / 2 ? mWindow->getHeight() / 2 : mWindow->getHeight() ) - 8;
+
+		Shape* shape = mSpace->addShape( ShapeSegment::New(
+			statiBody, cVectNew( x + 2, y ), cVectNew( x + pileWidth - 2, y ), 0.0f ) );
+		shape->setU( 1.0f );
+		shape->setLayers( NOT_GRABABLE_MASK );
+
+		for ( int i = 0; i < 200; i++ ) {
+			Body* body = mSpace->addBody( Body::New( 1.0f, Moment::forBox( 1.0f, 4.0f, 4.0f ) ) );
+			body->setPos(
+				cVectNew( x + 6 + ( i % 6 ) * 6 + ( i / 6 ) % 2 * 2, y - 3 - ( i / 6 ) * 5 ) );
+
+			shape = mSpace->addShape( ShapePoly::New( body, 4.0f, 4.0f ) );
+			shape->setU( 0.8f );
+		}
+	}
+
+	mStepTime = Time::Zero;
+}
+
+void demo5Update() {
+	if ( mStepClock.getElapsedTime() >= Seconds( 1 ) ) {
+		mWindow->setTitle( String::format( "eepp - Physics - 10000 bodies stepped in parallel ( "
+										   "%u threads ): %s per step",
+										   mStepPool->numThreads(),
+										   mStepTime.toString().c_str() ) );
+		mStepClock.restart();
+	}
+}
+
+void demo5Destroy() {
+	destroyDemo();
+}
+
 void ChangeDemo( int num ) {
 	if ( num >= 0 && num < (int)mDemo.size() && num != mCurDemo ) {
 		if ( (int)eeINDEX_NOT_FOUND != mCurDemo )
@@ -592,6 +661,11 @@ void physicsCreate() {
 	demo.destroy = &demo4Destroy;
 	mDemo.push_back( demo );
 
+	demo.init = &demo5Create;
+	demo.update = &demo5Update;
+	demo.destroy = &demo5Destroy;
+	mDemo.push_back( demo );
+
 	ChangeDemo( 0 );
 }
 
@@ -624,7 +698,11 @@ void physicsUpdate() {
 	}
 
 	mDemo[mCurDemo].update();
+
+	Clock stepClock;
 	mSpace->update();
+	mStepTime = stepClock.getElapsedTime();
+
 	mSpace->draw();
 }
 
@@ -45,6 +45,14 @@ class IPseudoTerminal : public eterm::System::IPipe {
 	virtual int getNumRows() const = 0;
 
 	virtual bool resize( int columns, int rows ) = 0;
+
+	/** Blocks until there is data to read, wakeUp() is called or timeoutMs elapses ( a negative
+	 * timeout waits indefinitely ).
+	 * @return False if the pseudo terminal can't be waited on ( i.e. it was hung up ) */
+	virtual bool waitForData( int timeoutMs = -1 ) = 0;
+
+	/** Makes the thread blocked in waitForData() return */
+	virtual void wakeUp() = 0;
 };
 
 }} // namespace eterm::Terminal
@@ -21,6 +21,7 @@
 //  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
 //  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 //  DEALINGS IN THE SOFTWARE.
+#include <atomic>
 #include <eepp/math/vector2.hpp>
 #include <eterm/system/autohandle.hpp>
 #include <eterm/terminal/ipseudoterminal.hpp>
@@ -58,6 +59,10 @@ class PseudoTerminal final : public IPseudoTerminal {
 	virtual int write( const char* s, size_t n ) override;
 	virtual int read( char* buf, size_t n, bool block = false ) override;
 
+	virtual bool waitForData( int timeoutMs = -1 ) override;
+
+	virtual void wakeUp() override;
+
 	static std::unique_ptr<PseudoTerminal> create( int columns, int rows );
 
   private:
@@ -70,6 +75,7 @@ class PseudoTerminal final : public IPseudoTerminal {
 	void* mPHPC;
 
 	bool mAttached;
+	std::atomic<bool> mWakeUp{ false };
 
 	PseudoTerminal( int columns, int rows, AutoHandle&& hInput, AutoHandle&& hOutput, void* hPC );
 #else
@@ -78,6 +84,8 @@ class PseudoTerminal final : public IPseudoTerminal {
 
 	AutoHandle mMaster;
 	AutoHandle mSlave;
+	AutoHandle mWakeUpRead;
+	AutoHandle mWakeUpWrite;
 
 	PseudoTerminal( int columns, int rows, AutoHandle&& master, AutoHandle&& slave );
 #endif
@@ -35,15 +35,21 @@
 //  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
 //  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 //  DEALINGS IN THE SOFTWARE.
+#include <atomic>
 #include <eepp/math/vector2.hpp>
+#include <eepp/system/mutex.hpp>
 #include <eepp/window/keycodes.hpp>
 #include <eterm/system/iprocess.hpp>
 #include <eterm/terminal/ipseudoterminal.hpp>
 #include <eterm/terminal/iterminaldisplay.hpp>
+#include <eterm/terminal/terminalhistory.hpp>
 #include <eterm/terminal/terminaltypes.hpp>
+#include <functional>
 #include <memory>
 #include <stdint.h>
 #include <sys/types.h>
+#include <thread>
+#include <vector>
 
 using namespace EE;
 using namespace EE::Math;
@@ -63,10 +69,7 @@ struct Term {
 	int col{ 0 };				   /* nb col */
 	Line* line{ nullptr };		   /* screen */
 	Line* alt{ nullptr };		   /* alternate screen */
-	Line* hist{ nullptr };		   /* history buffer */
-	int histcursize{ 0 };		   /* history current size */
-	int histsize{ 0 };			   /* history max size */
-	int histi{ 0 };				   /* history index */
+	TerminalHistory hist;		   /* history buffer */
 	int scr{ 0 };				   /* scroll back */
 	int* dirty{ nullptr };		   /* dirtyness of lines */
 	TerminalCursor c{};			   /* cursor */
@@ -166,6 +169,13 @@ class TerminalEmulator final {
 
 	int getHistorySize() const;
 
+	/** Searches the scrollback, the matched rows are history rows ( 0 is the newest ). */
+	std::vector<TerminalHistory::Match> searchHistory( const std::string& pattern,
+													   bool caseSensitive = true ) const;
+
+	/** @return The memory used by the compressed scrollback in bytes. */
+	size_t getHistoryMemoryUsage() const;
+
 	int write( const char* buf, size_t buflen );
 
 	void printscreen( const TerminalArg* );
@@ -227,6 +237,21 @@ class TerminalEmulator final {
 
 	Vector2i getSize() const;
 
+	/** Reads and parses the pseudoterminal output in a dedicated thread.
+	 * The UI thread only picks up the dirty lines on update(), so output arriving faster than the
+	 * display refresh gets coalesced into a single redraw. Display callbacks triggered by the
+	 * parser ( title, bell, clipboard, etc ) are deferred to the next update(). */
+	void setThreadedReader( bool threadedReader );
+
+	bool isThreadedReader() const;
+
+	/** @return The total number of bytes read from the pseudoterminal. */
+	Uint64 getBytesRead() const;
+
+	/** Locked by the reader thread while parsing. Hold it to access the screen from another
+	 * thread. */
+	EE::System::Mutex& getMutex();
+
   private:
 	DpyPtr mDpy;
 	PtyPtr mPty;
@@ -242,6 +267,16 @@ class TerminalEmulator final {
 	char mBuf[8192];
 	int mBuflen;
 
+	mutable EE::System::Mutex mMutex;
+	std::thread mReaderThread;
+	std::thread::id mReaderThreadId;
+	std::atomic<bool> mReaderRunning{ false };
+	std::atomic<bool> mReaderIdle{ true };
+	std::atomic<bool> mReaderFailed{ false };
+	std::atomic<Uint64> mBytesRead{ 0 };
+	EE::System::Mutex mDisplayEventsMutex;
+	std::vector<std::function<void( ITerminalDisplay& )>> mDisplayEvents;
+
 	Term mTerm;
 	TerminalSelection mSel;
 	CSIEscape mCsiescseq;
@@ -255,7 +290,6 @@ class TerminalEmulator final {
 	int mAllowAltScreen;
 	int mAllowWindowOps;
 
-	void resizeHistory();
 	void setClipboard( const char* str );
 
 	void loadColors();
@@ -292,6 +326,7 @@ class TerminalEmulator final {
 	void tnewline( int );
 	void tputtab( int );
 	void tputc( Rune );
+	void tputascii( const char*, int );
 	void treset();
 	void tscrollup( int, int, int );
 	void tscrolldown( int, int, int );
@@ -346,6 +381,18 @@ class TerminalEmulator final {
 
 	void trimMemory();
 
+	bool isReaderThread() const;
+
+	void startReaderThread();
+
+	void stopReaderThread();
+
+	void readerLoop();
+
+	void withDisplay( std::function<void( ITerminalDisplay& )> fn );
+
+	void flushDisplayEvents();
+
 	TerminalEmulator( PtyPtr&& pty, ProcPtr&& process,
 					  const std::shared_ptr<ITerminalDisplay>& display,
 					  const size_t& historySize = 1000 );
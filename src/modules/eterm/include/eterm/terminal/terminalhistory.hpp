@@ -0,0 +1,134 @@
+#ifndef ETERM_TERMINALHISTORY_HPP
+#define ETERM_TERMINALHISTORY_HPP
+
+#include <deque>
+#include <eterm/terminal/terminaltypes.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eterm { namespace Terminal {
+
+/**
+ * Scrollback storage of the terminal.
+ * Rows scrolled out of the screen are joined into logical lines ( following ATTR_WRAP ) and stored
+ * as UTF-8 text plus run-length attribute spans, grouped in chunks. Rows are only decompressed
+ * into glyphs when they are displayed, and they are reflowed when the number of columns changes.
+ */
+class TerminalHistory {
+  public:
+	struct Match {
+		int row;	/* history row, 0 is the newest */
+		int column; /* first cell */
+		int length; /* length in cells */
+	};
+
+	TerminalHistory() = default;
+
+	explicit TerminalHistory( int maxRows );
+
+	void setMaxRows( int maxRows );
+
+	int getMaxRows() const;
+
+	/** @return The number of rows at the current number of columns. */
+	int size() const;
+
+	bool empty() const;
+
+	void clear();
+
+	/** Appends a row scrolled out of the screen. A row ending with ATTR_WRAP continues in the next
+	 * pushed row. */
+	void push( const TerminalGlyph* row, int columns );
+
+	/** Removes the newest row. */
+	void pop();
+
+	/** @return The row ( 0 is the newest ) decompressed at the current number of columns.
+	 * The row is owned by a small cache, it's valid until the history is modified or until many
+	 * other rows are requested. */
+	Line getRow( int row ) const;
+
+	/** Reflows the logical lines to the new number of columns. */
+	void setColumns( int columns );
+
+	int getColumns() const;
+
+	/** Searches the UTF-8 pattern over the compressed lines ( case insensitive only for ASCII ).
+	 * @return The matches sorted from the oldest to the newest row. */
+	std::vector<Match> search( const std::string& pattern, bool caseSensitive = true ) const;
+
+	/** @return The approximate memory used by the compressed history in bytes. */
+	size_t getMemoryUsage() const;
+
+  protected:
+	struct Span {
+		uint32_t runes;
+		uint32_t fg;
+		uint32_t bg;
+		ushort mode;
+	};
+
+	struct LogicalLine {
+		uint32_t textOffset{ 0 };
+		uint32_t textLength{ 0 };
+		uint32_t spanOffset{ 0 };
+		uint32_t spanCount{ 0 };
+		uint32_t rows{ 1 };
+		uint32_t endColumn{ 0 }; /* cell after the last rune, where an open line continues */
+		TerminalGlyph pad{}; /* attributes of the trimmed blank cells */
+		bool open{ false };	 /* the last pushed row wrapped, the next row continues the line */
+	};
+
+	struct Chunk {
+		std::string text;
+		std::vector<Span> spans;
+		std::vector<LogicalLine> lines;
+	};
+
+	struct CachedRow {
+		std::vector<TerminalGlyph> glyphs;
+		uint64_t lastUse{ 0 };
+	};
+
+	int mMaxRows{ 0 };
+	int mColumns{ 0 };
+	std::deque<Chunk> mChunks;
+	/* lines evicted from the front chunk */
+	size_t mFrontLine{ 0 };
+	/* lines evicted since the creation, used to identify the cached rows */
+	uint64_t mEvictedLines{ 0 };
+	/* cumulative rows at the end of each line, the rows before the first line are mRowBase */
+	std::deque<uint64_t> mRowEnd;
+	uint64_t mRowBase{ 0 };
+	mutable std::map<std::pair<uint64_t, uint32_t>, CachedRow> mCache;
+	mutable uint64_t mCacheClock{ 0 };
+
+	size_t lineCount() const;
+
+	LogicalLine& getLine( size_t index );
+
+	const LogicalLine& getLine( size_t index ) const;
+
+	const Chunk& getLineChunk( size_t index ) const;
+
+	uint32_t countRows( const Chunk& chunk, const LogicalLine& line, uint32_t& endColumn ) const;
+
+	void locate( const Chunk& chunk, const LogicalLine& line, uint32_t rune, uint32_t& row,
+				 uint32_t& column ) const;
+
+	void decompress( const Chunk& chunk, const LogicalLine& line, uint32_t row,
+					 std::vector<TerminalGlyph>& glyphs ) const;
+
+	void evict();
+
+	/** Removes the first rows of the oldest line, used when a single line exceeds mMaxRows. */
+	void dropFrontRows( uint32_t count );
+
+	void invalidateCache( uint64_t lineId );
+};
+
+}} // namespace eterm::Terminal
+
+#endif
@@ -22,8 +22,10 @@
 
 #ifndef _WIN32
 // Windows has its own source file
+#include <cerrno>
 #include <cstdio>
 #include <eterm/terminal/pseudoterminal.hpp>
+#include <fcntl.h>
 #include <poll.h>
 #if defined( __linux )
 #include <pty.h>
@@ -98,7 +100,21 @@ PseudoTerminal::PseudoTerminal( int columns, int rows, AutoHandle&& master, Auto
 	mColumns( columns ),
 	mRows( rows ),
 	mMaster( std::move( master ) ),
-	mSlave( std::move( slave ) ) {}
+	mSlave( std::move( slave ) ) {
+	int fds[2];
+
+	if ( pipe( fds ) == 0 ) {
+		for ( int fd : fds ) {
+			fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK );
+			/* the shell must not inherit it */
+			fcntl( fd, F_SETFD, FD_CLOEXEC );
+		}
+		mWakeUpRead = AutoHandle( fds[0] );
+		mWakeUpWrite = AutoHandle( fds[1] );
+	} else {
+		perror( "PseudoTerminal(pipe)" );
+	}
+}
 
 bool PseudoTerminal::isTTY() const {
 	return true;
@@ -160,6 +176,45 @@ int PseudoTerminal::read( char* s, size_t n, bool block ) {
 	return (int)r;
 }
 
+bool PseudoTerminal::waitForData( int timeoutMs ) {
+	struct pollfd pfd[2];
+	pfd[0].fd = mMaster.handle();
+	pfd[0].events = POLLIN;
+	pfd[0].revents = 0;
+	pfd[1].fd = mWakeUpRead.handle();
+	pfd[1].events = POLLIN;
+	pfd[1].revents = 0;
+
+	int i;
+	do {
+		i = poll( pfd, mWakeUpRead ? 2 : 1, timeoutMs );
+	} while ( i < 0 && errno == EINTR );
+
+	if ( i < 0 ) {
+		perror( "PseudoTerminal::waitForData(poll)" );
+		return false;
+	}
+
+	if ( pfd[1].revents & POLLIN ) {
+		char buf[64];
+		while ( ::read( mWakeUpRead.handle(), buf, sizeof( buf ) ) > 0 )
+			;
+	}
+
+	/* a hung up master without pending data would make every poll return immediately */
+	return ( pfd[0].revents & POLLIN ) || !( pfd[0].revents & ( POLLERR | POLLHUP | POLLNVAL ) );
+}
+
+void PseudoTerminal::wakeUp() {
+	if ( !mWakeUpWrite )
+		return;
+
+	/* a full pipe already wakes up the reader */
+	char c = 0;
+	ssize_t r = ::write( mWakeUpWrite.handle(), &c, 1 );
+	(void)r;
+}
+
 std::unique_ptr<PseudoTerminal> PseudoTerminal::create( int columns, int rows ) {
 	AutoHandle master;
 	AutoHandle slave;
@@ -291,6 +346,30 @@ int PseudoTerminal::read( char* buf, size_t n, bool block ) {
 	return (int)read;
 }
 
+bool PseudoTerminal::waitForData( int timeoutMs ) {
+	/* anonymous pipes can't be waited on without overlapped I/O, so it peeks the pipe */
+	DWORD start = GetTickCount();
+
+	while ( !mWakeUp.exchange( false ) ) {
+		DWORD available = 0;
+
+		if ( !PeekNamedPipe( mInputHandle.handle(), nullptr, 0, nullptr, &available, nullptr ) )
+			return false;
+
+		if ( available > 0 ||
+			 ( timeoutMs >= 0 && GetTickCount() - start >= (DWORD)timeoutMs ) )
+			break;
+
+		Sleep( 1 );
+	}
+
+	return true;
+}
+
+void PseudoTerminal::wakeUp() {
+	mWakeUp = true;
+}
+
 int PseudoTerminal::getNumColumns() const {
 	return mSize.x;
 }
@@ -631,10 +631,13 @@ bool TerminalDisplay::update() {
 		invalidateCursor();
 	}
 	if ( mTerminal ) {
-		int histi = mTerminal->getHistorySize();
 		ret = mTerminal->update();
-		if ( histi != mTerminal->getHistorySize() )
+		// The threaded reader can grow the history between frames, compare with the last frame.
+		int historySize = mTerminal->getHistorySize();
+		if ( historySize != mHistorySize ) {
+			mHistorySize = historySize;
 			sendEvent( { EventType::HISTORY_LENGTH_CHANGE } );
+		}
 	}
 	return ret;
 }
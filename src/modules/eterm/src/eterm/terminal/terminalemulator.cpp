@@ -40,6 +40,8 @@
 #include <cmath>
 #include <ctype.h>
 #include <eepp/core/memorymanager.hpp>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/sys.hpp>
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
@@ -59,6 +61,11 @@ extern "C" {
 }
 #endif
 
+using EE::System::ConditionalLock;
+using EE::System::Lock;
+using EE::System::Milliseconds;
+using EE::System::Sys;
+
 namespace eterm { namespace Terminal {
 
 /* identification sequence returned in DA and DECID */
@@ -117,10 +124,9 @@ static const unsigned int tabspaces = 4;
 #define ISCONTROLC1( c ) ( BETWEEN( c, 0x80, 0x9f ) )
 #define ISCONTROL( c ) ( ISCONTROLC0( c ) || ISCONTROLC1( c ) )
 #define ISDELIM( u ) ( u && _wcschr( worddelimiters, u ) )
-#define TLINE( y )                                                                                \
-	( ( y ) < mTerm.scr && mTerm.histsize > 0                                                     \
-		  ? mTerm.hist[( ( y ) + mTerm.histi - mTerm.scr + mTerm.histsize + 1 ) % mTerm.histsize] \
-		  : mTerm.line[( y ) - mTerm.scr] )
+#define TLINE( y )                                                      \
+	( ( y ) < mTerm.scr ? mTerm.hist.getRow( mTerm.scr - 1 - ( y ) ) \
+						: mTerm.line[( y ) - mTerm.scr] )
 
 typedef struct emoji_range {
 	int32_t min_code;
@@ -219,6 +225,26 @@ static int isboxdraw( const Rune& u ) {
 	return ( block == 0x2500 && boxdata[u & 0xFF] ) || ( block == 0x2800 );
 }
 
+/* length of the run of printable ASCII ( 0x20 - 0x7E ) at the start of buf, scanning eight bytes
+ * at a time: a word is clean when no byte is below 0x20 and no byte is above 0x7E */
+static size_t asciiprintablelen( const char* buf, size_t len ) {
+	static constexpr uint64_t ones = 0x0101010101010101ULL;
+	static constexpr uint64_t highs = 0x8080808080808080ULL;
+	uint64_t w;
+	size_t i = 0;
+
+	for ( ; i + sizeof( w ) <= len; i += sizeof( w ) ) {
+		memcpy( &w, buf + i, sizeof( w ) );
+		if ( ( ( w - ones * 0x20 ) & ~w & highs ) | ( ( ( w + ones ) | w ) & highs ) )
+			break;
+	}
+
+	while ( i < len && BETWEEN( (uchar)buf[i], 0x20, 0x7E ) )
+		i++;
+
+	return i;
+}
+
 /* the "index" is actually the entire shape data encoded as ushort */
 ushort TerminalEmulator::boxdrawindex( const TerminalGlyph* g ) {
 	if ( ( g->u & ~0xff ) == 0x2800 )
@@ -377,10 +403,12 @@ int TerminalEmulator::tiswrapped( int y ) {
 }
 
 TerminalSelectionMode TerminalEmulator::getSelectionMode() const {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	return (TerminalSelectionMode)mSel.mode;
 }
 
 void TerminalEmulator::selstart( int col, int row, int snap ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	selclear();
 	mSel.mode = SEL_EMPTY;
 	mSel.type = SEL_REGULAR;
@@ -396,6 +424,7 @@ void TerminalEmulator::selstart( int col, int row, int snap ) {
 }
 
 void TerminalEmulator::selextend( int col, int row, int type, int done ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	int oldey, oldex, oldsby, oldsey, oldtype;
 
 	if ( mSel.mode == SEL_IDLE )
@@ -454,6 +483,7 @@ void TerminalEmulator::selnormalize( void ) {
 }
 
 int TerminalEmulator::selected( int x, int y ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	if ( mSel.mode == SEL_EMPTY || mSel.ob.x == -1 || mSel.alt != IS_SET( MODE_ALTSCREEN ) )
 		return 0;
 
@@ -585,10 +615,12 @@ char* TerminalEmulator::getsel( void ) const {
 }
 
 bool TerminalEmulator::hasSelection() const {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	return mSel.mode == SEL_READY;
 }
 
 std::string TerminalEmulator::getSelection() const {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	char* sel = getsel();
 	if ( sel ) {
 		std::string selection( sel );
@@ -599,6 +631,7 @@ std::string TerminalEmulator::getSelection() const {
 }
 
 void TerminalEmulator::selclear( void ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	if ( mSel.ob.x == -1 )
 		return;
 	mSel.mode = SEL_IDLE;
@@ -615,6 +648,11 @@ void TerminalEmulator::_die( const char* errstr, ... ) {
 	vsnprintf( buf, 256, errstr, ap );
 	va_end( ap );
 	logError( buf );
+	if ( isReaderThread() ) {
+		/* the process is owned by the UI thread, terminate it on the next update */
+		mReaderFailed = true;
+		return;
+	}
 	terminate();
 }
 
@@ -634,6 +672,7 @@ size_t TerminalEmulator::ttyread( void ) {
 			TerminalArg arg = { (int)mTerm.scr };
 			kscrolldown( &arg );
 
+			mBytesRead += ret;
 			mBuflen += ret;
 			written = twrite( mBuf, mBuflen, 0 );
 			mBuflen -= written;
@@ -647,6 +686,7 @@ size_t TerminalEmulator::ttyread( void ) {
 }
 
 void TerminalEmulator::kscrolldown( const TerminalArg* a ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	int n = a->i;
 
 	if ( n == INT_MAX )
@@ -666,21 +706,22 @@ void TerminalEmulator::kscrolldown( const TerminalArg* a ) {
 }
 
 void TerminalEmulator::kscrollup( const TerminalArg* a ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	int n = a->i;
 
 	if ( n == INT_MAX )
-		n = mTerm.histi - mTerm.scr;
+		n = mTerm.hist.size() - mTerm.scr;
 
 	if ( n < 0 )
 		n = mTerm.row + n;
 
-	if ( mTerm.scr + n > mTerm.histi )
-		n = mTerm.histi - mTerm.scr;
+	if ( mTerm.scr + n > mTerm.hist.size() )
+		n = mTerm.hist.size() - mTerm.scr;
 
 	if ( n == 0 )
 		return;
 
-	if ( mTerm.scr <= mTerm.histsize - n && mTerm.scr + n <= mTerm.histi ) {
+	if ( mTerm.scr + n <= mTerm.hist.size() ) {
 		mTerm.scr += n;
 		selmove( n );
 		tfulldirt();
@@ -688,9 +729,10 @@ void TerminalEmulator::kscrollup( const TerminalArg* a ) {
 }
 
 void TerminalEmulator::kscrollto( const TerminalArg* a ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	int n = a->i;
 
-	if ( 0 <= n && n <= mTerm.histi ) {
+	if ( 0 <= n && n <= mTerm.hist.size() ) {
 		mTerm.scr = n;
 		selscroll( 0, n );
 		tfulldirt();
@@ -702,7 +744,7 @@ int TerminalEmulator::tisaltscr() {
 }
 
 int TerminalEmulator::scrollSize() const {
-	return mTerm.histi;
+	return mTerm.hist.size();
 }
 
 int TerminalEmulator::rowCount() const {
@@ -718,15 +760,17 @@ void TerminalEmulator::trimMemory() {
 }
 
 void TerminalEmulator::clearHistory() {
-	for ( int i = 0; i < mTerm.histcursize; ++i )
-		eeSAFE_FREE( mTerm.hist[i] );
-	eeSAFE_FREE( mTerm.hist );
-	mTerm.histcursize = 0;
-	mTerm.histi = 0;
+	ConditionalLock l( mReaderRunning, &mMutex );
+	mTerm.hist.clear();
+	if ( mTerm.scr > 0 ) {
+		mTerm.scr = 0;
+		tfulldirt();
+	}
 	trimMemory();
 }
 
 int TerminalEmulator::scrollPos() {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	return mTerm.scr;
 }
 
@@ -739,14 +783,17 @@ void TerminalEmulator::setAllowMemoryTrimnming( bool allowMemoryTrimnming ) {
 }
 
 Vector2i TerminalEmulator::getSize() const {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	return { mTerm.col, mTerm.row };
 }
 
 bool TerminalEmulator::isScrolling() const {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	return mTerm.scr != 0;
 }
 
 void TerminalEmulator::ttywrite( const char* s, size_t n, int may_echo ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	const char* next;
 
 	TerminalArg arg = { (int)mTerm.scr };
@@ -873,7 +920,7 @@ void TerminalEmulator::tnew( int col, int row, size_t historySize ) {
 	mTerm.c.attr = TerminalGlyph{};
 	mTerm.c.attr.fg = mDefaultFg;
 	mTerm.c.attr.bg = mDefaultBg;
-	mTerm.histsize = historySize;
+	mTerm.hist.setMaxRows( (int)historySize );
 
 	tresize( col, row );
 	treset();
@@ -888,34 +935,16 @@ void TerminalEmulator::tswapscreen( void ) {
 	tfulldirt();
 }
 
-void TerminalEmulator::resizeHistory() {
-	size_t oriSize = mTerm.histcursize;
-	if ( mTerm.histi >= (int)mTerm.histcursize ) {
-		int newSize = eemin( mTerm.histi + mTerm.row, mTerm.histsize );
-		mTerm.hist = (Line*)xrealloc( mTerm.hist, newSize * sizeof( Line ) );
-		mTerm.histcursize = newSize;
-
-		for ( int i = oriSize; i < mTerm.histcursize; i++ ) {
-			mTerm.hist[i] = (TerminalGlyph*)xmalloc( mTerm.col * sizeof( TerminalGlyph ) );
-			for ( int j = 0; j < mTerm.col; j++ ) {
-				mTerm.hist[i][j] = mTerm.c.attr;
-				mTerm.hist[i][j].u = ' ';
-			}
-		}
-	}
-}
-
 void TerminalEmulator::tscrolldown( int top, int n, int copyhist ) {
 	int i;
 	Line temp;
 
 	LIMIT( n, 0, mTerm.bot - top + 1 );
-	if ( copyhist && mTerm.histsize > 0 ) {
-		mTerm.histi = ( mTerm.histi - 1 + mTerm.histsize ) % mTerm.histsize;
-		resizeHistory();
-		temp = mTerm.hist[mTerm.histi];
-		mTerm.hist[mTerm.histi] = mTerm.line[mTerm.bot];
-		mTerm.line[mTerm.bot] = temp;
+	if ( copyhist && !mTerm.hist.empty() ) {
+		/* the bottom line replaces the newest history row */
+		mTerm.hist.pop();
+		mTerm.hist.pop();
+		mTerm.hist.push( mTerm.line[mTerm.bot], mTerm.col );
 	}
 
 	tsetdirt( top, mTerm.bot - n );
@@ -937,16 +966,14 @@ void TerminalEmulator::tscrollup( int top, int n, int copyhist ) {
 
 	LIMIT( n, 0, mTerm.bot - top + 1 );
 
-	if ( copyhist && mTerm.histsize > 0 ) {
-		mTerm.histi = ( mTerm.histi + 1 ) % mTerm.histsize;
-		resizeHistory();
-		temp = mTerm.hist[mTerm.histi];
-		mTerm.hist[mTerm.histi] = mTerm.line[top];
-		mTerm.line[top] = temp;
+	if ( copyhist && mTerm.hist.getMaxRows() > 0 ) {
+		for ( i = 0; i < n; i++ )
+			mTerm.hist.push( mTerm.line[top + i], mTerm.col );
 	}
 
-	if ( mTerm.scr > 0 && mTerm.scr < mTerm.histsize )
-		mTerm.scr = MIN( mTerm.scr + n, mTerm.histsize - 1 );
+	/* keep the viewport on the same rows while scrolled back */
+	if ( mTerm.scr > 0 )
+		mTerm.scr = MIN( mTerm.scr + n, mTerm.hist.size() );
 
 	tclearregion( 0, top, mTerm.col - 1, top + n - 1 );
 	tsetdirt( top + n, mTerm.bot );
@@ -1426,8 +1453,6 @@ void TerminalEmulator::csihandle( void ) {
 	char buf[40];
 	int len;
 
-	std::shared_ptr<ITerminalDisplay> dpy{};
-
 	switch ( mCsiescseq.mode[0] ) {
 		default:
 		unknown:
@@ -1626,9 +1651,9 @@ void TerminalEmulator::csihandle( void ) {
 					if ( mCsiescseq.arg[0] < 0 ||
 						 mCsiescseq.arg[0] < TerminalCursorMode::MAX_CURSOR )
 						goto unknown;
-					dpy = mDpy.lock();
-					if ( dpy )
-						dpy->setCursorMode( (TerminalCursorMode)mCsiescseq.arg[0] );
+					withDisplay( [mode = mCsiescseq.arg[0]]( ITerminalDisplay& dpy ) {
+						dpy.setCursorMode( (TerminalCursorMode)mode );
+					} );
 					break;
 				default:
 					goto unknown;
@@ -1671,9 +1696,7 @@ void TerminalEmulator::strhandle( void ) {
 	strparse();
 	par = ( narg = mStrescseq.narg ) ? atoi( mStrescseq.args[0] ) : 0;
 
-	std::shared_ptr<ITerminalDisplay> dpy = mDpy.lock();
-
-	if ( !dpy )
+	if ( mDpy.expired() )
 		return;
 
 	switch ( mStrescseq.type ) {
@@ -1681,17 +1704,17 @@ void TerminalEmulator::strhandle( void ) {
 			switch ( par ) {
 				case 0:
 					if ( narg > 1 ) {
-						dpy->setTitle( mStrescseq.args[1] );
-						dpy->setIconTitle( mStrescseq.args[1] );
+						xsettitle( mStrescseq.args[1] );
+						xseticontitle( mStrescseq.args[1] );
 					}
 					return;
 				case 1:
 					if ( narg > 1 )
-						dpy->setIconTitle( mStrescseq.args[1] );
+						xseticontitle( mStrescseq.args[1] );
 					return;
 				case 2:
 					if ( narg > 1 ) {
-						dpy->setTitle( mStrescseq.args[1] );
+						xsettitle( mStrescseq.args[1] );
 					}
 					return;
 				case 52:
@@ -1728,7 +1751,7 @@ void TerminalEmulator::strhandle( void ) {
 			}
 			break;
 		case 'k': /* old title set compatibility */
-			dpy->setTitle( mStrescseq.args[0] );
+			xsettitle( mStrescseq.args[0] );
 			return;
 		case 'P': /* DCS -- Device Control String */
 		case '_': /* APC -- Application Program Command */
@@ -1936,9 +1959,7 @@ void TerminalEmulator::tcontrolcode( uchar ascii ) {
 				/* backwards compatibility to xterm */
 				strhandle();
 			} else {
-				auto dpy = mDpy.lock();
-				if ( dpy )
-					dpy->bell();
+				xbell();
 			}
 			break;
 		case '\033': /* ESC */
@@ -2272,12 +2293,80 @@ check_control_code:
 	}
 }
 
+void TerminalEmulator::tputascii( const char* s, int len ) {
+	TerminalGlyph* gp;
+	Line line;
+	int x, y, n, i;
+
+	while ( len > 0 ) {
+		if ( mTerm.c.state & CURSOR_WRAPNEXT ) {
+			if ( !IS_SET( MODE_WRAP ) ) {
+				/* without autowrap every character lands on the last column */
+				s += len - 1;
+				len = 1;
+			} else {
+				mTerm.line[mTerm.c.y][mTerm.c.x].mode |= ATTR_WRAP;
+				tnewline( 1 );
+			}
+		}
+
+		x = mTerm.c.x;
+		y = mTerm.c.y;
+		n = MIN( len, mTerm.col - x );
+		line = TLINE( y );
+
+		/* only the cells at the edges of the run can split a wide character */
+		if ( ( line[x].mode & ATTR_WDUMMY ) && x > 0 ) {
+			line[x - 1].u = ' ';
+			line[x - 1].mode &= ~ATTR_WIDE;
+		}
+		if ( ( line[x + n - 1].mode & ATTR_WIDE ) && x + n < mTerm.col ) {
+			line[x + n].u = ' ';
+			line[x + n].mode &= ~ATTR_WDUMMY;
+		}
+
+		gp = &line[x];
+		for ( i = 0; i < n; i++ ) {
+			gp[i] = mTerm.c.attr;
+			gp[i].u = (uchar)s[i];
+		}
+
+		mTerm.dirty[y] = 1;
+		mTerm.lastc = (uchar)s[n - 1];
+
+		/* as tputc, the cursor stays on the last column until the next character */
+		if ( x + n < mTerm.col ) {
+			tmoveto( x + n, y );
+		} else {
+			tmoveto( mTerm.col - 1, y );
+			mTerm.c.state |= CURSOR_WRAPNEXT;
+		}
+
+		s += n;
+		len -= n;
+	}
+
+	mDirty = true;
+}
+
 int TerminalEmulator::twrite( const char* buf, int buflen, int show_ctrl ) {
 	size_t charsize;
 	Rune u;
 	int n;
 
 	for ( n = 0; n < buflen; n += charsize ) {
+		/* runs of printable ASCII outside of sequences skip the per rune state machine */
+		if ( !mTerm.esc && !IS_SET( MODE_PRINT | MODE_INSERT ) && mSel.ob.x == -1 &&
+			 mTerm.trantbl[mTerm.charset] != CS_GRAPHIC0 &&
+			 ( !( mTerm.c.state & CURSOR_ORIGIN ) ||
+			   BETWEEN( mTerm.c.y, mTerm.top, mTerm.bot ) ) ) {
+			charsize = asciiprintablelen( buf + n, buflen - n );
+			if ( charsize > 0 ) {
+				tputascii( buf + n, (int)charsize );
+				continue;
+			}
+		}
+
 		if ( IS_SET( MODE_UTF8 ) ) {
 			/* process a complete utf8 char */
 			charsize = utf8decode( buf + n, &u, buflen - n );
@@ -2351,14 +2440,9 @@ void TerminalEmulator::tresize( int col, int row ) {
 		mTerm.alt[i] = (Line)xmalloc( col * sizeof( TerminalGlyph ) );
 	}
 
-	/* add new columns to history */
-	for ( int i = 0; i < mTerm.histcursize; i++ ) {
-		mTerm.hist[i] = (TerminalGlyph*)xrealloc( mTerm.hist[i], col * sizeof( TerminalGlyph ) );
-		for ( j = mincol; j < col; j++ ) {
-			mTerm.hist[i][j] = mTerm.c.attr;
-			mTerm.hist[i][j].u = ' ';
-		}
-	}
+	/* reflow the history to the new width */
+	mTerm.hist.setColumns( col );
+	mTerm.scr = MIN( mTerm.scr, mTerm.hist.size() );
 
 	if ( col > mTerm.col ) {
 		bp = mTerm.tabs + mTerm.col;
@@ -2394,9 +2478,23 @@ void TerminalEmulator::tresize( int col, int row ) {
 }
 
 void TerminalEmulator::resettitle( void ) {
-	auto dpy = mDpy.lock();
-	if ( dpy )
-		dpy->setTitle( NULL );
+	withDisplay( []( ITerminalDisplay& dpy ) { dpy.setTitle( NULL ); } );
+}
+
+void TerminalEmulator::xsettitle( char* title ) {
+	withDisplay( [title = std::string( title )]( ITerminalDisplay& dpy ) {
+		dpy.setTitle( title.c_str() );
+	} );
+}
+
+void TerminalEmulator::xseticontitle( char* title ) {
+	withDisplay( [title = std::string( title )]( ITerminalDisplay& dpy ) {
+		dpy.setIconTitle( title.c_str() );
+	} );
+}
+
+void TerminalEmulator::xbell() {
+	withDisplay( []( ITerminalDisplay& dpy ) { dpy.bell(); } );
 }
 
 void TerminalEmulator::drawregion( ITerminalDisplay& dpy, int x1, int y1, int x2, int y2 ) {
@@ -2449,14 +2547,17 @@ void TerminalEmulator::draw() {
 }
 
 void TerminalEmulator::redraw() {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	tfulldirt();
-	draw();
+	/* the reader thread only marks the lines, the UI thread draws them on update */
+	if ( !isReaderThread() )
+		draw();
 }
 
 void TerminalEmulator::xsetmode( int set, unsigned int mode ) {
-	auto dpy = mDpy.lock();
-	if ( dpy )
-		dpy->setMode( (TerminalWinMode)mode, set );
+	withDisplay( [set, mode]( ITerminalDisplay& dpy ) {
+		dpy.setMode( (TerminalWinMode)mode, set );
+	} );
 }
 
 bool TerminalEmulator::xgetmode( const TerminalWinMode& mode ) {
@@ -2468,6 +2569,7 @@ bool TerminalEmulator::xgetmode( const TerminalWinMode& mode ) {
 
 void TerminalEmulator::mousereport( const TerminalMouseEventType& type, const Vector2i& pos,
 									const Uint32& flags, const Uint32& mod ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	if ( !xgetmode( MODE_MOUSEBTN ) && !xgetmode( MODE_MOUSESGR ) &&
 		 ( TerminalMouseEventType::MouseButtonDown == type ||
 		   TerminalMouseEventType::MouseButtonRelease == type ) )
@@ -2566,10 +2668,14 @@ void TerminalEmulator::mousereport( const TerminalMouseEventType& type, const Ve
 }
 
 void TerminalEmulator::setPtyAndProcess( PtyPtr&& pty, ProcPtr&& process ) {
+	bool threadedReader = isThreadedReader();
+	stopReaderThread();
 	mStatus = STARTING;
 	mExitCode = 1;
 	mPty = std::move( pty );
 	mProcess = std::move( process );
+	if ( threadedReader )
+		startReaderThread();
 }
 
 void TerminalEmulator::xsetpointermotion( int ) {
@@ -2624,6 +2730,9 @@ TerminalEmulator::TerminalEmulator( PtyPtr&& pty, ProcPtr&& process,
 }
 
 TerminalEmulator::~TerminalEmulator() {
+	stopReaderThread();
+	mDisplayEvents.clear();
+
 	for ( int i = 0; i < mTerm.row; i++ ) {
 		eeSAFE_FREE( mTerm.line[i] );
 		eeSAFE_FREE( mTerm.alt[i] );
@@ -2661,18 +2770,26 @@ void TerminalEmulator::onProcessExit( int exitCode ) {
 }
 
 void TerminalEmulator::setClipboard( const char* str ) {
-	auto dpy = mDpy.lock();
-	if ( dpy )
-		dpy->setClipboard( str );
+	withDisplay( [str = std::string( str )]( ITerminalDisplay& dpy ) {
+		dpy.setClipboard( str.c_str() );
+	} );
 }
 
 void TerminalEmulator::loadColors() {
-	auto dpy = mDpy.lock();
-	if ( dpy )
-		dpy->resetColors();
+	withDisplay( []( ITerminalDisplay& dpy ) { dpy.resetColors(); } );
 }
 
 int TerminalEmulator::resetColor( int i, const char* name ) {
+	if ( isReaderThread() ) {
+		/* deferred, invalid colors are only reported by the display */
+		std::string color( name ? name : "" );
+		bool hasName = name != nullptr;
+		withDisplay( [i, color, hasName]( ITerminalDisplay& dpy ) {
+			dpy.resetColor( i, hasName ? color.c_str() : nullptr );
+		} );
+		return 0;
+	}
+
 	auto dpy = mDpy.lock();
 	if ( !dpy )
 		return 0;
@@ -2697,7 +2814,19 @@ int TerminalEmulator::getExitCode() const {
 }
 
 int TerminalEmulator::getHistorySize() const {
-	return mTerm.histi;
+	ConditionalLock l( mReaderRunning, &mMutex );
+	return mTerm.hist.size();
+}
+
+std::vector<TerminalHistory::Match> TerminalEmulator::searchHistory( const std::string& pattern,
+																	 bool caseSensitive ) const {
+	ConditionalLock l( mReaderRunning, &mMutex );
+	return mTerm.hist.search( pattern, caseSensitive );
+}
+
+size_t TerminalEmulator::getHistoryMemoryUsage() const {
+	ConditionalLock l( mReaderRunning, &mMutex );
+	return mTerm.hist.getMemoryUsage();
 }
 
 int TerminalEmulator::write( const char* buf, size_t buflen ) {
@@ -2705,6 +2834,7 @@ int TerminalEmulator::write( const char* buf, size_t buflen ) {
 }
 
 void TerminalEmulator::resize( int columns, int rows ) {
+	ConditionalLock l( mReaderRunning, &mMutex );
 	if ( !mPty->resize( columns, rows ) ) {
 		_die( "Failed to resize pty!" );
 		return;
@@ -2723,15 +2853,30 @@ bool TerminalEmulator::update() {
 	}
 
 	int read = MAX_TTY_READS;
-	while ( ttyread() > 0 && --read )
-		;
 
-	if ( read != MAX_TTY_READS || mDirty )
-		draw();
+	flushDisplayEvents();
+
+	if ( mReaderRunning ) {
+		if ( mReaderFailed ) {
+			terminate();
+			return true;
+		}
+
+		Lock l( mMutex );
+		if ( mDirty )
+			draw();
+	} else {
+		while ( ttyread() > 0 && --read )
+			;
+
+		if ( read != MAX_TTY_READS || mDirty )
+			draw();
+	}
 
 	mProcess->checkExitStatus();
 
-	if ( mProcess->hasExited() ) {
+	/* let the reader thread drain the remaining output before reporting the exit */
+	if ( mProcess->hasExited() && mReaderIdle ) {
 		mExitCode = mProcess->getExitCode();
 		mStatus = TERMINATED;
 		onProcessExit( mExitCode );
@@ -2740,6 +2885,114 @@ bool TerminalEmulator::update() {
 	return read != 0;
 }
 
+#define MAX_TTY_READS_PER_LOCK ( 16 )
+
+void TerminalEmulator::setThreadedReader( bool threadedReader ) {
+	if ( threadedReader == isThreadedReader() )
+		return;
+
+	if ( threadedReader ) {
+		startReaderThread();
+	} else {
+		stopReaderThread();
+	}
+}
+
+bool TerminalEmulator::isThreadedReader() const {
+	return mReaderRunning;
+}
+
+Uint64 TerminalEmulator::getBytesRead() const {
+	return mBytesRead;
+}
+
+EE::System::Mutex& TerminalEmulator::getMutex() {
+	return mMutex;
+}
+
+bool TerminalEmulator::isReaderThread() const {
+	return mReaderRunning && std::this_thread::get_id() == mReaderThreadId;
+}
+
+void TerminalEmulator::startReaderThread() {
+	if ( mReaderRunning )
+		return;
+
+	/* the reader locks the mutex before parsing, so the thread id is set by then */
+	Lock l( mMutex );
+	mReaderFailed = false;
+	mReaderRunning = true;
+	mReaderThread = std::thread( &TerminalEmulator::readerLoop, this );
+	mReaderThreadId = mReaderThread.get_id();
+}
+
+void TerminalEmulator::stopReaderThread() {
+	if ( !mReaderRunning )
+		return;
+
+	mReaderRunning = false;
+	mPty->wakeUp();
+	if ( mReaderThread.joinable() )
+		mReaderThread.join();
+	mReaderThreadId = std::thread::id();
+	mReaderIdle = true;
+}
+
+void TerminalEmulator::readerLoop() {
+	while ( mReaderRunning && !mReaderFailed ) {
+		size_t total = 0;
+
+		{
+			/* parse in bounded batches so the UI thread can take the dirty lines in between */
+			Lock l( mMutex );
+			int reads = MAX_TTY_READS_PER_LOCK;
+			size_t ret;
+			while ( mReaderRunning && !mReaderFailed && ( ret = ttyread() ) > 0 ) {
+				total += ret;
+				if ( !--reads )
+					break;
+			}
+		}
+
+		mReaderIdle = total == 0;
+
+		/* block until the shell writes or stopReaderThread wakes the reader up, a pty that can't
+		 * be waited on is polled instead */
+		if ( total == 0 && !mPty->waitForData() )
+			Sys::sleep( Milliseconds( 8 ) );
+	}
+}
+
+void TerminalEmulator::withDisplay( std::function<void( ITerminalDisplay& )> fn ) {
+	if ( isReaderThread() ) {
+		Lock l( mDisplayEventsMutex );
+		mDisplayEvents.emplace_back( std::move( fn ) );
+		return;
+	}
+
+	auto dpy = mDpy.lock();
+	if ( dpy )
+		fn( *dpy );
+}
+
+void TerminalEmulator::flushDisplayEvents() {
+	std::vector<std::function<void( ITerminalDisplay& )>> events;
+
+	{
+		Lock l( mDisplayEventsMutex );
+		if ( mDisplayEvents.empty() )
+			return;
+		events.swap( mDisplayEvents );
+	}
+
+	auto dpy = mDpy.lock();
+	if ( !dpy )
+		return;
+
+	for ( auto& event : events )
+		event( *dpy );
+}
+
 Term::~Term() {
 	eeSAFE_FREE( line );
 	eeSAFE_FREE( alt );
@@ -0,0 +1,567 @@
+#include <algorithm>
+#include <eepp/core/utf.hpp>
+#include <eterm/terminal/terminalhistory.hpp>
+#include <iterator>
+#include <string_view>
+
+using namespace EE;
+
+namespace eterm { namespace Terminal {
+
+static constexpr size_t LINES_PER_CHUNK = 256;
+static constexpr size_t MAX_CACHED_ROWS = 512;
+
+static inline bool sameAttributes( const TerminalGlyph& a, const TerminalGlyph& b ) {
+	return a.mode == b.mode && a.fg == b.fg && a.bg == b.bg;
+}
+
+static inline uint32_t runeWidth( ushort mode ) {
+	return ( mode & ATTR_WIDE ) ? 2 : 1;
+}
+
+/* Advances the cursor of a row walk placing a rune of the given width, breaking to the next row
+ * when it doesn't fit ( as the emulator does when the line wraps ). */
+static inline void placeRune( uint32_t width, uint32_t columns, uint32_t& row, uint32_t& x ) {
+	if ( x > 0 && x + width > columns ) {
+		row++;
+		x = 0;
+	}
+	x += width;
+}
+
+static inline char asciiLower( char c ) {
+	return ( c >= 'A' && c <= 'Z' ) ? c - 'A' + 'a' : c;
+}
+
+TerminalHistory::TerminalHistory( int maxRows ) : mMaxRows( maxRows ) {}
+
+void TerminalHistory::setMaxRows( int maxRows ) {
+	mMaxRows = maxRows;
+	evict();
+}
+
+int TerminalHistory::getMaxRows() const {
+	return mMaxRows;
+}
+
+int TerminalHistory::size() const {
+	return mRowEnd.empty() ? 0 : (int)( mRowEnd.back() - mRowBase );
+}
+
+bool TerminalHistory::empty() const {
+	return mRowEnd.empty();
+}
+
+void TerminalHistory::clear() {
+	mEvictedLines += lineCount();
+	mChunks.clear();
+	mRowEnd.clear();
+	mRowBase = 0;
+	mFrontLine = 0;
+	mCache.clear();
+}
+
+size_t TerminalHistory::lineCount() const {
+	return mRowEnd.size();
+}
+
+TerminalHistory::LogicalLine& TerminalHistory::getLine( size_t index ) {
+	index += mFrontLine;
+	return mChunks[index / LINES_PER_CHUNK].lines[index % LINES_PER_CHUNK];
+}
+
+const TerminalHistory::LogicalLine& TerminalHistory::getLine( size_t index ) const {
+	index += mFrontLine;
+	return mChunks[index / LINES_PER_CHUNK].lines[index % LINES_PER_CHUNK];
+}
+
+const TerminalHistory::Chunk& TerminalHistory::getLineChunk( size_t index ) const {
+	return mChunks[( index + mFrontLine ) / LINES_PER_CHUNK];
+}
+
+uint32_t TerminalHistory::countRows( const Chunk& chunk, const LogicalLine& line,
+									 uint32_t& endColumn ) const {
+	uint32_t columns = eemax( mColumns, 1 );
+	uint32_t row = 0;
+	uint32_t x = 0;
+
+	for ( uint32_t s = 0; s < line.spanCount; s++ ) {
+		const Span& span = chunk.spans[line.spanOffset + s];
+
+		if ( span.mode & ATTR_WIDE ) {
+			for ( uint32_t i = 0; i < span.runes; i++ )
+				placeRune( 2, columns, row, x );
+			continue;
+		}
+
+		uint32_t remaining = span.runes;
+		while ( remaining > 0 ) {
+			if ( x == columns ) {
+				row++;
+				x = 0;
+			}
+			uint32_t take = eemin( columns - x, remaining );
+			x += take;
+			remaining -= take;
+		}
+	}
+
+	endColumn = x;
+	return row + 1;
+}
+
+void TerminalHistory::locate( const Chunk& chunk, const LogicalLine& line, uint32_t rune,
+							  uint32_t& row, uint32_t& column ) const {
+	uint32_t columns = eemax( mColumns, 1 );
+	uint32_t index = 0;
+	uint32_t x = 0;
+	row = 0;
+
+	for ( uint32_t s = 0; s < line.spanCount; s++ ) {
+		const Span& span = chunk.spans[line.spanOffset + s];
+		uint32_t width = runeWidth( span.mode );
+
+		for ( uint32_t i = 0; i < span.runes; i++, index++ ) {
+			if ( index == rune ) {
+				if ( x > 0 && x + width > columns ) {
+					row++;
+					x = 0;
+				}
+				column = x;
+				return;
+			}
+			placeRune( width, columns, row, x );
+		}
+	}
+
+	if ( x >= columns ) {
+		row++;
+		x = 0;
+	}
+	column = x;
+}
+
+void TerminalHistory::decompress( const Chunk& chunk, const LogicalLine& line, uint32_t row,
+								  std::vector<TerminalGlyph>& glyphs ) const {
+	uint32_t columns = eemax( mColumns, 1 );
+	TerminalGlyph pad = line.pad;
+	pad.u = ' ';
+	glyphs.assign( columns, pad );
+
+	const char* text = chunk.text.data() + line.textOffset;
+	const char* textEnd = text + line.textLength;
+	uint32_t curRow = 0;
+	uint32_t x = 0;
+
+	for ( uint32_t s = 0; s < line.spanCount && curRow <= row; s++ ) {
+		const Span& span = chunk.spans[line.spanOffset + s];
+		uint32_t width = runeWidth( span.mode );
+
+		for ( uint32_t i = 0; i < span.runes; i++ ) {
+			uint32_t u = ' ';
+			text = Utf8::decode( text, textEnd, u, ' ' );
+
+			if ( x > 0 && x + width > columns ) {
+				curRow++;
+				x = 0;
+			}
+
+			if ( curRow > row )
+				break;
+
+			if ( curRow == row ) {
+				TerminalGlyph& glyph = glyphs[x];
+				glyph.u = u;
+				glyph.mode = span.mode;
+				glyph.fg = span.fg;
+				glyph.bg = span.bg;
+
+				if ( width == 2 && x + 1 < columns ) {
+					TerminalGlyph& dummy = glyphs[x + 1];
+					dummy.u = 0;
+					dummy.mode = ATTR_WDUMMY;
+					dummy.fg = span.fg;
+					dummy.bg = span.bg;
+				}
+			}
+
+			x += width;
+		}
+	}
+
+	/* keep the wrapping context for the selection and the line length */
+	if ( row + 1 < line.rows || line.open )
+		glyphs[columns - 1].mode |= ATTR_WRAP;
+}
+
+void TerminalHistory::push( const TerminalGlyph* row, int columns ) {
+	if ( columns <= 0 || mMaxRows <= 0 )
+		return;
+
+	if ( mColumns == 0 )
+		mColumns = columns;
+
+	bool wraps = ( row[columns - 1].mode & ATTR_WRAP ) != 0;
+	TerminalGlyph pad = row[columns - 1];
+	pad.mode &= ~( ATTR_WRAP | ATTR_WIDE | ATTR_WDUMMY );
+	int end = columns;
+
+	/* trim the trailing blanks of the finished lines, they are restored as padding */
+	if ( !wraps ) {
+		while ( end > 0 && ( row[end - 1].u == ' ' || row[end - 1].u == 0 ) &&
+				!( row[end - 1].mode & ( ATTR_WIDE | ATTR_WDUMMY ) ) &&
+				sameAttributes( row[end - 1], pad ) )
+			end--;
+	}
+
+	bool append = !mRowEnd.empty() && getLine( lineCount() - 1 ).open;
+
+	if ( append ) {
+		invalidateCache( mEvictedLines + lineCount() - 1 );
+	} else {
+		if ( mChunks.empty() || mChunks.back().lines.size() >= LINES_PER_CHUNK )
+			mChunks.emplace_back();
+
+		Chunk& chunk = mChunks.back();
+		LogicalLine line;
+		line.textOffset = (uint32_t)chunk.text.size();
+		line.spanOffset = (uint32_t)chunk.spans.size();
+		chunk.lines.emplace_back( line );
+		mRowEnd.push_back( ( mRowEnd.empty() ? mRowBase : mRowEnd.back() ) + line.rows );
+	}
+
+	Chunk& chunk = mChunks.back();
+	LogicalLine& line = chunk.lines.back();
+	auto out = std::back_inserter( chunk.text );
+	/* continue the row walk of the line, so only the pushed runes are laid out */
+	uint32_t layoutColumns = eemax( mColumns, 1 );
+	uint32_t lastRow = line.rows - 1;
+	uint32_t x = line.endColumn;
+
+	for ( int i = 0; i < end; i++ ) {
+		const TerminalGlyph& glyph = row[i];
+
+		/* the second half of a wide character is implicit */
+		if ( ( glyph.mode & ATTR_WDUMMY ) && i > 0 && ( row[i - 1].mode & ATTR_WIDE ) )
+			continue;
+
+		ushort mode = glyph.mode & ~( ATTR_WRAP | ATTR_WDUMMY );
+		Rune u = glyph.u == 0 || ( glyph.mode & ATTR_WDUMMY ) ? ' ' : glyph.u;
+		placeRune( runeWidth( mode ), layoutColumns, lastRow, x );
+
+		if ( line.spanCount > 0 ) {
+			Span& last = chunk.spans.back();
+			if ( last.mode == mode && last.fg == glyph.fg && last.bg == glyph.bg ) {
+				last.runes++;
+				Utf8::encode( u, out );
+				continue;
+			}
+		}
+
+		chunk.spans.push_back( { 1, glyph.fg, glyph.bg, mode } );
+		line.spanCount++;
+		Utf8::encode( u, out );
+	}
+
+	line.textLength = (uint32_t)chunk.text.size() - line.textOffset;
+	line.pad = pad;
+	line.open = wraps;
+	mRowEnd.back() += lastRow + 1 - line.rows;
+	line.rows = lastRow + 1;
+	line.endColumn = x;
+	evict();
+}
+
+void TerminalHistory::pop() {
+	if ( mRowEnd.empty() )
+		return;
+
+	Chunk& chunk = mChunks.back();
+	LogicalLine& line = chunk.lines.back();
+	invalidateCache( mEvictedLines + lineCount() - 1 );
+
+	if ( line.rows <= 1 ) {
+		chunk.text.resize( line.textOffset );
+		chunk.spans.resize( line.spanOffset );
+		chunk.lines.pop_back();
+		mRowEnd.pop_back();
+
+		bool isFront = mChunks.size() == 1;
+		if ( chunk.lines.size() == ( isFront ? mFrontLine : 0 ) ) {
+			mChunks.pop_back();
+			if ( isFront )
+				mFrontLine = 0;
+		}
+		return;
+	}
+
+	/* truncate the line at the start of its last row */
+	uint32_t lastRow = line.rows - 1;
+	uint32_t columns = eemax( mColumns, 1 );
+	uint32_t row = 0, x = 0, endColumn = 0, runes = 0, spans = 0, keepInSpan = 0;
+	bool done = false;
+
+	for ( uint32_t s = 0; s < line.spanCount && !done; s++ ) {
+		const Span& span = chunk.spans[line.spanOffset + s];
+		uint32_t width = runeWidth( span.mode );
+
+		for ( uint32_t i = 0; i < span.runes; i++ ) {
+			endColumn = x;
+			placeRune( width, columns, row, x );
+			if ( row == lastRow ) {
+				spans = s;
+				keepInSpan = i;
+				done = true;
+				break;
+			}
+			runes++;
+		}
+	}
+
+	if ( keepInSpan > 0 ) {
+		chunk.spans[line.spanOffset + spans].runes = keepInSpan;
+		spans++;
+	}
+
+	chunk.spans.resize( line.spanOffset + spans );
+	line.spanCount = spans;
+
+	const char* begin = chunk.text.data() + line.textOffset;
+	const char* end = begin + line.textLength;
+	const char* it = begin;
+	for ( uint32_t i = 0; i < runes && it < end; i++ )
+		it = Utf8::next( it, end );
+
+	line.textLength = (uint32_t)( it - begin );
+	chunk.text.resize( line.textOffset + line.textLength );
+	line.open = false;
+	line.rows = lastRow;
+	line.endColumn = endColumn;
+	mRowEnd.back()--;
+}
+
+Line TerminalHistory::getRow( int row ) const {
+	int total = size();
+
+	if ( row < 0 || row >= total )
+		return nullptr;
+
+	uint64_t absRow = mRowBase + ( total - 1 - row );
+	size_t index = std::upper_bound( mRowEnd.begin(), mRowEnd.end(), absRow ) - mRowEnd.begin();
+	uint64_t lineStart = index == 0 ? mRowBase : mRowEnd[index - 1];
+	uint32_t rowInLine = (uint32_t)( absRow - lineStart );
+	auto key = std::make_pair( mEvictedLines + index, rowInLine );
+
+	auto it = mCache.find( key );
+
+	if ( it == mCache.end() ) {
+		if ( mCache.size() >= MAX_CACHED_ROWS ) {
+			auto oldest = mCache.begin();
+			for ( auto cit = mCache.begin(); cit != mCache.end(); ++cit ) {
+				if ( cit->second.lastUse < oldest->second.lastUse )
+					oldest = cit;
+			}
+			mCache.erase( oldest );
+		}
+
+		it = mCache.emplace( key, CachedRow() ).first;
+		decompress( getLineChunk( index ), getLine( index ), rowInLine, it->second.glyphs );
+	}
+
+	it->second.lastUse = ++mCacheClock;
+	return it->second.glyphs.data();
+}
+
+void TerminalHistory::setColumns( int columns ) {
+	if ( columns <= 0 || columns == mColumns )
+		return;
+
+	mColumns = columns;
+	mCache.clear();
+	mRowBase = 0;
+
+	uint64_t rows = 0;
+	for ( size_t i = 0; i < mRowEnd.size(); i++ ) {
+		LogicalLine& line = getLine( i );
+		line.rows = countRows( getLineChunk( i ), line, line.endColumn );
+		rows += line.rows;
+		mRowEnd[i] = rows;
+	}
+
+	evict();
+}
+
+int TerminalHistory::getColumns() const {
+	return mColumns;
+}
+
+std::vector<TerminalHistory::Match> TerminalHistory::search( const std::string& pattern,
+															 bool caseSensitive ) const {
+	std::vector<Match> matches;
+
+	if ( pattern.empty() )
+		return matches;
+
+	std::string needle( pattern );
+	if ( !caseSensitive )
+		std::transform( needle.begin(), needle.end(), needle.begin(), asciiLower );
+
+	uint32_t patternRunes = 0;
+	for ( unsigned char c : needle )
+		patternRunes += ( c & 0xC0 ) != 0x80;
+
+	int total = size();
+
+	for ( size_t i = 0; i < lineCount(); i++ ) {
+		const Chunk& chunk = getLineChunk( i );
+		const LogicalLine& line = getLine( i );
+
+		if ( line.textLength < needle.size() )
+			continue;
+
+		std::string_view text( chunk.text.data() + line.textOffset, line.textLength );
+		uint64_t lineStart = ( i == 0 ? mRowBase : mRowEnd[i - 1] ) - mRowBase;
+		size_t pos = 0;
+		size_t countedPos = 0;
+		uint32_t rune = 0;
+
+		while ( pos + needle.size() <= text.size() ) {
+			size_t found;
+
+			if ( caseSensitive ) {
+				found = text.find( needle, pos );
+			} else {
+				found = std::string_view::npos;
+				for ( size_t p = pos; p + needle.size() <= text.size(); p++ ) {
+					size_t k = 0;
+					while ( k < needle.size() && asciiLower( text[p + k] ) == needle[k] )
+						k++;
+					if ( k == needle.size() ) {
+						found = p;
+						break;
+					}
+				}
+			}
+
+			if ( found == std::string_view::npos )
+				break;
+
+			for ( ; countedPos < found; countedPos++ )
+				rune += ( (unsigned char)text[countedPos] & 0xC0 ) != 0x80;
+
+			uint32_t startRow, startColumn, endRow, endColumn;
+			locate( chunk, line, rune, startRow, startColumn );
+			locate( chunk, line, rune + patternRunes, endRow, endColumn );
+
+			Match match;
+			match.row = total - 1 - (int)( lineStart + startRow );
+			match.column = (int)startColumn;
+			match.length = (int)( ( endRow - startRow ) * mColumns + endColumn - startColumn );
+			matches.emplace_back( match );
+
+			pos = found + needle.size();
+		}
+	}
+
+	return matches;
+}
+
+size_t TerminalHistory::getMemoryUsage() const {
+	size_t usage = mRowEnd.size() * sizeof( uint64_t );
+
+	for ( const auto& chunk : mChunks ) {
+		usage += chunk.text.capacity() + chunk.spans.capacity() * sizeof( Span ) +
+				 chunk.lines.capacity() * sizeof( LogicalLine );
+	}
+
+	for ( const auto& cached : mCache )
+		usage += cached.second.glyphs.capacity() * sizeof( TerminalGlyph );
+
+	return usage;
+}
+
+void TerminalHistory::evict() {
+	if ( mMaxRows <= 0 ) {
+		if ( !empty() )
+			clear();
+		return;
+	}
+
+	while ( lineCount() > 1 && size() > mMaxRows ) {
+		invalidateCache( mEvictedLines );
+		mRowBase = mRowEnd.front();
+		mRowEnd.pop_front();
+		mEvictedLines++;
+
+		if ( ++mFrontLine == LINES_PER_CHUNK ) {
+			mChunks.pop_front();
+			mFrontLine = 0;
+		}
+	}
+
+	/* a single line ( usually still open ) longer than the history keeps its newest rows */
+	if ( size() > mMaxRows )
+		dropFrontRows( (uint32_t)( size() - mMaxRows ) );
+}
+
+void TerminalHistory::dropFrontRows( uint32_t count ) {
+	Chunk& chunk = mChunks.front();
+	LogicalLine& line = getLine( 0 );
+	uint32_t columns = eemax( mColumns, 1 );
+	uint32_t row = 0, x = 0, runes = 0, spans = 0, dropInSpan = 0;
+	bool found = false;
+
+	/* the first rune of the row "count" starts the kept part of the line */
+	for ( uint32_t s = 0; s < line.spanCount && !found; s++ ) {
+		const Span& span = chunk.spans[line.spanOffset + s];
+		uint32_t width = runeWidth( span.mode );
+
+		for ( uint32_t i = 0; i < span.runes; i++ ) {
+			placeRune( width, columns, row, x );
+			if ( row == count ) {
+				spans = s;
+				dropInSpan = i;
+				found = true;
+				break;
+			}
+			runes++;
+		}
+	}
+
+	if ( !found )
+		return;
+
+	invalidateCache( mEvictedLines );
+
+	chunk.spans[line.spanOffset + spans].runes -= dropInSpan;
+	line.spanOffset += spans;
+	line.spanCount -= spans;
+
+	const char* begin = chunk.text.data() + line.textOffset;
+	const char* end = begin + line.textLength;
+	const char* it = begin;
+	for ( uint32_t i = 0; i < runes && it < end; i++ )
+		it = Utf8::next( it, end );
+
+	uint32_t bytes = (uint32_t)( it - begin );
+	line.textOffset += bytes;
+	line.textLength -= bytes;
+	line.rows -= count;
+	mRowBase += count;
+
+	/* it's the only line left, reclaim the dropped data once it outweighs the line */
+	if ( line.textOffset > line.textLength ) {
+		chunk.text.erase( 0, line.textOffset );
+		chunk.spans.erase( chunk.spans.begin(), chunk.spans.begin() + line.spanOffset );
+		line.textOffset = 0;
+		line.spanOffset = 0;
+	}
+}
+
+void TerminalHistory::invalidateCache( uint64_t lineId ) {
+	auto it = mCache.lower_bound( std::make_pair( lineId, (uint32_t)0 ) );
+	while ( it != mCache.end() && it->first.first == lineId )
+		it = mCache.erase( it );
+}
+
+}} // namespace eterm::Terminal
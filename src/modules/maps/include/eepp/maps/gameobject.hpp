@@ -70,6 +70,8 @@ class EE_MAPS_API GameObject {
 	MapLayer* getLayer() const;
 
   protected:
+	friend class TileMapLayer;
+
 	Uint32 mFlags;
 	MapLayer* mLayer;
 
@@ -81,6 +83,10 @@ class EE_MAPS_API GameObject {
 
 	void assignTilePos();
 
+	/** Updates the object in the spatial index of its object layer, after a change of its bounds
+	 * or its flags */
+	void updateLayerIndex();
+
 	Float getRotation();
 };
 
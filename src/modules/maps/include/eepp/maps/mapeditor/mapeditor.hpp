@@ -79,6 +79,7 @@ class EE_MAPS_API MapEditor {
 	UITextInput* mDataIdInput;
 	UIMenuCheckBox* mLayerChkVisible;
 	UIMenuCheckBox* mLayerChkLights;
+	UIMenuCheckBox* mLayerChkChunked;
 	UITabWidget* mTabWidget;
 	UIMenuCheckBox* mChkShowGrid;
 	UIMenuCheckBox* mChkMarkTileOver;
@@ -243,6 +244,8 @@ class EE_MAPS_API MapEditor {
 
 	UIMessageBox* createNoLayerAlert( const String title );
 
+	bool isChunkedLayer( MapLayer* layer );
+
 	void onTabSelected( const Event* Event );
 
 	void createTabs();
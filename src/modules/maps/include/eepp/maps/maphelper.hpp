@@ -78,6 +78,22 @@ struct sMapObjObjHdr {
 	Uint32 PropertyCount;
 };
 
+//! The chunked maps store the lights after the layer headers, followed by the chunks header, the
+//! chunks table and the compressed chunks. Every chunk holds the tiles of its area and the objects
+//! whose position falls inside it, with the same layout than the map file.
+struct sMapChunksHdr {
+	Uint32 ChunkSize; //! Width and height in tiles
+	Uint32 ChunksX;
+	Uint32 ChunksY;
+	Uint32 Compression; //! The Compression::Mode of the chunks
+};
+
+struct sMapChunkEntry {
+	Uint64 Offset; //! From the end of the chunks table
+	Uint32 Size;   //! Compressed size, 0 for the empty chunks
+	Uint32 DataSize;
+};
+
 class GObjFlags {
   public:
 	enum EE_GAMEOBJECT_FLAGS {
@@ -88,7 +104,8 @@ class GObjFlags {
 		GAMEOBJECT_BLOCKED = ( 1 << 4 ),
 		GAMEOBJECT_ROTATE_90DEG = ( 1 << 5 ),
 		GAMEOBJECT_AUTO_FIX_TILE_POS = ( 1 << 6 ),
-		GAMEOBJECT_BLEND_ADD = ( 1 << 7 )
+		GAMEOBJECT_BLEND_ADD = ( 1 << 7 ),
+		GAMEOBJECT_ACTIVE = ( 1 << 8 ) //! Updated every frame in the object layers
 	};
 };
 
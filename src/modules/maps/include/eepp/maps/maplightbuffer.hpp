@@ -0,0 +1,93 @@
+#ifndef EE_MAPS_MAPLIGHTBUFFER_HPP
+#define EE_MAPS_MAPLIGHTBUFFER_HPP
+
+#include <eepp/maps/base.hpp>
+#include <eepp/maps/maplight.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
+#include <vector>
+
+namespace EE { namespace Maps {
+
+/** The light colors of the tiles of a map, sampled at the tile corners when lighting by vertex
+ * ( the corners are shared by the neighbour tiles ) or at the tile centers when lighting by tile.
+ * The samples are cached and only recomputed when a light that covers them moves or changes, or
+ * when they become visible after being invalidated. */
+class EE_MAPS_API MapLightBuffer {
+  public:
+	typedef std::vector<MapLight*> LightsList;
+
+	MapLightBuffer( const Sizei& mapSize, const Sizei& tileSize, bool byVertex );
+
+	/** Recomputes the invalid samples of the visible tiles [start, end), after invalidating the
+	 * areas of the lights that were added, removed, moved or changed since the last update. */
+	void update( const LightsList& lights, const Vector2i& start, const Vector2i& end,
+				 const Color& baseColor );
+
+	/** Invalidates every sample */
+	void invalidate();
+
+	/** Invalidates the samples inside the area ( in map pixels ) */
+	void invalidate( const Rectf& area );
+
+	const Color* getTileColor( const Vector2i& TilePos ) const;
+
+	const Color* getTileColor( const Vector2i& TilePos, const Uint32& Vertex ) const;
+
+	const bool& isByVertex() const;
+
+	/** Splits the recomputation across the pool when at least minSamples are invalid */
+	void setThreadPool( std::shared_ptr<ThreadPool> pool, Uint32 minSamples = 16384 );
+
+	/** @return The number of samples recomputed by the last update */
+	const Uint32& getUpdatedCount() const;
+
+  protected:
+	struct LightState {
+		MapLight* light;
+		Vector2f pos;
+		Float radius;
+		RGB color;
+		MapLightType type;
+		bool active;
+		Rectf aabb;
+	};
+
+	struct Run {
+		Int32 y;
+		Int32 x0;
+		Int32 x1;
+	};
+
+	Sizei mMapSize;
+	Sizei mTileSize;
+	bool mIsByVertex;
+	Sizei mSamples;
+	Vector2i mOrigin;
+	Color mBaseColor;
+	std::vector<Uint8> mR;
+	std::vector<Uint8> mG;
+	std::vector<Uint8> mB;
+	std::vector<Color> mColors;
+	std::vector<Uint8> mValid;
+	std::vector<LightState> mStates;
+	std::vector<Run> mRuns;
+	std::vector<Float> mDistances;
+	std::shared_ptr<ThreadPool> mThreadPool;
+	Uint32 mMinParallelSamples{ 16384 };
+	Uint32 mUpdatedCount{ 0 };
+
+	static LightState getState( MapLight* light );
+
+	static bool changed( const LightState& state, MapLight* light );
+
+	void syncLights( const LightsList& lights );
+
+	void computeRuns( size_t begin, size_t end, Float* distances );
+
+	void applyLight( const LightState& light, Int32 y, Int32 x0, Int32 x1, Float* distances );
+};
+
+}} // namespace EE::Maps
+
+#endif
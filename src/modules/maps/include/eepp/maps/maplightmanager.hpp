@@ -3,6 +3,7 @@
 
 #include <eepp/maps/base.hpp>
 #include <eepp/maps/maplight.hpp>
+#include <eepp/maps/maplightbuffer.hpp>
 
 namespace EE { namespace Maps {
 
@@ -38,22 +39,17 @@ class EE_MAPS_API MapLightManager {
 
 	MapLight* getLightOver( const Vector2f& OverPos, MapLight* LightCurrent = NULL );
 
+	/** Splits the light accumulation of large views across the pool threads */
+	void setThreadPool( std::shared_ptr<ThreadPool> pool, Uint32 minSamples = 16384 );
+
+	MapLightBuffer& getBuffer();
+
   protected:
 	TileMap* mMap;
-	Int32 mNumVertex;
-	Color**** mTileColors;
 	LightsList mLights;
-	bool mIsByVertex;
-
-	void allocateColors();
-
-	void deallocateColors();
+	MapLightBuffer mBuffer;
 
 	void destroyLights();
-
-	virtual void updateByVertex();
-
-	virtual void updateByTile();
 };
 
 }} // namespace EE::Maps
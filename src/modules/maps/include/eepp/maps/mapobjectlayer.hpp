@@ -3,6 +3,8 @@
 
 #include <eepp/maps/gameobject.hpp>
 #include <eepp/maps/maplayer.hpp>
+#include <eepp/maps/mapspatialindex.hpp>
+#include <unordered_set>
 
 namespace EE { namespace Maps {
 
@@ -26,14 +28,37 @@ class EE_MAPS_API MapObjectLayer : public MapLayer {
 
 	virtual void removeGameObject( const Vector2i& pos );
 
+	/** Removes and deletes the objects of the list that are still in the layer */
+	void removeGameObjects( const ObjList& objs );
+
 	virtual GameObject* getObjectOver( const Vector2i& pos, SEARCH_TYPE type = SEARCH_ALL );
 
+	/** @return The objects whose bounds intersect the area, in draw order */
+	ObjList getObjectsInArea( const Rectf& area );
+
 	virtual Uint32 getObjectCount() const;
 
+	/** Updates the object bounds in the spatial index and its active state. The objects call it
+	 * from their setters, it's needed only for changes made by other means. */
+	void updateGameObject( GameObject* obj );
+
+	/** @return The area of the layer that the object covers */
+	static Rectf getObjectBounds( GameObject* obj );
+
+	/** The objects updated every frame, the ones flagged as active or animated */
+	const ObjList& getActiveObjects() const;
+
   protected:
 	friend class TileMap;
 
 	ObjList mObjects;
+	ObjList mActiveObjects;
+	std::unordered_set<GameObject*> mActiveSet;
+	ObjList mVisibleObjects;
+	ObjList mUpdateObjects;
+	ObjList mRemovedObjects;
+	MapSpatialIndex mIndex;
+	bool mUpdating{ false };
 
 	MapObjectLayer( TileMap* map, Uint32 flags, std::string name = "",
 					Vector2f offset = Vector2f( 0, 0 ) );
@@ -43,6 +68,11 @@ class EE_MAPS_API MapObjectLayer : public MapLayer {
 	void deallocateLayer();
 
 	ObjList& getObjectList();
+
+	void setActive( GameObject* obj, bool active );
+
+	/** Deletes the object, or defers it until the end of the update if the layer is updating */
+	void deleteGameObject( GameObject* obj );
 };
 
 }} // namespace EE::Maps
@@ -8,9 +8,12 @@
 #include <eepp/maps/mapeditor/mapeditor.hpp>
 #include <eepp/maps/maplayer.hpp>
 #include <eepp/maps/maplight.hpp>
+#include <eepp/maps/maplightbuffer.hpp>
 #include <eepp/maps/mapobjectlayer.hpp>
+#include <eepp/maps/mapspatialindex.hpp>
 #include <eepp/maps/tilemap.hpp>
 #include <eepp/maps/tilemaplayer.hpp>
+#include <eepp/maps/tilemapstreamer.hpp>
 using namespace EE::Maps;
 
 #endif
@@ -0,0 +1,74 @@
+#ifndef EE_MAPS_MAPSPATIALINDEX_HPP
+#define EE_MAPS_MAPSPATIALINDEX_HPP
+
+#include <eepp/maps/base.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace EE { namespace Maps {
+
+class GameObject;
+
+/** Uniform grid over the bounds of the objects of a layer. Every object is linked to all the
+ * cells that its bounds overlap, the bounds outside the indexed area are clamped to the border
+ * cells. The queries return the objects in insertion order, that is the draw order. */
+class EE_MAPS_API MapSpatialIndex {
+  public:
+	typedef std::vector<GameObject*> ObjList;
+
+	MapSpatialIndex( const Sizei& areaSize = Sizei(), const Int32& cellSize = 256 );
+
+	/** Sets the indexed area and the cell size, reindexing the objects */
+	void setArea( const Sizei& areaSize, const Int32& cellSize );
+
+	const Int32& getCellSize() const;
+
+	void insert( GameObject* obj, const Rectf& bounds );
+
+	/** Moves the object to its new bounds, keeping its insertion order */
+	void update( GameObject* obj, const Rectf& bounds );
+
+	void remove( GameObject* obj );
+
+	bool contains( GameObject* obj ) const;
+
+	void clear();
+
+	Uint32 getCount() const;
+
+	/** Appends the objects whose bounds intersect the area */
+	void query( const Rectf& area, ObjList& objects );
+
+	/** Appends the objects whose bounds contain the point */
+	void query( const Vector2f& point, ObjList& objects );
+
+  protected:
+	struct Entry {
+		GameObject* object;
+		Rectf bounds;
+		Rect cells;
+		Uint64 order;
+		Uint32 mark;
+	};
+
+	Sizei mAreaSize;
+	Int32 mCellSize;
+	Sizei mGridSize;
+	Uint64 mLastOrder{ 0 };
+	Uint32 mLastMark{ 0 };
+	std::unordered_map<GameObject*, Entry> mEntries;
+	std::vector<std::vector<Entry*>> mCells;
+	std::vector<Entry*> mFound;
+
+	Rect getCells( const Rectf& bounds ) const;
+
+	void link( Entry* entry );
+
+	void unlink( Entry* entry );
+
+	void collect( const Rect& cells, const Rectf& area, ObjList& objects );
+};
+
+}} // namespace EE::Maps
+
+#endif
@@ -8,6 +8,7 @@
 #include <eepp/maps/maplayer.hpp>
 #include <eepp/maps/maplight.hpp>
 #include <eepp/maps/maplightmanager.hpp>
+#include <eepp/maps/tilemapstreamer.hpp>
 
 #include <eepp/window/engine.hpp>
 #include <eepp/window/input.hpp>
@@ -25,6 +26,7 @@ class UIMapNew;
 
 #define EE_MAP_LAYER_UNKNOWN eeINDEX_NOT_FOUND
 #define EE_MAP_MAGIC ( ( 'E' << 0 ) | ( 'E' << 8 ) | ( 'M' << 16 ) | ( 'P' << 24 ) )
+#define EE_MAP_CHUNKED_MAGIC ( ( 'E' << 0 ) | ( 'E' << 8 ) | ( 'M' << 16 ) | ( 'C' << 24 ) )
 
 class EE_MAPS_API TileMap {
   public:
@@ -64,6 +66,22 @@ class EE_MAPS_API TileMap {
 
 	virtual void saveToStream( IOStream& IOS );
 
+	/** Saves the map in the chunked format: the tiles and objects are stored compressed in
+	 * chunks of ChunkSize x ChunkSize tiles that can be streamed with streamFromFile. Loading it
+	 * with loadFromFile loads every chunk, so it can be saved back in the classic format. */
+	void saveToChunkedFile( const std::string& path,
+							const Uint32& ChunkSize = TileMapStreamer::DefaultChunkSize );
+
+	void saveToChunkedStream( IOStream& IOS,
+							  const Uint32& ChunkSize = TileMapStreamer::DefaultChunkSize );
+
+	/** Loads the headers of a chunked map and streams its chunks around the view while the map
+	 * is updated. The file is kept open until the map is reset. */
+	bool streamFromFile( const std::string& path );
+
+	/** @return The streamer of the map loaded with streamFromFile, NULL otherwise */
+	TileMapStreamer* getStreamer() const;
+
 	virtual void draw();
 
 	virtual void update();
@@ -234,6 +252,7 @@ class EE_MAPS_API TileMap {
 
   protected:
 	friend class EE::Maps::Private::UIMapNew;
+	friend class TileMapStreamer;
 
 	class ForcedHeaders {
 	  public:
@@ -286,6 +305,7 @@ class EE_MAPS_API TileMap {
 	Uint32 mLastObjId;
 	PolyObjMap mPolyObjs;
 	ForcedHeaders* mForcedHeaders;
+	TileMapStreamer* mStreamer;
 
 	virtual GameObject* createGameObject( const Uint32& Type, const Uint32& Flags, MapLayer* Layer,
 										  const Uint32& DataId = 0 );
@@ -311,6 +331,24 @@ class EE_MAPS_API TileMap {
 	void createLightManager();
 
 	virtual void onMapLoaded();
+
+	void readHeaders( IOStream& IOS, const sMapHdr& MapHdr, std::vector<sLayerHdr>& LayersHdr );
+
+	bool hasTiledLayers();
+
+	void readTiles( IOStream& IOS, const Rect& TileArea );
+
+	GameObject* readObject( IOStream& IOS, MapObjectLayer* Layer );
+
+	void readLights( IOStream& IOS, const Uint32& LightsCount );
+
+	sMapHdr writeHeaders( IOStream& IOS, const Uint32& Magic );
+
+	void writeTiles( IOStream& IOS, const Rect& TileArea );
+
+	void writeObject( IOStream& IOS, GameObject* Obj );
+
+	void writeLights( IOStream& IOS );
 };
 
 }} // namespace EE::Maps
@@ -4,6 +4,11 @@
 #include <eepp/maps/gameobject.hpp>
 #include <eepp/maps/maplayer.hpp>
 
+#include <eepp/graphics/batchrenderer.hpp>
+#include <eepp/graphics/texture.hpp>
+#include <vector>
+using namespace EE::Graphics;
+
 namespace EE { namespace Maps {
 
 class EE_MAPS_API TileMapLayer : public MapLayer {
@@ -28,12 +33,67 @@ class EE_MAPS_API TileMapLayer : public MapLayer {
 
 	Vector2f getPosFromTilePos( const Vector2i& TilePos );
 
+	/** Width and height in tiles of the chunks of the chunked rendering */
+	static constexpr Int32 ChunkSize = 32;
+
+	/** In chunked rendering the consecutive static tiles ( the texture region objects ) of every
+	 * chunk that share texture and blend mode are baked into a vertex array, and drawn with a
+	 * single draw call each. A chunk is rebuilt only when one of its tiles is added, removed or
+	 * moved. The rest of the objects are drawn one by one between the baked tiles, so inside a
+	 * chunk the tiles keep the order of the unchunked draw. The chunks are drawn one after
+	 * another though: a tile bigger than the tile size that overlaps a neighbour chunk can be
+	 * drawn in a different order relative to the tiles of that chunk. */
+	void setChunkedRendering( bool chunked );
+
+	bool isChunkedRendering() const;
+
+	/** Rebuilds the dirty chunks in view and refreshes the light colors of the rest, the work
+	 * draw() does before submitting the chunks.
+	 * @return The number of vertex arrays and unbaked objects that draw() submits */
+	Uint32 updateChunks();
+
+	/** Rebuilds the chunk of the tile, needed after modifying the tile object in place ( e.g. its
+	 * flags or its texture region ) in chunked rendering. */
+	void invalidateTile( const Vector2i& TilePos );
+
+	/** Rebuilds every chunk */
+	void invalidateChunks();
+
+	/** Deletes the objects of the tiles inside the area ( in tiles, right and bottom excluded ) and
+	 * releases the tile blocks left empty */
+	void removeGameObjects( const Rect& TileArea );
+
+	/** @return The number of tile blocks allocated */
+	Uint32 getAllocatedBlocks() const;
+
   protected:
 	friend class TileMap;
 
-	GameObject*** mTiles;
+	struct ChunkBatch {
+		Texture* texture{ NULL };
+		BlendMode blend;
+		std::vector<VertexData> vertexs;
+		/** The tile of every quad, to update the light colors */
+		std::vector<Vector2i> tiles;
+		/** The tiles with objects that can't be baked, drawn after the quads of the batch */
+		std::vector<Vector2i> objects;
+	};
+
+	struct Chunk {
+		bool dirty{ true };
+		std::vector<ChunkBatch> batches;
+	};
+
+	/** The tiles are stored in blocks of ChunkSize x ChunkSize tiles, allocated with the first
+	 * object added to the block, so the memory used follows the tiles in use */
+	std::vector<GameObject**> mTileBlocks;
+	Sizei mBlocksSize;
 	Sizei mSize;
 	Vector2i mCurTile;
+	bool mChunked{ false };
+	Uint32 mChunksLightMode{ 0 };
+	Sizei mChunksSize;
+	std::vector<Chunk> mChunks;
 
 	TileMapLayer( TileMap* map, Sizei size, Uint32 flags, std::string name = "",
 				  Vector2f offset = Vector2f( 0, 0 ) );
@@ -41,6 +101,26 @@ class EE_MAPS_API TileMapLayer : public MapLayer {
 	void allocateLayer();
 
 	void deallocateLayer();
+
+	GameObject* getTile( const Int32& x, const Int32& y ) const;
+
+	/** @return The tile slot, allocating its block if needed */
+	GameObject*& getTileRef( const Int32& x, const Int32& y );
+
+	/** @return False if there are no tiles in view */
+	bool getChunksInView( Vector2i& chunkStart, Vector2i& chunkEnd );
+
+	bool isTileInView( const Vector2i& TilePos );
+
+	void drawChunks();
+
+	void buildChunk( const Vector2i& chunkPos, Chunk& chunk );
+
+	bool bakeTile( Chunk& chunk, GameObject* obj, const Vector2i& TilePos );
+
+	void updateChunkLights( Chunk& chunk );
+
+	Uint32 getLightMode();
 };
 
 }} // namespace EE::Maps
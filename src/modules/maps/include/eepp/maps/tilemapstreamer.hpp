@@ -0,0 +1,117 @@
+#ifndef EE_MAPS_TILEMAPSTREAMER_HPP
+#define EE_MAPS_TILEMAPSTREAMER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <eepp/core/noncopyable.hpp>
+#include <eepp/maps/base.hpp>
+#include <eepp/maps/maphelper.hpp>
+#include <eepp/maps/mapobjectlayer.hpp>
+#include <eepp/system/iostream.hpp>
+#include <eepp/system/mutex.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace EE { namespace Maps {
+
+class TileMap;
+
+/** Loads the chunks of a chunked map file around the view of the map, and unloads the ones that
+ * get far from it, so the memory used is bounded by the view and the load radius instead of the
+ * map size. The chunks are read and decompressed in a background thread and added to the map in
+ * update(). The changes made to the objects of a chunk are lost when it's unloaded.
+ * @see TileMap::saveToChunkedFile and TileMap::streamFromFile */
+class EE_MAPS_API TileMapStreamer : NonCopyable {
+  public:
+	static constexpr Uint32 DefaultChunkSize = 32;
+
+	/** Reads the chunks header and table from the current position of the stream. The stream
+	 * must stay valid while the streamer exists, it's deleted with it if ownStream is true. */
+	TileMapStreamer( TileMap* map, IOStream* stream, bool ownStream );
+
+	~TileMapStreamer();
+
+	/** Adds the chunks loaded in background, unloads the chunks outside the load radius plus the
+	 * unload margin and queues the missing chunks inside the load radius, nearest first. */
+	void update();
+
+	/** Loads every chunk of the map, in the calling thread */
+	void loadAll();
+
+	/** Waits for the queued chunks and adds them to the map */
+	void flush();
+
+	/** Chunks around the visible ones to keep loaded */
+	void setLoadRadius( const Uint32& radius );
+
+	const Uint32& getLoadRadius() const;
+
+	/** Chunks beyond the load radius to wait before unloading a chunk, so the chunks on the border
+	 * are not reloaded while the view moves back and forth */
+	void setUnloadMargin( const Uint32& margin );
+
+	const Uint32& getUnloadMargin() const;
+
+	bool isValid() const;
+
+	bool isChunkLoaded( const Vector2i& chunk ) const;
+
+	Uint32 getLoadedCount() const;
+
+	Uint32 getPendingCount() const;
+
+	const Uint32& getChunkSize() const;
+
+	const Sizei& getChunksSize() const;
+
+  protected:
+	enum ChunkState : Uint8 { CHUNK_UNLOADED, CHUNK_QUEUED, CHUNK_LOADED };
+
+	struct ChunkData {
+		Uint32 index;
+		std::vector<char> data;
+	};
+
+	TileMap* mMap;
+	IOStream* mStream;
+	bool mOwnStream;
+	bool mValid{ false };
+	sMapChunksHdr mHdr;
+	Sizei mChunksSize;
+	ios_size mDataStart{ 0 };
+	std::vector<sMapChunkEntry> mTable;
+	std::vector<Uint8> mStates;
+	Uint32 mLoadedCount{ 0 };
+	//! The objects added by every loaded chunk, by object layer
+	std::unordered_map<Uint32, std::vector<std::pair<MapObjectLayer*, MapObjectLayer::ObjList>>>
+		mChunkObjects;
+	Uint32 mLoadRadius{ 1 };
+	Uint32 mUnloadMargin{ 1 };
+	Mutex mStreamMutex;
+	std::mutex mDoneMutex;
+	std::condition_variable mDoneCond;
+	std::vector<ChunkData> mDone;
+	//! Decremented with mDoneMutex locked, so flush can wait for it
+	std::atomic<Uint32> mPending{ 0 };
+	std::unique_ptr<ThreadPool> mPool;
+
+	/** The chunks around the visible tiles, clamped to the map */
+	Rect getViewChunks( const Uint32& radius ) const;
+
+	bool readChunk( const Uint32& index, std::vector<char>& data );
+
+	void applyChunk( const Uint32& index, const std::vector<char>& data );
+
+	void applyDone();
+
+	void queueChunk( const Uint32& index );
+
+	void unloadChunk( const Uint32& index );
+};
+
+}} // namespace EE::Maps
+
+#endif
@@ -1,4 +1,5 @@
 #include <eepp/maps/gameobject.hpp>
+#include <eepp/maps/mapobjectlayer.hpp>
 #include <eepp/maps/tilemaplayer.hpp>
 
 namespace EE { namespace Maps {
@@ -26,12 +27,14 @@ Uint32 GameObject::getFlag( const Uint32& Flag ) {
 void GameObject::setFlag( const Uint32& Flag ) {
 	if ( !( mFlags & Flag ) ) {
 		mFlags |= Flag;
+		updateLayerIndex();
 	}
 }
 
 void GameObject::clearFlag( const Uint32& Flag ) {
 	if ( mFlags & Flag ) {
 		mFlags &= ~Flag;
+		updateLayerIndex();
 	}
 }
 
@@ -88,6 +91,7 @@ Vector2f GameObject::getPosition() const {
 
 void GameObject::setPosition( Vector2f pos ) {
 	autoFixTilePos();
+	updateLayerIndex();
 }
 
 Vector2i GameObject::getTilePosition() const {
@@ -155,6 +159,11 @@ void GameObject::assignTilePos() {
 	setTilePosition( TLayer->getTilePosFromPos( getPosition() ) );
 }
 
+void GameObject::updateLayerIndex() {
+	if ( NULL != mLayer && mLayer->getType() == MAP_LAYER_OBJECT )
+		static_cast<MapObjectLayer*>( mLayer )->updateGameObject( this );
+}
+
 Float GameObject::getRotation() {
 	return isRotated() ? 90 : 0;
 }
@@ -54,6 +54,7 @@ void GameObjectObject::setPosition( Vector2f pos ) {
 	mPoly.move( pos - mPos );
 	mPos = pos;
 	mRect = Rectf( pos, Sizef( getSize().x, getSize().y ) );
+	updateLayerIndex();
 }
 
 void GameObjectObject::setPolygonPoint( Uint32 index, Vector2f p ) {
@@ -85,6 +86,7 @@ void GameObjectObject::setPolygonPoint( Uint32 index, Vector2f p ) {
 	mRect = mPoly.getBounds();
 	mPos = Vector2f( mRect.Left, mRect.Top );
 	mPoly = mRect;
+	updateLayerIndex();
 }
 
 Uint32 GameObjectObject::getDataId() {
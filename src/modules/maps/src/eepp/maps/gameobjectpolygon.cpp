@@ -44,6 +44,7 @@ void GameObjectPolygon::setPolygonPoint( Uint32 index, Vector2f p ) {
 	mPoly.setAt( index, p );
 	mRect = mPoly.getBounds();
 	mPos = Vector2f( mRect.Left, mRect.Top );
+	updateLayerIndex();
 }
 
 bool GameObjectPolygon::pointInside( const Vector2f& p ) {
@@ -120,6 +120,7 @@ Vector2f GameObjectVirtual::getPosition() const {
 
 void GameObjectVirtual::setPosition( Vector2f pos ) {
 	mPos = pos;
+	updateLayerIndex();
 }
 
 Uint32 GameObjectVirtual::getDataId() {
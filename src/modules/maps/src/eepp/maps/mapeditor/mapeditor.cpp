@@ -192,6 +192,10 @@ void MapEditor::createMenuBar() {
 
 	mLayerChkLights = PU5->addCheckBox( "Lights Enabled" );
 
+	mLayerChkChunked = PU5->addCheckBox( "Chunked Rendering" );
+	mLayerChkChunked->setTooltipText(
+		"Bakes the static tiles of the tile layer in chunks, drawn with a few draw calls each." );
+
 	PU5->addSeparator();
 
 	mLayerChkVisible = PU5->addCheckBox( "Visible" );
@@ -1327,6 +1331,13 @@ void MapEditor::layerMenuClick( const Event* Event ) {
 		if ( NULL != mCurLayer ) {
 			mCurLayer->setLightsEnabled( !mCurLayer->getLightsEnabled() );
 		}
+	} else if ( "Chunked Rendering" == txt ) {
+		if ( NULL != mCurLayer && mCurLayer->getType() == MAP_LAYER_TILED ) {
+			TileMapLayer* tileLayer = static_cast<TileMapLayer*>( mCurLayer );
+			tileLayer->setChunkedRendering( !tileLayer->isChunkedRendering() );
+		}
+
+		mLayerChkChunked->setActive( isChunkedLayer( mCurLayer ) );
 	} else if ( "Visible" == txt ) {
 		if ( NULL != mCurLayer ) {
 			mCurLayer->setVisible( !mCurLayer->isVisible() );
@@ -1334,6 +1345,11 @@ void MapEditor::layerMenuClick( const Event* Event ) {
 	}
 }
 
+bool MapEditor::isChunkedLayer( MapLayer* layer ) {
+	return NULL != layer && layer->getType() == MAP_LAYER_TILED &&
+		   static_cast<TileMapLayer*>( layer )->isChunkedRendering();
+}
+
 UIMessageBox* MapEditor::createAlert( const String& title, const String& text ) {
 	UIMessageBox* MsgBox = UIMessageBox::New( UIMessageBox::OK, text );
 	MsgBox->setWindowFlags( UI_WIN_DEFAULT_FLAGS | UI_WIN_RESIZEABLE | UI_WIN_MODAL );
@@ -1443,6 +1459,8 @@ void MapEditor::onLayerSelect( const Event* ) {
 		mLayerChkVisible->setActive( mCurLayer->isVisible() );
 
 		mLayerChkLights->setActive( mCurLayer->getLightsEnabled() );
+
+		mLayerChkChunked->setActive( isChunkedLayer( mCurLayer ) );
 	}
 }
 
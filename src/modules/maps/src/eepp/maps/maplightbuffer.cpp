@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <eepp/maps/maplightbuffer.hpp>
+
+namespace EE { namespace Maps {
+
+/** The MapLight::processVertex falloff of a color channel over the samples [from, to): the
+ * channel moves towards the light color when the light is brighter and the sample is inside the
+ * radius. It's written without branches so the compiler can vectorize it. */
+static void lightChannel( Uint8* channel, const Float* distances, Int32 from, Int32 to,
+						  const Uint8& lightColor, const Float& radius ) {
+	const Float light = lightColor;
+
+	for ( Int32 x = from; x < to; x++ ) {
+		const Float color = channel[x];
+		const Float lit = light - distances[x] * ( ( light - color ) / radius );
+		const bool inside = ( distances[x] <= radius ) & ( light > color );
+		const Uint8 result = (Uint8)( inside ? lit : color );
+		channel[x] = eemax( result, channel[x] );
+	}
+}
+
+/** The sample index of a position in the axis, clamped to [-1, count] */
+static Int32 sampleIndex( const Float& pos, const Int32& count ) {
+	return (Int32)eemax( -1.f, eemin( pos, (Float)count ) );
+}
+
+MapLightBuffer::MapLightBuffer( const Sizei& mapSize, const Sizei& tileSize, bool byVertex ) :
+	mMapSize( mapSize ),
+	mTileSize( tileSize ),
+	mIsByVertex( byVertex ),
+	mBaseColor( 255, 255, 255, 255 ) {
+	if ( mIsByVertex ) {
+		mSamples = Sizei( mapSize.x + 1, mapSize.y + 1 );
+	} else {
+		mSamples = mapSize;
+		mOrigin = Vector2i( tileSize.x / 2, tileSize.y / 2 );
+	}
+
+	size_t count = (size_t)mSamples.x * mSamples.y;
+	mR.resize( count, 255 );
+	mG.resize( count, 255 );
+	mB.resize( count, 255 );
+	mColors.resize( count, Color( 255, 255, 255, 255 ) );
+	mValid.resize( count, 0 );
+	mDistances.resize( mSamples.x );
+}
+
+const bool& MapLightBuffer::isByVertex() const {
+	return mIsByVertex;
+}
+
+void MapLightBuffer::setThreadPool( std::shared_ptr<ThreadPool> pool, Uint32 minSamples ) {
+	mThreadPool = pool;
+	mMinParallelSamples = minSamples;
+}
+
+const Uint32& MapLightBuffer::getUpdatedCount() const {
+	return mUpdatedCount;
+}
+
+MapLightBuffer::LightState MapLightBuffer::getState( MapLight* light ) {
+	return { light,
+			 light->getPosition(),
+			 light->getRadius(),
+			 light->getColor(),
+			 light->getType(),
+			 light->isActive(),
+			 light->getAABB() };
+}
+
+bool MapLightBuffer::changed( const LightState& state, MapLight* light ) {
+	const RGB& color = light->getColor();
+	return state.pos != light->getPosition() || state.radius != light->getRadius() ||
+		   state.color.r != color.r || state.color.g != color.g || state.color.b != color.b ||
+		   state.type != light->getType() || state.active != light->isActive();
+}
+
+void MapLightBuffer::syncLights( const LightsList& lights ) {
+	size_t common = 0;
+
+	while ( common < mStates.size() && common < lights.size() &&
+			mStates[common].light == lights[common] ) {
+		if ( changed( mStates[common], lights[common] ) ) {
+			invalidate( mStates[common].aabb );
+			mStates[common] = getState( lights[common] );
+			invalidate( mStates[common].aabb );
+		}
+
+		common++;
+	}
+
+	// The lights are accumulated in order, so every light after the first one added, removed or
+	// reordered is invalidated
+	for ( size_t i = common; i < mStates.size(); i++ )
+		invalidate( mStates[i].aabb );
+
+	mStates.resize( common );
+
+	for ( size_t i = common; i < lights.size(); i++ ) {
+		mStates.push_back( getState( lights[i] ) );
+		invalidate( mStates.back().aabb );
+	}
+}
+
+void MapLightBuffer::invalidate() {
+	std::fill( mValid.begin(), mValid.end(), 0 );
+}
+
+void MapLightBuffer::invalidate( const Rectf& area ) {
+	Int32 x0 = eemax( 0, sampleIndex( eeceil( ( area.Left - mOrigin.x ) / mTileSize.x ),
+									  mSamples.x ) );
+	Int32 x1 = eemin( mSamples.x - 1,
+					  sampleIndex( eefloor( ( area.Right - mOrigin.x ) / mTileSize.x ),
+								   mSamples.x ) );
+	Int32 y0 = eemax( 0, sampleIndex( eeceil( ( area.Top - mOrigin.y ) / mTileSize.y ),
+									  mSamples.y ) );
+	Int32 y1 = eemin( mSamples.y - 1,
+					  sampleIndex( eefloor( ( area.Bottom - mOrigin.y ) / mTileSize.y ),
+								   mSamples.y ) );
+
+	if ( x0 > x1 )
+		return;
+
+	for ( Int32 y = y0; y <= y1; y++ )
+		std::fill( &mValid[y * mSamples.x + x0], &mValid[y * mSamples.x + x1] + 1, 0 );
+}
+
+void MapLightBuffer::update( const LightsList& lights, const Vector2i& start, const Vector2i& end,
+							 const Color& baseColor ) {
+	if ( baseColor.r != mBaseColor.r || baseColor.g != mBaseColor.g ||
+		 baseColor.b != mBaseColor.b ) {
+		mBaseColor = baseColor;
+		invalidate();
+	}
+
+	syncLights( lights );
+
+	// The corners of the last visible tiles are visible too
+	Int32 extra = mIsByVertex ? 1 : 0;
+	Int32 x0 = eemax( start.x, 0 );
+	Int32 y0 = eemax( start.y, 0 );
+	Int32 x1 = eemin( end.x + extra, mSamples.x );
+	Int32 y1 = eemin( end.y + extra, mSamples.y );
+
+	mRuns.clear();
+	mUpdatedCount = 0;
+
+	for ( Int32 y = y0; y < y1; y++ ) {
+		const Uint8* valid = &mValid[y * mSamples.x];
+		Int32 x = x0;
+
+		while ( x < x1 ) {
+			if ( valid[x] ) {
+				x++;
+				continue;
+			}
+
+			Int32 runStart = x;
+
+			while ( x < x1 && !valid[x] )
+				x++;
+
+			mRuns.push_back( { y, runStart, x } );
+			mUpdatedCount += x - runStart;
+		}
+	}
+
+	if ( mRuns.empty() )
+		return;
+
+	if ( mThreadPool && mRuns.size() > 1 && mUpdatedCount >= mMinParallelSamples ) {
+		size_t ranges = ( mThreadPool->numThreads() + 1 ) * 4;
+		size_t grain = eemax<size_t>( 1, mRuns.size() / ranges );
+
+		mThreadPool->parallelFor( 0, mRuns.size(), grain, [this]( size_t first, size_t last ) {
+			std::vector<Float> distances( mSamples.x );
+			computeRuns( first, last, distances.data() );
+		} );
+	} else {
+		computeRuns( 0, mRuns.size(), mDistances.data() );
+	}
+}
+
+void MapLightBuffer::computeRuns( size_t begin, size_t end, Float* distances ) {
+	for ( size_t i = begin; i < end; i++ ) {
+		const Run& run = mRuns[i];
+		size_t row = (size_t)run.y * mSamples.x;
+		Float y = mOrigin.y + run.y * mTileSize.y;
+
+		std::fill( &mR[row + run.x0], &mR[row + run.x1], mBaseColor.r );
+		std::fill( &mG[row + run.x0], &mG[row + run.x1], mBaseColor.g );
+		std::fill( &mB[row + run.x0], &mB[row + run.x1], mBaseColor.b );
+
+		for ( const auto& light : mStates ) {
+			if ( light.active && light.radius > 0 && y >= light.aabb.Top &&
+				 y <= light.aabb.Bottom )
+				applyLight( light, run.y, run.x0, run.x1, distances );
+		}
+
+		for ( Int32 x = run.x0; x < run.x1; x++ )
+			mColors[row + x].assign( mR[row + x], mG[row + x], mB[row + x], 255 );
+
+		std::fill( &mValid[row + run.x0], &mValid[row + run.x1], 1 );
+	}
+}
+
+void MapLightBuffer::applyLight( const LightState& light, Int32 y, Int32 x0, Int32 x1,
+								 Float* distances ) {
+	Float left = eeceil( ( light.aabb.Left - mOrigin.x ) / mTileSize.x );
+	Float right = eefloor( ( light.aabb.Right - mOrigin.x ) / mTileSize.x );
+	Int32 from = eemax( x0, sampleIndex( left, mSamples.x ) );
+	Int32 to = eemin( x1, sampleIndex( right, mSamples.x ) + 1 );
+
+	if ( from >= to )
+		return;
+
+	size_t row = (size_t)y * mSamples.x;
+	const Float dy = (Float)( mOrigin.y + y * mTileSize.y ) - light.pos.y;
+
+	if ( light.type == MapLightType::Normal ) {
+		for ( Int32 x = from; x < to; x++ ) {
+			const Float dx = (Float)( mOrigin.x + x * mTileSize.x ) - light.pos.x;
+			distances[x] = eesqrt( dx * dx + dy * dy );
+		}
+	} else {
+		for ( Int32 x = from; x < to; x++ ) {
+			const Float dx = ( (Float)( mOrigin.x + x * mTileSize.x ) - light.pos.x ) * 0.5f;
+			distances[x] = eesqrt( dx * dx + dy * dy ) * 2.0f;
+		}
+	}
+
+	lightChannel( &mR[row], distances, from, to, light.color.r, light.radius );
+	lightChannel( &mG[row], distances, from, to, light.color.g, light.radius );
+	lightChannel( &mB[row], distances, from, to, light.color.b, light.radius );
+}
+
+const Color* MapLightBuffer::getTileColor( const Vector2i& TilePos ) const {
+	return &mColors[TilePos.y * mSamples.x + TilePos.x];
+}
+
+const Color* MapLightBuffer::getTileColor( const Vector2i& TilePos, const Uint32& Vertex ) const {
+	// The corners are sorted as the tile quad: top-left, bottom-left, bottom-right and top-right
+	static const Int32 cornerX[4] = { 0, 0, 1, 1 };
+	static const Int32 cornerY[4] = { 0, 1, 1, 0 };
+	return &mColors[( TilePos.y + cornerY[Vertex] ) * mSamples.x + TilePos.x + cornerX[Vertex]];
+}
+
+}} // namespace EE::Maps
@@ -4,138 +4,28 @@
 
 namespace EE { namespace Maps {
 
-MapLightManager::MapLightManager( TileMap* Map, bool ByVertex ) : mMap( Map ), mTileColors( NULL ) {
-	mIsByVertex = ByVertex;
-
-	if ( mIsByVertex )
-		mNumVertex = 4;
-	else
-		mNumVertex = 1;
-
-	allocateColors();
-}
+MapLightManager::MapLightManager( TileMap* Map, bool ByVertex ) :
+	mMap( Map ), mBuffer( Map->getSize(), Map->getTileSize(), ByVertex ) {}
 
 MapLightManager::~MapLightManager() {
-	deallocateColors();
 	destroyLights();
 }
 
 void MapLightManager::update() {
-	if ( mIsByVertex ) {
-		updateByVertex();
-	} else {
-		updateByTile();
-	}
+	// Also runs without lights, so the tiles lit by the removed lights are invalidated
+	mBuffer.update( mLights, mMap->getStartTile(), mMap->getEndTile(), mMap->getBaseColor() );
 }
 
 const bool& MapLightManager::isByVertex() const {
-	return mIsByVertex;
+	return mBuffer.isByVertex();
 }
 
-void MapLightManager::updateByVertex() {
-	Vector2i start = mMap->getStartTile();
-	Vector2i end = mMap->getEndTile();
-	Rectf VisibleArea = mMap->getViewAreaAABB();
-	Sizei TileSize = mMap->getTileSize();
-	Color BaseColor = mMap->getBaseColor();
-	bool firstLight = true;
-	Vector2i Pos;
-
-	if ( !mLights.size() )
-		return;
-
-	for ( LightsList::iterator it = mLights.begin(); it != mLights.end(); ++it ) {
-		MapLight* Light = ( *it );
-
-		if ( firstLight || VisibleArea.intersect( Light->getAABB() ) ) {
-			for ( Int32 x = start.x; x < end.x; x++ ) {
-				for ( Int32 y = start.y; y < end.y; y++ ) {
-					if ( firstLight ) {
-						mTileColors[x][y][0]->r = mTileColors[x][y][1]->r =
-							mTileColors[x][y][2]->r = mTileColors[x][y][3]->r = BaseColor.r;
-						mTileColors[x][y][0]->g = mTileColors[x][y][1]->g =
-							mTileColors[x][y][2]->g = mTileColors[x][y][3]->g = BaseColor.g;
-						mTileColors[x][y][0]->b = mTileColors[x][y][1]->b =
-							mTileColors[x][y][2]->b = mTileColors[x][y][3]->b = BaseColor.b;
-					}
-
-					Pos.x = x * TileSize.x;
-					Pos.y = y * TileSize.y;
-
-					Rectf TileAABB( Pos.x, Pos.y, Pos.x + TileSize.x, Pos.y + TileSize.y );
-
-					if ( TileAABB.intersect( Light->getAABB() ) ) {
-						if ( y > 0 )
-							mTileColors[x][y][0]->assign( *mTileColors[x][y - 1][1] );
-						else
-							mTileColors[x][y][0]->assign(
-								Light->processVertex( Pos.x, Pos.y, *( mTileColors[x][y][0] ),
-													  *( mTileColors[x][y][0] ) ) );
-
-						mTileColors[x][y][1]->assign( Light->processVertex(
-							Pos.x, Pos.y + TileSize.getHeight(), *( mTileColors[x][y][1] ),
-							*( mTileColors[x][y][1] ) ) );
-
-						mTileColors[x][y][2]->assign( Light->processVertex(
-							Pos.x + TileSize.getWidth(), Pos.y + TileSize.getHeight(),
-							*( mTileColors[x][y][2] ), *( mTileColors[x][y][2] ) ) );
-
-						if ( y > 0 )
-							mTileColors[x][y][3]->assign( *mTileColors[x][y - 1][2] );
-						else
-							mTileColors[x][y][3]->assign( Light->processVertex(
-								Pos.x + TileSize.getWidth(), Pos.y, *( mTileColors[x][y][3] ),
-								*( mTileColors[x][y][3] ) ) );
-					}
-				}
-			}
-
-			firstLight = false;
-		}
-	}
+void MapLightManager::setThreadPool( std::shared_ptr<ThreadPool> pool, Uint32 minSamples ) {
+	mBuffer.setThreadPool( pool, minSamples );
 }
 
-void MapLightManager::updateByTile() {
-	Vector2i start = mMap->getStartTile();
-	Vector2i end = mMap->getEndTile();
-	Rectf VisibleArea = mMap->getViewAreaAABB();
-	Sizei TileSize = mMap->getTileSize();
-	Sizei HalfTileSize = mMap->getTileSize() / 2;
-	Color BaseColor = mMap->getBaseColor();
-	bool firstLight = true;
-	Vector2i Pos;
-
-	if ( !mLights.size() )
-		return;
-
-	for ( LightsList::iterator it = mLights.begin(); it != mLights.end(); ++it ) {
-		MapLight* Light = ( *it );
-
-		if ( firstLight || VisibleArea.intersect( Light->getAABB() ) ) {
-			for ( Int32 x = start.x; x < end.x; x++ ) {
-				for ( Int32 y = start.y; y < end.y; y++ ) {
-					if ( firstLight ) {
-						mTileColors[x][y][0]->r = BaseColor.r;
-						mTileColors[x][y][0]->g = BaseColor.g;
-						mTileColors[x][y][0]->b = BaseColor.b;
-					}
-
-					Pos.x = x * TileSize.x;
-					Pos.y = y * TileSize.y;
-
-					Rectf TileAABB( Pos.x, Pos.y, Pos.x + TileSize.x, Pos.y + TileSize.y );
-
-					if ( TileAABB.intersect( Light->getAABB() ) ) {
-						mTileColors[x][y][0]->assign( Light->processVertex(
-							Pos.x + HalfTileSize.getWidth(), Pos.y + HalfTileSize.getHeight(),
-							*( mTileColors[x][y][0] ), *( mTileColors[x][y][0] ) ) );
-					}
-				}
-			}
-
-			firstLight = false;
-		}
-	}
+MapLightBuffer& MapLightManager::getBuffer() {
+	return mBuffer;
 }
 
 Color MapLightManager::getColorFromPos( const Vector2f& Pos ) {
@@ -188,56 +78,21 @@ void MapLightManager::removeLight( const Vector2f& OverPos ) {
 }
 
 const Color* MapLightManager::getTileColor( const Vector2i& TilePos ) {
-	eeASSERT( 1 == mNumVertex );
+	eeASSERT( !mBuffer.isByVertex() );
 
 	if ( !mLights.size() )
 		return &mMap->getBaseColor();
 
-	return mTileColors[TilePos.x][TilePos.y][0];
+	return mBuffer.getTileColor( TilePos );
 }
 
 const Color* MapLightManager::getTileColor( const Vector2i& TilePos, const Uint32& Vertex ) {
-	eeASSERT( 4 == mNumVertex );
+	eeASSERT( mBuffer.isByVertex() );
 
 	if ( !mLights.size() )
 		return &mMap->getBaseColor();
 
-	return mTileColors[TilePos.x][TilePos.y][Vertex];
-}
-
-void MapLightManager::allocateColors() {
-	Sizei Size = mMap->getSize();
-	mTileColors = eeNewArray( Color***, Size.getWidth() );
-
-	for ( Int32 x = 0; x < Size.x; x++ ) {
-		mTileColors[x] = eeNewArray( Color**, Size.getHeight() );
-
-		for ( Int32 y = 0; y < Size.y; y++ ) {
-			mTileColors[x][y] = eeNewArray( Color*, mNumVertex );
-
-			for ( Int32 v = 0; v < mNumVertex; v++ ) {
-				mTileColors[x][y][v] = eeNew( Color, ( 255, 255, 255, 255 ) );
-			}
-		}
-	}
-}
-
-void MapLightManager::deallocateColors() {
-	Sizei Size = mMap->getSize();
-
-	for ( Int32 x = 0; x < Size.x; x++ ) {
-		for ( Int32 y = 0; y < Size.y; y++ ) {
-			for ( Int32 v = 0; v < mNumVertex; v++ ) {
-				eeSAFE_DELETE( mTileColors[x][y][v] );
-			}
-
-			eeSAFE_DELETE_ARRAY( mTileColors[x][y] );
-		}
-
-		eeSAFE_DELETE_ARRAY( mTileColors[x] );
-	}
-
-	eeSAFE_DELETE_ARRAY( mTileColors );
+	return mBuffer.getTileColor( TilePos, Vertex );
 }
 
 void MapLightManager::destroyLights() {
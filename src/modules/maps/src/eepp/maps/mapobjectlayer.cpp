@@ -12,7 +12,8 @@ using namespace EE::Graphics;
 namespace EE { namespace Maps {
 
 MapObjectLayer::MapObjectLayer( TileMap* map, Uint32 flags, std::string name, Vector2f offset ) :
-	MapLayer( map, MAP_LAYER_OBJECT, flags, name, offset ) {}
+	MapLayer( map, MAP_LAYER_OBJECT, flags, name, offset ),
+	mIndex( map->getTotalSize(), eemax( map->getTileSize().x, map->getTileSize().y ) * 8 ) {}
 
 MapObjectLayer::~MapObjectLayer() {
 	deallocateLayer();
@@ -24,6 +25,15 @@ void MapObjectLayer::deallocateLayer() {
 	for ( ObjList::iterator it = mObjects.begin(); it != mObjects.end(); ++it ) {
 		eeSAFE_DELETE( *it );
 	}
+
+	for ( GameObject* obj : mRemovedObjects )
+		eeDelete( obj );
+
+	mObjects.clear();
+	mRemovedObjects.clear();
+	mActiveObjects.clear();
+	mActiveSet.clear();
+	mIndex.clear();
 }
 
 void MapObjectLayer::draw( const Vector2f& Offset ) {
@@ -37,7 +47,16 @@ void MapObjectLayer::draw( const Vector2f& Offset ) {
 	GLi->pushMatrix();
 	GLi->translatef( mOffset.x, mOffset.y, 0.0f );
 
-	for ( it = mObjects.begin(); it != mObjects.end(); ++it ) {
+	// The view area in the layer coordinates
+	const Rectf& view = mMap->getViewAreaAABB();
+	Float scale = mMap->getScale();
+	Rectf area( view.Left / scale - mOffset.x, view.Top / scale - mOffset.y,
+				view.Right / scale - mOffset.x, view.Bottom / scale - mOffset.y );
+
+	mVisibleObjects.clear();
+	mIndex.query( area, mVisibleObjects );
+
+	for ( it = mVisibleObjects.begin(); it != mVisibleObjects.end(); ++it ) {
 		( *it )->draw();
 	}
 
@@ -46,7 +65,7 @@ void MapObjectLayer::draw( const Vector2f& Offset ) {
 	if ( mMap->getShowBlocked() && NULL != Tex ) {
 		Color Col( 255, 0, 0, 200 );
 
-		for ( it = mObjects.begin(); it != mObjects.end(); ++it ) {
+		for ( it = mVisibleObjects.begin(); it != mVisibleObjects.end(); ++it ) {
 			GameObject* Obj = ( *it );
 
 			if ( Obj->isBlocked() ) {
@@ -62,9 +81,23 @@ void MapObjectLayer::draw( const Vector2f& Offset ) {
 }
 
 void MapObjectLayer::update( const Time& dt ) {
-	for ( ObjList::iterator it = mObjects.begin(); it != mObjects.end(); ++it ) {
-		( *it )->update( dt );
+	// An update can add or remove objects. The active objects are iterated from a snapshot, the
+	// ones removed or deactivated meanwhile are skipped and their deletion is deferred.
+	mUpdateObjects = mActiveObjects;
+	mUpdating = true;
+
+	for ( GameObject* obj : mUpdateObjects ) {
+		if ( mActiveSet.find( obj ) != mActiveSet.end() )
+			obj->update( dt );
 	}
+
+	mUpdating = false;
+	mUpdateObjects.clear();
+
+	for ( GameObject* obj : mRemovedObjects )
+		eeDelete( obj );
+
+	mRemovedObjects.clear();
 }
 
 Uint32 MapObjectLayer::getObjectCount() const {
@@ -73,13 +106,99 @@ Uint32 MapObjectLayer::getObjectCount() const {
 
 void MapObjectLayer::addGameObject( GameObject* obj ) {
 	mObjects.push_back( obj );
+	mIndex.insert( obj, getObjectBounds( obj ) );
+	setActive( obj, obj->getFlags() & ( GObjFlags::GAMEOBJECT_ACTIVE |
+										GObjFlags::GAMEOBJECT_ANIMATED ) );
 }
 
 void MapObjectLayer::removeGameObject( GameObject* obj ) {
 	auto found = std::find( mObjects.begin(), mObjects.end(), obj );
 	if ( found != mObjects.end() )
 		mObjects.erase( found );
-	eeSAFE_DELETE( obj );
+	mIndex.remove( obj );
+	setActive( obj, false );
+	deleteGameObject( obj );
+}
+
+void MapObjectLayer::removeGameObjects( const ObjList& objs ) {
+	std::unordered_set<GameObject*> removed;
+
+	for ( GameObject* obj : objs ) {
+		if ( mIndex.contains( obj ) )
+			removed.insert( obj );
+	}
+
+	if ( removed.empty() )
+		return;
+
+	mObjects.erase( std::remove_if( mObjects.begin(), mObjects.end(),
+									[&removed]( GameObject* obj ) {
+										return removed.find( obj ) != removed.end();
+									} ),
+					mObjects.end() );
+
+	for ( GameObject* obj : removed ) {
+		mIndex.remove( obj );
+		setActive( obj, false );
+		deleteGameObject( obj );
+	}
+}
+
+void MapObjectLayer::updateGameObject( GameObject* obj ) {
+	if ( !mIndex.contains( obj ) )
+		return;
+
+	mIndex.update( obj, getObjectBounds( obj ) );
+	setActive( obj, obj->getFlags() & ( GObjFlags::GAMEOBJECT_ACTIVE |
+										GObjFlags::GAMEOBJECT_ANIMATED ) );
+}
+
+void MapObjectLayer::setActive( GameObject* obj, bool active ) {
+	if ( active == ( mActiveSet.find( obj ) != mActiveSet.end() ) )
+		return;
+
+	if ( active ) {
+		mActiveSet.insert( obj );
+		mActiveObjects.push_back( obj );
+	} else {
+		mActiveSet.erase( obj );
+		mActiveObjects.erase( std::find( mActiveObjects.begin(), mActiveObjects.end(), obj ) );
+	}
+}
+
+void MapObjectLayer::deleteGameObject( GameObject* obj ) {
+	if ( NULL == obj )
+		return;
+
+	if ( mUpdating ) {
+		mRemovedObjects.push_back( obj );
+	} else {
+		eeDelete( obj );
+	}
+}
+
+const MapObjectLayer::ObjList& MapObjectLayer::getActiveObjects() const {
+	return mActiveObjects;
+}
+
+Rectf MapObjectLayer::getObjectBounds( GameObject* obj ) {
+	Vector2f pos( obj->getPosition() );
+	Sizei size( obj->getSize() );
+
+	// The rotated objects turn around their center
+	if ( obj->isRotated() && size.x != size.y ) {
+		Vector2f center( pos.x + size.x * 0.5f, pos.y + size.y * 0.5f );
+		Float half = eemax( size.x, size.y ) * 0.5f;
+		return Rectf( center.x - half, center.y - half, center.x + half, center.y + half );
+	}
+
+	return Rectf( pos.x, pos.y, pos.x + size.x, pos.y + size.y );
+}
+
+MapObjectLayer::ObjList MapObjectLayer::getObjectsInArea( const Rectf& area ) {
+	ObjList objects;
+	mIndex.query( area, objects );
+	return objects;
 }
 
 void MapObjectLayer::removeGameObject( const Vector2i& pos ) {
@@ -94,8 +213,11 @@ GameObject* MapObjectLayer::getObjectOver( const Vector2i& pos, SEARCH_TYPE type
 	GameObject* tObj;
 	Vector2f tPos;
 	Sizei tSize;
+	ObjList candidates;
+
+	mIndex.query( Vector2f( pos.x, pos.y ), candidates );
 
-	for ( ObjList::reverse_iterator it = mObjects.rbegin(); it != mObjects.rend(); ++it ) {
+	for ( ObjList::reverse_iterator it = candidates.rbegin(); it != candidates.rend(); ++it ) {
 		tObj = ( *it );
 
 		if ( type & SEARCH_POLY ) {
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <eepp/maps/mapspatialindex.hpp>
+
+namespace EE { namespace Maps {
+
+MapSpatialIndex::MapSpatialIndex( const Sizei& areaSize, const Int32& cellSize ) {
+	setArea( areaSize, cellSize );
+}
+
+void MapSpatialIndex::setArea( const Sizei& areaSize, const Int32& cellSize ) {
+	mAreaSize = areaSize;
+	mCellSize = eemax( cellSize, 1 );
+	mGridSize = Sizei( eemax( ( areaSize.x + mCellSize - 1 ) / mCellSize, 1 ),
+					   eemax( ( areaSize.y + mCellSize - 1 ) / mCellSize, 1 ) );
+	mCells.clear();
+	mCells.resize( mGridSize.x * mGridSize.y );
+
+	for ( auto& it : mEntries ) {
+		it.second.cells = getCells( it.second.bounds );
+		link( &it.second );
+	}
+}
+
+const Int32& MapSpatialIndex::getCellSize() const {
+	return mCellSize;
+}
+
+Rect MapSpatialIndex::getCells( const Rectf& bounds ) const {
+	auto cell = [this]( const Float& pos, const Int32& count ) {
+		return eemax( 0, eemin( (Int32)eefloor( pos / mCellSize ), count - 1 ) );
+	};
+
+	return Rect( cell( bounds.Left, mGridSize.x ), cell( bounds.Top, mGridSize.y ),
+				 cell( bounds.Right, mGridSize.x ), cell( bounds.Bottom, mGridSize.y ) );
+}
+
+void MapSpatialIndex::link( Entry* entry ) {
+	for ( Int32 y = entry->cells.Top; y <= entry->cells.Bottom; y++ )
+		for ( Int32 x = entry->cells.Left; x <= entry->cells.Right; x++ )
+			mCells[y * mGridSize.x + x].push_back( entry );
+}
+
+void MapSpatialIndex::unlink( Entry* entry ) {
+	for ( Int32 y = entry->cells.Top; y <= entry->cells.Bottom; y++ ) {
+		for ( Int32 x = entry->cells.Left; x <= entry->cells.Right; x++ ) {
+			auto& cell = mCells[y * mGridSize.x + x];
+			auto found = std::find( cell.begin(), cell.end(), entry );
+
+			if ( found != cell.end() ) {
+				*found = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+}
+
+void MapSpatialIndex::insert( GameObject* obj, const Rectf& bounds ) {
+	if ( contains( obj ) ) {
+		update( obj, bounds );
+		return;
+	}
+
+	Entry& entry = mEntries[obj];
+	entry.object = obj;
+	entry.bounds = bounds;
+	entry.cells = getCells( bounds );
+	entry.order = ++mLastOrder;
+	entry.mark = 0;
+	link( &entry );
+}
+
+void MapSpatialIndex::update( GameObject* obj, const Rectf& bounds ) {
+	auto it = mEntries.find( obj );
+
+	if ( it == mEntries.end() )
+		return;
+
+	Entry& entry = it->second;
+	Rect cells( getCells( bounds ) );
+	entry.bounds = bounds;
+
+	if ( cells != entry.cells ) {
+		unlink( &entry );
+		entry.cells = cells;
+		link( &entry );
+	}
+}
+
+void MapSpatialIndex::remove( GameObject* obj ) {
+	auto it = mEntries.find( obj );
+
+	if ( it == mEntries.end() )
+		return;
+
+	unlink( &it->second );
+	mEntries.erase( it );
+}
+
+bool MapSpatialIndex::contains( GameObject* obj ) const {
+	return mEntries.find( obj ) != mEntries.end();
+}
+
+void MapSpatialIndex::clear() {
+	mEntries.clear();
+
+	for ( auto& cell : mCells )
+		cell.clear();
+}
+
+Uint32 MapSpatialIndex::getCount() const {
+	return mEntries.size();
+}
+
+void MapSpatialIndex::query( const Rectf& area, ObjList& objects ) {
+	collect( getCells( area ), area, objects );
+}
+
+void MapSpatialIndex::query( const Vector2f& point, ObjList& objects ) {
+	collect( getCells( Rectf( point, Sizef( 0, 0 ) ) ), Rectf( point, Sizef( 0, 0 ) ), objects );
+}
+
+void MapSpatialIndex::collect( const Rect& cells, const Rectf& area, ObjList& objects ) {
+	// The objects that span several cells are found once per query
+	Uint32 mark = ++mLastMark;
+	mFound.clear();
+
+	for ( Int32 y = cells.Top; y <= cells.Bottom; y++ ) {
+		for ( Int32 x = cells.Left; x <= cells.Right; x++ ) {
+			for ( Entry* entry : mCells[y * mGridSize.x + x] ) {
+				if ( entry->mark != mark && entry->bounds.intersect( area ) ) {
+					entry->mark = mark;
+					mFound.push_back( entry );
+				}
+			}
+		}
+	}
+
+	std::sort( mFound.begin(), mFound.end(),
+			   []( const Entry* a, const Entry* b ) { return a->order < b->order; } );
+
+	for ( Entry* entry : mFound )
+		objects.push_back( entry->object );
+}
+
+}} // namespace EE::Maps
@@ -9,6 +9,7 @@
 #include <eepp/maps/mapobjectlayer.hpp>
 #include <eepp/maps/tilemap.hpp>
 #include <eepp/maps/tilemaplayer.hpp>
+#include <eepp/maps/tilemapstreamer.hpp>
 
 #include <eepp/graphics/globalbatchrenderer.hpp>
 #include <eepp/graphics/primitives.hpp>
@@ -16,6 +17,8 @@
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/textureatlasloader.hpp>
 #include <eepp/graphics/textureatlasmanager.hpp>
+#include <eepp/system/compression.hpp>
+#include <eepp/system/iostreamstring.hpp>
 #include <eepp/system/packmanager.hpp>
 #include <eepp/system/virtualfilesystem.hpp>
 using namespace EE::Graphics;
@@ -45,7 +48,8 @@ TileMap::TileMap() :
 	mScale( 1 ),
 	mOffscale( 1, 1 ),
 	mLastObjId( 0 ),
-	mForcedHeaders( NULL ) {
+	mForcedHeaders( NULL ),
+	mStreamer( NULL ) {
 	setViewSize( mViewSize );
 }
 
@@ -77,6 +81,7 @@ void TileMap::disableForcedHeaders() {
 }
 
 void TileMap::deleteLayers() {
+	eeSAFE_DELETE( mStreamer );
 	eeSAFE_DELETE( mLightManager );
 
 	for ( Uint32 i = 0; i < mLayerCount; i++ )
@@ -123,6 +128,10 @@ void TileMap::createLightManager() {
 void TileMap::createEmptyTile() {
 	//! I create a texture representing an empty tile to render instead of rendering with primitives
 	//! because is a lot faster, at least with NVIDIA GPUs.
+	// Without a renderer ( headless tools and tests ) the map has no grid tile
+	if ( NULL == GLi )
+		return;
+
 	TextureFactory* TF = TextureFactory::instance();
 
 	std::string tileName( String::format( "maptile-%dx%d-%u", mTileSize.getWidth(),
@@ -451,6 +460,9 @@ void TileMap::update() {
 
 	updateScreenAABB();
 
+	if ( NULL != mStreamer )
+		mStreamer->update();
+
 	if ( NULL != mLightManager )
 		mLightManager->update();
 
@@ -809,259 +821,266 @@ void TileMap::setCreateGameObjectCallback( const CreateGOCb& Cb ) {
 	mCreateGOCb = Cb;
 }
 
-bool TileMap::loadFromStream( IOStream& IOS ) {
-	sMapHdr MapHdr;
+void TileMap::readHeaders( IOStream& IOS, const sMapHdr& MapHdr,
+						   std::vector<sLayerHdr>& LayersHdr ) {
 	Uint32 i, z;
 
-	if ( IOS.isOpen() ) {
-		IOS.read( (char*)&MapHdr, sizeof( sMapHdr ) );
+	if ( NULL == mForcedHeaders ) {
+		create( Sizei( MapHdr.SizeX, MapHdr.SizeY ), MapHdr.MaxLayers,
+				Sizei( MapHdr.TileSizeX, MapHdr.TileSizeY ), MapHdr.Flags );
+	} else {
+		create( mForcedHeaders->MapSize, mForcedHeaders->NumLayers, mForcedHeaders->TileSize,
+				mForcedHeaders->Flags );
+	}
 
-		if ( MapHdr.Magic == EE_MAP_MAGIC ) {
-			if ( NULL == mForcedHeaders ) {
-				create( Sizei( MapHdr.SizeX, MapHdr.SizeY ), MapHdr.MaxLayers,
-						Sizei( MapHdr.TileSizeX, MapHdr.TileSizeY ), MapHdr.Flags );
-			} else {
-				create( mForcedHeaders->MapSize, mForcedHeaders->NumLayers,
-						mForcedHeaders->TileSize, mForcedHeaders->Flags );
-			}
+	setBaseColor( Color( MapHdr.BaseColor ) );
 
-			setBaseColor( Color( MapHdr.BaseColor ) );
+	//! Load Properties
+	if ( MapHdr.PropertyCount ) {
+		sPropertyHdr* tProp = eeNewArray( sPropertyHdr, MapHdr.PropertyCount );
 
-			//! Load Properties
-			if ( MapHdr.PropertyCount ) {
-				sPropertyHdr* tProp = eeNewArray( sPropertyHdr, MapHdr.PropertyCount );
+		IOS.read( (char*)&tProp[0], sizeof( sPropertyHdr ) * MapHdr.PropertyCount );
 
-				IOS.read( (char*)&tProp[0], sizeof( sPropertyHdr ) * MapHdr.PropertyCount );
+		for ( i = 0; i < MapHdr.PropertyCount; i++ ) {
+			addProperty( std::string( tProp[i].Name ), std::string( tProp[i].Value ) );
+		}
 
-				for ( i = 0; i < MapHdr.PropertyCount; i++ ) {
-					addProperty( std::string( tProp[i].Name ), std::string( tProp[i].Value ) );
-				}
+		eeSAFE_DELETE_ARRAY( tProp );
+	}
 
-				eeSAFE_DELETE_ARRAY( tProp );
-			}
+	//! Load Texture Atlases
+	if ( MapHdr.TextureAtlasCount ) {
+		sMapTextureAtlas* tSG = eeNewArray( sMapTextureAtlas, MapHdr.TextureAtlasCount );
+
+		IOS.read( (char*)&tSG[0], sizeof( sMapTextureAtlas ) * MapHdr.TextureAtlasCount );
 
-			//! Load Texture Atlases
-			if ( MapHdr.TextureAtlasCount ) {
-				sMapTextureAtlas* tSG = eeNewArray( sMapTextureAtlas, MapHdr.TextureAtlasCount );
+		std::vector<std::string> TextureAtlases;
 
-				IOS.read( (char*)&tSG[0], sizeof( sMapTextureAtlas ) * MapHdr.TextureAtlasCount );
+		for ( i = 0; i < MapHdr.TextureAtlasCount; i++ ) {
+			TextureAtlases.push_back( std::string( tSG[i].Path ) );
+		}
 
-				std::vector<std::string> TextureAtlases;
+		//! Load the Texture Atlases if needed
+		for ( i = 0; i < TextureAtlases.size(); i++ ) {
+			std::string sgname = FileSystem::fileRemoveExtension(
+				FileSystem::fileNameFromPath( TextureAtlases[i] ) );
 
-				for ( i = 0; i < MapHdr.TextureAtlasCount; i++ ) {
-					TextureAtlases.push_back( std::string( tSG[i].Path ) );
+			if ( NULL == TextureAtlasManager::instance()->getByName( sgname ) ) {
+				TextureAtlasLoader* tgl = eeNew( TextureAtlasLoader, () );
+
+				if ( !VirtualFileSystem::instance()->fileExists( TextureAtlases[i] ) &&
+					 !FileSystem::fileExists( TextureAtlases[i] ) ) {
+					std::string path( FileSystem::fileRemoveFileName( mPath ) );
+
+					if ( FileSystem::fileExists( path + TextureAtlases[i] ) ||
+						 VirtualFileSystem::instance()->fileExists( path + TextureAtlases[i] ) ) {
+						TextureAtlases[i] = path + TextureAtlases[i];
+					}
 				}
 
-				//! Load the Texture Atlases if needed
-				for ( i = 0; i < TextureAtlases.size(); i++ ) {
-					std::string sgname = FileSystem::fileRemoveExtension(
-						FileSystem::fileNameFromPath( TextureAtlases[i] ) );
+				tgl->loadFromFile( TextureAtlases[i] );
 
-					if ( NULL == TextureAtlasManager::instance()->getByName( sgname ) ) {
-						TextureAtlasLoader* tgl = eeNew( TextureAtlasLoader, () );
+				eeSAFE_DELETE( tgl );
+			}
+		}
 
-						if ( !VirtualFileSystem::instance()->fileExists( TextureAtlases[i] ) &&
-							 !FileSystem::fileExists( TextureAtlases[i] ) ) {
-							std::string path( FileSystem::fileRemoveFileName( mPath ) );
+		eeSAFE_DELETE_ARRAY( tSG );
+	}
 
-							if ( FileSystem::fileExists( path + TextureAtlases[i] ) ||
-								 VirtualFileSystem::instance()->fileExists( path +
-																			TextureAtlases[i] ) ) {
-								TextureAtlases[i] = path + TextureAtlases[i];
-							}
-						}
+	//! Load Virtual Object Types
+	if ( MapHdr.VirtualObjectTypesCount ) {
+		sVirtualObj* tVObj = eeNewArray( sVirtualObj, MapHdr.VirtualObjectTypesCount );
 
-						tgl->loadFromFile( TextureAtlases[i] );
+		IOS.read( (char*)&tVObj[0], sizeof( sVirtualObj ) * MapHdr.VirtualObjectTypesCount );
 
-						eeSAFE_DELETE( tgl );
-					}
-				}
+		for ( i = 0; i < MapHdr.VirtualObjectTypesCount; i++ ) {
+			addVirtualObjectType( std::string( tVObj[i].Name ) );
+		}
 
-				eeSAFE_DELETE_ARRAY( tSG );
-			}
+		eeSAFE_DELETE_ARRAY( tVObj );
+	}
 
-			//! Load Virtual Object Types
-			if ( MapHdr.VirtualObjectTypesCount ) {
-				sVirtualObj* tVObj = eeNewArray( sVirtualObj, MapHdr.VirtualObjectTypesCount );
+	//! Load Layers
+	LayersHdr.resize( MapHdr.LayerCount );
 
-				IOS.read( (char*)&tVObj[0],
-						  sizeof( sVirtualObj ) * MapHdr.VirtualObjectTypesCount );
+	for ( i = 0; i < MapHdr.LayerCount; i++ ) {
+		sLayerHdr* tLayerHdr = &LayersHdr[i];
 
-				for ( i = 0; i < MapHdr.VirtualObjectTypesCount; i++ ) {
-					addVirtualObjectType( std::string( tVObj[i].Name ) );
-				}
+		IOS.read( (char*)tLayerHdr, sizeof( sLayerHdr ) );
 
-				eeSAFE_DELETE_ARRAY( tVObj );
-			}
+		MapLayer* tLayer =
+			addLayer( tLayerHdr->Type, tLayerHdr->Flags, std::string( tLayerHdr->Name ) );
 
-			//! Load Layers
-			if ( MapHdr.LayerCount ) {
-				sLayerHdr* tLayersHdr = eeNewArray( sLayerHdr, MapHdr.LayerCount );
-				sLayerHdr* tLayerHdr;
+		if ( NULL != tLayer ) {
+			tLayer->setOffset( Vector2f( (Float)tLayerHdr->OffsetX, (Float)tLayerHdr->OffsetY ) );
 
-				for ( i = 0; i < MapHdr.LayerCount; i++ ) {
-					IOS.read( (char*)&tLayersHdr[i], sizeof( sLayerHdr ) );
+			sPropertyHdr* tProps = eeNewArray( sPropertyHdr, tLayerHdr->PropertyCount );
 
-					tLayerHdr = &( tLayersHdr[i] );
+			IOS.read( (char*)&tProps[0], sizeof( sPropertyHdr ) * tLayerHdr->PropertyCount );
 
-					MapLayer* tLayer = addLayer( tLayerHdr->Type, tLayerHdr->Flags,
-												 std::string( tLayerHdr->Name ) );
+			for ( z = 0; z < tLayerHdr->PropertyCount; z++ ) {
+				tLayer->addProperty( std::string( tProps[z].Name ),
+									 std::string( tProps[z].Value ) );
+			}
 
-					if ( NULL != tLayer ) {
-						tLayer->setOffset(
-							Vector2f( (Float)tLayerHdr->OffsetX, (Float)tLayerHdr->OffsetY ) );
+			eeSAFE_DELETE_ARRAY( tProps );
+		}
+	}
+}
 
-						sPropertyHdr* tProps = eeNewArray( sPropertyHdr, tLayerHdr->PropertyCount );
+bool TileMap::hasTiledLayers() {
+	for ( Uint32 i = 0; i < mLayerCount; i++ ) {
+		if ( NULL != mLayers[i] && mLayers[i]->getType() == MAP_LAYER_TILED )
+			return true;
+	}
 
-						IOS.read( (char*)&tProps[0],
-								  sizeof( sPropertyHdr ) * tLayerHdr->PropertyCount );
+	return false;
+}
 
-						for ( z = 0; z < tLayerHdr->PropertyCount; z++ ) {
-							tLayer->addProperty( std::string( tProps[z].Name ),
-												 std::string( tProps[z].Value ) );
-						}
+void TileMap::readTiles( IOStream& IOS, const Rect& TileArea ) {
+	Uint32 tReadFlag = 0;
 
-						eeSAFE_DELETE_ARRAY( tProps );
-					}
-				}
+	for ( Int32 y = TileArea.Top; y < TileArea.Bottom; y++ ) {
+		for ( Int32 x = TileArea.Left; x < TileArea.Right; x++ ) {
+			//! Read the current tile flags
+			IOS.read( (char*)&tReadFlag, sizeof( Uint32 ) );
 
-				bool ThereIsTiled = false;
+			//! Read every game object header corresponding to this tile
+			for ( Uint32 i = 0; i < mLayerCount; i++ ) {
+				if ( tReadFlag & ( 1 << i ) ) {
+					TileMapLayer* tTLayer = reinterpret_cast<TileMapLayer*>( mLayers[i] );
 
-				for ( i = 0; i < mLayerCount; i++ ) {
-					if ( NULL != mLayers[i] && mLayers[i]->getType() == MAP_LAYER_TILED ) {
-						ThereIsTiled = true;
-					}
-				}
+					sMapTileGOHdr tTGOHdr;
 
-				Int32 x, y;
-				Uint32 tReadFlag = 0;
-				TileMapLayer* tTLayer;
-				GameObject* tGO;
+					IOS.read( (char*)&tTGOHdr, sizeof( sMapTileGOHdr ) );
 
-				if ( NULL != mForcedHeaders ) {
-					mSize = Sizei( MapHdr.SizeX, MapHdr.SizeY );
+					GameObject* tGO =
+						createGameObject( tTGOHdr.Type, tTGOHdr.Flags, mLayers[i], tTGOHdr.Id );
+
+					tTLayer->addGameObject( tGO, Vector2i( x, y ) );
 				}
+			}
+		}
+	}
+}
 
-				if ( ThereIsTiled ) {
-					//! First we read the tiled layers.
-					for ( y = 0; y < mSize.y; y++ ) {
-						for ( x = 0; x < mSize.x; x++ ) {
+GameObject* TileMap::readObject( IOStream& IOS, MapObjectLayer* Layer ) {
+	sMapObjGOHdr tOGOHdr;
 
-							//! Read the current tile flags
-							IOS.read( (char*)&tReadFlag, sizeof( Uint32 ) );
+	IOS.read( (char*)&tOGOHdr, sizeof( sMapObjGOHdr ) );
 
-							//! Read every game object header corresponding to this tile
-							for ( i = 0; i < mLayerCount; i++ ) {
-								if ( tReadFlag & ( 1 << i ) ) {
-									tTLayer = reinterpret_cast<TileMapLayer*>( mLayers[i] );
+	//! For the polygon objects wee need to read the polygon points, the Name, the TypeName and
+	//! the Properties.
+	if ( tOGOHdr.Type == GAMEOBJECT_TYPE_OBJECT || tOGOHdr.Type == GAMEOBJECT_TYPE_POLYGON ||
+		 tOGOHdr.Type == GAMEOBJECT_TYPE_POLYLINE ) {
+		GameObjectPolyData tObjData;
 
-									sMapTileGOHdr tTGOHdr;
+		//! First we read the poly obj header
+		sMapObjObjHdr tObjObjHdr;
 
-									IOS.read( (char*)&tTGOHdr, sizeof( sMapTileGOHdr ) );
+		IOS.read( (char*)&tObjObjHdr, sizeof( sMapObjObjHdr ) );
 
-									tGO = createGameObject( tTGOHdr.Type, tTGOHdr.Flags, mLayers[i],
-															tTGOHdr.Id );
+		tObjData.Name = std::string( tObjObjHdr.Name );
+		tObjData.Type = std::string( tObjObjHdr.Type );
 
-									tTLayer->addGameObject( tGO, Vector2i( x, y ) );
-								}
-							}
-						}
-					}
-				}
+		//! Reads the properties
+		for ( Uint32 iProp = 0; iProp < tObjObjHdr.PropertyCount; iProp++ ) {
+			sPropertyHdr tObjProp;
 
-				if ( NULL != mForcedHeaders ) {
-					mSize = mForcedHeaders->MapSize;
-				}
+			IOS.read( (char*)&tObjProp, sizeof( sPropertyHdr ) );
 
-				//! Load the game objects from the object layers
-				MapObjectLayer* tOLayer;
+			tObjData.Properties[std::string( tObjProp.Name )] = std::string( tObjProp.Value );
+		}
 
-				for ( i = 0; i < mLayerCount; i++ ) {
-					if ( NULL != mLayers[i] && mLayers[i]->getType() == MAP_LAYER_OBJECT ) {
-						tLayerHdr = &( tLayersHdr[i] );
-						tOLayer = reinterpret_cast<MapObjectLayer*>( mLayers[i] );
+		//! Reads the polygon points
+		for ( Uint32 iPoint = 0; iPoint < tObjObjHdr.PointCount; iPoint++ ) {
+			Vector2if p;
 
-						for ( Uint32 objCount = 0; objCount < tLayerHdr->ObjectCount; objCount++ ) {
-							sMapObjGOHdr tOGOHdr;
+			IOS.read( (char*)&p, sizeof( Vector2if ) );
 
-							IOS.read( (char*)&tOGOHdr, sizeof( sMapObjGOHdr ) );
+			tObjData.Poly.pushBack( Vector2f( p.x, p.y ) );
+		}
 
-							//! For the polygon objects wee need to read the polygon points, the
-							//! Name, the TypeName and the Properties.
-							if ( tOGOHdr.Type == GAMEOBJECT_TYPE_OBJECT ||
-								 tOGOHdr.Type == GAMEOBJECT_TYPE_POLYGON ||
-								 tOGOHdr.Type == GAMEOBJECT_TYPE_POLYLINE ) {
-								GameObjectPolyData tObjData;
+		mPolyObjs[tOGOHdr.Id] = tObjData;
 
-								//! First we read the poly obj header
-								sMapObjObjHdr tObjObjHdr;
+		//! Recover the last max id
+		mLastObjId = eemax( mLastObjId, tOGOHdr.Id );
+	}
 
-								IOS.read( (char*)&tObjObjHdr, sizeof( sMapObjObjHdr ) );
+	GameObject* tGO = createGameObject( tOGOHdr.Type, tOGOHdr.Flags, Layer, tOGOHdr.Id );
 
-								tObjData.Name = std::string( tObjObjHdr.Name );
-								tObjData.Type = std::string( tObjObjHdr.Type );
+	tGO->setPosition( Vector2f( tOGOHdr.PosX, tOGOHdr.PosY ) );
 
-								//! Reads the properties
-								for ( Uint32 iProp = 0; iProp < tObjObjHdr.PropertyCount;
-									  iProp++ ) {
-									sPropertyHdr tObjProp;
+	Layer->addGameObject( tGO );
 
-									IOS.read( (char*)&tObjProp, sizeof( sPropertyHdr ) );
+	return tGO;
+}
 
-									tObjData.Properties[std::string( tObjProp.Name )] =
-										std::string( tObjProp.Value );
-								}
+void TileMap::readLights( IOStream& IOS, const Uint32& LightsCount ) {
+	if ( !LightsCount )
+		return;
 
-								//! Reads the polygon points
-								for ( Uint32 iPoint = 0; iPoint < tObjObjHdr.PointCount;
-									  iPoint++ ) {
-									Vector2if p;
+	createLightManager();
 
-									IOS.read( (char*)&p, sizeof( Vector2if ) );
+	sMapLightHdr* tLighsHdr = eeNewArray( sMapLightHdr, LightsCount );
+	sMapLightHdr* tLightHdr;
 
-									tObjData.Poly.pushBack( Vector2f( p.x, p.y ) );
-								}
+	IOS.read( (char*)tLighsHdr, sizeof( sMapLightHdr ) * LightsCount );
 
-								mPolyObjs[tOGOHdr.Id] = tObjData;
+	for ( Uint32 i = 0; i < LightsCount; i++ ) {
+		tLightHdr = &( tLighsHdr[i] );
 
-								//! Recover the last max id
-								mLastObjId = eemax( mLastObjId, tOGOHdr.Id );
-							}
+		Color color( tLightHdr->Color );
+		RGB rgb( color.toRGB() );
 
-							tGO = createGameObject( tOGOHdr.Type, tOGOHdr.Flags, mLayers[i],
-													tOGOHdr.Id );
+		mLightManager->addLight( eeNew( MapLight, ( tLightHdr->Radius, tLightHdr->PosX,
+													tLightHdr->PosY, rgb,
+													(MapLightType)tLightHdr->Type ) ) );
+	}
 
-							tGO->setPosition( Vector2f( tOGOHdr.PosX, tOGOHdr.PosY ) );
+	eeSAFE_DELETE_ARRAY( tLighsHdr );
+}
 
-							tOLayer->addGameObject( tGO );
-						}
-					}
-				}
+bool TileMap::loadFromStream( IOStream& IOS ) {
+	sMapHdr MapHdr;
+	Uint32 i;
 
-				//! Load the lights
-				if ( MapHdr.LightsCount ) {
-					createLightManager();
+	if ( IOS.isOpen() ) {
+		IOS.read( (char*)&MapHdr, sizeof( sMapHdr ) );
 
-					sMapLightHdr* tLighsHdr = eeNewArray( sMapLightHdr, MapHdr.LightsCount );
-					sMapLightHdr* tLightHdr;
+		if ( MapHdr.Magic == EE_MAP_MAGIC ) {
+			std::vector<sLayerHdr> LayersHdr;
 
-					IOS.read( (char*)tLighsHdr, sizeof( sMapLightHdr ) * MapHdr.LightsCount );
+			readHeaders( IOS, MapHdr, LayersHdr );
 
-					for ( i = 0; i < MapHdr.LightsCount; i++ ) {
-						tLightHdr = &( tLighsHdr[i] );
+			if ( MapHdr.LayerCount ) {
+				if ( NULL != mForcedHeaders ) {
+					mSize = Sizei( MapHdr.SizeX, MapHdr.SizeY );
+				}
 
-						Color color( tLightHdr->Color );
-						RGB rgb( color.toRGB() );
+				//! First we read the tiled layers.
+				if ( hasTiledLayers() ) {
+					readTiles( IOS, Rect( 0, 0, mSize.x, mSize.y ) );
+				}
 
-						mLightManager->addLight(
-							eeNew( MapLight, ( tLightHdr->Radius, tLightHdr->PosX, tLightHdr->PosY,
-											   rgb, (MapLightType)tLightHdr->Type ) ) );
-					}
+				if ( NULL != mForcedHeaders ) {
+					mSize = mForcedHeaders->MapSize;
+				}
+
+				//! Load the game objects from the object layers
+				for ( i = 0; i < mLayerCount; i++ ) {
+					if ( NULL != mLayers[i] && mLayers[i]->getType() == MAP_LAYER_OBJECT ) {
+						MapObjectLayer* tOLayer = reinterpret_cast<MapObjectLayer*>( mLayers[i] );
 
-					eeSAFE_DELETE_ARRAY( tLighsHdr );
+						for ( Uint32 objCount = 0; objCount < LayersHdr[i].ObjectCount;
+							  objCount++ ) {
+							readObject( IOS, tOLayer );
+						}
+					}
 				}
 
-				eeSAFE_DELETE_ARRAY( tLayersHdr );
+				//! Load the lights
+				readLights( IOS, MapHdr.LightsCount );
 			}
 
 			onMapLoaded();
@@ -1069,12 +1088,60 @@ bool TileMap::loadFromStream( IOStream& IOS ) {
 			mPolyObjs.clear();
 
 			return true;
+		} else if ( MapHdr.Magic == EE_MAP_CHUNKED_MAGIC ) {
+			//! The chunked maps are loaded entirely from a stream, see streamFromFile
+			std::vector<sLayerHdr> LayersHdr;
+
+			readHeaders( IOS, MapHdr, LayersHdr );
+
+			readLights( IOS, MapHdr.LightsCount );
+
+			TileMapStreamer streamer( this, &IOS, false );
+
+			streamer.loadAll();
+
+			onMapLoaded();
+
+			return streamer.isValid();
 		}
 	}
 
 	return false;
 }
 
+bool TileMap::streamFromFile( const std::string& path ) {
+	if ( !FileSystem::fileExists( path ) )
+		return false;
+
+	IOStreamFile* IOS = eeNew( IOStreamFile, ( path ) );
+	sMapHdr MapHdr;
+
+	if ( !IOS->isOpen() || IOS->read( (char*)&MapHdr, sizeof( sMapHdr ) ) != sizeof( sMapHdr ) ||
+		 MapHdr.Magic != EE_MAP_CHUNKED_MAGIC ) {
+		eeSAFE_DELETE( IOS );
+		return false;
+	}
+
+	mPath = path;
+
+	std::vector<sLayerHdr> LayersHdr;
+
+	readHeaders( *IOS, MapHdr, LayersHdr );
+
+	readLights( *IOS, MapHdr.LightsCount );
+
+	//! The streamer owns the file from now on
+	mStreamer = eeNew( TileMapStreamer, ( this, IOS, true ) );
+
+	onMapLoaded();
+
+	return mStreamer->isValid();
+}
+
+TileMapStreamer* TileMap::getStreamer() const {
+	return mStreamer;
+}
+
 const std::string& TileMap::getPath() const {
 	return mPath;
 }
@@ -1118,14 +1185,14 @@ bool TileMap::loadFromMemory( const char* Data, const Uint32& DataSize ) {
 	return loadFromStream( IOS );
 }
 
-void TileMap::saveToStream( IOStream& IOS ) {
+sMapHdr TileMap::writeHeaders( IOStream& IOS, const Uint32& Magic ) {
 	Uint32 i;
 	sMapHdr MapHdr;
 	MapLayer* tLayer;
 
 	std::vector<std::string> TextureAtlases = getTextureAtlases();
 
-	MapHdr.Magic = EE_MAP_MAGIC;
+	MapHdr.Magic = Magic;
 	MapHdr.Flags = mFlags;
 	MapHdr.MaxLayers = mMaxLayers;
 	MapHdr.SizeX = mSize.getWidth();
@@ -1145,292 +1212,395 @@ void TileMap::saveToStream( IOStream& IOS ) {
 	else
 		MapHdr.LightsCount = 0;
 
-	if ( IOS.isOpen() ) {
-		//! Writes the map header
-		IOS.write( (const char*)&MapHdr, sizeof( sMapHdr ) );
+	//! Writes the map header
+	IOS.write( (const char*)&MapHdr, sizeof( sMapHdr ) );
+
+	//! Writes the properties of the map
+	for ( TileMap::PropertiesMap::iterator it = mProperties.begin(); it != mProperties.end();
+		  ++it ) {
+		sPropertyHdr tProp;
+
+		memset( tProp.Name, 0, MAP_PROPERTY_SIZE );
+		memset( tProp.Value, 0, MAP_PROPERTY_SIZE );
+
+		String::strCopy( tProp.Name, it->first.c_str(), MAP_PROPERTY_SIZE );
+		String::strCopy( tProp.Value, it->second.c_str(), MAP_PROPERTY_SIZE );
+
+		IOS.write( (const char*)&tProp, sizeof( sPropertyHdr ) );
+	}
+
+	//! Writes the texture atlases that the map will need and load
+	for ( i = 0; i < TextureAtlases.size(); i++ ) {
+		sMapTextureAtlas tSG;
+
+		memset( tSG.Path, 0, MAP_TEXTUREATLAS_PATH_SIZE );
+
+		if ( !mPath.empty() &&
+			 String::startsWith( TextureAtlases[i], FileSystem::fileRemoveFileName( mPath ) ) ) {
+			TextureAtlases[i] =
+				TextureAtlases[i].substr( FileSystem::fileRemoveFileName( mPath ).size() );
+		}
+
+		String::strCopy( tSG.Path, TextureAtlases[i].c_str(), MAP_TEXTUREATLAS_PATH_SIZE );
+
+		IOS.write( (const char*)&tSG, sizeof( sMapTextureAtlas ) );
+	}
+
+	//! Writes the names of the virtual object types created in the map editor
+	for ( GOTypesList::iterator votit = mObjTypes.begin(); votit != mObjTypes.end(); ++votit ) {
+		sVirtualObj tVObjH;
+
+		memset( tVObjH.Name, 0, MAP_PROPERTY_SIZE );
+
+		String::strCopy( tVObjH.Name, ( *votit ).c_str(), MAP_PROPERTY_SIZE );
+
+		IOS.write( (const char*)&tVObjH, sizeof( sVirtualObj ) );
+	}
+
+	//! Writes every layer header
+	for ( i = 0; i < mLayerCount; i++ ) {
+		tLayer = mLayers[i];
+		sLayerHdr tLayerH;
+
+		memset( tLayerH.Name, 0, LAYER_NAME_SIZE );
+
+		String::strCopy( tLayerH.Name, tLayer->getName().c_str(), LAYER_NAME_SIZE );
+
+		tLayerH.Type = tLayer->getType();
+		tLayerH.Flags = tLayer->getFlags();
+		tLayerH.OffsetX = tLayer->getOffset().x;
+		tLayerH.OffsetY = tLayer->getOffset().y;
+
+		if ( MAP_LAYER_OBJECT == tLayerH.Type )
+			tLayerH.ObjectCount = reinterpret_cast<MapObjectLayer*>( tLayer )->getObjectCount();
+		else
+			tLayerH.ObjectCount = 0;
 
-		//! Writes the properties of the map
-		for ( TileMap::PropertiesMap::iterator it = mProperties.begin(); it != mProperties.end();
-			  ++it ) {
+		MapLayer::PropertiesMap& tLayerProp = tLayer->getProperties();
+
+		tLayerH.PropertyCount = tLayerProp.size();
+
+		//! Writes the layer header
+		IOS.write( (const char*)&tLayerH, sizeof( sLayerHdr ) );
+
+		//! Writes the properties of the current layer
+		for ( MapLayer::PropertiesMap::iterator lit = tLayerProp.begin(); lit != tLayerProp.end();
+			  ++lit ) {
 			sPropertyHdr tProp;
 
 			memset( tProp.Name, 0, MAP_PROPERTY_SIZE );
 			memset( tProp.Value, 0, MAP_PROPERTY_SIZE );
 
-			String::strCopy( tProp.Name, it->first.c_str(), MAP_PROPERTY_SIZE );
-			String::strCopy( tProp.Value, it->second.c_str(), MAP_PROPERTY_SIZE );
+			String::strCopy( tProp.Name, ( *lit ).first.c_str(), MAP_PROPERTY_SIZE );
+			String::strCopy( tProp.Value, ( *lit ).second.c_str(), MAP_PROPERTY_SIZE );
 
 			IOS.write( (const char*)&tProp, sizeof( sPropertyHdr ) );
 		}
+	}
 
-		//! Writes the texture atlases that the map will need and load
-		for ( i = 0; i < TextureAtlases.size(); i++ ) {
-			sMapTextureAtlas tSG;
+	return MapHdr;
+}
+
+void TileMap::writeTiles( IOStream& IOS, const Rect& TileArea ) {
+	//! This method is slow, but allows to save big maps with little space needed, i'll add an
+	//! alternative save method ( just plain layer -> tile object saving )
+	Uint32 tReadFlag = 0, i, z;
+	MapLayer* tLayer;
+	TileMapLayer* tTLayer;
+	GameObject* tObj;
 
-			memset( tSG.Path, 0, MAP_TEXTUREATLAS_PATH_SIZE );
+	std::vector<GameObject*> tObjects( mLayerCount );
 
-			if ( !mPath.empty() && String::startsWith( TextureAtlases[i],
-													   FileSystem::fileRemoveFileName( mPath ) ) ) {
-				TextureAtlases[i] =
-					TextureAtlases[i].substr( FileSystem::fileRemoveFileName( mPath ).size() );
+	for ( Int32 y = TileArea.Top; y < TileArea.Bottom; y++ ) {
+		for ( Int32 x = TileArea.Left; x < TileArea.Right; x++ ) {
+			//! Reset Layer Read Flags and temporal objects
+			tReadFlag = 0;
+
+			for ( z = 0; z < mLayerCount; z++ )
+				tObjects[z] = NULL;
+
+			//! Look at every layer if it's some data on the current tile, in that case it will
+			//! write a bit flag to inform that it's an object on the current tile layer, and it
+			//! will store a temporal reference to the object to write layer the object header
+			//! information
+			for ( i = 0; i < mLayerCount; i++ ) {
+				tLayer = mLayers[i];
+
+				if ( NULL != tLayer && tLayer->getType() == MAP_LAYER_TILED ) {
+					tTLayer = reinterpret_cast<TileMapLayer*>( tLayer );
+
+					tObj = tTLayer->getGameObject( Vector2i( x, y ) );
+
+					if ( NULL != tObj ) {
+						tReadFlag |= 1 << i;
+
+						tObjects[i] = tObj;
+					}
+				}
 			}
 
-			String::strCopy( tSG.Path, TextureAtlases[i].c_str(), MAP_TEXTUREATLAS_PATH_SIZE );
+			//! Writes the current tile flags
+			IOS.write( (const char*)&tReadFlag, sizeof( Uint32 ) );
 
-			IOS.write( (const char*)&tSG, sizeof( sMapTextureAtlas ) );
-		}
+			//! Writes every game object header corresponding to this tile
+			for ( i = 0; i < mLayerCount; i++ ) {
+				if ( tReadFlag & ( 1 << i ) ) {
+					tObj = tObjects[i];
 
-		//! Writes the names of the virtual object types created in the map editor
-		for ( GOTypesList::iterator votit = mObjTypes.begin(); votit != mObjTypes.end(); ++votit ) {
-			sVirtualObj tVObjH;
+					sMapTileGOHdr tTGOHdr;
+
+					//! The DataId should be the TextureRegion hash name ( at least in the cases of
+					//! type TextureRegion, TextureRegionEx and Sprite.
+					tTGOHdr.Id = tObj->getDataId();
+
+					//! If the object type is virtual, means that the real type is stored
+					//! elsewhere.
+					if ( tObj->getType() != GAMEOBJECT_TYPE_VIRTUAL ) {
+						tTGOHdr.Type = tObj->getType();
+					} else {
+						GameObjectVirtual* tObjV = reinterpret_cast<GameObjectVirtual*>( tObj );
 
-			memset( tVObjH.Name, 0, MAP_PROPERTY_SIZE );
+						tTGOHdr.Type = tObjV->getRealType();
+					}
 
-			String::strCopy( tVObjH.Name, ( *votit ).c_str(), MAP_PROPERTY_SIZE );
+					tTGOHdr.Flags = tObj->getFlags();
 
-			IOS.write( (const char*)&tVObjH, sizeof( sVirtualObj ) );
+					IOS.write( (const char*)&tTGOHdr, sizeof( sMapTileGOHdr ) );
+				}
+			}
 		}
+	}
+}
 
-		//! Writes every layer header
-		for ( i = 0; i < mLayerCount; i++ ) {
-			tLayer = mLayers[i];
-			sLayerHdr tLayerH;
+void TileMap::writeObject( IOStream& IOS, GameObject* tObj ) {
+	sMapObjGOHdr tOGOHdr;
 
-			memset( tLayerH.Name, 0, LAYER_NAME_SIZE );
+	//! The DataId should be the TextureRegion hash name ( at least in the cases of type
+	//! TextureRegion, TextureRegionEx and Sprite. And for the Poly Obj should be an arbitrary value
+	//! assigned by the map on the moment of creation
+	tOGOHdr.Id = tObj->getDataId();
 
-			String::strCopy( tLayerH.Name, tLayer->getName().c_str(), LAYER_NAME_SIZE );
+	//! If the object type is virtual, means that the real type is stored elsewhere.
+	if ( tObj->getType() != GAMEOBJECT_TYPE_VIRTUAL ) {
+		tOGOHdr.Type = tObj->getType();
+	} else {
+		GameObjectVirtual* tObjV = reinterpret_cast<GameObjectVirtual*>( tObj );
 
-			tLayerH.Type = tLayer->getType();
-			tLayerH.Flags = tLayer->getFlags();
-			tLayerH.OffsetX = tLayer->getOffset().x;
-			tLayerH.OffsetY = tLayer->getOffset().y;
+		tOGOHdr.Type = tObjV->getRealType();
+	}
 
-			if ( MAP_LAYER_OBJECT == tLayerH.Type )
-				tLayerH.ObjectCount = reinterpret_cast<MapObjectLayer*>( tLayer )->getObjectCount();
-			else
-				tLayerH.ObjectCount = 0;
+	tOGOHdr.Flags = tObj->getFlags();
 
-			MapLayer::PropertiesMap& tLayerProp = tLayer->getProperties();
+	tOGOHdr.PosX = (Int32)tObj->getPosition().x;
 
-			tLayerH.PropertyCount = tLayerProp.size();
+	tOGOHdr.PosY = (Int32)tObj->getPosition().y;
 
-			//! Writes the layer header
-			IOS.write( (const char*)&tLayerH, sizeof( sLayerHdr ) );
+	IOS.write( (const char*)&tOGOHdr, sizeof( sMapObjGOHdr ) );
 
-			//! Writes the properties of the current layer
-			for ( MapLayer::PropertiesMap::iterator lit = tLayerProp.begin();
-				  lit != tLayerProp.end(); ++lit ) {
-				sPropertyHdr tProp;
+	//! For the polygon objects wee need to write the polygon points, the Name, the TypeName and
+	//! the Properties.
+	if ( tObj->getType() == GAMEOBJECT_TYPE_OBJECT || tObj->getType() == GAMEOBJECT_TYPE_POLYGON ||
+		 tObj->getType() == GAMEOBJECT_TYPE_POLYLINE ) {
+		GameObjectObject* tObjObj = reinterpret_cast<GameObjectObject*>( tObj );
+		Polygon2f tPoly = tObjObj->getPolygon();
+		GameObjectObject::PropertiesMap tObjObjProp = tObjObj->getProperties();
+		sMapObjObjHdr tObjObjHdr;
 
-				memset( tProp.Name, 0, MAP_PROPERTY_SIZE );
-				memset( tProp.Value, 0, MAP_PROPERTY_SIZE );
+		memset( tObjObjHdr.Name, 0, MAP_PROPERTY_SIZE );
+		memset( tObjObjHdr.Type, 0, MAP_PROPERTY_SIZE );
 
-				String::strCopy( tProp.Name, ( *lit ).first.c_str(), MAP_PROPERTY_SIZE );
-				String::strCopy( tProp.Value, ( *lit ).second.c_str(), MAP_PROPERTY_SIZE );
+		String::strCopy( tObjObjHdr.Name, tObjObj->getName().c_str(), MAP_PROPERTY_SIZE );
+		String::strCopy( tObjObjHdr.Type, tObjObj->getTypeName().c_str(), MAP_PROPERTY_SIZE );
 
-				IOS.write( (const char*)&tProp, sizeof( sPropertyHdr ) );
-			}
-		}
+		tObjObjHdr.PointCount = tPoly.getSize();
+		tObjObjHdr.PropertyCount = tObjObjProp.size();
 
-		bool ThereIsTiled = false;
+		//! Writes the ObjObj header
+		IOS.write( (const char*)&tObjObjHdr, sizeof( sMapObjObjHdr ) );
 
-		for ( i = 0; i < mLayerCount; i++ ) {
-			if ( NULL != mLayers[i] && mLayers[i]->getType() == MAP_LAYER_TILED ) {
-				ThereIsTiled = true;
-			}
-		}
+		//! Writes the properties of the current polygon object
+		for ( GameObjectObject::PropertiesMap::iterator ooit = tObjObjProp.begin();
+			  ooit != tObjObjProp.end(); ++ooit ) {
+			sPropertyHdr tProp;
 
-		//! This method is slow, but allows to save big maps with little space needed, i'll add an
-		//! alternative save method ( just plain layer -> tile object saving )
-		Int32 x, y;
-		Uint32 tReadFlag = 0, z;
-		TileMapLayer* tTLayer;
-		GameObject* tObj;
+			memset( tProp.Name, 0, MAP_PROPERTY_SIZE );
+			memset( tProp.Value, 0, MAP_PROPERTY_SIZE );
 
-		std::vector<GameObject*> tObjects( mLayerCount );
+			String::strCopy( tProp.Name, ooit->first.c_str(), MAP_PROPERTY_SIZE );
+			String::strCopy( tProp.Value, ooit->second.c_str(), MAP_PROPERTY_SIZE );
 
-		if ( ThereIsTiled ) {
-			//! First we save the tiled layers.
-			for ( y = 0; y < mSize.y; y++ ) {
-				for ( x = 0; x < mSize.x; x++ ) {
-					//! Reset Layer Read Flags and temporal objects
-					tReadFlag = 0;
+			IOS.write( (const char*)&tProp, sizeof( sPropertyHdr ) );
+		}
 
-					for ( z = 0; z < mLayerCount; z++ )
-						tObjects[z] = NULL;
+		//! Writes the polygon points
+		for ( Uint32 tPoint = 0; tPoint < tPoly.getSize(); tPoint++ ) {
+			Vector2f pf( tPoly.getAt( tPoint ) );
+			Vector2if p( pf.x, pf.y ); //! Convert it to Int32
 
-					//! Look at every layer if it's some data on the current tile, in that case it
-					//! will write a bit flag to inform that it's an object on the current tile
-					//! layer, and it will store a temporal reference to the object to write layer
-					//! the object header information
-					for ( i = 0; i < mLayerCount; i++ ) {
-						tLayer = mLayers[i];
+			IOS.write( (const char*)&p, sizeof( Vector2if ) );
+		}
+	}
+}
 
-						if ( NULL != tLayer && tLayer->getType() == MAP_LAYER_TILED ) {
-							tTLayer = reinterpret_cast<TileMapLayer*>( tLayer );
+void TileMap::writeLights( IOStream& IOS ) {
+	if ( !getLightsEnabled() || NULL == mLightManager )
+		return;
 
-							tObj = tTLayer->getGameObject( Vector2i( x, y ) );
+	MapLightManager::LightsList& Lights = mLightManager->getLights();
 
-							if ( NULL != tObj ) {
-								tReadFlag |= 1 << i;
+	for ( MapLightManager::LightsList::iterator LightsIt = Lights.begin(); LightsIt != Lights.end();
+		  ++LightsIt ) {
+		MapLight* Light = ( *LightsIt );
 
-								tObjects[i] = tObj;
-							}
-						}
-					}
+		sMapLightHdr tLightHdr;
 
-					//! Writes the current tile flags
-					IOS.write( (const char*)&tReadFlag, sizeof( Uint32 ) );
+		tLightHdr.Radius = Light->getRadius();
+		tLightHdr.PosX = (Int32)Light->getPosition().x;
+		tLightHdr.PosY = (Int32)Light->getPosition().y;
+		tLightHdr.Color = Color( Light->getColor() ).getValue();
+		tLightHdr.Type = Light->getType();
 
-					//! Writes every game object header corresponding to this tile
-					for ( i = 0; i < mLayerCount; i++ ) {
-						if ( tReadFlag & ( 1 << i ) ) {
-							tObj = tObjects[i];
+		IOS.write( (const char*)&tLightHdr, sizeof( sMapLightHdr ) );
+	}
+}
 
-							sMapTileGOHdr tTGOHdr;
+void TileMap::saveToStream( IOStream& IOS ) {
+	if ( !IOS.isOpen() )
+		return;
 
-							//! The DataId should be the TextureRegion hash name ( at least in the
-							//! cases of type TextureRegion, TextureRegionEx and Sprite.
-							tTGOHdr.Id = tObj->getDataId();
+	writeHeaders( IOS, EE_MAP_MAGIC );
 
-							//! If the object type is virtual, means that the real type is stored
-							//! elsewhere.
-							if ( tObj->getType() != GAMEOBJECT_TYPE_VIRTUAL ) {
-								tTGOHdr.Type = tObj->getType();
-							} else {
-								GameObjectVirtual* tObjV =
-									reinterpret_cast<GameObjectVirtual*>( tObj );
+	//! First we save the tiled layers.
+	if ( hasTiledLayers() )
+		writeTiles( IOS, Rect( 0, 0, mSize.x, mSize.y ) );
 
-								tTGOHdr.Type = tObjV->getRealType();
-							}
+	//! Then we save the Object layers.
+	for ( Uint32 i = 0; i < mLayerCount; i++ ) {
+		if ( NULL != mLayers[i] && mLayers[i]->getType() == MAP_LAYER_OBJECT ) {
+			MapObjectLayer* tOLayer = reinterpret_cast<MapObjectLayer*>( mLayers[i] );
 
-							tTGOHdr.Flags = tObj->getFlags();
+			MapObjectLayer::ObjList ObjList = tOLayer->getObjectList();
 
-							IOS.write( (const char*)&tTGOHdr, sizeof( sMapTileGOHdr ) );
-						}
-					}
-				}
+			for ( MapObjectLayer::ObjList::iterator MapObjIt = ObjList.begin();
+				  MapObjIt != ObjList.end(); ++MapObjIt ) {
+				writeObject( IOS, *MapObjIt );
 			}
 		}
+	}
 
-		//! Then we save the Object layers.
-		MapObjectLayer* tOLayer;
-
-		for ( i = 0; i < mLayerCount; i++ ) {
-			tLayer = mLayers[i];
+	//! Saves the lights
+	writeLights( IOS );
+}
 
-			if ( NULL != tLayer && tLayer->getType() == MAP_LAYER_OBJECT ) {
-				tOLayer = reinterpret_cast<MapObjectLayer*>( tLayer );
+void TileMap::saveToFile( const std::string& path ) {
+	if ( !FileSystem::isDirectory( path ) ) {
+		mPath = path;
 
-				MapObjectLayer::ObjList ObjList = tOLayer->getObjectList();
+		IOStreamFile IOS( path, "wb" );
 
-				for ( MapObjectLayer::ObjList::iterator MapObjIt = ObjList.begin();
-					  MapObjIt != ObjList.end(); ++MapObjIt ) {
-					tObj = ( *MapObjIt );
+		saveToStream( IOS );
+	}
+}
 
-					sMapObjGOHdr tOGOHdr;
+void TileMap::saveToChunkedStream( IOStream& IOS, const Uint32& ChunkSize ) {
+	if ( !IOS.isOpen() || 0 == ChunkSize )
+		return;
 
-					//! The DataId should be the TextureRegion hash name ( at least in the cases of
-					//! type TextureRegion, TextureRegionEx and Sprite. And for the Poly Obj should
-					//! be an arbitrary value assigned by the map on the moment of creation
-					tOGOHdr.Id = tObj->getDataId();
+	writeHeaders( IOS, EE_MAP_CHUNKED_MAGIC );
 
-					//! If the object type is virtual, means that the real type is stored elsewhere.
-					if ( tObj->getType() != GAMEOBJECT_TYPE_VIRTUAL ) {
-						tOGOHdr.Type = tObj->getType();
-					} else {
-						GameObjectVirtual* tObjV = reinterpret_cast<GameObjectVirtual*>( tObj );
+	//! The lights are few and small, they are always loaded
+	writeLights( IOS );
 
-						tOGOHdr.Type = tObjV->getRealType();
-					}
+	sMapChunksHdr ChunksHdr;
+	ChunksHdr.ChunkSize = ChunkSize;
+	ChunksHdr.ChunksX = ( mSize.x + ChunkSize - 1 ) / ChunkSize;
+	ChunksHdr.ChunksY = ( mSize.y + ChunkSize - 1 ) / ChunkSize;
+	ChunksHdr.Compression = Compression::MODE_DEFLATE;
 
-					tOGOHdr.Flags = tObj->getFlags();
+	IOS.write( (const char*)&ChunksHdr, sizeof( sMapChunksHdr ) );
 
-					tOGOHdr.PosX = (Int32)tObj->getPosition().x;
+	Uint32 ChunksCount = ChunksHdr.ChunksX * ChunksHdr.ChunksY;
+	std::vector<sMapChunkEntry> Table( ChunksCount );
 
-					tOGOHdr.PosY = (Int32)tObj->getPosition().y;
+	//! The chunks are compressed before writing the table that precedes them, the stream is only
+	//! written sequentially ( IOStreamString inserts at the seek position )
+	IOStreamString ChunksData;
 
-					IOS.write( (const char*)&tOGOHdr, sizeof( sMapObjGOHdr ) );
+	//! The objects belong to the chunk that contains its position
+	std::vector<std::vector<std::vector<GameObject*>>> ChunkObjects( ChunksCount );
+	Int32 ChunkWidth = ChunkSize * eemax( 1, mTileSize.x );
+	Int32 ChunkHeight = ChunkSize * eemax( 1, mTileSize.y );
 
-					//! For the polygon objects wee need to write the polygon points, the Name, the
-					//! TypeName and the Properties.
-					if ( tObj->getType() == GAMEOBJECT_TYPE_OBJECT ||
-						 tObj->getType() == GAMEOBJECT_TYPE_POLYGON ||
-						 tObj->getType() == GAMEOBJECT_TYPE_POLYLINE ) {
-						GameObjectObject* tObjObj = reinterpret_cast<GameObjectObject*>( tObj );
-						Polygon2f tPoly = tObjObj->getPolygon();
-						GameObjectObject::PropertiesMap tObjObjProp = tObjObj->getProperties();
-						sMapObjObjHdr tObjObjHdr;
+	for ( Uint32 i = 0; i < mLayerCount; i++ ) {
+		if ( NULL == mLayers[i] || mLayers[i]->getType() != MAP_LAYER_OBJECT )
+			continue;
 
-						memset( tObjObjHdr.Name, 0, MAP_PROPERTY_SIZE );
-						memset( tObjObjHdr.Type, 0, MAP_PROPERTY_SIZE );
+		MapObjectLayer* tOLayer = reinterpret_cast<MapObjectLayer*>( mLayers[i] );
+		MapObjectLayer::ObjList ObjList = tOLayer->getObjectList();
 
-						String::strCopy( tObjObjHdr.Name, tObjObj->getName().c_str(),
-										 MAP_PROPERTY_SIZE );
-						String::strCopy( tObjObjHdr.Type, tObjObj->getTypeName().c_str(),
-										 MAP_PROPERTY_SIZE );
+		for ( GameObject* tObj : ObjList ) {
+			Int32 cx = eeclamp( (Int32)eefloor( tObj->getPosition().x / ChunkWidth ), 0,
+								(Int32)ChunksHdr.ChunksX - 1 );
+			Int32 cy = eeclamp( (Int32)eefloor( tObj->getPosition().y / ChunkHeight ), 0,
+								(Int32)ChunksHdr.ChunksY - 1 );
+			auto& Layers = ChunkObjects[cx * ChunksHdr.ChunksY + cy];
 
-						tObjObjHdr.PointCount = tPoly.getSize();
-						tObjObjHdr.PropertyCount = tObjObjProp.size();
+			Layers.resize( mLayerCount );
+			Layers[i].push_back( tObj );
+		}
+	}
 
-						//! Writes the ObjObj header
-						IOS.write( (const char*)&tObjObjHdr, sizeof( sMapObjObjHdr ) );
+	bool ThereIsTiled = hasTiledLayers();
 
-						//! Writes the properties of the current polygon object
-						for ( GameObjectObject::PropertiesMap::iterator ooit = tObjObjProp.begin();
-							  ooit != tObjObjProp.end(); ++ooit ) {
-							sPropertyHdr tProp;
+	for ( Uint32 cx = 0; cx < ChunksHdr.ChunksX; cx++ ) {
+		for ( Uint32 cy = 0; cy < ChunksHdr.ChunksY; cy++ ) {
+			Uint32 Index = cx * ChunksHdr.ChunksY + cy;
+			auto& Layers = ChunkObjects[Index];
+			IOStreamString Data;
 
-							memset( tProp.Name, 0, MAP_PROPERTY_SIZE );
-							memset( tProp.Value, 0, MAP_PROPERTY_SIZE );
+			//! The chunks on the borders are padded with empty tiles
+			if ( ThereIsTiled ) {
+				writeTiles( Data, Rect( cx * ChunkSize, cy * ChunkSize, ( cx + 1 ) * ChunkSize,
+										( cy + 1 ) * ChunkSize ) );
+			}
 
-							String::strCopy( tProp.Name, ooit->first.c_str(), MAP_PROPERTY_SIZE );
-							String::strCopy( tProp.Value, ooit->second.c_str(), MAP_PROPERTY_SIZE );
+			for ( Uint32 i = 0; i < mLayerCount; i++ ) {
+				if ( NULL == mLayers[i] || mLayers[i]->getType() != MAP_LAYER_OBJECT )
+					continue;
 
-							IOS.write( (const char*)&tProp, sizeof( sPropertyHdr ) );
-						}
+				Uint32 ObjCount = i < Layers.size() ? Layers[i].size() : 0;
 
-						//! Writes the polygon points
-						for ( Uint32 tPoint = 0; tPoint < tPoly.getSize(); tPoint++ ) {
-							Vector2f pf( tPoly.getAt( tPoint ) );
-							Vector2if p( pf.x, pf.y ); //! Convert it to Int32
+				Data.write( (const char*)&ObjCount, sizeof( Uint32 ) );
 
-							IOS.write( (const char*)&p, sizeof( Vector2if ) );
-						}
-					}
-				}
+				for ( Uint32 o = 0; o < ObjCount; o++ )
+					writeObject( Data, Layers[i][o] );
 			}
-		}
-
-		//! Saves the lights
-		if ( MapHdr.LightsCount && NULL != mLightManager ) {
-			MapLightManager::LightsList& Lights = mLightManager->getLights();
 
-			for ( MapLightManager::LightsList::iterator LightsIt = Lights.begin();
-				  LightsIt != Lights.end(); ++LightsIt ) {
-				MapLight* Light = ( *LightsIt );
+			IOStreamString Compressed;
 
-				sMapLightHdr tLightHdr;
+			if ( Compression::OK != Compression::compress( Compressed, Data ) )
+				continue;
 
-				tLightHdr.Radius = Light->getRadius();
-				tLightHdr.PosX = (Int32)Light->getPosition().x;
-				tLightHdr.PosY = (Int32)Light->getPosition().y;
-				tLightHdr.Color = Color( Light->getColor() ).getValue();
-				tLightHdr.Type = Light->getType();
+			sMapChunkEntry& Entry = Table[Index];
+			Entry.Offset = ChunksData.getSize();
+			Entry.Size = Compressed.getStream().size();
+			Entry.DataSize = Data.getStream().size();
 
-				IOS.write( (const char*)&tLightHdr, sizeof( sMapLightHdr ) );
-			}
+			ChunksData.write( Compressed.getStream().c_str(), Entry.Size );
 		}
 	}
+
+	IOS.write( (const char*)Table.data(), sizeof( sMapChunkEntry ) * ChunksCount );
+	IOS.write( ChunksData.getStream().c_str(), ChunksData.getSize() );
 }
 
-void TileMap::saveToFile( const std::string& path ) {
+void TileMap::saveToChunkedFile( const std::string& path, const Uint32& ChunkSize ) {
 	if ( !FileSystem::isDirectory( path ) ) {
 		mPath = path;
 
 		IOStreamFile IOS( path, "wb" );
 
-		saveToStream( IOS );
+		saveToChunkedStream( IOS, ChunkSize );
 	}
 }
 
@@ -1442,15 +1612,22 @@ std::vector<std::string> TileMap::getTextureAtlases() {
 
 	//! Ugly ugly ugly, but i don't see another way
 	Uint32 Restricted1 = String::hash( std::string( "global" ) );
-	Uint32 Restricted2 = String::hash( SceneManager::instance()
-										   ->getUISceneNode()
-										   ->getUIThemeManager()
-										   ->getDefaultTheme()
-										   ->getTextureAtlas()
-										   ->getName() );
+	std::string ThemeAtlas;
+
+	//! Without a scene ( headless tools and tests ) there's no theme atlas to skip
+	UISceneNode* SceneNode = NULL != SceneManager::existsSingleton()
+								 ? SceneManager::instance()->getUISceneNode()
+								 : NULL;
+
+	if ( NULL != SceneNode && NULL != SceneNode->getUIThemeManager()->getDefaultTheme() &&
+		 NULL != SceneNode->getUIThemeManager()->getDefaultTheme()->getTextureAtlas() ) {
+		ThemeAtlas =
+			SceneNode->getUIThemeManager()->getDefaultTheme()->getTextureAtlas()->getName();
+	}
 
 	for ( auto& it : res ) {
-		if ( it.second->getId() != Restricted1 && it.second->getId() != Restricted2 )
+		if ( it.second->getId() != Restricted1 &&
+			 ( ThemeAtlas.empty() || it.second->getName() != ThemeAtlas ) )
 			items.push_back( it.second->getPath() );
 	}
 
@@ -1,13 +1,21 @@
+#include <algorithm>
+#include <eepp/maps/gameobjecttextureregion.hpp>
 #include <eepp/maps/tilemap.hpp>
 #include <eepp/maps/tilemaplayer.hpp>
 
 #include <eepp/graphics/globalbatchrenderer.hpp>
+#include <eepp/graphics/renderer/openglext.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/texture.hpp>
 using namespace EE::Graphics;
 
 namespace EE { namespace Maps {
 
+/** Without a renderer ( headless ) the chunks are built with quads */
+static bool quadsSupported() {
+	return NULL == GLi || GLi->quadsSupported();
+}
+
 TileMapLayer::TileMapLayer( TileMap* map, Sizei size, Uint32 flags, std::string name,
 							Vector2f offset ) :
 	MapLayer( map, MAP_LAYER_TILED, flags, name, offset ), mSize( size ) {
@@ -27,13 +35,19 @@ void TileMapLayer::draw( const Vector2f& Offset ) {
 	Vector2i start = mMap->getStartTile();
 	Vector2i end = mMap->getEndTile();
 
-	for ( Int32 x = start.x; x < end.x; x++ ) {
-		for ( Int32 y = start.y; y < end.y; y++ ) {
-			mCurTile.x = x;
-			mCurTile.y = y;
+	if ( mChunked ) {
+		drawChunks();
+	} else {
+		for ( Int32 x = start.x; x < end.x; x++ ) {
+			for ( Int32 y = start.y; y < end.y; y++ ) {
+				mCurTile.x = x;
+				mCurTile.y = y;
 
-			if ( NULL != mTiles[x][y] ) {
-				mTiles[x][y]->draw();
+				GameObject* obj = getTile( x, y );
+
+				if ( NULL != obj ) {
+					obj->draw();
+				}
 			}
 		}
 	}
@@ -43,8 +57,10 @@ void TileMapLayer::draw( const Vector2f& Offset ) {
 	if ( mMap->getShowBlocked() && NULL != Tex ) {
 		for ( Int32 x = start.x; x < end.x; x++ ) {
 			for ( Int32 y = start.y; y < end.y; y++ ) {
-				if ( NULL != mTiles[x][y] ) {
-					if ( mTiles[x][y]->isBlocked() ) {
+				GameObject* obj = getTile( x, y );
+
+				if ( NULL != obj ) {
+					if ( obj->isBlocked() ) {
 						Tex->draw( x * mMap->getTileSize().x, y * mMap->getTileSize().y, 0,
 								   Vector2f::One, Color( 255, 0, 0, 200 ) );
 					}
@@ -67,35 +83,82 @@ void TileMapLayer::update( const Time& dt ) {
 			mCurTile.x = x;
 			mCurTile.y = y;
 
-			if ( NULL != mTiles[x][y] ) {
-				mTiles[x][y]->update( dt );
+			GameObject* obj = getTile( x, y );
+
+			if ( NULL != obj ) {
+				obj->update( dt );
 			}
 		}
 	}
 }
 
 void TileMapLayer::allocateLayer() {
-	mTiles = eeNewArray( GameObject**, mSize.getWidth() );
+	mBlocksSize = Sizei( ( mSize.x + ChunkSize - 1 ) / ChunkSize,
+						 ( mSize.y + ChunkSize - 1 ) / ChunkSize );
+	mTileBlocks.assign( mBlocksSize.x * mBlocksSize.y, NULL );
+}
 
-	for ( Int32 x = 0; x < mSize.x; x++ ) {
-		mTiles[x] = eeNewArray( GameObject*, mSize.getHeight() );
+void TileMapLayer::deallocateLayer() {
+	for ( auto& block : mTileBlocks ) {
+		if ( NULL != block ) {
+			for ( Int32 i = 0; i < ChunkSize * ChunkSize; i++ )
+				eeSAFE_DELETE( block[i] );
 
-		for ( Int32 y = 0; y < mSize.y; y++ ) {
-			mTiles[x][y] = NULL;
+			eeSAFE_DELETE_ARRAY( block );
 		}
 	}
+
+	mTileBlocks.clear();
 }
 
-void TileMapLayer::deallocateLayer() {
-	for ( Int32 x = 0; x < mSize.x; x++ ) {
-		for ( Int32 y = 0; y < mSize.y; y++ ) {
-			eeSAFE_DELETE( mTiles[x][y] );
+GameObject* TileMapLayer::getTile( const Int32& x, const Int32& y ) const {
+	GameObject** block = mTileBlocks[( x / ChunkSize ) * mBlocksSize.y + y / ChunkSize];
+
+	return NULL != block ? block[( x % ChunkSize ) * ChunkSize + y % ChunkSize] : NULL;
+}
+
+GameObject*& TileMapLayer::getTileRef( const Int32& x, const Int32& y ) {
+	GameObject**& block = mTileBlocks[( x / ChunkSize ) * mBlocksSize.y + y / ChunkSize];
+
+	if ( NULL == block ) {
+		block = eeNewArray( GameObject*, ChunkSize * ChunkSize );
+		std::fill( block, block + ChunkSize * ChunkSize, (GameObject*)NULL );
+	}
+
+	return block[( x % ChunkSize ) * ChunkSize + y % ChunkSize];
+}
+
+void TileMapLayer::removeGameObjects( const Rect& TileArea ) {
+	Rect area( eemax( TileArea.Left, 0 ), eemax( TileArea.Top, 0 ),
+			   eemin( TileArea.Right, mSize.x ), eemin( TileArea.Bottom, mSize.y ) );
+
+	if ( area.Left >= area.Right || area.Top >= area.Bottom )
+		return;
+
+	for ( Int32 x = area.Left; x < area.Right; x++ ) {
+		for ( Int32 y = area.Top; y < area.Bottom; y++ ) {
+			if ( NULL != getTile( x, y ) ) {
+				eeSAFE_DELETE( getTileRef( x, y ) );
+				invalidateTile( Vector2i( x, y ) );
+			}
 		}
+	}
 
-		eeSAFE_DELETE_ARRAY( mTiles[x] );
+	// Releases the blocks left empty
+	for ( Int32 bx = area.Left / ChunkSize; bx <= ( area.Right - 1 ) / ChunkSize; bx++ ) {
+		for ( Int32 by = area.Top / ChunkSize; by <= ( area.Bottom - 1 ) / ChunkSize; by++ ) {
+			GameObject**& block = mTileBlocks[bx * mBlocksSize.y + by];
+
+			if ( NULL != block && std::all_of( block, block + ChunkSize * ChunkSize,
+											   []( GameObject* obj ) { return NULL == obj; } ) )
+				eeSAFE_DELETE_ARRAY( block );
+		}
 	}
+}
 
-	eeSAFE_DELETE_ARRAY( mTiles );
+Uint32 TileMapLayer::getAllocatedBlocks() const {
+	return std::count_if( mTileBlocks.begin(), mTileBlocks.end(),
+						  []( GameObject** block ) { return NULL != block; } );
 }
 
 void TileMapLayer::addGameObject( GameObject* obj, const Vector2i& TilePos ) {
@@ -104,10 +167,12 @@ void TileMapLayer::addGameObject( GameObject* obj, const Vector2i& TilePos ) {
 	if ( TilePos.x < mSize.x && TilePos.y < mSize.y ) {
 		removeGameObject( TilePos );
 
-		mTiles[TilePos.x][TilePos.y] = obj;
+		getTileRef( TilePos.x, TilePos.y ) = obj;
 
 		obj->setPosition(
 			Vector2f( TilePos.x * mMap->getTileSize().x, TilePos.y * mMap->getTileSize().y ) );
+
+		invalidateTile( TilePos );
 	}
 }
 
@@ -115,8 +180,9 @@ void TileMapLayer::removeGameObject( const Vector2i& TilePos ) {
 	eeASSERT( TilePos.x >= 0 && TilePos.y >= 0 );
 
 	if ( TilePos.x < mSize.x && TilePos.y < mSize.y ) {
-		if ( NULL != mTiles[TilePos.x][TilePos.y] ) {
-			eeSAFE_DELETE( mTiles[TilePos.x][TilePos.y] );
+		if ( NULL != getTile( TilePos.x, TilePos.y ) ) {
+			eeSAFE_DELETE( getTileRef( TilePos.x, TilePos.y ) );
+			invalidateTile( TilePos );
 		}
 	}
 }
@@ -124,15 +190,22 @@ void TileMapLayer::removeGameObject( const Vector2i& TilePos ) {
 void TileMapLayer::moveTileObject( const Vector2i& FromPos, const Vector2i& ToPos ) {
 	removeGameObject( ToPos );
 
-	GameObject* tObj = mTiles[FromPos.x][FromPos.y];
+	GameObject* tObj = getTile( FromPos.x, FromPos.y );
 
-	mTiles[FromPos.x][FromPos.y] = NULL;
+	if ( NULL != tObj ) {
+		getTileRef( FromPos.x, FromPos.y ) = NULL;
+		getTileRef( ToPos.x, ToPos.y ) = tObj;
+	}
 
-	mTiles[ToPos.x][ToPos.y] = tObj;
+	invalidateTile( FromPos );
+	invalidateTile( ToPos );
 }
 
 GameObject* TileMapLayer::getGameObject( const Vector2i& TilePos ) {
-	return mTiles[TilePos.x][TilePos.y];
+	if ( TilePos.x < 0 || TilePos.y < 0 || TilePos.x >= mSize.x || TilePos.y >= mSize.y )
+		return NULL;
+
+	return getTile( TilePos.x, TilePos.y );
 }
 
 const Vector2i& TileMapLayer::getCurrentTile() const {
@@ -149,4 +222,263 @@ Vector2f TileMapLayer::getPosFromTilePos( const Vector2i& TilePos ) {
 					 TilePos.y * mMap->getTileSize().getHeight() + mOffset.y );
 }
 
+void TileMapLayer::setChunkedRendering( bool chunked ) {
+	if ( chunked == mChunked )
+		return;
+
+	mChunked = chunked;
+	mChunks.clear();
+
+	if ( mChunked ) {
+		mChunksSize = Sizei( ( mSize.x + ChunkSize - 1 ) / ChunkSize,
+							 ( mSize.y + ChunkSize - 1 ) / ChunkSize );
+		mChunks.resize( mChunksSize.x * mChunksSize.y );
+	}
+}
+
+bool TileMapLayer::isChunkedRendering() const {
+	return mChunked;
+}
+
+void TileMapLayer::invalidateTile( const Vector2i& TilePos ) {
+	if ( mChunked && TilePos.x >= 0 && TilePos.y >= 0 && TilePos.x < mSize.x &&
+		 TilePos.y < mSize.y )
+		mChunks[( TilePos.x / ChunkSize ) * mChunksSize.y + TilePos.y / ChunkSize].dirty = true;
+}
+
+void TileMapLayer::invalidateChunks() {
+	for ( auto& chunk : mChunks )
+		chunk.dirty = true;
+}
+
+Uint32 TileMapLayer::getLightMode() {
+	if ( !mMap->getLightsEnabled() || !getLightsEnabled() || NULL == mMap->getLightManager() )
+		return 0;
+
+	return mMap->getLightManager()->isByVertex() ? 2 : 1;
+}
+
+bool TileMapLayer::getChunksInView( Vector2i& chunkStart, Vector2i& chunkEnd ) {
+	Vector2i start = mMap->getStartTile();
+	Vector2i end = mMap->getEndTile();
+
+	if ( end.x <= start.x || end.y <= start.y )
+		return false;
+
+	chunkStart = Vector2i( start.x / ChunkSize, start.y / ChunkSize );
+	chunkEnd = Vector2i( ( end.x - 1 ) / ChunkSize + 1, ( end.y - 1 ) / ChunkSize + 1 );
+
+	return true;
+}
+
+bool TileMapLayer::isTileInView( const Vector2i& TilePos ) {
+	const Vector2i& start = mMap->getStartTile();
+	const Vector2i& end = mMap->getEndTile();
+
+	return TilePos.x >= start.x && TilePos.x < end.x && TilePos.y >= start.y && TilePos.y < end.y;
+}
+
+Uint32 TileMapLayer::updateChunks() {
+	Vector2i chunkStart, chunkEnd;
+
+	if ( !mChunked || !getChunksInView( chunkStart, chunkEnd ) )
+		return 0;
+
+	Uint32 lightMode = getLightMode();
+
+	if ( lightMode != mChunksLightMode ) {
+		mChunksLightMode = lightMode;
+		invalidateChunks();
+	}
+
+	Uint32 draws = 0;
+
+	for ( Int32 cx = chunkStart.x; cx < chunkEnd.x; cx++ ) {
+		for ( Int32 cy = chunkStart.y; cy < chunkEnd.y; cy++ ) {
+			Chunk& chunk = mChunks[cx * mChunksSize.y + cy];
+
+			if ( chunk.dirty ) {
+				buildChunk( Vector2i( cx, cy ), chunk );
+			} else if ( 0 != lightMode ) {
+				updateChunkLights( chunk );
+			}
+
+			for ( const auto& batch : chunk.batches ) {
+				if ( !batch.vertexs.empty() )
+					draws++;
+
+				draws += std::count_if( batch.objects.begin(), batch.objects.end(),
+										[this]( const Vector2i& tile ) {
+											return isTileInView( tile );
+										} );
+			}
+		}
+	}
+
+	return draws;
+}
+
+void TileMapLayer::drawChunks() {
+	Vector2i chunkStart, chunkEnd;
+
+	if ( 0 == updateChunks() || !getChunksInView( chunkStart, chunkEnd ) )
+		return;
+
+	PrimitiveType mode = GLi->quadsSupported() ? PRIMITIVE_QUADS : PRIMITIVE_TRIANGLES;
+
+	for ( Int32 cx = chunkStart.x; cx < chunkEnd.x; cx++ ) {
+		for ( Int32 cy = chunkStart.y; cy < chunkEnd.y; cy++ ) {
+			for ( auto& batch : mChunks[cx * mChunksSize.y + cy].batches ) {
+				if ( !batch.vertexs.empty() ) {
+					Uint32 alloc = sizeof( VertexData ) * batch.vertexs.size();
+					char* vertexs = reinterpret_cast<char*>( &batch.vertexs[0] );
+
+					BlendMode::setMode( batch.blend );
+					batch.texture->bind();
+					GLi->texCoordPointer( 2, GL_FP, sizeof( VertexData ),
+										  vertexs + sizeof( Vector2f ), alloc );
+					GLi->vertexPointer( 2, GL_FP, sizeof( VertexData ), vertexs, alloc );
+					GLi->colorPointer( 4, GL_UNSIGNED_BYTE, sizeof( VertexData ),
+									   vertexs + sizeof( Vector2f ) + sizeof( Vector2f ), alloc );
+					GLi->drawArrays( mode, 0, batch.vertexs.size() );
+				}
+
+				if ( batch.objects.empty() )
+					continue;
+
+				for ( const auto& tile : batch.objects ) {
+					if ( isTileInView( tile ) ) {
+						mCurTile = tile;
+						getTile( tile.x, tile.y )->draw();
+					}
+				}
+
+				// The objects must be drawn before the next baked tiles
+				GlobalBatchRenderer::instance()->draw();
+			}
+		}
+	}
+}
+
+void TileMapLayer::buildChunk( const Vector2i& chunkPos, Chunk& chunk ) {
+	chunk.dirty = false;
+	chunk.batches.clear();
+
+	Int32 endX = eemin( ( chunkPos.x + 1 ) * ChunkSize, mSize.x );
+	Int32 endY = eemin( ( chunkPos.y + 1 ) * ChunkSize, mSize.y );
+
+	for ( Int32 x = chunkPos.x * ChunkSize; x < endX; x++ ) {
+		for ( Int32 y = chunkPos.y * ChunkSize; y < endY; y++ ) {
+			GameObject* obj = getTile( x, y );
+
+			if ( NULL != obj && !bakeTile( chunk, obj, Vector2i( x, y ) ) ) {
+				if ( chunk.batches.empty() )
+					chunk.batches.emplace_back();
+
+				chunk.batches.back().objects.emplace_back( x, y );
+			}
+		}
+	}
+
+	if ( 0 != mChunksLightMode )
+		updateChunkLights( chunk );
+}
+
+bool TileMapLayer::bakeTile( Chunk& chunk, GameObject* obj, const Vector2i& TilePos ) {
+	// Only the plain texture regions, the rest of the objects can change on every frame
+	if ( obj->getType() != GAMEOBJECT_TYPE_TEXTUREREGION )
+		return false;
+
+	TextureRegion* region = static_cast<GameObjectTextureRegion*>( obj )->getTextureRegion();
+
+	if ( NULL == region || NULL == region->getTexture() ||
+		 region->getTexture()->getClampMode() == Texture::ClampMode::ClampRepeat )
+		return false;
+
+	// Same quad that TextureRegion::draw emits for the object, see Texture::drawEx
+	Texture* tex = region->getTexture();
+	Float w = (Float)tex->getImageWidth();
+	Float h = (Float)tex->getImageHeight();
+	Rect sector = region->getSrcRect();
+
+	if ( sector.Right == 0 && sector.Bottom == 0 )
+		sector = Rect( 0, 0, tex->getImageWidth(), tex->getImageHeight() );
+
+	Rectf coords( sector.Left / w, sector.Top / h, sector.Right / w, sector.Bottom / h );
+	RenderMode effect = obj->getRenderModeFromFlags();
+
+	if ( effect == RENDER_MIRROR || effect == RENDER_FLIPPED_MIRRORED )
+		std::swap( coords.Left, coords.Right );
+
+	if ( effect == RENDER_FLIPPED || effect == RENDER_FLIPPED_MIRRORED )
+		std::swap( coords.Top, coords.Bottom );
+
+	Vector2f pos( obj->getPosition() + region->getOffset().asFloat() );
+	Vector2f size( region->getRealSize().asFloat() );
+	Quad2f quad( pos, Vector2f( pos.x, pos.y + size.y ), pos + size,
+				 Vector2f( pos.x + size.x, pos.y ) );
+	Float angle = obj->getRotation();
+
+	if ( angle != 0.f )
+		quad.rotate( angle, pos + size * 0.5f );
+
+	Vector2f texCoords[4] = { { coords.Left, coords.Top },
+							  { coords.Left, coords.Bottom },
+							  { coords.Right, coords.Bottom },
+							  { coords.Right, coords.Top } };
+
+	// The tiles lit by tile ignore the blend flags, as GameObjectTextureRegion::draw does
+	BlendMode blend = 1 == mChunksLightMode ? BlendMode::Alpha() : obj->getBlendModeFromFlags();
+
+	// Only the last batch can take the tile, an earlier one would draw it below the tiles and
+	// objects that come before it
+	if ( chunk.batches.empty() || chunk.batches.back().texture != tex ||
+		 chunk.batches.back().blend != blend || !chunk.batches.back().objects.empty() ) {
+		chunk.batches.emplace_back();
+		chunk.batches.back().texture = tex;
+		chunk.batches.back().blend = blend;
+	}
+
+	ChunkBatch* batch = &chunk.batches.back();
+	static const int quadCorners[4] = { 0, 1, 2, 3 };
+	static const int triangleCorners[6] = { 1, 0, 3, 1, 2, 3 };
+	const int* corners = quadsSupported() ? quadCorners : triangleCorners;
+	int count = quadsSupported() ? 4 : 6;
+
+	for ( int i = 0; i < count; i++ )
+		batch->vertexs.push_back( { quad[corners[i]], texCoords[corners[i]], Color::White } );
+
+	batch->tiles.push_back( TilePos );
+
+	return true;
+}
+
+void TileMapLayer::updateChunkLights( Chunk& chunk ) {
+	MapLightManager* LM = mMap->getLightManager();
+	int count = quadsSupported() ? 4 : 6;
+
+	for ( auto& batch : chunk.batches ) {
+		VertexData* vertex = batch.vertexs.data();
+
+		if ( LM->isByVertex() ) {
+			static const int quadCorners[4] = { 0, 1, 2, 3 };
+			static const int triangleCorners[6] = { 1, 0, 3, 1, 2, 3 };
+			const int* corners = 4 == count ? quadCorners : triangleCorners;
+
+			for ( const auto& tile : batch.tiles ) {
+				for ( int i = 0; i < count; i++ )
+					vertex[i].color = *LM->getTileColor( tile, corners[i] );
+				vertex += count;
+			}
+		} else {
+			for ( const auto& tile : batch.tiles ) {
+				Color color( *LM->getTileColor( tile ) );
+				for ( int i = 0; i < count; i++ )
+					vertex[i].color = color;
+				vertex += count;
+			}
+		}
+	}
+}
+
 }} // namespace EE::Maps
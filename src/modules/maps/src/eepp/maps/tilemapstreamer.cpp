@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <eepp/maps/tilemap.hpp>
+#include <eepp/maps/tilemaplayer.hpp>
+#include <eepp/maps/tilemapstreamer.hpp>
+#include <eepp/system/compression.hpp>
+#include <eepp/system/iostreammemory.hpp>
+#include <eepp/system/lock.hpp>
+
+namespace EE { namespace Maps {
+
+TileMapStreamer::TileMapStreamer( TileMap* map, IOStream* stream, bool ownStream ) :
+	mMap( map ), mStream( stream ), mOwnStream( ownStream ) {
+	if ( NULL == mStream || !mStream->isOpen() ||
+		 mStream->read( (char*)&mHdr, sizeof( sMapChunksHdr ) ) != sizeof( sMapChunksHdr ) ||
+		 0 == mHdr.ChunkSize )
+		return;
+
+	mChunksSize = Sizei( mHdr.ChunksX, mHdr.ChunksY );
+	mTable.resize( mHdr.ChunksX * mHdr.ChunksY );
+
+	ios_size tableSize = sizeof( sMapChunkEntry ) * mTable.size();
+
+	if ( mStream->read( (char*)mTable.data(), tableSize ) != tableSize )
+		return;
+
+	mDataStart = mStream->tell();
+	mStates.resize( mTable.size(), CHUNK_UNLOADED );
+	mValid = true;
+}
+
+TileMapStreamer::~TileMapStreamer() {
+	// Waits for the chunk being read before releasing the stream
+	mPool.reset();
+
+	if ( mOwnStream )
+		eeSAFE_DELETE( mStream );
+}
+
+void TileMapStreamer::update() {
+	if ( !mValid )
+		return;
+
+	applyDone();
+
+	Rect keep( getViewChunks( mLoadRadius + mUnloadMargin ) );
+	std::vector<Uint32> unload;
+
+	for ( const auto& chunk : mChunkObjects ) {
+		Vector2i pos( chunk.first / mChunksSize.y, chunk.first % mChunksSize.y );
+
+		if ( pos.x < keep.Left || pos.x > keep.Right || pos.y < keep.Top || pos.y > keep.Bottom )
+			unload.push_back( chunk.first );
+	}
+
+	for ( Uint32 index : unload )
+		unloadChunk( index );
+
+	Rect load( getViewChunks( mLoadRadius ) );
+	Vector2f center( ( load.Left + load.Right ) * 0.5f, ( load.Top + load.Bottom ) * 0.5f );
+	std::vector<Uint32> missing;
+
+	for ( Int32 x = load.Left; x <= load.Right; x++ ) {
+		for ( Int32 y = load.Top; y <= load.Bottom; y++ ) {
+			Uint32 index = x * mChunksSize.y + y;
+
+			if ( CHUNK_UNLOADED == mStates[index] )
+				missing.push_back( index );
+		}
+	}
+
+	// The chunks nearest to the view are needed first
+	std::sort( missing.begin(), missing.end(), [this, &center]( Uint32 a, Uint32 b ) {
+		Vector2f pa( a / mChunksSize.y, a % mChunksSize.y );
+		Vector2f pb( b / mChunksSize.y, b % mChunksSize.y );
+		return pa.distance( center ) < pb.distance( center );
+	} );
+
+	for ( Uint32 index : missing )
+		queueChunk( index );
+}
+
+void TileMapStreamer::loadAll() {
+	if ( !mValid )
+		return;
+
+	flush();
+
+	std::vector<char> data;
+
+	for ( Uint32 index = 0; index < mStates.size(); index++ ) {
+		if ( CHUNK_UNLOADED == mStates[index] ) {
+			readChunk( index, data );
+			applyChunk( index, data );
+		}
+	}
+}
+
+void TileMapStreamer::flush() {
+	{
+		std::unique_lock<std::mutex> l( mDoneMutex );
+		mDoneCond.wait( l, [this] { return 0 == mPending; } );
+	}
+
+	applyDone();
+}
+
+void TileMapStreamer::setLoadRadius( const Uint32& radius ) {
+	mLoadRadius = radius;
+}
+
+const Uint32& TileMapStreamer::getLoadRadius() const {
+	return mLoadRadius;
+}
+
+void TileMapStreamer::setUnloadMargin( const Uint32& margin ) {
+	mUnloadMargin = margin;
+}
+
+const Uint32& TileMapStreamer::getUnloadMargin() const {
+	return mUnloadMargin;
+}
+
+bool TileMapStreamer::isValid() const {
+	return mValid;
+}
+
+bool TileMapStreamer::isChunkLoaded( const Vector2i& chunk ) const {
+	if ( chunk.x < 0 || chunk.y < 0 || chunk.x >= mChunksSize.x || chunk.y >= mChunksSize.y )
+		return false;
+
+	return CHUNK_LOADED == mStates[chunk.x * mChunksSize.y + chunk.y];
+}
+
+Uint32 TileMapStreamer::getLoadedCount() const {
+	return mLoadedCount;
+}
+
+Uint32 TileMapStreamer::getPendingCount() const {
+	return mPending;
+}
+
+const Uint32& TileMapStreamer::getChunkSize() const {
+	return mHdr.ChunkSize;
+}
+
+const Sizei& TileMapStreamer::getChunksSize() const {
+	return mChunksSize;
+}
+
+Rect TileMapStreamer::getViewChunks( const Uint32& radius ) const {
+	Int32 size = mHdr.ChunkSize;
+	Int32 r = radius;
+	const Vector2i& start = mMap->getStartTile();
+	Vector2i end( eemax( mMap->getEndTile().x, start.x + 1 ),
+				  eemax( mMap->getEndTile().y, start.y + 1 ) );
+
+	return Rect( eemax( 0, start.x / size - r ), eemax( 0, start.y / size - r ),
+				 eemin( mChunksSize.x - 1, ( end.x - 1 ) / size + r ),
+				 eemin( mChunksSize.y - 1, ( end.y - 1 ) / size + r ) );
+}
+
+bool TileMapStreamer::readChunk( const Uint32& index, std::vector<char>& data ) {
+	const sMapChunkEntry& entry = mTable[index];
+
+	data.clear();
+
+	if ( 0 == entry.Size )
+		return true;
+
+	std::vector<char> compressed( entry.Size );
+
+	{
+		Lock l( mStreamMutex );
+
+		mStream->seek( mDataStart + entry.Offset );
+
+		if ( mStream->read( compressed.data(), entry.Size ) != entry.Size )
+			return false;
+	}
+
+	data.resize( entry.DataSize );
+
+	if ( Compression::OK != Compression::decompress( (Uint8*)data.data(), data.size(),
+													  (const Uint8*)compressed.data(),
+													  compressed.size(),
+													  (Compression::Mode)mHdr.Compression ) ) {
+		data.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void TileMapStreamer::applyChunk( const Uint32& index, const std::vector<char>& data ) {
+	auto& objects = mChunkObjects[index];
+
+	mStates[index] = CHUNK_LOADED;
+	mLoadedCount++;
+
+	if ( data.empty() )
+		return;
+
+	IOStreamMemory IOS( data.data(), data.size() );
+	Int32 size = mHdr.ChunkSize;
+	Vector2i pos( index / mChunksSize.y, index % mChunksSize.y );
+
+	if ( mMap->hasTiledLayers() ) {
+		mMap->readTiles( IOS, Rect( pos.x * size, pos.y * size, ( pos.x + 1 ) * size,
+									( pos.y + 1 ) * size ) );
+	}
+
+	for ( Uint32 i = 0; i < mMap->getLayerCount(); i++ ) {
+		MapLayer* layer = mMap->getLayer( i );
+
+		if ( NULL == layer || layer->getType() != MAP_LAYER_OBJECT )
+			continue;
+
+		MapObjectLayer* objLayer = reinterpret_cast<MapObjectLayer*>( layer );
+		Uint32 count = 0;
+
+		IOS.read( (char*)&count, sizeof( Uint32 ) );
+
+		if ( 0 == count )
+			continue;
+
+		objects.emplace_back( objLayer, MapObjectLayer::ObjList() );
+
+		for ( Uint32 o = 0; o < count; o++ )
+			objects.back().second.push_back( mMap->readObject( IOS, objLayer ) );
+	}
+
+	mMap->mPolyObjs.clear();
+}
+
+void TileMapStreamer::applyDone() {
+	std::vector<ChunkData> done;
+
+	{
+		std::lock_guard<std::mutex> l( mDoneMutex );
+		done.swap( mDone );
+	}
+
+	for ( const ChunkData& chunk : done ) {
+		if ( CHUNK_QUEUED == mStates[chunk.index] )
+			applyChunk( chunk.index, chunk.data );
+	}
+}
+
+void TileMapStreamer::queueChunk( const Uint32& index ) {
+	if ( !mPool )
+		mPool = ThreadPool::createUnique( 1 );
+
+	mStates[index] = CHUNK_QUEUED;
+	mPending++;
+
+	mPool->run( [this, index] {
+		ChunkData chunk;
+		chunk.index = index;
+
+		// A chunk that can't be read is added empty, so it's not requested again
+		readChunk( index, chunk.data );
+
+		{
+			std::lock_guard<std::mutex> l( mDoneMutex );
+			mDone.emplace_back( std::move( chunk ) );
+			mPending--;
+		}
+
+		mDoneCond.notify_all();
+	} );
+}
+
+void TileMapStreamer::unloadChunk( const Uint32& index ) {
+	auto found = mChunkObjects.find( index );
+
+	if ( found == mChunkObjects.end() )
+		return;
+
+	Int32 size = mHdr.ChunkSize;
+	Vector2i pos( index / mChunksSize.y, index % mChunksSize.y );
+	Rect area( pos.x * size, pos.y * size, ( pos.x + 1 ) * size, ( pos.y + 1 ) * size );
+
+	for ( Uint32 i = 0; i < mMap->getLayerCount(); i++ ) {
+		MapLayer* layer = mMap->getLayer( i );
+
+		if ( NULL != layer && layer->getType() == MAP_LAYER_TILED )
+			reinterpret_cast<TileMapLayer*>( layer )->removeGameObjects( area );
+	}
+
+	for ( auto& layerObjects : found->second ) {
+		// The layer could have been removed from the map since the chunk was loaded
+		if ( EE_MAP_LAYER_UNKNOWN != mMap->getLayerIndex( layerObjects.first ) )
+			layerObjects.first->removeGameObjects( layerObjects.second );
+	}
+
+	mChunkObjects.erase( found );
+	mStates[index] = CHUNK_UNLOADED;
+	mLoadedCount--;
+}
+
+}} // namespace EE::Maps
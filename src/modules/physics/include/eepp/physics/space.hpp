@@ -6,6 +6,8 @@
 #include <eepp/physics/body.hpp>
 #include <eepp/physics/constraints/constraint.hpp>
 #include <eepp/physics/shape.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
 
 namespace EE { namespace Physics {
 
@@ -80,6 +82,50 @@ class EE_PHYSICS_API Space {
 		void* Data;
 	};
 
+	/** A segment of a batched segment query */
+	struct QuerySegment {
+		cVect start;
+		cVect end;
+	};
+
+	/** A shape hit by a segment: t is the fraction of the segment to the hit point and n the
+	 * surface normal at the hit point */
+	struct SegmentHit {
+		Shape* shape;
+		cpFloat t;
+		cVect n;
+	};
+
+	/** The results of a batched query packed in a single array. The results of the query i are
+	 * the range [ offsets[i], offsets[i + 1] ) of the array, in the same order that the per-call
+	 * query reports them. The object can be reused between queries to keep its allocations. */
+	template <typename T> class BatchResults {
+	  public:
+		std::vector<T> results;
+		std::vector<Uint32> offsets;
+
+		size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+		Uint32 count( const size_t& query ) const {
+			return offsets[query + 1] - offsets[query];
+		}
+
+		const T* begin( const size_t& query ) const { return results.data() + offsets[query]; }
+
+		const T* end( const size_t& query ) const { return results.data() + offsets[query + 1]; }
+
+	  protected:
+		friend class Space;
+
+		//! The results of every batch of queries, before packing them
+		std::vector<std::vector<T>> mBatches;
+		//! The queries sorted by their position
+		std::vector<Uint32> mOrder;
+	};
+
+	typedef BatchResults<Shape*> ShapeBatchResults;
+	typedef BatchResults<SegmentHit> SegmentBatchResults;
+
 	class BodyIterator {
 	  public:
 		BodyIterator( Physics::Space* space, void* data, BodyIteratorFunc func ) :
@@ -110,6 +156,16 @@ class EE_PHYSICS_API Space {
 
 	void step( const cpFloat& dt );
 
+	/** Steps the space in the thread pool: the bodies are integrated, the broadphase pairs are
+	 * collided in batches and the independent islands of bodies ( the bodies connected by contacts
+	 * or constraints ) are solved in parallel. The collision callbacks are still called from the
+	 * stepping thread, in the same order, and the results are the same as the serial step. The
+	 * custom velocity and position functions of the bodies are called from the pool threads.
+	 * The batched queries use the pool too. Pass an empty pointer to step in the calling thread. */
+	void setThreadPool( std::shared_ptr<ThreadPool> pool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
 	void update();
 
 	Body* getStaticBody() const;
@@ -214,6 +270,25 @@ class EE_PHYSICS_API Space {
 
 	void pointQuery( cVect point, cpLayers layers, cpGroup group, PointQueryFunc func, void* data );
 
+	/** Batched version of bbQuery: queries every box and packs the shapes found in out. The
+	 * queries are split across the thread pool of the space, if any. The space must not be
+	 * modified or stepped meanwhile. */
+	void bbQueryBatch( const cBB* bbs, const size_t& count, cpLayers layers, cpGroup group,
+					   ShapeBatchResults& out );
+
+	/** Batched version of segmentQuery, @see bbQueryBatch */
+	void segmentQueryBatch( const QuerySegment* segments, const size_t& count, cpLayers layers,
+							cpGroup group, SegmentBatchResults& out );
+
+	/** Batched version of segmentQueryFirst: out gets the nearest hit of every segment, with a
+	 * NULL shape and t equal to 1 for the segments that don't hit anything. @see bbQueryBatch */
+	void segmentQueryFirstBatch( const QuerySegment* segments, const size_t& count,
+								 cpLayers layers, cpGroup group, std::vector<SegmentHit>& out );
+
+	/** Batched version of pointQuery, @see bbQueryBatch */
+	void pointQueryBatch( const cVect* points, const size_t& count, cpLayers layers, cpGroup group,
+						  ShapeBatchResults& out );
+
 	void setData( void* data );
 
 	void* getData() const;
@@ -226,6 +301,11 @@ class EE_PHYSICS_API Space {
 
 	void useSpatialHash( cpFloat dim, int count );
 
+	/** Rebuilds the tree of the active shapes. The tree is updated incrementally while the space
+	 * is stepped and its quality degrades over time, rebuilding it before a large batch of
+	 * queries makes them considerably faster. It does nothing with the spatial hash. */
+	void optimizeSpatialIndex();
+
 	void eachShape( ShapeIteratorFunc Func, void* data );
 
 	virtual void onEachShape( Shape* Shape, ShapeIterator* it );
@@ -239,6 +319,8 @@ class EE_PHYSICS_API Space {
 	void convertBodyToStatic( Body* body );
 
   protected:
+	struct ParallelStep;
+
 	cpSpace* mSpace;
 	Body* mStatiBody;
 	void* mData;
@@ -248,6 +330,17 @@ class EE_PHYSICS_API Space {
 	UnorderedMap<cpHashValue, CollisionHandler> mCollisions;
 	CollisionHandler mCollisionsDefault;
 	std::vector<PostStepCallbackCont*> mPostStepCallbacks;
+	std::shared_ptr<ThreadPool> mThreadPool;
+	std::unique_ptr<ParallelStep> mParallelStep;
+
+	bool mSpatialHash{ false };
+
+	void stepParallel( const cpFloat& dt );
+
+	/** Runs query( index, results ) for every query in batches, in the order of out.mOrder and in
+	 * parallel when it's safe, and packs the results of every query in out */
+	template <typename T, typename QueryFunc>
+	void runQueryBatch( const size_t& count, BatchResults<T>& out, QueryFunc query );
 };
 
 }} // namespace EE::Physics
@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <eepp/physics/physicsmanager.hpp>
 #include <eepp/physics/space.hpp>
+#include <functional>
+#include <unordered_map>
 
 #ifdef PHYSICS_RENDERER_ENABLED
 #include <eepp/graphics/globalbatchrenderer.hpp>
@@ -9,6 +12,156 @@ using namespace EE::Graphics;
 
 namespace EE { namespace Physics {
 
+/** The buffers reused by every parallel step */
+struct Space::ParallelStep {
+	struct Pair {
+		cpShape* a;
+		cpShape* b;
+	};
+
+	struct Island {
+		struct Redirect {
+			cpBody** slot;
+			cpBody* body;
+		};
+
+		std::vector<cpArbiter*> arbiters;
+		std::vector<cpConstraint*> constraints;
+		std::vector<Redirect> redirects;
+		std::vector<cpBody> copies;
+
+		void redirect( cpBody** slot ) {
+			if ( isShared( *slot ) )
+				redirects.push_back( { slot, *slot } );
+		}
+
+		/** Points the arbiters and constraints to private copies of the shared bodies. The
+		 * impulses don't change the velocities of the bodies of infinite mass, but the solver
+		 * still writes them, and other islands may be solving against the same bodies. */
+		void isolate() {
+			redirects.clear();
+
+			for ( cpArbiter* arb : arbiters ) {
+				redirect( &arb->body_a );
+				redirect( &arb->body_b );
+			}
+
+			for ( cpConstraint* constraint : constraints ) {
+				redirect( &constraint->a );
+				redirect( &constraint->b );
+			}
+
+			std::sort( redirects.begin(), redirects.end(),
+					   []( const Redirect& a, const Redirect& b ) {
+						   return std::less<cpBody*>()( a.body, b.body );
+					   } );
+
+			// Reserved so the copies don't move while they are referenced
+			copies.clear();
+			copies.reserve( redirects.size() );
+
+			for ( size_t i = 0; i < redirects.size(); i++ ) {
+				if ( i == 0 || redirects[i].body != redirects[i - 1].body )
+					copies.push_back( *redirects[i].body );
+
+				*redirects[i].slot = &copies.back();
+			}
+		}
+
+		void restore() {
+			for ( Redirect& redirect : redirects )
+				*redirect.slot = redirect.body;
+		}
+	};
+
+	std::vector<cpShape*> shapes;
+	std::vector<Pair> pairs;
+	std::vector<cpContact> contacts;
+	std::vector<int> counts;
+	std::unordered_map<cpBody*, int> nodes;
+	std::vector<int> parents;
+	std::vector<int> islandOf;
+	std::vector<Island> islands;
+	size_t islandCount{ 0 };
+
+	static void collectShape( cpShape* shape, ParallelStep* step ) {
+		step->shapes.push_back( shape );
+	}
+
+	static void collectPair( cpShape* a, cpShape* b, ParallelStep* step ) {
+		step->pairs.push_back( { a, b } );
+	}
+
+	int find( int node ) {
+		while ( parents[node] != node ) {
+			parents[node] = parents[parents[node]];
+			node = parents[node];
+		}
+		return node;
+	}
+
+	/** @return If the body is of infinite mass, the impulses don't move it */
+	static bool isShared( cpBody* body ) { return body->m_inv == 0.0f && body->i_inv == 0.0f; }
+
+	/** @return The union-find node of the body, -1 for the bodies that the impulses don't move */
+	int node( cpBody* body ) {
+		if ( isShared( body ) )
+			return -1;
+
+		auto it = nodes.find( body );
+
+		if ( it != nodes.end() )
+			return it->second;
+
+		int id = parents.size();
+		nodes[body] = id;
+		parents.push_back( id );
+		return id;
+	}
+
+	void join( cpBody* a, cpBody* b ) {
+		int na = node( a );
+		int nb = node( b );
+
+		if ( na >= 0 && nb >= 0 ) {
+			na = find( na );
+			nb = find( nb );
+
+			// The lowest node is the root, so the islands don't depend on the join order
+			if ( na != nb )
+				parents[eemax( na, nb )] = eemin( na, nb );
+		}
+	}
+
+	Island& islandFor( cpBody* a, cpBody* b ) {
+		int root = node( a );
+
+		if ( root < 0 )
+			root = node( b );
+
+		if ( root >= 0 ) {
+			root = find( root );
+
+			if ( islandOf[root] < 0 )
+				islandOf[root] = newIsland();
+
+			return islands[islandOf[root]];
+		}
+
+		// Joins only bodies of infinite mass
+		return islands[newIsland()];
+	}
+
+	int newIsland() {
+		if ( islandCount == islands.size() )
+			islands.emplace_back();
+
+		islands[islandCount].arbiters.clear();
+		islands[islandCount].constraints.clear();
+		return islandCount++;
+	}
+};
+
 Space* Space::New() {
 	return eeNew( Space, () );
 }
@@ -57,7 +210,232 @@ void* Space::getData() const {
 }
 
 void Space::step( const cpFloat& dt ) {
-	cpSpaceStep( mSpace, dt );
+	if ( mThreadPool )
+		stepParallel( dt );
+	else
+		cpSpaceStep( mSpace, dt );
+}
+
+void Space::setThreadPool( std::shared_ptr<ThreadPool> pool ) {
+	mThreadPool = pool;
+
+	if ( mThreadPool && !mParallelStep )
+		mParallelStep = std::make_unique<ParallelStep>();
+}
+
+const std::shared_ptr<ThreadPool>& Space::getThreadPool() const {
+	return mThreadPool;
+}
+
+/** The same stages than cpSpaceStep, with the work that doesn't call the collision callbacks
+ * split across the thread pool */
+void Space::stepParallel( const cpFloat& dt ) {
+	if ( dt == 0.0f )
+		return;
+
+	cpSpace* space = mSpace;
+	ParallelStep& step = *mParallelStep;
+	ThreadPool& pool = *mThreadPool;
+
+	space->stamp++;
+
+	cpFloat prev_dt = space->curr_dt;
+	space->curr_dt = dt;
+
+	cpArray* bodies = space->bodies;
+	cpArray* constraints = space->constraints;
+	cpArray* arbiters = space->arbiters;
+
+	// Reset and empty the arbiter lists.
+	for ( int i = 0; i < arbiters->num; i++ ) {
+		cpArbiter* arb = (cpArbiter*)arbiters->arr[i];
+		arb->state = cpArbiterStateNormal;
+
+		// If both bodies are awake, unthread the arbiter from the contact graph.
+		if ( !cpBodyIsSleeping( arb->body_a ) && !cpBodyIsSleeping( arb->body_b ) )
+			cpArbiterUnthread( arb );
+	}
+
+	arbiters->num = 0;
+
+	cpSpaceLock( space );
+	{
+		// Integrate positions
+		pool.parallelFor( 0, bodies->num, 256, [bodies, dt]( size_t begin, size_t end ) {
+			for ( size_t i = begin; i < end; i++ ) {
+				cpBody* body = (cpBody*)bodies->arr[i];
+				body->position_func( body, dt );
+			}
+		} );
+
+		// Update the shapes and find the broadphase pairs
+		step.shapes.clear();
+		cpSpatialIndexEach( space->activeShapes,
+							(cpSpatialIndexIteratorFunc)ParallelStep::collectShape, &step );
+
+		pool.parallelFor( 0, step.shapes.size(), 256, [&step]( size_t begin, size_t end ) {
+			for ( size_t i = begin; i < end; i++ )
+				cpShapeUpdateFunc( step.shapes[i], NULL );
+		} );
+
+		step.pairs.clear();
+		cpSpatialIndexReindexQuery( space->activeShapes,
+									(cpSpatialIndexQueryFunc)ParallelStep::collectPair, &step );
+
+		// Narrow-phase collision detection of the pairs in batches
+		step.contacts.resize( step.pairs.size() * CP_MAX_CONTACTS_PER_ARBITER );
+		step.counts.resize( step.pairs.size() );
+
+		pool.parallelFor( 0, step.pairs.size(), 128, [&step, space]( size_t begin, size_t end ) {
+			for ( size_t i = begin; i < end; i++ ) {
+				ParallelStep::Pair& pair = step.pairs[i];
+
+				cpContact* contacts = &step.contacts[i * CP_MAX_CONTACTS_PER_ARBITER];
+
+				step.counts[i] = cpSpaceCollisionPair( space, &pair.a, &pair.b )
+									 ? cpCollideShapes( pair.a, pair.b, contacts )
+									 : 0;
+			}
+		} );
+
+		// The arbiters are updated, and the collision callbacks called, in the broadphase order
+		cpSpacePushFreshContactBuffer( space );
+
+		for ( size_t i = 0; i < step.pairs.size(); i++ ) {
+			int numContacts = step.counts[i];
+
+			if ( !numContacts )
+				continue;
+
+			cpContact* contacts = cpContactBufferGetArray( space );
+			memcpy( contacts, &step.contacts[i * CP_MAX_CONTACTS_PER_ARBITER],
+					sizeof( cpContact ) * numContacts );
+			cpSpacePushContacts( space, numContacts );
+			cpSpaceCollideContacts( space, step.pairs[i].a, step.pairs[i].b, contacts,
+									numContacts );
+		}
+	}
+	cpSpaceUnlock( space, cpFalse );
+
+	// Rebuild the contact graph (and detect sleeping components if sleeping is enabled)
+	cpSpaceProcessComponents( space, dt );
+
+	cpSpaceLock( space );
+	{
+		// Clear out old cached arbiters and call separate callbacks
+		cpHashSetFilter( space->cachedArbiters, (cpHashSetFilterFunc)cpSpaceArbiterSetFilter,
+						 space );
+
+		// Prestep the arbiters and constraints.
+		cpFloat slop = space->collisionSlop;
+		cpFloat biasCoef = 1.0f - cpfpow( space->collisionBias, dt );
+
+		pool.parallelFor( 0, arbiters->num, 256,
+						  [arbiters, dt, slop, biasCoef]( size_t begin, size_t end ) {
+							  for ( size_t i = begin; i < end; i++ )
+								  cpArbiterPreStep( (cpArbiter*)arbiters->arr[i], dt, slop,
+													biasCoef );
+						  } );
+
+		for ( int i = 0; i < constraints->num; i++ ) {
+			cpConstraint* constraint = (cpConstraint*)constraints->arr[i];
+
+			cpConstraintPreSolveFunc preSolve = constraint->preSolve;
+			if ( preSolve )
+				preSolve( constraint, space );
+
+			constraint->klass->preStep( constraint, dt );
+		}
+
+		// Integrate velocities.
+		cpFloat damping = cpfpow( space->damping, dt );
+		cpVect gravity = space->gravity;
+
+		pool.parallelFor( 0, bodies->num, 256,
+						  [bodies, gravity, damping, dt]( size_t begin, size_t end ) {
+							  for ( size_t i = begin; i < end; i++ ) {
+								  cpBody* body = (cpBody*)bodies->arr[i];
+								  body->velocity_func( body, gravity, damping, dt );
+							  }
+						  } );
+
+		// Split the arbiters and constraints in islands of bodies connected by them. The islands
+		// keep the order of the space arrays, so solving every island in order gives the same
+		// results than solving the arrays. The bodies of infinite mass can be shared between
+		// islands, so every island is solved against its own copies of them.
+		step.nodes.clear();
+		step.parents.clear();
+
+		for ( int i = 0; i < arbiters->num; i++ ) {
+			cpArbiter* arb = (cpArbiter*)arbiters->arr[i];
+			step.join( arb->body_a, arb->body_b );
+		}
+
+		for ( int i = 0; i < constraints->num; i++ ) {
+			cpConstraint* constraint = (cpConstraint*)constraints->arr[i];
+			step.join( constraint->a, constraint->b );
+		}
+
+		step.islandOf.assign( step.parents.size(), -1 );
+		step.islandCount = 0;
+
+		for ( int i = 0; i < arbiters->num; i++ ) {
+			cpArbiter* arb = (cpArbiter*)arbiters->arr[i];
+			step.islandFor( arb->body_a, arb->body_b ).arbiters.push_back( arb );
+		}
+
+		for ( int i = 0; i < constraints->num; i++ ) {
+			cpConstraint* constraint = (cpConstraint*)constraints->arr[i];
+			step.islandFor( constraint->a, constraint->b ).constraints.push_back( constraint );
+		}
+
+		// Apply cached impulses and run the impulse solver, island by island.
+		cpFloat dt_coef = ( prev_dt == 0.0f ? 0.0f : dt / prev_dt );
+		int iterations = space->iterations;
+
+		pool.parallelFor(
+			0, step.islandCount, 1, [&step, dt, dt_coef, iterations]( size_t begin, size_t end ) {
+				for ( size_t i = begin; i < end; i++ ) {
+					ParallelStep::Island& island = step.islands[i];
+
+					island.isolate();
+
+					for ( cpArbiter* arb : island.arbiters )
+						cpArbiterApplyCachedImpulse( arb, dt_coef );
+
+					for ( cpConstraint* constraint : island.constraints )
+						constraint->klass->applyCachedImpulse( constraint, dt_coef );
+
+					for ( int it = 0; it < iterations; it++ ) {
+						for ( cpArbiter* arb : island.arbiters )
+							cpArbiterApplyImpulse( arb );
+
+						for ( cpConstraint* constraint : island.constraints )
+							constraint->klass->applyImpulse( constraint, dt );
+					}
+
+					island.restore();
+				}
+			} );
+
+		// Run the constraint post-solve callbacks
+		for ( int i = 0; i < constraints->num; i++ ) {
+			cpConstraint* constraint = (cpConstraint*)constraints->arr[i];
+
+			cpConstraintPostSolveFunc postSolve = constraint->postSolve;
+			if ( postSolve )
+				postSolve( constraint, space );
+		}
+
+		// run the post-solve callbacks
+		for ( int i = 0; i < arbiters->num; i++ ) {
+			cpArbiter* arb = (cpArbiter*)arbiters->arr[i];
+
+			cpCollisionHandler* handler = arb->handler;
+			handler->postSolve( arb, space, handler->data );
+		}
+	}
+	cpSpaceUnlock( space, cpTrue );
 }
 
 void Space::update() {
@@ -608,6 +986,269 @@ void Space::pointQuery( cVect point, cpLayers layers, cpGroup group, PointQueryF
 					   reinterpret_cast<void*>( &tPointQuery ) );
 }
 
+/** The shape filter of the space queries */
+struct BatchQuery {
+	cpLayers layers;
+	cpGroup group;
+
+	bool accepts( cpShape* shape ) const {
+		return !( shape->group && group == shape->group ) && ( layers & shape->layers );
+	}
+};
+
+struct BatchBBQuery : BatchQuery {
+	cpBB bb;
+	std::vector<Shape*>* results;
+
+	static void query( BatchBBQuery* query, cpShape* shape, void* ) {
+		if ( query->accepts( shape ) && cpBBIntersects( query->bb, shape->bb ) )
+			query->results->push_back( reinterpret_cast<Shape*>( shape->data ) );
+	}
+};
+
+struct BatchPointQuery : BatchQuery {
+	cpVect point;
+	std::vector<Shape*>* results;
+
+	static void query( BatchPointQuery* query, cpShape* shape, void* ) {
+		if ( query->accepts( shape ) && cpShapePointQuery( shape, query->point ) )
+			query->results->push_back( reinterpret_cast<Shape*>( shape->data ) );
+	}
+};
+
+struct BatchSegmentQuery : BatchQuery {
+	cpVect start;
+	cpVect end;
+	std::vector<Space::SegmentHit>* results;
+
+	static cpFloat query( BatchSegmentQuery* query, cpShape* shape, void* ) {
+		cpSegmentQueryInfo info;
+
+		if ( query->accepts( shape ) &&
+			 cpShapeSegmentQuery( shape, query->start, query->end, &info ) ) {
+			query->results->push_back(
+				{ reinterpret_cast<Shape*>( shape->data ), info.t, tovect( info.n ) } );
+		}
+
+		return 1.0f;
+	}
+
+	static cpFloat queryFirst( BatchSegmentQuery* query, cpShape* shape,
+							   cpSegmentQueryInfo* out ) {
+		cpSegmentQueryInfo info;
+
+		if ( query->accepts( shape ) && !shape->sensor &&
+			 cpShapeSegmentQuery( shape, query->start, query->end, &info ) && info.t < out->t )
+			*out = info;
+
+		return out->t;
+	}
+};
+
+//! The queries run by every task of a batched query
+static constexpr size_t QueryBatchGrain = 64;
+
+/** Sorts the queries by the Morton code of their position, so the consecutive queries traverse
+ * the same branches of the tree while they're still in the cache */
+template <typename PositionFunc>
+static void sortQueries( const size_t& count, PositionFunc position, std::vector<Uint32>& order ) {
+	order.resize( count );
+
+	for ( size_t i = 0; i < count; i++ )
+		order[i] = i;
+
+	if ( count <= QueryBatchGrain )
+		return;
+
+	cpBB bounds = cpBBNewForCircle( position( 0 ), 0.0f );
+
+	for ( size_t i = 1; i < count; i++ )
+		bounds = cpBBExpand( bounds, position( i ) );
+
+	std::vector<Uint32> codes( count );
+	cpFloat scaleX = 65535.0f / eemax( bounds.r - bounds.l, (cpFloat)1.0f );
+	cpFloat scaleY = 65535.0f / eemax( bounds.t - bounds.b, (cpFloat)1.0f );
+
+	for ( size_t i = 0; i < count; i++ ) {
+		cpVect pos = position( i );
+		Uint32 x = ( pos.x - bounds.l ) * scaleX;
+		Uint32 y = ( pos.y - bounds.b ) * scaleY;
+		Uint32 code = 0;
+
+		for ( Uint32 bit = 0; bit < 16; bit++ )
+			code |= ( ( x >> bit ) & 1 ) << ( bit * 2 ) | ( ( y >> bit ) & 1 ) << ( bit * 2 + 1 );
+
+		codes[i] = code;
+	}
+
+	std::sort( order.begin(), order.end(),
+			   [&codes]( Uint32 a, Uint32 b ) { return codes[a] < codes[b]; } );
+}
+
+template <typename T, typename QueryFunc>
+void Space::runQueryBatch( const size_t& count, BatchResults<T>& out, QueryFunc query ) {
+	size_t batches = ( count + QueryBatchGrain - 1 ) / QueryBatchGrain;
+	const std::vector<Uint32>& order = out.mOrder;
+
+	out.offsets.resize( count + 1 );
+	out.offsets[0] = 0;
+
+	if ( out.mBatches.size() < batches )
+		out.mBatches.resize( batches );
+
+	auto runBatches = [&out, &order, &query, count]( size_t first, size_t last ) {
+		for ( size_t b = first; b < last; b++ ) {
+			std::vector<T>& results = out.mBatches[b];
+			size_t end = eemin( count, ( b + 1 ) * QueryBatchGrain );
+
+			results.clear();
+
+			// Every query stores its count, the offsets are accumulated later
+			for ( size_t i = b * QueryBatchGrain; i < end; i++ ) {
+				size_t prev = results.size();
+				query( order[i], results );
+				out.offsets[order[i] + 1] = results.size() - prev;
+			}
+		}
+	};
+
+	// The spatial hash index writes in its cells while it's queried, only the tree is read-only
+	if ( mThreadPool && !mSpatialHash && batches > 1 )
+		mThreadPool->parallelFor( 0, batches, 1, runBatches );
+	else
+		runBatches( 0, batches );
+
+	for ( size_t i = 0; i < count; i++ )
+		out.offsets[i + 1] += out.offsets[i];
+
+	out.results.resize( out.offsets[count] );
+
+	for ( size_t b = 0; b < batches; b++ ) {
+		auto it = out.mBatches[b].begin();
+		size_t end = eemin( count, ( b + 1 ) * QueryBatchGrain );
+
+		for ( size_t i = b * QueryBatchGrain; i < end; i++ ) {
+			Uint32 query = order[i];
+			Uint32 queryCount = out.offsets[query + 1] - out.offsets[query];
+			std::copy( it, it + queryCount, out.results.begin() + out.offsets[query] );
+			it += queryCount;
+		}
+	}
+}
+
+void Space::bbQueryBatch( const cBB* bbs, const size_t& count, cpLayers layers, cpGroup group,
+						  ShapeBatchResults& out ) {
+	cpSpace* space = mSpace;
+
+	sortQueries(
+		count,
+		[bbs]( size_t i ) {
+			cpBB bb = tocpbb( bbs[i] );
+			return cpv( ( bb.l + bb.r ) * 0.5f, ( bb.b + bb.t ) * 0.5f );
+		},
+		out.mOrder );
+
+	runQueryBatch( count, out, [=]( size_t i, std::vector<Shape*>& results ) {
+		BatchBBQuery query;
+		query.layers = layers;
+		query.group = group;
+		query.bb = tocpbb( bbs[i] );
+		query.results = &results;
+
+		cpSpatialIndexQuery( space->activeShapes, &query, query.bb,
+							 (cpSpatialIndexQueryFunc)BatchBBQuery::query, NULL );
+		cpSpatialIndexQuery( space->staticShapes, &query, query.bb,
+							 (cpSpatialIndexQueryFunc)BatchBBQuery::query, NULL );
+	} );
+}
+
+void Space::segmentQueryBatch( const QuerySegment* segments, const size_t& count,
+							   cpLayers layers, cpGroup group, SegmentBatchResults& out ) {
+	cpSpace* space = mSpace;
+
+	sortQueries(
+		count, [segments]( size_t i ) { return tocpv( segments[i].start ); }, out.mOrder );
+
+	runQueryBatch( count, out, [=]( size_t i, std::vector<SegmentHit>& results ) {
+		BatchSegmentQuery query;
+		query.layers = layers;
+		query.group = group;
+		query.start = tocpv( segments[i].start );
+		query.end = tocpv( segments[i].end );
+		query.results = &results;
+
+		cpSpatialIndexSegmentQuery( space->staticShapes, &query, query.start, query.end, 1.0f,
+									(cpSpatialIndexSegmentQueryFunc)BatchSegmentQuery::query,
+									NULL );
+		cpSpatialIndexSegmentQuery( space->activeShapes, &query, query.start, query.end, 1.0f,
+									(cpSpatialIndexSegmentQueryFunc)BatchSegmentQuery::query,
+									NULL );
+	} );
+}
+
+void Space::segmentQueryFirstBatch( const QuerySegment* segments, const size_t& count,
+									cpLayers layers, cpGroup group,
+									std::vector<SegmentHit>& out ) {
+	cpSpace* space = mSpace;
+	std::vector<Uint32> order;
+
+	sortQueries(
+		count, [segments]( size_t i ) { return tocpv( segments[i].start ); }, order );
+
+	out.resize( count );
+
+	auto runQueries = [=, &order, &out]( size_t first, size_t last ) {
+		for ( size_t j = first; j < last; j++ ) {
+			size_t i = order[j];
+			BatchSegmentQuery query;
+			query.layers = layers;
+			query.group = group;
+			query.start = tocpv( segments[i].start );
+			query.end = tocpv( segments[i].end );
+
+			cpSegmentQueryInfo info = { NULL, 1.0f, cpvzero };
+
+			cpSpatialIndexSegmentQuery(
+				space->staticShapes, &query, query.start, query.end, 1.0f,
+				(cpSpatialIndexSegmentQueryFunc)BatchSegmentQuery::queryFirst, &info );
+			cpSpatialIndexSegmentQuery(
+				space->activeShapes, &query, query.start, query.end, info.t,
+				(cpSpatialIndexSegmentQueryFunc)BatchSegmentQuery::queryFirst, &info );
+
+			out[i] = { NULL != info.shape ? reinterpret_cast<Shape*>( info.shape->data ) : NULL,
+					   info.t, tovect( info.n ) };
+		}
+	};
+
+	if ( mThreadPool && !mSpatialHash && count > QueryBatchGrain )
+		mThreadPool->parallelFor( 0, count, QueryBatchGrain, runQueries );
+	else
+		runQueries( 0, count );
+}
+
+void Space::pointQueryBatch( const cVect* points, const size_t& count, cpLayers layers,
+							 cpGroup group, ShapeBatchResults& out ) {
+	cpSpace* space = mSpace;
+
+	sortQueries(
+		count, [points]( size_t i ) { return tocpv( points[i] ); }, out.mOrder );
+
+	runQueryBatch( count, out, [=]( size_t i, std::vector<Shape*>& results ) {
+		BatchPointQuery query;
+		query.layers = layers;
+		query.group = group;
+		query.point = tocpv( points[i] );
+		query.results = &results;
+
+		cpBB bb = cpBBNewForCircle( query.point, 0.0f );
+
+		cpSpatialIndexQuery( space->activeShapes, &query, bb,
+							 (cpSpatialIndexQueryFunc)BatchPointQuery::query, NULL );
+		cpSpatialIndexQuery( space->staticShapes, &query, bb,
+							 (cpSpatialIndexQueryFunc)BatchPointQuery::query, NULL );
+	} );
+}
+
 void Space::reindexShape( Shape* shape ) {
 	cpSpaceReindexShape( mSpace, shape->getShape() );
 }
@@ -622,6 +1263,12 @@ void Space::reindexStatic() {
 
 void Space::useSpatialHash( cpFloat dim, int count ) {
 	cpSpaceUseSpatialHash( mSpace, dim, count );
+	mSpatialHash = true;
+}
+
+void Space::optimizeSpatialIndex() {
+	if ( !mSpatialHash )
+		cpBBTreeOptimize( mSpace->activeShapes );
 }
 
 static void SpaceBodyIteratorFunc( cpBody* body, void* data ) {
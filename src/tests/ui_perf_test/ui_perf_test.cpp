@@ -102,6 +102,91 @@ class TestModel : public Model {
 // It's just used to test whatever I need to test at any given moment.
 
 EE::Window::Window* win = NULL;
+Clock updateClock;
+Time updateTime;
+Time updateTimeAccum;
+Uint64 updateFrames = 0;
+
+// Hit-testing benchmark over a container with 10k childs, with and without spatial index.
+void overFindBenchmark( UISceneNode* uiSceneNode ) {
+	const size_t childCount = 10000;
+	const size_t queries = 100000;
+	const size_t columns = 100;
+	auto* container = UIWidget::New();
+	container->setParent( uiSceneNode->getRoot() );
+	container->setPixelsSize( uiSceneNode->getRoot()->getPixelsSize() );
+	Sizef cellSize( container->getPixelsSize().getWidth() / columns,
+					container->getPixelsSize().getHeight() / ( childCount / columns ) );
+	for ( size_t i = 0; i < childCount; i++ ) {
+		auto* child = UIWidget::New();
+		child->setParent( container );
+		child->setPixelsSize( cellSize );
+		child->setPixelsPosition( { ( i % columns ) * cellSize.getWidth(),
+									( i / columns ) * cellSize.getHeight() } );
+	}
+
+	std::vector<Vector2f> points;
+	points.reserve( queries );
+	for ( size_t i = 0; i < queries; i++ )
+		points.emplace_back( Math::randf( 0, container->getPixelsSize().getWidth() ),
+							 Math::randf( 0, container->getPixelsSize().getHeight() ) );
+
+	auto run = [&]() {
+		size_t found = 0;
+		Clock clock;
+		for ( const auto& point : points )
+			found += container->overFind( point ) != container ? 1 : 0;
+		return std::make_pair( clock.getElapsedTime(), found );
+	};
+
+	auto linear = run();
+	container->setSpatialIndexEnabled( true, eemax( cellSize.getWidth(), cellSize.getHeight() ) );
+	auto indexed = run();
+
+	Log::notice( "overFind %zu childs, %zu queries: linear %.2f ms (%zu hits), spatial index %.2f "
+				 "ms (%zu hits)",
+				 childCount, queries, linear.first.asMilliseconds(), linear.second,
+				 indexed.first.asMilliseconds(), indexed.second );
+
+	container->close();
+}
+
+// Layout loading benchmark of a ~1000 widgets layout, parsing the XML vs the compiled layout cache.
+void layoutLoadBenchmark( UISceneNode* uiSceneNode ) {
+	const size_t iterations = 20;
+	std::string layout( "<vbox layout_width='match_parent' layout_height='wrap_content'>" );
+	for ( size_t i = 0; i < 250; i++ ) {
+		layout += String::format( "<hbox id='row_%zu' layout_width='match_parent' "
+								  "layout_height='wrap_content' class='row'>",
+								  i );
+		layout += "<TextView text='Label' layout_width='wrap_content' "
+				  "layout_height='wrap_content' />";
+		layout += "<PushButton text='Button' layout_width='wrap_content' "
+				  "layout_height='wrap_content' />";
+		layout += "<CheckBox text='Check' layout_width='wrap_content' "
+				  "layout_height='wrap_content' />";
+		layout += "</hbox>";
+	}
+	layout += "</vbox>";
+
+	auto run = [&]() {
+		Clock clock;
+		for ( size_t i = 0; i < iterations; i++ )
+			uiSceneNode->loadLayoutFromString( layout )->close();
+		return clock.getElapsedTime();
+	};
+
+	bool cacheEnabled = uiSceneNode->isLayoutCacheEnabled();
+	uiSceneNode->setLayoutCacheEnabled( false );
+	auto parsed = run();
+	uiSceneNode->setLayoutCacheEnabled( true );
+	auto cached = run();
+	uiSceneNode->setLayoutCacheEnabled( cacheEnabled );
+	uiSceneNode->clearLayoutCache();
+
+	Log::notice( "loadLayout %zu times: xml %.2f ms, compiled %.2f ms", iterations,
+				 parsed.asMilliseconds(), cached.asMilliseconds() );
+}
 
 void mainLoop() {
 	win->getInput()->update();
@@ -112,6 +197,14 @@ void mainLoop() {
 
 	UISceneNode* uiSceneNode = SceneManager::instance()->getUISceneNode();
 
+	if ( win->getInput()->isKeyUp( KEY_F5 ) ) {
+		UIWidget* view = uiSceneNode->getRoot()->find<UIWidget>( "treeview" );
+		if ( view ) {
+			view->setRenderLayer( !view->isRenderLayer() );
+			uiSceneNode->setHighlightRenderLayers( view->isRenderLayer() );
+		}
+	}
+
 	if ( win->getInput()->isKeyUp( KEY_F6 ) ) {
 		uiSceneNode->setHighlightFocus( !uiSceneNode->getHighlightFocus() );
 		uiSceneNode->setHighlightOver( !uiSceneNode->getHighlightOver() );
@@ -129,8 +222,28 @@ void mainLoop() {
 		UIWidgetInspector::create( uiSceneNode );
 	}
 
-	// Update the UI scene.
+	if ( win->getInput()->isKeyUp( KEY_F10 ) )
+		overFindBenchmark( uiSceneNode );
+
+	if ( win->getInput()->isKeyUp( KEY_F12 ) )
+		layoutLoadBenchmark( uiSceneNode );
+
+	if ( win->getInput()->isKeyUp( KEY_F9 ) ) {
+		uiSceneNode->setUpdateAllChilds( !uiSceneNode->getUpdateAllChilds() );
+		updateTimeAccum = Time::Zero;
+		updateFrames = 0;
+	}
+
+	// Update the UI scene, measuring the CPU time spent per frame (mostly idle time, since
+	// nothing changes unless the user interacts with the UI).
+	updateClock.restart();
 	SceneManager::instance()->update();
+	updateTimeAccum += updateClock.getElapsedTime();
+	if ( ++updateFrames == 60 ) {
+		updateTime = updateTimeAccum / 60.0;
+		updateTimeAccum = Time::Zero;
+		updateFrames = 0;
+	}
 
 	// Check if the UI has been invalidated ( needs redraw ).
 	if ( true || SceneManager::instance()->getUISceneNode()->invalidated() ) {
@@ -140,7 +253,13 @@ void mainLoop() {
 		SceneManager::instance()->draw();
 
 		Text::draw(
-			String( String::format( "FPS: %d", win->getFPS() ) ), { 16, 16 },
+			String( String::format(
+				"FPS: %d - Update: %.3f ms (%s) - Render layers: %u hits, %u misses, %.2f MiB",
+				win->getFPS(), updateTime.asMilliseconds(),
+				uiSceneNode->getUpdateAllChilds() ? "all childs" : "on demand",
+				uiSceneNode->getRenderLayersHits(), uiSceneNode->getRenderLayersMisses(),
+				uiSceneNode->getRenderLayersMemoryUsage() / ( 1024.f * 1024.f ) ) ),
+			{ 16, 16 },
 			SceneManager::instance()->getUISceneNode()->getUIThemeManager()->getDefaultFont(), 12.f,
 			Color::White, 0, 1.f, Color::Black );
 
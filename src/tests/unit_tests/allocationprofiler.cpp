@@ -0,0 +1,183 @@
+#include "utest.h"
+#include <algorithm>
+#include <cstring>
+#include <eepp/core/allocationprofiler.hpp>
+#include <eepp/core/memorymanager.hpp>
+#include <eepp/core/string.hpp>
+#include <eepp/system/clock.hpp>
+#include <thread>
+
+using namespace EE;
+using namespace EE::System;
+
+struct Payload {
+	Uint64 data[4];
+};
+
+// Keeps the compiler from removing the allocations
+static Payload* volatile sPayload = nullptr;
+
+static void allocate( int count ) {
+	for ( int i = 0; i < count; i++ ) {
+		sPayload = eeNew( Payload, () );
+		eeDelete( sPayload );
+	}
+}
+
+static const AllocationProfiler::Site* findSite( const std::vector<AllocationProfiler::Site>& sites,
+												 const char* zone ) {
+	for ( const auto& site : sites ) {
+		if ( site.zones.size() == 1 && strcmp( site.zones[0], zone ) == 0 )
+			return &site;
+	}
+	return nullptr;
+}
+
+UTEST( AllocationProfiler, countsSitesAndFrames ) {
+	AllocationProfiler::setSampleInterval( 1 );
+	AllocationProfiler::setEnabled( true );
+	AllocationProfiler::reset();
+
+	{
+		AllocationProfiler::Zone zone( "countsSitesAndFrames" );
+		allocate( 1000 );
+	}
+	AllocationProfiler::endFrame();
+	allocate( 10 );
+	AllocationProfiler::endFrame();
+	AllocationProfiler::setEnabled( false );
+	allocate( 10 );
+
+	auto frames = AllocationProfiler::getFrames();
+	ASSERT_EQ( frames.size(), (size_t)2 );
+	EXPECT_EQ( frames[0].allocations, (Uint64)1000 );
+	EXPECT_EQ( frames[0].bytes, (Uint64)( 1000 * sizeof( Payload ) ) );
+	EXPECT_EQ( frames[1].allocations, (Uint64)10 );
+	EXPECT_EQ( AllocationProfiler::getTotal().allocations, (Uint64)1010 );
+
+	auto sites = AllocationProfiler::getSites();
+	const AllocationProfiler::Site* site = findSite( sites, "countsSitesAndFrames" );
+	ASSERT_TRUE( site != nullptr );
+	EXPECT_EQ( site->allocations, (Uint64)1000 );
+	EXPECT_EQ( site->bytes, (Uint64)( 1000 * sizeof( Payload ) ) );
+	EXPECT_EQ( AllocationProfiler::getBytesPerSubsystem()["unit_tests"],
+			   (Uint64)( 1010 * sizeof( Payload ) ) );
+
+	std::string folded( AllocationProfiler::getFolded( AllocationProfiler::Weight::Allocations ) );
+	std::string line( "countsSitesAndFrames;unit_tests;allocationprofiler.cpp:" +
+					  String::toString( site->line ) + " 1000\n" );
+	EXPECT_NE( folded.find( line ), std::string::npos );
+
+	AllocationProfiler::reset();
+	EXPECT_TRUE( AllocationProfiler::getSites().empty() );
+	EXPECT_EQ( AllocationProfiler::getTotal().allocations, (Uint64)0 );
+	AllocationProfiler::setSampleInterval( 64 );
+}
+
+UTEST( AllocationProfiler, samplesThreads ) {
+	AllocationProfiler::setSampleInterval( 16 );
+	AllocationProfiler::setEnabled( true );
+	AllocationProfiler::reset();
+
+	std::vector<std::thread> threads;
+	for ( int i = 0; i < 4; i++ ) {
+		threads.emplace_back( [] {
+			AllocationProfiler::Zone zone( "samplesThreads" );
+			allocate( 100000 );
+		} );
+	}
+	for ( auto& thread : threads )
+		thread.join();
+
+	AllocationProfiler::setEnabled( false );
+	EXPECT_EQ( AllocationProfiler::getTotal().allocations, (Uint64)400000 );
+
+	// The sampled estimate is close to the real count
+	auto sites = AllocationProfiler::getSites();
+	const AllocationProfiler::Site* site = findSite( sites, "samplesThreads" );
+	ASSERT_TRUE( site != nullptr );
+	EXPECT_GT( site->allocations, (Uint64)380000 );
+	EXPECT_LT( site->allocations, (Uint64)420000 );
+
+	AllocationProfiler::reset();
+	AllocationProfiler::setSampleInterval( 64 );
+}
+
+UTEST( AllocationProfiler, countsReallocationsApart ) {
+	AllocationProfiler::setSampleInterval( 1 );
+	AllocationProfiler::setEnabled( true );
+	AllocationProfiler::reset();
+
+	{
+		AllocationProfiler::Zone zone( "countsReallocationsApart" );
+		void* data = eeMalloc( 16 );
+		for ( size_t size = 32; size <= 1024 * 1024; size *= 2 )
+			data = eeRealloc( data, size );
+		eeFree( data );
+	}
+	AllocationProfiler::endFrame();
+	AllocationProfiler::setEnabled( false );
+
+	// The reallocations don't add allocations nor bytes
+	auto total = AllocationProfiler::getTotal();
+	EXPECT_EQ( total.allocations, (Uint64)1 );
+	EXPECT_EQ( total.bytes, (Uint64)16 );
+	EXPECT_EQ( total.reallocations, (Uint64)16 );
+	auto frames = AllocationProfiler::getFrames();
+	ASSERT_EQ( frames.size(), (size_t)1 );
+	EXPECT_EQ( frames[0].reallocations, (Uint64)16 );
+
+	Uint64 reallocations = 0;
+	for ( const auto& site : AllocationProfiler::getSites() ) {
+		if ( site.reallocations ) {
+			EXPECT_EQ( site.allocations, (Uint64)0 );
+			EXPECT_EQ( site.bytes, (Uint64)0 );
+			reallocations += site.reallocations;
+		}
+	}
+	EXPECT_EQ( reallocations, (Uint64)16 );
+
+	// Only the allocation has weight
+	std::string folded( AllocationProfiler::getFolded() );
+	EXPECT_EQ( std::count( folded.begin(), folded.end(), '\n' ), 1 );
+
+	AllocationProfiler::reset();
+	AllocationProfiler::setSampleInterval( 64 );
+}
+
+UTEST( AllocationProfiler, subsystems ) {
+	EXPECT_TRUE( AllocationProfiler::getSubsystem( "/src/eepp/ui/uiwidget.cpp" ) == "ui" );
+	EXPECT_TRUE( AllocationProfiler::getSubsystem( "C:\\eepp\\src\\eepp\\graphics\\text.cpp" ) ==
+				 "graphics" );
+	EXPECT_TRUE( AllocationProfiler::getSubsystem( "../src/tools/ecode/ecode.cpp" ) == "ecode" );
+	EXPECT_TRUE( AllocationProfiler::getSubsystem(
+					 "/home/eepp/src/modules/physics/src/eepp/physics/space.cpp" ) == "physics" );
+	EXPECT_TRUE( AllocationProfiler::getSubsystem( "main.cpp" ) == "unknown" );
+}
+
+UTEST( AllocationProfiler, benchmarkOverhead ) {
+	const int count = 2000000;
+	auto run = [count] {
+		Clock clock;
+		allocate( count );
+		return clock.getElapsedTime();
+	};
+
+	Clock clock;
+	for ( int i = 0; i < count; i++ ) {
+		sPayload = new Payload();
+		delete sPayload;
+	}
+	Time plainTime = clock.getElapsedTime();
+
+	Time disabledTime = run();
+	AllocationProfiler::setEnabled( true );
+	Time enabledTime = run();
+	AllocationProfiler::setEnabled( false );
+	AllocationProfiler::reset();
+
+	printf( "AllocationProfiler %d eeNew/eeDelete: new/delete %s, disabled %s, enabled "
+			"( 1 of %u sampled ) %s\n",
+			count, plainTime.toString().c_str(), disabledTime.toString().c_str(),
+			AllocationProfiler::getSampleInterval(), enabledTime.toString().c_str() );
+}
@@ -0,0 +1,153 @@
+#include "../../tools/ecode/plugins/git/gitchangedetector.hpp"
+#include "utest.h"
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/sys.hpp>
+
+using namespace ecode;
+
+static const std::string PROJECT = "/home/user/project/";
+static const std::string GIT_FOLDER = PROJECT + ".git/";
+
+static Git::DiffFile diffFile( const std::string& file, int inserts, int deletes ) {
+	return { file, inserts, deletes,
+			 { Git::GitStatus::NotSet, Git::GitStatusType::Changed, Git::GitStatusChar::Modified } };
+}
+
+UTEST( GitChangeDetector, classifiesEvents ) {
+	GitChangeDetector detector;
+	detector.reset( PROJECT, GIT_FOLDER );
+
+	// A reset refreshes everything
+	auto changes = detector.takeChanges();
+	EXPECT_TRUE( changes.full );
+	EXPECT_TRUE( changes.refs );
+	EXPECT_TRUE( detector.takeChanges().empty() );
+
+	EXPECT_FALSE( detector.onFileEvent( GIT_FOLDER + "index.lock" ) );
+	EXPECT_FALSE( detector.onFileEvent( GIT_FOLDER + "objects/ab/cdef" ) );
+	EXPECT_FALSE( detector.onFileEvent( GIT_FOLDER + "FETCH_HEAD.lock" ) );
+	EXPECT_FALSE( detector.onFileEvent( "/home/user/other/file.cpp" ) );
+	EXPECT_FALSE( detector.onFileEvent( PROJECT ) );
+	EXPECT_TRUE( detector.takeChanges().empty() );
+
+	// Remote branches only refresh the branches
+	EXPECT_TRUE( detector.onFileEvent( GIT_FOLDER + "refs/remotes/origin/main" ) );
+	changes = detector.takeChanges();
+	EXPECT_TRUE( changes.refs );
+	EXPECT_FALSE( changes.full );
+
+	EXPECT_TRUE( detector.onFileEvent( GIT_FOLDER + "HEAD" ) );
+	changes = detector.takeChanges();
+	EXPECT_TRUE( changes.refs );
+	EXPECT_TRUE( changes.full );
+
+	EXPECT_TRUE( detector.onFileEvent( GIT_FOLDER + "modules/sub/index" ) );
+	changes = detector.takeChanges();
+	EXPECT_FALSE( changes.refs );
+	EXPECT_TRUE( changes.full );
+}
+
+UTEST( GitChangeDetector, coalescesPaths ) {
+	GitChangeDetector detector;
+	detector.reset( PROJECT, GIT_FOLDER );
+	detector.takeChanges();
+
+	// The events received until the debounced update are merged into a single refresh
+	EXPECT_TRUE( detector.onFileEvent( PROJECT + "src/b.cpp" ) );
+	EXPECT_TRUE( detector.onFileEvent( PROJECT + "src/a.cpp" ) );
+	EXPECT_TRUE( detector.onFileEvent( PROJECT + "src/b.cpp" ) );
+	EXPECT_TRUE( detector.onFileEvent( PROJECT + "README.md" ) );
+	auto changes = detector.takeChanges();
+	EXPECT_FALSE( changes.full );
+	EXPECT_FALSE( changes.refs );
+	ASSERT_EQ( changes.paths.size(), (size_t)3 );
+	EXPECT_TRUE( changes.paths[0] == "README.md" );
+	EXPECT_TRUE( changes.paths[1] == "src/a.cpp" );
+	EXPECT_TRUE( changes.paths[2] == "src/b.cpp" );
+	EXPECT_TRUE( detector.takeChanges().empty() );
+
+	// A pending full refresh already covers the paths
+	EXPECT_TRUE( detector.onFileEvent( PROJECT + "src/a.cpp" ) );
+	detector.invalidate();
+	EXPECT_TRUE( detector.onFileEvent( PROJECT + "src/c.cpp" ) );
+	changes = detector.takeChanges();
+	EXPECT_TRUE( changes.full );
+	EXPECT_TRUE( changes.paths.empty() );
+
+	// Too many paths fall back to a full refresh
+	for ( size_t i = 0; i <= GitChangeDetector::MAX_PATHSPECS; i++ )
+		detector.onFileEvent( PROJECT + "file" + std::to_string( i ) );
+	changes = detector.takeChanges();
+	EXPECT_TRUE( changes.full );
+	EXPECT_TRUE( changes.paths.empty() );
+}
+
+UTEST( GitChangeDetector, detectsUnreportedGitChanges ) {
+	std::string project( Sys::getTempPath() + "eepp-gitchangedetector/" );
+	std::string gitFolder( project + ".git/" );
+	FileSystem::makeDir( gitFolder + "refs/heads", true );
+	FileSystem::fileWrite( gitFolder + "HEAD", "ref: refs/heads/main\n" );
+	FileSystem::fileWrite( gitFolder + "index", "index" );
+	FileSystem::fileWrite( gitFolder + "refs/heads/main", "1" );
+
+	GitChangeDetector detector;
+	detector.reset( project, gitFolder );
+	detector.takeChanges();
+	detector.onFileEvent( project + "file.txt" );
+	EXPECT_FALSE( detector.takeChanges().full );
+
+	// The index changed without an event
+	FileSystem::fileWrite( gitFolder + "index", "index changed" );
+	auto changes = detector.takeChanges();
+	EXPECT_TRUE( changes.full );
+	EXPECT_TRUE( changes.refs );
+
+	// The current branch moved
+	FileSystem::fileWrite( gitFolder + "refs/heads/main", "12" );
+	EXPECT_TRUE( detector.takeChanges().full );
+	EXPECT_TRUE( detector.takeChanges().empty() );
+
+	FileSystem::fileRemove( gitFolder + "refs/heads/main" );
+	FileSystem::fileRemove( gitFolder + "index" );
+	FileSystem::fileRemove( gitFolder + "HEAD" );
+}
+
+UTEST( GitChangeDetector, isInPathspecs ) {
+	std::vector<std::string> paths{ "src/a.cpp", "docs", "build/" };
+	EXPECT_TRUE( GitChangeDetector::isInPathspecs( "src/a.cpp", paths ) );
+	EXPECT_FALSE( GitChangeDetector::isInPathspecs( "src/a.cpp.orig", paths ) );
+	EXPECT_TRUE( GitChangeDetector::isInPathspecs( "docs/index.md", paths ) );
+	EXPECT_FALSE( GitChangeDetector::isInPathspecs( "docs2/index.md", paths ) );
+	EXPECT_TRUE( GitChangeDetector::isInPathspecs( "build/out.o", paths ) );
+	EXPECT_FALSE( GitChangeDetector::isInPathspecs( "src/b.cpp", paths ) );
+	EXPECT_FALSE( GitChangeDetector::isInPathspecs( "src/a.cpp", {} ) );
+}
+
+UTEST( GitChangeDetector, mergeStatus ) {
+	// The status files are relative to the project path, like the detector paths
+	Git::Status status;
+	status.files["project"] = { diffFile( "a.cpp", 1, 1 ), diffFile( "docs/b.md", 2, 0 ),
+								diffFile( "docs/c.md", 3, 0 ), diffFile( "z.cpp", 0, 4 ) };
+	status.totalInserts = 6;
+	status.totalDeletions = 5;
+
+	// a.cpp was reverted, docs/c.md changed and new.cpp was created. z.cpp wasn't modified.
+	std::vector<std::string> paths{ "a.cpp", "docs", "new.cpp" };
+	Git::Status pathsStatus;
+	pathsStatus.files["project"] = { diffFile( "docs/c.md", 5, 1 ), diffFile( "new.cpp", 7, 0 ) };
+
+	GitChangeDetector::mergeStatus( status, std::move( pathsStatus ), paths );
+
+	ASSERT_EQ( status.files.size(), (size_t)1 );
+	const auto& files = status.files["project"];
+	ASSERT_EQ( files.size(), (size_t)3 );
+	EXPECT_TRUE( files[0] == diffFile( "docs/c.md", 5, 1 ) );
+	EXPECT_TRUE( files[1] == diffFile( "new.cpp", 7, 0 ) );
+	EXPECT_TRUE( files[2] == diffFile( "z.cpp", 0, 4 ) );
+	EXPECT_EQ( status.totalInserts, 12 );
+	EXPECT_EQ( status.totalDeletions, 5 );
+
+	// A repository without changes left is removed
+	GitChangeDetector::mergeStatus( status, {}, { "docs", "new.cpp", "z.cpp" } );
+	EXPECT_TRUE( status.empty() );
+}
@@ -0,0 +1,250 @@
+#include "utest.h"
+#include <atomic>
+#include <eepp/network/http.hpp>
+#include <eepp/network/socketselector.hpp>
+#include <eepp/network/tcplistener.hpp>
+#include <eepp/system/clock.hpp>
+#include <eepp/system/sys.hpp>
+#include <memory>
+
+using namespace EE::Network;
+using namespace EE::System;
+
+/** Minimal HTTP/1.1 server, it answers "ok" to every request and supports pipelining.
+ * "/drop" closes the connection without answering. */
+class LoopbackHttpServer {
+  public:
+	std::atomic<int> connections{ 0 };
+	std::atomic<int> requests{ 0 };
+
+	LoopbackHttpServer() : mThread( &LoopbackHttpServer::run, this ) {}
+
+	~LoopbackHttpServer() {
+		mRunning = false;
+		mThread.wait();
+	}
+
+	bool start() {
+		if ( mListener.listen( 0, IpAddress::LocalHost ) != Socket::Done )
+			return false;
+		mSelector.add( mListener );
+		mRunning = true;
+		mThread.launch();
+		return true;
+	}
+
+	unsigned short getPort() const { return mListener.getLocalPort(); }
+
+  protected:
+	struct Client {
+		std::unique_ptr<TcpSocket> socket;
+		std::string buffer;
+	};
+
+	TcpListener mListener;
+	SocketSelector mSelector;
+	std::vector<std::unique_ptr<Client>> mClients;
+	std::atomic<bool> mRunning{ false };
+	Thread mThread;
+
+	void run() {
+		while ( mRunning ) {
+			if ( !mSelector.wait( Milliseconds( 50 ) ) )
+				continue;
+
+			std::vector<Socket*> ready( mSelector.getReadySockets() );
+			for ( Socket* socket : ready ) {
+				if ( socket == &mListener ) {
+					auto client = std::make_unique<Client>();
+					client->socket = std::make_unique<TcpSocket>();
+					if ( mListener.accept( *client->socket ) == Socket::Done ) {
+						mSelector.add( *client->socket );
+						mClients.emplace_back( std::move( client ) );
+						connections++;
+					}
+					continue;
+				}
+
+				for ( size_t i = 0; i < mClients.size(); i++ ) {
+					if ( mClients[i]->socket.get() == socket && !serve( *mClients[i] ) ) {
+						mSelector.remove( *socket );
+						mClients.erase( mClients.begin() + i );
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	bool serve( Client& client ) {
+		char data[4096];
+		size_t received = 0;
+		if ( client.socket->receive( data, sizeof( data ), received ) != Socket::Done )
+			return false;
+		client.buffer.append( data, received );
+
+		std::string responses;
+		bool close = false;
+		size_t end;
+		while ( ( end = client.buffer.find( "\r\n\r\n" ) ) != std::string::npos ) {
+			std::string request( client.buffer.substr( 0, end ) );
+			client.buffer.erase( 0, end + 4 );
+			std::string path( request.substr( request.find( ' ' ) + 1 ) );
+			path = path.substr( 0, path.find( ' ' ) );
+			requests++;
+
+			if ( path == "/chunked" ) {
+				responses += "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+							 "1\r\no\r\n1\r\nk\r\n0\r\n\r\n";
+			} else if ( path == "/redirect" ) {
+				responses += "HTTP/1.1 302 Found\r\nLocation: /\r\nContent-Length: 5\r\n\r\nfound";
+			} else if ( path == "/drop" ) {
+				close = true;
+				break;
+			} else if ( path == "/close" ) {
+				responses += "HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nok";
+				close = true;
+				break;
+			} else if ( request.compare( 0, 5, "HEAD " ) == 0 ) {
+				responses += "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n";
+			} else {
+				responses += "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+			}
+		}
+
+		if ( !responses.empty() )
+			client.socket->send( responses.c_str(), responses.size() );
+		return !close;
+	}
+};
+
+UTEST( Http, keepAlive ) {
+	LoopbackHttpServer server;
+	ASSERT_TRUE( server.start() );
+	Http http( "127.0.0.1", server.getPort() );
+
+	Http::Response response = http.sendRequest( Http::Request( "/" ), Seconds( 5 ) );
+	EXPECT_EQ( response.getStatus(), Http::Response::Ok );
+	EXPECT_STREQ( response.getBody().c_str(), "ok" );
+
+	response = http.sendRequest( Http::Request( "/chunked" ), Seconds( 5 ) );
+	EXPECT_STREQ( response.getBody().c_str(), "ok" );
+
+	response = http.sendRequest( Http::Request( "/", Http::Request::Head ), Seconds( 5 ) );
+	EXPECT_EQ( response.getStatus(), Http::Response::Ok );
+	EXPECT_TRUE( response.getBody().empty() );
+	EXPECT_EQ( server.connections.load(), 1 );
+
+	// The redirection body is not read, so it needs a new connection
+	response = http.sendRequest( Http::Request( "/redirect" ), Seconds( 5 ) );
+	EXPECT_STREQ( response.getBody().c_str(), "ok" );
+	EXPECT_EQ( server.connections.load(), 2 );
+
+	// The response is delimited by the connection close
+	response = http.sendRequest( Http::Request( "/close" ), Seconds( 5 ) );
+	EXPECT_STREQ( response.getBody().c_str(), "ok" );
+	response = http.sendRequest( Http::Request( "/" ), Seconds( 5 ) );
+	EXPECT_STREQ( response.getBody().c_str(), "ok" );
+	EXPECT_EQ( server.connections.load(), 3 );
+
+	std::atomic<int> done{ 0 };
+	std::atomic<int> ok{ 0 };
+	const char* paths[] = { "/", "/chunked", "/redirect", "/close", "/" };
+	for ( const char* path : paths ) {
+		http.sendAsyncRequest(
+			[&]( const Http&, Http::Request&, Http::Response& response ) {
+				if ( response.getStatus() == Http::Response::Ok && response.getBody() == "ok" )
+					ok++;
+				done++;
+			},
+			Http::Request( path ), Seconds( 5 ) );
+	}
+
+	Clock clock;
+	while ( done < 5 && clock.getElapsedTime() < Seconds( 10 ) )
+		Sys::sleep( Milliseconds( 1 ) );
+	EXPECT_EQ( ok.load(), 5 );
+}
+
+static void waitFor( std::atomic<int>& done, int count ) {
+	Clock clock;
+	while ( done < count && clock.getElapsedTime() < Seconds( 10 ) )
+		Sys::sleep( Milliseconds( 1 ) );
+}
+
+UTEST( Http, retriesOnlyIdempotentRequests ) {
+	LoopbackHttpServer server;
+	ASSERT_TRUE( server.start() );
+	Http http( "127.0.0.1", server.getPort() );
+
+	// The server might have processed the request, a POST is not sent again
+	http.sendRequest( Http::Request( "/" ), Seconds( 5 ) );
+	int requests = server.requests;
+	Http::Response response =
+		http.sendRequest( Http::Request( "/drop", Http::Request::Post ), Seconds( 5 ) );
+	EXPECT_NE( response.getStatus(), Http::Response::Ok );
+	EXPECT_EQ( server.requests - requests, 1 );
+
+	// A GET through the reused connection is sent again once
+	http.sendRequest( Http::Request( "/" ), Seconds( 5 ) );
+	requests = server.requests;
+	response = http.sendRequest( Http::Request( "/drop" ), Seconds( 5 ) );
+	EXPECT_NE( response.getStatus(), Http::Response::Ok );
+	EXPECT_EQ( server.requests - requests, 2 );
+
+	std::atomic<int> done{ 0 };
+	auto cb = [&]( const Http&, Http::Request&, Http::Response& ) { done++; };
+	http.sendAsyncRequest( cb, Http::Request( "/" ), Seconds( 5 ) );
+	waitFor( done, 1 );
+	requests = server.requests;
+	http.sendAsyncRequest( cb, Http::Request( "/drop", Http::Request::Post ), Seconds( 5 ) );
+	waitFor( done, 2 );
+	EXPECT_EQ( server.requests - requests, 1 );
+
+	requests = server.requests;
+	http.sendAsyncRequest( cb, Http::Request( "/drop" ), Seconds( 5 ) );
+	waitFor( done, 3 );
+	EXPECT_EQ( server.requests - requests, 2 );
+}
+
+UTEST( Http, benchmark10kRequests ) {
+	LoopbackHttpServer server;
+	ASSERT_TRUE( server.start() );
+
+	// A new connection for every request, as the async requests did before the event loop
+	const int syncRequests = 1000;
+	Http closeHttp( "127.0.0.1", server.getPort() );
+	closeHttp.setIdleTimeout( Time::Zero );
+	Clock clock;
+	for ( int i = 0; i < syncRequests; i++ )
+		closeHttp.sendRequest( Http::Request( "/" ), Seconds( 5 ) );
+	Time closeTime = clock.getElapsedTimeAndReset();
+	EXPECT_EQ( server.connections.load(), syncRequests );
+
+	const int requests = 10000;
+	Http http( "127.0.0.1", server.getPort() );
+	http.setMaxConnections( 8 );
+	http.setPipeliningDepth( 8 );
+	std::atomic<int> done{ 0 };
+	std::atomic<int> ok{ 0 };
+	clock.restart();
+	for ( int i = 0; i < requests; i++ ) {
+		http.sendAsyncRequest(
+			[&]( const Http&, Http::Request&, Http::Response& response ) {
+				if ( response.getStatus() == Http::Response::Ok && response.getBody() == "ok" )
+					ok++;
+				done++;
+			},
+			Http::Request( "/" ), Seconds( 5 ) );
+	}
+
+	while ( done < requests && clock.getElapsedTime() < Seconds( 60 ) )
+		Sys::sleep( Milliseconds( 1 ) );
+	Time asyncTime = clock.getElapsedTime();
+
+	EXPECT_EQ( ok.load(), requests );
+	EXPECT_LE( server.connections.load(), syncRequests + 8 );
+
+	printf( "Http loopback: %d requests without keep-alive %s, %d async requests %s\n",
+			syncRequests, closeTime.toString().c_str(), requests, asyncTime.toString().c_str() );
+}
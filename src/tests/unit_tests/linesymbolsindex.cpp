@@ -0,0 +1,153 @@
+#include "../../tools/ecode/plugins/autocomplete/linesymbolsindex.hpp"
+#include "utest.h"
+#include <eepp/system/luapattern.hpp>
+
+using namespace EE::System;
+using namespace ecode;
+
+/** Indexes the documents as the autocomplete plugin does, counting the lines scanned */
+struct TestIndex {
+	LineSymbolsIndex index;
+	std::unordered_map<std::string, Int64> langSymbols;
+	int scannedLines{ 0 };
+	// Forces every line into the same bucket, as if all of them had the same hash
+	bool collide{ false };
+
+	size_t update( const std::vector<String>& document ) {
+		std::vector<LineSymbolsIndex::Line> lines;
+		for ( const auto& line : document )
+			lines.push_back( { &line, collide ? 0 : line.getHash() } );
+
+		LineSymbolsIndex::Scan scan;
+		index.scan(
+			lines,
+			[this]( const String& line ) {
+				scannedLines++;
+				std::vector<std::string> symbols;
+				std::string text( line.toUtf8() );
+				LuaPattern pattern( "[%a_][%w_]*" );
+				for ( auto& match : pattern.gmatch( text ) )
+					symbols.emplace_back( match[0] );
+				return symbols;
+			},
+			scan );
+
+		return index.apply( std::move( scan ), [this]( const std::string& symbol, Int64 delta ) {
+			if ( ( langSymbols[symbol] += delta ) == 0 )
+				langSymbols.erase( symbol );
+		} );
+	}
+
+	Uint32 count( const std::string& symbol ) const {
+		auto it = index.getSymbols().find( symbol );
+		return it != index.getSymbols().end() ? it->second : 0;
+	}
+
+	bool matchesLang() const {
+		if ( langSymbols.size() != index.getSymbols().size() )
+			return false;
+		for ( const auto& symbol : index.getSymbols() ) {
+			auto it = langSymbols.find( symbol.first );
+			if ( it == langSymbols.end() || it->second != symbol.second )
+				return false;
+		}
+		return true;
+	}
+};
+
+UTEST( LineSymbolsIndex, incrementalUpdate ) {
+	TestIndex test;
+	std::vector<String> doc{ "int alpha = 0;", "int beta = alpha;", "int alpha = 0;" };
+
+	EXPECT_EQ( test.update( doc ), (size_t)2 );
+	EXPECT_EQ( test.scannedLines, 2 );
+	EXPECT_EQ( test.index.getLinesCount(), (size_t)2 );
+	EXPECT_EQ( test.count( "alpha" ), 3u );
+	EXPECT_EQ( test.count( "beta" ), 1u );
+	EXPECT_EQ( test.count( "int" ), 3u );
+	EXPECT_TRUE( test.matchesLang() );
+
+	// Nothing changed, nothing is scanned
+	EXPECT_EQ( test.update( doc ), (size_t)0 );
+	EXPECT_EQ( test.scannedLines, 2 );
+
+	// Only the modified line is scanned
+	doc[1] = "int gamma = alpha;";
+	EXPECT_EQ( test.update( doc ), (size_t)2 );
+	EXPECT_EQ( test.scannedLines, 3 );
+	EXPECT_EQ( test.count( "beta" ), 0u );
+	EXPECT_EQ( test.count( "gamma" ), 1u );
+	EXPECT_EQ( test.count( "alpha" ), 3u );
+	EXPECT_TRUE( test.matchesLang() );
+
+	// A copy of an indexed line is not scanned again
+	doc.push_back( "int gamma = alpha;" );
+	EXPECT_EQ( test.update( doc ), (size_t)1 );
+	EXPECT_EQ( test.scannedLines, 3 );
+	EXPECT_EQ( test.count( "gamma" ), 2u );
+	EXPECT_TRUE( test.matchesLang() );
+}
+
+UTEST( LineSymbolsIndex, lineRemoval ) {
+	TestIndex test;
+	std::vector<String> doc{ "one two", "two three", "one two" };
+	test.update( doc );
+
+	// Removing one of the copies keeps the line indexed
+	doc.pop_back();
+	EXPECT_EQ( test.update( doc ), (size_t)1 );
+	EXPECT_EQ( test.index.getLinesCount(), (size_t)2 );
+	EXPECT_EQ( test.count( "one" ), 1u );
+	EXPECT_EQ( test.count( "two" ), 2u );
+	EXPECT_TRUE( test.matchesLang() );
+
+	doc.erase( doc.begin() );
+	EXPECT_EQ( test.update( doc ), (size_t)1 );
+	EXPECT_EQ( test.index.getLinesCount(), (size_t)1 );
+	EXPECT_EQ( test.count( "one" ), 0u );
+	EXPECT_TRUE( test.index.getSymbols().find( "one" ) == test.index.getSymbols().end() );
+	EXPECT_EQ( test.count( "two" ), 1u );
+	EXPECT_TRUE( test.matchesLang() );
+
+	// A huge document is indexed as an empty one
+	EXPECT_EQ( test.update( {} ), (size_t)1 );
+	EXPECT_EQ( test.index.getLinesCount(), (size_t)0 );
+	EXPECT_TRUE( test.index.getSymbols().empty() );
+	EXPECT_TRUE( test.langSymbols.empty() );
+}
+
+UTEST( LineSymbolsIndex, hashCollisions ) {
+	TestIndex test;
+	test.collide = true;
+	std::vector<String> doc{ "first line", "second line", "first line" };
+
+	EXPECT_EQ( test.update( doc ), (size_t)2 );
+	EXPECT_EQ( test.scannedLines, 2 );
+	EXPECT_EQ( test.count( "first" ), 2u );
+	EXPECT_EQ( test.count( "second" ), 1u );
+	EXPECT_EQ( test.count( "line" ), 3u );
+
+	// A different line with the same hash is not mistaken for an indexed one
+	doc[0] = "third line";
+	EXPECT_EQ( test.update( doc ), (size_t)2 );
+	EXPECT_EQ( test.scannedLines, 3 );
+	EXPECT_EQ( test.count( "first" ), 1u );
+	EXPECT_EQ( test.count( "third" ), 1u );
+	EXPECT_TRUE( test.matchesLang() );
+
+	doc = { "second line" };
+	test.update( doc );
+	EXPECT_EQ( test.index.getLinesCount(), (size_t)1 );
+	EXPECT_EQ( test.count( "first" ), 0u );
+	EXPECT_EQ( test.count( "third" ), 0u );
+	EXPECT_EQ( test.count( "second" ), 1u );
+	EXPECT_TRUE( test.matchesLang() );
+
+	// Real collisions of the line hash are indexed as different lines
+	TestIndex real;
+	EXPECT_EQ( String( "msaors" ).getHash(), String( "nnkewr" ).getHash() );
+	real.update( { "msaors", "nnkewr" } );
+	EXPECT_EQ( real.count( "msaors" ), 1u );
+	EXPECT_EQ( real.count( "nnkewr" ), 1u );
+	EXPECT_EQ( real.index.getLinesCount(), (size_t)2 );
+}
@@ -0,0 +1,132 @@
+#include "utest.h"
+#include <eepp/system/clock.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/log.hpp>
+#include <eepp/system/thread.hpp>
+#include <memory>
+
+using namespace EE;
+using namespace EE::System;
+
+/** Restores the log settings changed by a test */
+struct LogSettings {
+	Log* log{ Log::instance() };
+	bool keepLog{ log->getKeepLog() };
+	size_t keepLogMaxSize{ log->getKeepLogMaxSize() };
+	bool stdOut{ log->isLoggingToStdOut() };
+	bool liveWrite{ log->isLiveWrite() };
+	std::string filePath{ log->getFilePath() };
+	LogLevel threshold{ log->getLogLevelThreshold() };
+
+	~LogSettings() {
+		log->setAsync( false );
+		log->setKeepLog( keepLog );
+		log->setKeepLogMaxSize( keepLogMaxSize );
+		log->setLogToStdOut( stdOut );
+		log->setLiveWrite( liveWrite );
+		log->setFilePath( filePath );
+		log->setLogLevelThreshold( threshold );
+	}
+};
+
+static void writeFromThreads( int threads, int lines,
+							  const std::function<void( int thread, int line )>& write ) {
+	std::vector<std::unique_ptr<Thread>> writers;
+	for ( int t = 0; t < threads; t++ ) {
+		writers.emplace_back( std::make_unique<Thread>( [t, lines, &write] {
+			for ( int i = 0; i < lines; i++ )
+				write( t, i );
+		} ) );
+		writers.back()->launch();
+	}
+	for ( auto& writer : writers )
+		writer->wait();
+}
+
+UTEST( Log, async ) {
+	LogSettings settings;
+	Log* log = settings.log;
+	log->setLogToStdOut( false );
+	log->setLiveWrite( false );
+	log->setLogLevelThreshold( LogLevel::Info );
+	log->setKeepLog( true );
+	log->setKeepLogMaxSize( 64 * EE_1MB );
+	log->setAsync( true );
+	EXPECT_TRUE( log->isAsync() );
+
+	// More lines than a thread ring holds, to wait for the flusher
+	const int threads = 16;
+	const int lines = 3000;
+	writeFromThreads( threads, lines, [log]( int thread, int line ) {
+		log->writel( LogLevel::Info, String::format( "async-test %d %d", thread, line ) );
+		log->writel( LogLevel::Debug, "filtered" );
+	} );
+	log->writel( "async-test end" );
+	log->flush();
+
+	std::vector<int> next( threads, 0 );
+	int total = 0;
+	bool inOrder = true;
+	for ( const auto& line : String::split( log->getBuffer(), '\n' ) ) {
+		auto pos = line.find( "INFO: async-test " );
+		if ( pos == std::string::npos )
+			continue;
+		int thread = 0;
+		int number = 0;
+		if ( sscanf( line.c_str() + pos, "INFO: async-test %d %d", &thread, &number ) != 2 )
+			continue;
+		inOrder &= next[thread] == number;
+		next[thread] = number + 1;
+		total++;
+	}
+	EXPECT_EQ( total, threads * lines );
+	EXPECT_TRUE( inOrder );
+	EXPECT_TRUE( String::endsWith( log->getBuffer(), "async-test end\n" ) );
+	EXPECT_FALSE( String::contains( log->getBuffer(), "filtered" ) );
+
+	log->setAsync( false );
+	log->writel( "sync-test" );
+	EXPECT_TRUE( String::endsWith( log->getBuffer(), "sync-test\n" ) );
+
+	log->setKeepLogMaxSize( 16 * EE_1KB );
+	for ( int i = 0; i < 1000; i++ )
+		log->writel( LogLevel::Info, "bounded history line" );
+	EXPECT_LE( log->getBuffer().size(), 16u * EE_1KB );
+	EXPECT_TRUE( String::endsWith( log->getBuffer(), "bounded history line\n" ) );
+}
+
+UTEST( Log, benchmarkThreads ) {
+	LogSettings settings;
+	Log* log = settings.log;
+	std::string path( Sys::getTempPath() + "eepp-log-benchmark.log" );
+	log->setLogToStdOut( false );
+	log->setLogLevelThreshold( LogLevel::Info );
+	log->setKeepLog( true );
+	log->setFilePath( path );
+	log->setLiveWrite( true );
+
+	const int threads = 16;
+	const int lines = 5000;
+	auto write = [log]( int thread, int line ) {
+		log->writel( LogLevel::Info,
+					 String::format( "benchmark thread %d line %d", thread, line ) );
+	};
+
+	Clock clock;
+	writeFromThreads( threads, lines, write );
+	double syncRate = threads * lines / clock.getElapsedTime().asSeconds();
+
+	log->setAsync( true );
+	clock.restart();
+	writeFromThreads( threads, lines, write );
+	double asyncRate = threads * lines / clock.getElapsedTime().asSeconds();
+	log->flush();
+	double asyncFlushedRate = threads * lines / clock.getElapsedTime().asSeconds();
+	log->setAsync( false );
+
+	log->setFilePath( "" );
+	FileSystem::fileRemove( path );
+
+	printf( "Log calls per second from %d threads: sync %.0f, async %.0f ( %.0f flushed )\n",
+			threads, syncRate, asyncRate, asyncFlushedRate );
+}
@@ -0,0 +1,163 @@
+#include "../../tools/ecode/plugins/lsp/lspmessageframer.hpp"
+#include "utest.h"
+#include <eepp/system/clock.hpp>
+#include <nlohmann/json.hpp>
+
+using namespace EE::System;
+using namespace ecode;
+using json = nlohmann::json;
+
+static std::string frame( const std::string& payload ) {
+	return "Content-Length: " + std::to_string( payload.size() ) + "\r\n\r\n" + payload;
+}
+
+/** A clangd session shape: initialize, diagnostics and completion replies for every edit, and the
+ * semantic tokens of a big file, which is a single multi-megabyte message. */
+static std::vector<std::string> clangdSession() {
+	std::vector<std::string> payloads;
+	json init = { { "jsonrpc", "2.0" }, { "id", 0 } };
+	init["result"]["capabilities"]["semanticTokensProvider"]["full"] = { { "delta", true } };
+	init["result"]["serverInfo"] = { { "name", "clangd" }, { "version", "17.0.6" } };
+	payloads.emplace_back( init.dump() );
+
+	for ( int i = 0; i < 2000; i++ ) {
+		json diag = { { "jsonrpc", "2.0" }, { "method", "textDocument/publishDiagnostics" } };
+		diag["params"]["uri"] = "file:///src/eepp/ui/uicodeeditor.cpp";
+		diag["params"]["version"] = i;
+		for ( int d = 0; d < i % 8; d++ ) {
+			diag["params"]["diagnostics"].push_back(
+				{ { "message", "unused variable 'x" + std::to_string( d ) + "'" },
+				  { "severity", 2 },
+				  { "range",
+					{ { "start", { { "line", d }, { "character", 4 } } },
+					  { "end", { { "line", d }, { "character", 8 } } } } } } );
+		}
+		payloads.emplace_back( diag.dump() );
+
+		json completion = { { "jsonrpc", "2.0" }, { "id", i + 1 } };
+		for ( int c = 0; c < 50; c++ )
+			completion["result"]["items"].push_back(
+				{ { "label", "getDocument" + std::to_string( c ) }, { "kind", 2 } } );
+		payloads.emplace_back( completion.dump() );
+	}
+
+	json tokens = { { "jsonrpc", "2.0" }, { "id", 5000 } };
+	std::vector<int> data;
+	for ( int i = 0; i < 1000000; i++ )
+		data.push_back( i % 97 );
+	tokens["result"]["data"] = data;
+	payloads.emplace_back( tokens.dump() );
+	return payloads;
+}
+
+UTEST( LSPMessageFramer, split ) {
+	std::vector<std::string> payloads = { R"({"id":1})", R"({"method":"exit"})", "{}" };
+	std::string stream;
+	for ( const auto& payload : payloads )
+		stream += frame( payload );
+
+	// Every split point of the header and the payload
+	for ( size_t chunk = 1; chunk <= stream.size(); chunk++ ) {
+		LSPMessageFramer framer;
+		std::vector<std::string> received;
+		for ( size_t i = 0; i < stream.size(); i += chunk ) {
+			framer.append( stream.data() + i, std::min( chunk, stream.size() - i ),
+						   [&]( std::string_view payload ) { received.emplace_back( payload ); } );
+		}
+		ASSERT_EQ( received.size(), payloads.size() );
+		for ( size_t i = 0; i < payloads.size(); i++ )
+			EXPECT_STREQ( received[i].c_str(), payloads[i].c_str() );
+		EXPECT_EQ( framer.getPendingSize(), 0u );
+	}
+}
+
+UTEST( LSPMessageFramer, errors ) {
+	LSPMessageFramer framer;
+	std::vector<std::string> received;
+	std::vector<LSPMessageFramer::Error> errors;
+	auto onPayload = [&]( std::string_view payload ) { received.emplace_back( payload ); };
+	auto onError = [&]( LSPMessageFramer::Error error ) { errors.push_back( error ); };
+
+	std::string stream( "Content-Length: abc\r\n\r\nContent-Length: 0\r\n\r\n" );
+	stream += "Content-Type: application/vscode-jsonrpc\r\n" + frame( "{}" );
+	framer.append( stream.data(), stream.size(), onPayload, onError );
+	ASSERT_EQ( received.size(), 1u );
+	EXPECT_STREQ( received[0].c_str(), "{}" );
+	ASSERT_EQ( errors.size(), 2u );
+	EXPECT_TRUE( errors[0] == LSPMessageFramer::Error::InvalidLength );
+	EXPECT_TRUE( errors[1] == LSPMessageFramer::Error::EmptyPayload );
+
+	stream = "Content-Length: 99999999999\r\n\r\n{}";
+	framer.append( stream.data(), stream.size(), onPayload, onError );
+	EXPECT_TRUE( errors.back() == LSPMessageFramer::Error::ExcessiveSize );
+	EXPECT_EQ( framer.getPendingSize(), 0u );
+
+	stream = frame( "[]" );
+	framer.append( stream.data(), stream.size(), onPayload, onError );
+	ASSERT_EQ( received.size(), 2u );
+	EXPECT_STREQ( received[1].c_str(), "[]" );
+}
+
+UTEST( LSPMessageFramer, benchmarkClangdReplay ) {
+	std::vector<std::string> payloads( clangdSession() );
+	std::string stream;
+	size_t payloadsSize = 0;
+	for ( const auto& payload : payloads ) {
+		stream += frame( payload );
+		payloadsSize += payload.size();
+	}
+
+	// The pipe reads of the process output arrive in chunks of this size
+	const size_t chunk = 64 * 1024;
+	Clock clock;
+
+	// The previous framing: append, search from the start, copy the payload and erase it
+	size_t legacyCount = 0;
+	std::string buffer;
+	for ( size_t i = 0; i < stream.size(); i += chunk ) {
+		buffer.append( stream.data() + i, std::min( chunk, stream.size() - i ) );
+		while ( true ) {
+			auto index = buffer.find( "Content-Length:" );
+			auto msgstart = buffer.find( "\r\n\r\n", index );
+			if ( index == std::string::npos || msgstart == std::string::npos )
+				break;
+			msgstart += 4;
+			size_t length = std::stoul( buffer.substr( index + 15 ) );
+			if ( msgstart + length > buffer.size() )
+				break;
+			auto payload = buffer.substr( msgstart, length );
+			buffer.erase( 0, msgstart + length );
+			legacyCount += !payload.empty();
+		}
+	}
+	Time legacyTime = clock.getElapsedTimeAndReset();
+
+	size_t count = 0;
+	size_t bytes = 0;
+	LSPMessageFramer framer;
+	for ( size_t i = 0; i < stream.size(); i += chunk ) {
+		framer.append( stream.data() + i, std::min( chunk, stream.size() - i ),
+					   [&]( std::string_view payload ) {
+						   count++;
+						   bytes += payload.size();
+					   } );
+	}
+	Time framerTime = clock.getElapsedTimeAndReset();
+
+	EXPECT_EQ( legacyCount, payloads.size() );
+	EXPECT_EQ( count, payloads.size() );
+	EXPECT_EQ( bytes, payloadsSize );
+
+	// The payloads can be parsed in place
+	size_t parsed = 0;
+	framer.append( stream.data(), stream.size(), [&]( std::string_view payload ) {
+		parsed += json::parse( payload.begin(), payload.end() ).is_object();
+	} );
+	Time parseTime = clock.getElapsedTime();
+	EXPECT_EQ( parsed, payloads.size() );
+
+	printf( "LSP clangd replay ( %zu messages, %zu bytes ): framing before %s, after %s, "
+			"parsing %s\n",
+			payloads.size(), stream.size(), legacyTime.toString().c_str(),
+			framerTime.toString().c_str(), parseTime.toString().c_str() );
+}
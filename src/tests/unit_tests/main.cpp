@@ -1,3 +1,32 @@
 #include "utest.h"
+#include <cstdlib>
+#include <cstring>
 
-UTEST_MAIN()
+UTEST_STATE();
+
+// The benchmarks ( "benchmark*" tests ) only print their timings, so they are only run when
+// selected with --filter ( e.g. --filter=*.benchmark* )
+static void removeBenchmarks() {
+	size_t count = 0;
+	for ( size_t i = 0; i < utest_state.tests_length; i++ ) {
+		if ( strstr( utest_state.tests[i].name, ".benchmark" ) != NULL ) {
+			free( utest_state.tests[i].name );
+		} else {
+			utest_state.tests[count++] = utest_state.tests[i];
+		}
+	}
+	utest_state.tests_length = count;
+}
+
+int main( int argc, const char* const argv[] ) {
+	bool filtered = false;
+	for ( int i = 1; i < argc; i++ ) {
+		if ( strncmp( argv[i], "--filter=", strlen( "--filter=" ) ) == 0 )
+			filtered = true;
+	}
+
+	if ( !filtered )
+		removeBenchmarks();
+
+	return utest_main( argc, argv );
+}
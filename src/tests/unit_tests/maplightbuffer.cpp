@@ -0,0 +1,205 @@
+#include "utest.h"
+#include <eepp/maps/maplightbuffer.hpp>
+#include <eepp/system/clock.hpp>
+#include <memory>
+#include <random>
+
+using namespace EE;
+using namespace EE::Maps;
+using namespace EE::System;
+
+/** Lights over a map of 128x128 tiles of 32x32, with a dark base color */
+struct LitMap {
+	Sizei mapSize{ 128, 128 };
+	Sizei tileSize{ 32, 32 };
+	Color baseColor{ 40, 40, 40, 255 };
+	std::vector<std::unique_ptr<MapLight>> owned;
+	MapLightBuffer::LightsList lights;
+	std::mt19937 rng{ 42 };
+
+	Float random( Float min, Float max ) {
+		return std::uniform_real_distribution<Float>( min, max )( rng );
+	}
+
+	MapLight* addLight() {
+		// Brighter than the base color, as the lights of the map editor
+		RGB color( 128 + rng() % 128, 128 + rng() % 128, 128 + rng() % 128 );
+		owned.emplace_back( std::make_unique<MapLight>(
+			random( 64, 320 ), random( 0, mapSize.x * tileSize.x ),
+			random( 0, mapSize.y * tileSize.y ), color,
+			rng() % 4 == 0 ? MapLightType::Isometric : MapLightType::Normal ) );
+		lights.push_back( owned.back().get() );
+		return lights.back();
+	}
+
+	/** The color of a point as MapLight::processVertex accumulates it */
+	Color colorAt( const Vector2f& pos ) const {
+		Color color( baseColor );
+		for ( MapLight* light : lights )
+			color = light->processVertex( pos, color, color );
+		return color;
+	}
+
+	/** The previous MapLightManager::updateByTile: every frame, every light over the view is
+	 * accumulated over every visible tile */
+	void updateByTile( std::vector<Color>& colors, const Vector2i& start, const Vector2i& end,
+					   const Rectf& visibleArea ) {
+		bool firstLight = true;
+
+		for ( MapLight* light : lights ) {
+			if ( !firstLight && !visibleArea.intersect( light->getAABB() ) )
+				continue;
+
+			for ( Int32 x = start.x; x < end.x; x++ ) {
+				for ( Int32 y = start.y; y < end.y; y++ ) {
+					Color& color = colors[x * mapSize.y + y];
+
+					if ( firstLight )
+						color = baseColor;
+
+					Vector2i pos( x * tileSize.x, y * tileSize.y );
+					Rectf tileAABB( pos.x, pos.y, pos.x + tileSize.x, pos.y + tileSize.y );
+
+					if ( tileAABB.intersect( light->getAABB() ) )
+						color = light->processVertex( pos.x + tileSize.x / 2,
+													  pos.y + tileSize.y / 2, color, color );
+				}
+			}
+
+			firstLight = false;
+		}
+	}
+};
+
+static bool sameColor( const Color& a, const Color& b ) {
+	return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+/** Updates a buffer through 60 frames of changing lights and panning view, and returns the
+ * visible tiles that don't match processVertex plus the ones recomputed by a second update */
+static int checkLighting( bool byVertex ) {
+	LitMap map;
+	MapLightBuffer buffer( map.mapSize, map.tileSize, byVertex );
+	Sizei viewTiles( 40, 23 );
+	int errors = 0;
+
+	for ( int i = 0; i < 64; i++ )
+		map.addLight();
+
+	for ( int frame = 0; frame < 60; frame++ ) {
+		Vector2i start( frame, frame / 2 );
+		Vector2i end( start.x + viewTiles.x, start.y + viewTiles.y );
+
+		MapLight* light = map.lights[map.rng() % map.lights.size()];
+
+		switch ( frame % 6 ) {
+			case 0:
+				light->move( 16, -8 );
+				break;
+			case 1:
+				light->setColor( RGB( 255, 200, 128 ) );
+				break;
+			case 2:
+				light->setRadius( light->getRadius() + 32 );
+				break;
+			case 3:
+				light->setActive( !light->isActive() );
+				break;
+			case 4:
+				map.lights.erase( std::find( map.lights.begin(), map.lights.end(), light ) );
+				break;
+			case 5:
+				map.addLight();
+				break;
+		}
+
+		buffer.update( map.lights, start, end, map.baseColor );
+
+		for ( Int32 x = start.x; x < end.x; x++ ) {
+			for ( Int32 y = start.y; y < end.y; y++ ) {
+				Vector2i tile( x, y );
+				Vector2f pos( x * map.tileSize.x, y * map.tileSize.y );
+
+				if ( byVertex ) {
+					if ( !sameColor( *buffer.getTileColor( tile, 0 ), map.colorAt( pos ) ) ||
+						 !sameColor( *buffer.getTileColor( tile, 2 ),
+									 map.colorAt( pos + Vector2f( map.tileSize.x,
+																  map.tileSize.y ) ) ) )
+						errors++;
+				} else if ( !sameColor( *buffer.getTileColor( tile ),
+										map.colorAt( pos + Vector2f( map.tileSize.x / 2,
+																	 map.tileSize.y / 2 ) ) ) ) {
+					errors++;
+				}
+			}
+		}
+
+		// Nothing changed, nothing is recomputed
+		buffer.update( map.lights, start, end, map.baseColor );
+		errors += buffer.getUpdatedCount();
+	}
+
+	return errors;
+}
+
+UTEST( MapLightBuffer, byTile ) {
+	EXPECT_EQ( checkLighting( false ), 0 );
+}
+
+UTEST( MapLightBuffer, byVertex ) {
+	EXPECT_EQ( checkLighting( true ), 0 );
+}
+
+UTEST( MapLightBuffer, benchmarkLightsByViewport ) {
+	const int frames = 60;
+	const Sizei viewports[] = { { 40, 23 }, { 60, 34 }, { 120, 68 } };
+	const size_t lightCounts[] = { 16, 64, 256 };
+	auto pool = ThreadPool::createShared( eemax( 2u, std::thread::hardware_concurrency() ) );
+
+	for ( const Sizei& viewTiles : viewports ) {
+		for ( size_t lightCount : lightCounts ) {
+			LitMap map;
+			std::vector<Color> colors( map.mapSize.x * map.mapSize.y );
+			MapLightBuffer buffer( map.mapSize, map.tileSize, false );
+			MapLightBuffer threaded( map.mapSize, map.tileSize, false );
+			threaded.setThreadPool( pool, 4096 );
+
+			for ( size_t i = 0; i < lightCount; i++ )
+				map.addLight();
+
+			Time times[3];
+			Uint64 updated = 0;
+
+			for ( int frame = 0; frame < frames; frame++ ) {
+				// A camera panning 4 pixels per frame and an eighth of the lights moving
+				Vector2f offset( frame * 4, frame * 4 );
+				Vector2i start( offset.x / map.tileSize.x, offset.y / map.tileSize.y );
+				Vector2i end( start.x + viewTiles.x, start.y + viewTiles.y );
+				Rectf view( offset, Sizef( viewTiles.x * map.tileSize.x,
+										   viewTiles.y * map.tileSize.y ) );
+
+				for ( size_t i = frame % 8; i < map.lights.size(); i += 8 )
+					map.lights[i]->move( 3, 2 );
+
+				Clock clock;
+				map.updateByTile( colors, start, end, view );
+				times[0] += clock.getElapsedTimeAndReset();
+				buffer.update( map.lights, start, end, map.baseColor );
+				times[1] += clock.getElapsedTimeAndReset();
+				threaded.update( map.lights, start, end, map.baseColor );
+				times[2] += clock.getElapsedTime();
+				updated += buffer.getUpdatedCount();
+
+				EXPECT_TRUE( sameColor( colors[start.x * map.mapSize.y + start.y],
+										*buffer.getTileColor( start ) ) );
+			}
+
+			printf( "MapLightBuffer %zu lights, %dx%d tiles view, %d frames: full update %s, "
+					"incremental %s ( %.1f%% of the tiles ), incremental threaded %s\n",
+					lightCount, viewTiles.x, viewTiles.y, frames, times[0].toString().c_str(),
+					times[1].toString().c_str(),
+					100.0 * updated / ( (double)viewTiles.x * viewTiles.y * frames ),
+					times[2].toString().c_str() );
+		}
+	}
+}
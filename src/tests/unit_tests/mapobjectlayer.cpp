@@ -0,0 +1,72 @@
+#include "utest.h"
+#include <eepp/maps/mapobjectlayer.hpp>
+#include <eepp/maps/tilemap.hpp>
+#include <functional>
+
+using namespace EE;
+using namespace EE::Maps;
+using namespace EE::System;
+
+/** An active object that runs an action on every update */
+class ScriptedObject : public GameObject {
+  public:
+	ScriptedObject( MapLayer* layer, std::vector<int>& updates, int id ) :
+		GameObject( GObjFlags::GAMEOBJECT_ACTIVE, layer ), mUpdates( updates ), mId( id ) {}
+
+	void update( const Time& ) override {
+		mUpdates.push_back( mId );
+		if ( action )
+			action();
+	}
+
+	std::function<void()> action;
+
+  protected:
+	std::vector<int>& mUpdates;
+	int mId;
+};
+
+UTEST( MapObjectLayer, updateWhileRemoving ) {
+	// Without a renderer the map is created without the grid tile
+	TileMap map;
+	map.create( Sizei( 16, 16 ), 1, Sizei( 32, 32 ) );
+	MapObjectLayer* layer =
+		static_cast<MapObjectLayer*>( map.addLayer( MAP_LAYER_OBJECT, 0, "objects" ) );
+	ASSERT_TRUE( layer != NULL );
+
+	std::vector<int> updates;
+	std::vector<ScriptedObject*> objects;
+	for ( int i = 0; i < 5; i++ ) {
+		objects.push_back( eeNew( ScriptedObject, ( layer, updates, i ) ) );
+		layer->addGameObject( objects.back() );
+	}
+
+	ScriptedObject* added = NULL;
+	objects[0]->action = [&] {
+		added = eeNew( ScriptedObject, ( layer, updates, 5 ) );
+		layer->addGameObject( added );
+		objects[0]->action = nullptr;
+	};
+	// Removes itself, the next object must still be updated
+	objects[1]->action = [&] { layer->removeGameObject( objects[1] ); };
+	// Removes an object that wasn't updated yet
+	objects[2]->action = [&] {
+		layer->removeGameObject( objects[3] );
+		objects[2]->action = nullptr;
+	};
+
+	layer->update( Seconds( 0 ) );
+	EXPECT_TRUE( updates == std::vector<int>( { 0, 1, 2, 4 } ) );
+	EXPECT_EQ( layer->getObjectCount(), 4u );
+	EXPECT_EQ( layer->getActiveObjects().size(), (size_t)4 );
+
+	// The objects added during the update are updated from the next one
+	updates.clear();
+	layer->update( Seconds( 0 ) );
+	EXPECT_TRUE( updates == std::vector<int>( { 0, 2, 4, 5 } ) );
+
+	layer->removeGameObjects( { objects[0], added } );
+	updates.clear();
+	layer->update( Seconds( 0 ) );
+	EXPECT_TRUE( updates == std::vector<int>( { 2, 4 } ) );
+}
@@ -0,0 +1,133 @@
+#include "utest.h"
+#include <eepp/maps/gameobject.hpp>
+#include <eepp/maps/mapspatialindex.hpp>
+#include <eepp/system/clock.hpp>
+#include <memory>
+#include <random>
+
+using namespace EE;
+using namespace EE::Maps;
+using namespace EE::System;
+
+/** Objects of 32 to 128 pixels scattered over a map of 1000x1000 tiles of 32x32 */
+struct IndexedObjects {
+	Sizei mapSize{ 32000, 32000 };
+	std::vector<std::unique_ptr<GameObject>> objects;
+	std::vector<Rectf> bounds;
+	MapSpatialIndex index{ mapSize, 256 };
+	std::mt19937 rng{ 42 };
+
+	Rectf randomBounds() {
+		std::uniform_real_distribution<Float> pos( -64, mapSize.x + 64 );
+		std::uniform_real_distribution<Float> size( 32, 128 );
+		Vector2f p( pos( rng ), pos( rng ) );
+		return Rectf( p, Sizef( size( rng ), size( rng ) ) );
+	}
+
+	explicit IndexedObjects( size_t count ) {
+		for ( size_t i = 0; i < count; i++ ) {
+			objects.emplace_back( std::make_unique<GameObject>( 0, nullptr ) );
+			bounds.push_back( randomBounds() );
+			index.insert( objects.back().get(), bounds.back() );
+		}
+	}
+
+	MapSpatialIndex::ObjList scan( const Rectf& area ) const {
+		MapSpatialIndex::ObjList found;
+		for ( size_t i = 0; i < objects.size(); i++ ) {
+			if ( objects[i] && bounds[i].intersect( area ) )
+				found.push_back( objects[i].get() );
+		}
+		return found;
+	}
+};
+
+UTEST( MapSpatialIndex, queries ) {
+	IndexedObjects set( 5000 );
+	EXPECT_EQ( set.index.getCount(), 5000u );
+
+	for ( int i = 0; i < 200; i++ ) {
+		size_t moved = set.rng() % set.objects.size();
+		set.bounds[moved] = set.randomBounds();
+		set.index.update( set.objects[moved].get(), set.bounds[moved] );
+
+		if ( i % 10 == 0 ) {
+			size_t removed = set.rng() % set.objects.size();
+			if ( set.objects[removed] ) {
+				set.index.remove( set.objects[removed].get() );
+				EXPECT_FALSE( set.index.contains( set.objects[removed].get() ) );
+				set.objects[removed].reset();
+			}
+		}
+
+		// Same objects and same ( insertion ) order than a linear scan
+		Rectf view( set.randomBounds().getPosition(), Sizef( 1280, 720 ) );
+		MapSpatialIndex::ObjList found;
+		set.index.query( view, found );
+		EXPECT_TRUE( found == set.scan( view ) );
+
+		Vector2f point( view.getPosition() );
+		found.clear();
+		set.index.query( point, found );
+		EXPECT_TRUE( found == set.scan( Rectf( point, Sizef( 0, 0 ) ) ) );
+	}
+
+	// The objects outside of the map are clamped to the border cells
+	GameObject outside( 0, nullptr );
+	set.index.insert( &outside, Rectf( -500, -500, -400, -400 ) );
+	MapSpatialIndex::ObjList found;
+	set.index.query( Rectf( -450, -450, -440, -440 ), found );
+	ASSERT_EQ( found.size(), 1u );
+	EXPECT_TRUE( found[0] == &outside );
+}
+
+UTEST( MapSpatialIndex, benchmark100kObjects ) {
+	const int frames = 300;
+	IndexedObjects set( 100000 );
+	Sizef viewSize( 1920, 1080 );
+	Clock clock;
+
+	// A camera panning across the map, as the draw of an object layer
+	size_t scanned = 0;
+	for ( int f = 0; f < frames; f++ ) {
+		Rectf view( Vector2f( f * 100, f * 100 ), viewSize );
+		scanned += set.scan( view ).size();
+	}
+	Time scanTime = clock.getElapsedTimeAndReset();
+
+	size_t queried = 0;
+	MapSpatialIndex::ObjList found;
+	for ( int f = 0; f < frames; f++ ) {
+		Rectf view( Vector2f( f * 100, f * 100 ), viewSize );
+		found.clear();
+		set.index.query( view, found );
+		queried += found.size();
+	}
+	Time queryTime = clock.getElapsedTimeAndReset();
+	EXPECT_EQ( queried, scanned );
+
+	// 1000 moving objects per frame
+	for ( int f = 0; f < frames; f++ ) {
+		for ( int i = 0; i < 1000; i++ ) {
+			size_t moved = set.rng() % set.objects.size();
+			set.bounds[moved] = Rectf( set.bounds[moved].getPosition() + Vector2f( 4, 4 ),
+										set.bounds[moved].getSize() );
+			set.index.update( set.objects[moved].get(), set.bounds[moved] );
+		}
+	}
+	Time moveTime = clock.getElapsedTimeAndReset();
+
+	size_t picked = 0;
+	for ( int i = 0; i < 100000; i++ ) {
+		found.clear();
+		set.index.query( Vector2f( set.rng() % set.mapSize.x, set.rng() % set.mapSize.y ),
+						 found );
+		picked += found.size();
+	}
+	Time pickTime = clock.getElapsedTime();
+
+	printf( "MapSpatialIndex 100k objects, %d frames: visible objects by linear scan %s, by index "
+			"%s; 1000 moves per frame %s; 100k point picks %s ( %zu hits )\n",
+			frames, scanTime.toString().c_str(), queryTime.toString().c_str(),
+			moveTime.toString().c_str(), pickTime.toString().c_str(), picked );
+}
@@ -0,0 +1,121 @@
+#include "utest.h"
+#include <eepp/graphics/particlepool.hpp>
+#include <eepp/system/clock.hpp>
+#include <random>
+
+using namespace EE;
+using namespace EE::Graphics;
+using namespace EE::System;
+
+/** Particles spreading from the origin with random speeds and decays, as the Nofx effect */
+static std::vector<Particle> createParticles( size_t count ) {
+	std::mt19937 rng( 42 );
+	std::uniform_real_distribution<Float> speed( -1.f, 1.f );
+	std::uniform_real_distribution<Float> decay( 0.001f, 0.02f );
+	std::vector<Particle> particles( count );
+
+	for ( size_t i = 0; i < count; i++ ) {
+		particles[i].reset( 400, 300, speed( rng ), speed( rng ), speed( rng ) * 0.01f,
+							speed( rng ) * 0.01f );
+		particles[i].setColor( ColorAf( 1.f, 0.5f, 0.1f, 1.f ), decay( rng ) );
+		particles[i].setId( i + 1 );
+	}
+
+	return particles;
+}
+
+UTEST( ParticlePool, integrateMatchesParticle ) {
+	std::vector<Particle> particles( createParticles( 1000 ) );
+	ParticlePool pool;
+
+	for ( const auto& particle : particles )
+		pool.add( particle );
+
+	for ( int frame = 0; frame < 100; frame++ ) {
+		pool.integrate( 0.16f );
+
+		for ( auto& particle : particles )
+			particle.update( 0.16f );
+	}
+
+	ASSERT_EQ( pool.size(), particles.size() );
+
+	for ( size_t i = 0; i < particles.size(); i++ ) {
+		EXPECT_NEAR( particles[i].getX(), pool.getX( i ), 0.001f );
+		EXPECT_NEAR( particles[i].getY(), pool.getY( i ), 0.001f );
+		EXPECT_NEAR( particles[i].a(), pool.getAlpha( i ), 0.0001f );
+		EXPECT_EQ( particles[i].getId(), pool.getId( i ) );
+	}
+}
+
+UTEST( ParticlePool, removeSwapsTheLast ) {
+	std::vector<Particle> particles( createParticles( 10 ) );
+	ParticlePool pool;
+
+	for ( const auto& particle : particles )
+		pool.add( particle );
+
+	pool.remove( 2 );
+	EXPECT_EQ( pool.size(), (size_t)9 );
+	EXPECT_EQ( pool.getId( 2 ), (Uint32)10 );
+
+	pool.remove( 8 );
+	EXPECT_EQ( pool.size(), (size_t)8 );
+	EXPECT_EQ( pool.getId( 7 ), (Uint32)8 );
+
+	std::vector<VertexData> vertices( pool.size() * ParticlePool::getQuadVertexCount( true ) );
+	EXPECT_EQ( pool.emitQuads( vertices.data(), 16, true ), (Uint32)vertices.size() );
+	EXPECT_EQ( vertices[0].pos.x, pool.getX( 0 ) - 8 );
+	EXPECT_EQ( vertices[1].pos.y, pool.getY( 0 ) - 8 );
+}
+
+UTEST( ParticlePool, benchmarkUpdateAndEmit ) {
+	const size_t count = 100000;
+	const int frames = 60;
+	const Float size = 16;
+	const Float hsize = size * 0.5f;
+	std::vector<Particle> initial( createParticles( count ) );
+	std::vector<Particle> particles( initial );
+	std::vector<VertexData> vertices( count * 4 );
+	ParticlePool pool;
+
+	for ( const auto& particle : initial )
+		pool.add( particle );
+
+	// The particles as they were updated and batched one by one
+	Clock clock;
+	for ( int frame = 0; frame < frames; frame++ ) {
+		Uint32 numVertex = 0;
+
+		for ( size_t i = 0; i < count; i++ ) {
+			Particle* P = &particles[i];
+			P->update( 0.16f );
+
+			if ( P->a() <= 0.f )
+				*P = initial[i];
+
+			Color color( static_cast<Uint8>( P->r() * 255 ), static_cast<Uint8>( P->g() * 255 ),
+						 static_cast<Uint8>( P->b() * 255 ), static_cast<Uint8>( P->a() * 255 ) );
+			Float x = P->getX() - hsize;
+			Float y = P->getY() - hsize;
+			vertices[numVertex++] = { { x, y }, { 0, 0 }, color };
+			vertices[numVertex++] = { { x, y + size }, { 0, 1 }, color };
+			vertices[numVertex++] = { { x + size, y + size }, { 1, 1 }, color };
+			vertices[numVertex++] = { { x + size, y }, { 1, 0 }, color };
+		}
+	}
+	Time particleTime = clock.getElapsedTimeAndReset();
+
+	for ( int frame = 0; frame < frames; frame++ ) {
+		pool.integrate( 0.16f );
+
+		for ( size_t i = pool.findDead( 0 ); i < pool.size(); i = pool.findDead( i + 1 ) )
+			pool.set( i, initial[pool.getId( i ) - 1] );
+
+		pool.emitQuads( vertices.data(), size, false );
+	}
+	Time poolTime = clock.getElapsedTime();
+
+	printf( "ParticlePool %zu particles, %d frames: Particle array %s, ParticlePool %s\n", count,
+			frames, particleTime.toString().c_str(), poolTime.toString().c_str() );
+}
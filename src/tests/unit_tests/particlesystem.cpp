@@ -0,0 +1,175 @@
+#include "utest.h"
+#include <eepp/graphics/particlesystem.hpp>
+
+using namespace EE;
+using namespace EE::Graphics;
+using namespace EE::System;
+
+static const Uint32 COUNT = 12;
+
+/** Every particle respawns at the same place. The decays are powers of two, so the particles
+ * die in the same frame than an array of Particle: every 2, 4 or 8 frames. */
+static void resetParticle( Particle* P, ParticleSystem* ) {
+	Uint32 id = P->getId();
+	P->reset( id * 10.f, 0.f, 1.f, 0.5f, 0.f, 0.25f );
+	P->setColor( ColorAf( 1.f, 1.f, 1.f, 1.f ), 1.f / ( 2 << ( id % 3 ) ) );
+}
+
+/** The particles updated as an array, as ParticleSystem did before the particle pool */
+struct ParticleArray {
+	std::vector<Particle> particles;
+	Uint32 left;
+	Uint32 loops;
+	bool loop;
+	bool used{ true };
+
+	ParticleArray( bool loop, Uint32 loops ) :
+		particles( COUNT ), left( COUNT ), loops( loops ), loop( loop ) {
+		for ( Uint32 i = 0; i < COUNT; i++ ) {
+			particles[i].setUsed( true );
+			particles[i].setId( i + 1 );
+			resetParticle( &particles[i], NULL );
+		}
+	}
+
+	void update() {
+		if ( !used )
+			return;
+
+		for ( Uint32 i = 0; i < COUNT; i++ ) {
+			Particle* P = &particles[i];
+
+			if ( !P->isUsed() && P->a() <= 0.f )
+				continue;
+
+			P->update( 1.f );
+
+			if ( P->a() > 0.f )
+				continue;
+
+			if ( !loop ) {
+				if ( loops == 1 ) {
+					P->setUsed( false );
+					left--;
+				} else {
+					if ( i == 0 && loops > 0 )
+						loops--;
+
+					resetParticle( P, NULL );
+				}
+
+				if ( left == 0 )
+					used = false;
+			} else {
+				resetParticle( P, NULL );
+			}
+		}
+	}
+
+	void reuse() {
+		loop = true;
+		loops = 0;
+
+		for ( auto& particle : particles )
+			particle.setUsed( true );
+	}
+};
+
+static void createSystem( ParticleSystem& system, bool loop, Uint32 loops ) {
+	system.setCallbackReset( resetParticle );
+	system.create( ParticleEffect::Callback, COUNT, 0, Vector2f( 0, 0 ), 16, loop, loops );
+}
+
+static void update( ParticleSystem& system, ParticleArray& array ) {
+	// 100 ms at the default time modifier of 0.01 are an update of 1
+	system.update( Milliseconds( 100 ) );
+	array.update();
+}
+
+static void expectSame( int* utest_result, const ParticleSystem& system,
+						const ParticleArray& array ) {
+	const ParticlePool& pool = system.getPool();
+	size_t alive = 0;
+
+	for ( const auto& particle : array.particles )
+		alive += particle.isUsed() ? 1 : 0;
+
+	EXPECT_EQ( system.isUsing(), array.used );
+	ASSERT_EQ( pool.size(), alive );
+
+	for ( size_t i = 0; i < pool.size(); i++ ) {
+		const Particle& particle = array.particles[pool.getId( i ) - 1];
+		EXPECT_TRUE( particle.isUsed() );
+		EXPECT_NEAR( pool.getX( i ), particle.getX(), 0.001f );
+		EXPECT_NEAR( pool.getY( i ), particle.getY(), 0.001f );
+		EXPECT_EQ( pool.getAlpha( i ), particle.getColor().a );
+	}
+}
+
+UTEST( ParticleSystem, lastLoopRemovesTheDeadParticles ) {
+	ParticleSystem system;
+	ParticleArray array( false, 1 );
+	createSystem( system, false, 1 );
+	expectSame( utest_result, system, array );
+
+	for ( int frame = 1; frame <= 8; frame++ ) {
+		update( system, array );
+		expectSame( utest_result, system, array );
+
+		// The dead particles are swapped with the last ones, that die in the same frame or later
+		if ( frame == 2 )
+			EXPECT_EQ( system.getPool().size(), (size_t)8 );
+		else if ( frame == 4 )
+			EXPECT_EQ( system.getPool().size(), (size_t)4 );
+	}
+
+	EXPECT_EQ( system.getPool().size(), (size_t)0 );
+	EXPECT_FALSE( system.isUsing() );
+}
+
+UTEST( ParticleSystem, loopsEndWithTheFirstParticle ) {
+	ParticleSystem system;
+	ParticleArray array( false, 3 );
+	createSystem( system, false, 3 );
+
+	// The particle 1 dies every 4 frames, every death of it ends a loop
+	for ( int frame = 1; frame <= 20; frame++ ) {
+		update( system, array );
+		expectSame( utest_result, system, array );
+
+		// The third loop starts when the particle 1 dies in the frame 8, with every other particle
+		if ( frame < 8 ) {
+			EXPECT_EQ( system.getPool().size(), (size_t)COUNT );
+		} else if ( frame == 8 ) {
+			ASSERT_EQ( system.getPool().size(), (size_t)1 );
+			EXPECT_EQ( system.getPool().getId( 0 ), 1u );
+		}
+	}
+
+	EXPECT_FALSE( system.isUsing() );
+}
+
+UTEST( ParticleSystem, reuseRespawnsTheRemovedParticles ) {
+	ParticleSystem system;
+	ParticleArray array( false, 1 );
+	createSystem( system, false, 1 );
+
+	for ( int frame = 1; frame <= 2; frame++ )
+		update( system, array );
+
+	expectSame( utest_result, system, array );
+	EXPECT_EQ( system.getPool().size(), (size_t)8 );
+
+	// The removed particles are back dead, and respawn in the next update
+	system.reuse();
+	array.reuse();
+	EXPECT_EQ( system.getPool().size(), (size_t)COUNT );
+
+	for ( int frame = 1; frame <= 20; frame++ ) {
+		update( system, array );
+		expectSame( utest_result, system, array );
+	}
+
+	EXPECT_EQ( system.getPool().size(), (size_t)COUNT );
+	EXPECT_TRUE( system.isUsing() );
+}
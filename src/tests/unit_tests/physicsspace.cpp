@@ -0,0 +1,253 @@
+#include "utest.h"
+#include <eepp/physics/physics.hpp>
+#include <eepp/system/clock.hpp>
+#include <memory>
+
+using namespace EE;
+using namespace EE::Physics;
+using namespace EE::System;
+
+/** Piles of boxes and balls falling on separated platforms, every pile is an island */
+static Space* createPiles( int piles, int bodiesPerPile ) {
+	// The shape ids order the broadphase pairs, every space must start from the same ids
+	Shape::resetShapeIdCounter();
+	Space* space = Space::New();
+	space->setGravity( cVectNew( 0, 100 ) );
+	space->setIterations( 10 );
+
+	for ( int p = 0; p < piles; p++ ) {
+		cpFloat x = p * 200;
+
+		space->addStaticShape( ShapeSegment::New( space->getStaticBody(), cVectNew( x, 1000 ),
+												  cVectNew( x + 150, 1000 ), 0 ) );
+
+		for ( int i = 0; i < bodiesPerPile; i++ ) {
+			cVect pos( cVectNew( x + 20 + ( i % 4 ) * 32 + ( i / 4 ) % 2 * 8,
+								 1000 - 16 - ( i / 4 ) * 31 ) );
+			Body* body;
+			Shape* shape;
+
+			if ( i % 3 == 0 ) {
+				body = space->addBody( Body::New( 1, Moment::forCircle( 1, 0, 14, cVectZero ) ) );
+				shape = ShapeCircle::New( body, 14, cVectZero );
+			} else {
+				body = space->addBody( Body::New( 1, Moment::forBox( 1, 30, 30 ) ) );
+				shape = ShapePoly::New( body, 30, 30 );
+			}
+
+			body->setPos( pos );
+			shape->setU( 0.8 );
+			space->addShape( shape );
+		}
+	}
+
+	return space;
+}
+
+static bool sameBodies( Space* a, Space* b ) {
+	cpArray* bodiesA = a->getSpace()->bodies;
+	cpArray* bodiesB = b->getSpace()->bodies;
+
+	if ( bodiesA->num != bodiesB->num )
+		return false;
+
+	for ( int i = 0; i < bodiesA->num; i++ ) {
+		cpBody* ba = (cpBody*)bodiesA->arr[i];
+		cpBody* bb = (cpBody*)bodiesB->arr[i];
+
+		if ( ba->p.x != bb->p.x || ba->p.y != bb->p.y || ba->v.x != bb->v.x ||
+			 ba->v.y != bb->v.y || ba->a != bb->a || ba->w != bb->w )
+			return false;
+	}
+
+	return true;
+}
+
+UTEST( PhysicsSpace, parallelStepMatchesSerial ) {
+	auto pool = ThreadPool::createShared( 4 );
+	std::unique_ptr<Space> serial( createPiles( 16, 24 ) );
+	std::unique_ptr<Space> parallel( createPiles( 16, 24 ) );
+	parallel->setThreadPool( pool );
+
+	for ( int frame = 0; frame < 120; frame++ ) {
+		serial->step( 1 / 60.0 );
+		parallel->step( 1 / 60.0 );
+	}
+
+	EXPECT_TRUE( sameBodies( serial.get(), parallel.get() ) );
+	EXPECT_GT( serial->getSpace()->arbiters->num, 0 );
+}
+
+UTEST( PhysicsSpace, benchmark10kBodies ) {
+	const int frames = 60;
+	const Uint32 threads = eemax( 2u, std::thread::hardware_concurrency() );
+	auto pool = ThreadPool::createShared( threads );
+	std::unique_ptr<Space> serial( createPiles( 250, 40 ) );
+	std::unique_ptr<Space> parallel( createPiles( 250, 40 ) );
+	parallel->setThreadPool( pool );
+
+	Clock clock;
+	for ( int frame = 0; frame < frames; frame++ )
+		serial->step( 1 / 60.0 );
+	Time serialTime = clock.getElapsedTimeAndReset();
+
+	for ( int frame = 0; frame < frames; frame++ )
+		parallel->step( 1 / 60.0 );
+	Time parallelTime = clock.getElapsedTime();
+
+	EXPECT_TRUE( sameBodies( serial.get(), parallel.get() ) );
+
+	printf( "Physics::Space 10k bodies in 250 islands, %d steps: serial %s, "
+			"parallel ( %u threads ) %s\n",
+			frames, serialTime.toString().c_str(), threads, parallelTime.toString().c_str() );
+}
+
+/** Segments crossing the piles, deterministic so every run queries the same */
+static std::vector<Space::QuerySegment> createSegments( int count, cpFloat width ) {
+	std::vector<Space::QuerySegment> segments( count );
+
+	for ( int i = 0; i < count; i++ ) {
+		cpFloat x = ( i * 7919 ) % (int)width;
+		cpFloat y = 700 + ( i * 104729 ) % 300;
+		segments[i].start = cVectNew( x, y );
+		segments[i].end = cVectNew( x + 300 - ( i % 600 ), y + 100 - ( i % 200 ) );
+	}
+
+	return segments;
+}
+
+UTEST( PhysicsSpace, batchedQueriesMatchPerCall ) {
+	std::unique_ptr<Space> space( createPiles( 16, 24 ) );
+	space->setThreadPool( ThreadPool::createShared( 4 ) );
+
+	for ( int frame = 0; frame < 30; frame++ )
+		space->step( 1 / 60.0 );
+
+	std::vector<Space::QuerySegment> segments( createSegments( 1000, 16 * 200 ) );
+	std::vector<cVect> points;
+	std::vector<cBB> bbs;
+
+	for ( const auto& segment : segments ) {
+		points.push_back( segment.start );
+		bbs.push_back( cBBNew( segment.start.x, segment.start.y, segment.start.x + 40,
+							   segment.start.y + 40 ) );
+	}
+
+	Space::SegmentBatchResults segmentResults;
+	space->segmentQueryBatch( segments.data(), segments.size(), CP_ALL_LAYERS, CP_NO_GROUP,
+							  segmentResults );
+	ASSERT_EQ( segmentResults.size(), segments.size() );
+
+	std::vector<Space::SegmentHit> firstHits;
+	space->segmentQueryFirstBatch( segments.data(), segments.size(), CP_ALL_LAYERS, CP_NO_GROUP,
+								   firstHits );
+
+	Space::ShapeBatchResults pointResults;
+	space->pointQueryBatch( points.data(), points.size(), CP_ALL_LAYERS, CP_NO_GROUP,
+							pointResults );
+
+	Space::ShapeBatchResults bbResults;
+	space->bbQueryBatch( bbs.data(), bbs.size(), CP_ALL_LAYERS, CP_NO_GROUP, bbResults );
+
+	size_t totalHits = 0;
+
+	for ( size_t i = 0; i < segments.size(); i++ ) {
+		std::vector<Space::SegmentHit> hits;
+		space->segmentQuery( segments[i].start, segments[i].end, CP_ALL_LAYERS, CP_NO_GROUP,
+							 [&hits]( Shape* shape, cpFloat t, cVect n, void* ) {
+								 hits.push_back( { shape, t, n } );
+							 },
+							 NULL );
+
+		ASSERT_EQ( hits.size(), (size_t)segmentResults.count( i ) );
+
+		for ( size_t h = 0; h < hits.size(); h++ ) {
+			EXPECT_TRUE( hits[h].shape == segmentResults.begin( i )[h].shape );
+			EXPECT_EQ( hits[h].t, segmentResults.begin( i )[h].t );
+		}
+
+		totalHits += hits.size();
+
+		cpSegmentQueryInfo info;
+		Shape* first = space->segmentQueryFirst( segments[i].start, segments[i].end,
+												 CP_ALL_LAYERS, CP_NO_GROUP, &info );
+		EXPECT_TRUE( first == firstHits[i].shape );
+		EXPECT_EQ( info.t, firstHits[i].t );
+
+		std::vector<Shape*> shapes;
+		space->pointQuery( points[i], CP_ALL_LAYERS, CP_NO_GROUP,
+						   [&shapes]( Shape* shape, void* ) { shapes.push_back( shape ); }, NULL );
+		ASSERT_EQ( shapes.size(), (size_t)pointResults.count( i ) );
+		EXPECT_TRUE( std::equal( shapes.begin(), shapes.end(), pointResults.begin( i ) ) );
+
+		shapes.clear();
+		space->bbQuery( bbs[i], CP_ALL_LAYERS, CP_NO_GROUP,
+						[&shapes]( Shape* shape, void* ) { shapes.push_back( shape ); }, NULL );
+		ASSERT_EQ( shapes.size(), (size_t)bbResults.count( i ) );
+		EXPECT_TRUE( std::equal( shapes.begin(), shapes.end(), bbResults.begin( i ) ) );
+	}
+
+	EXPECT_GT( totalHits, (size_t)0 );
+}
+
+UTEST( PhysicsSpace, benchmarkBatchedRaycasts ) {
+	const Uint32 threads = eemax( 2u, std::thread::hardware_concurrency() );
+	std::unique_ptr<Space> space( createPiles( 250, 40 ) );
+
+	for ( int frame = 0; frame < 10; frame++ )
+		space->step( 1 / 60.0 );
+
+	std::vector<Space::QuerySegment> segments( createSegments( 10000, 250 * 200 ) );
+	std::vector<Space::SegmentHit> hits;
+	Space::SegmentBatchResults results;
+	size_t perCallHits = 0;
+
+	auto perCall = [&]() {
+		Clock clock;
+		for ( const auto& segment : segments ) {
+			space->segmentQuery(
+				segment.start, segment.end, CP_ALL_LAYERS, CP_NO_GROUP,
+				[&perCallHits]( Shape*, cpFloat, cVect, void* ) { perCallHits++; }, NULL );
+		}
+		return clock.getElapsedTime();
+	};
+
+	auto batched = [&]() {
+		Clock clock;
+		space->segmentQueryBatch( segments.data(), segments.size(), CP_ALL_LAYERS, CP_NO_GROUP,
+								  results );
+		return clock.getElapsedTime();
+	};
+
+	Time perCallTime = perCall();
+	Time batchTime = batched();
+	EXPECT_EQ( perCallHits, results.results.size() );
+
+	Clock clock;
+	space->optimizeSpatialIndex();
+	Time optimizeTime = clock.getElapsedTime();
+	Time optimizedPerCallTime = perCall();
+	Time optimizedBatchTime = batched();
+
+	space->setThreadPool( ThreadPool::createShared( threads ) );
+	Time parallelTime = batched();
+
+	space->setThreadPool( nullptr );
+	clock.restart();
+	for ( const auto& segment : segments )
+		space->segmentQueryFirst( segment.start, segment.end, CP_ALL_LAYERS, CP_NO_GROUP, NULL );
+	Time firstPerCallTime = clock.getElapsedTimeAndReset();
+
+	space->segmentQueryFirstBatch( segments.data(), segments.size(), CP_ALL_LAYERS, CP_NO_GROUP,
+								   hits );
+	Time firstBatchTime = clock.getElapsedTime();
+
+	printf( "Physics::Space 10k segment queries: per-call %s, batched %s\n",
+			perCallTime.toString().c_str(), batchTime.toString().c_str() );
+	printf( "Physics::Space 10k segment queries after optimizeSpatialIndex ( %s ): per-call %s, "
+			"batched %s, batched ( %u threads ) %s\n",
+			optimizeTime.toString().c_str(), optimizedPerCallTime.toString().c_str(),
+			optimizedBatchTime.toString().c_str(), threads, parallelTime.toString().c_str() );
+	printf( "Physics::Space 10k first hit segment queries: per-call %s, batched %s\n",
+			firstPerCallTime.toString().c_str(), firstBatchTime.toString().c_str() );
+}
@@ -0,0 +1,108 @@
+#include "utest.h"
+#include <eepp/network/socketselector.hpp>
+#include <eepp/network/tcplistener.hpp>
+#include <eepp/network/tcpsocket.hpp>
+#include <eepp/system/clock.hpp>
+#include <memory>
+
+#if defined( EE_PLATFORM_POSIX )
+#include <sys/resource.h>
+#endif
+
+using namespace EE::Network;
+using namespace EE::System;
+
+struct LoopbackConnections {
+	TcpListener listener;
+	std::vector<std::unique_ptr<TcpSocket>> clients;
+	std::vector<std::unique_ptr<TcpSocket>> servers;
+
+	bool open( int count, SocketSelector& selector ) {
+		if ( listener.listen( 0, IpAddress::LocalHost ) != Socket::Done )
+			return false;
+		selector.add( listener );
+		for ( int i = 0; i < count; i++ ) {
+			auto client = std::make_unique<TcpSocket>();
+			auto server = std::make_unique<TcpSocket>();
+			if ( client->connect( IpAddress::LocalHost, listener.getLocalPort() ) != Socket::Done ||
+				 listener.accept( *server ) != Socket::Done )
+				return false;
+			selector.add( *server );
+			clients.emplace_back( std::move( client ) );
+			servers.emplace_back( std::move( server ) );
+		}
+		return true;
+	}
+};
+
+UTEST( SocketSelector, readySockets ) {
+	SocketSelector selector;
+	LoopbackConnections conns;
+	ASSERT_TRUE( conns.open( 4, selector ) );
+
+	EXPECT_FALSE( selector.wait( Milliseconds( 10 ) ) );
+	EXPECT_TRUE( selector.getReadySockets().empty() );
+
+	char data = 'x';
+	conns.clients[2]->send( &data, 1 );
+	ASSERT_TRUE( selector.wait( Seconds( 1 ) ) );
+	ASSERT_EQ( selector.getReadySockets().size(), 1u );
+	EXPECT_TRUE( selector.getReadySockets()[0] == conns.servers[2].get() );
+	EXPECT_TRUE( selector.isReady( *conns.servers[2] ) );
+	EXPECT_FALSE( selector.isReady( *conns.servers[1] ) );
+
+	SocketSelector copy( selector );
+	selector.remove( *conns.servers[2] );
+	EXPECT_TRUE( selector.getReadySockets().empty() );
+	EXPECT_FALSE( selector.wait( Milliseconds( 10 ) ) );
+	EXPECT_TRUE( copy.wait( Seconds( 1 ) ) );
+	EXPECT_TRUE( copy.isReady( *conns.servers[2] ) );
+}
+
+#if EE_PLATFORM != EE_PLATFORM_WIN
+UTEST( SocketSelector, benchmark10kConnections ) {
+	int count = 10000;
+#if defined( EE_PLATFORM_POSIX )
+	// Every connection uses two descriptors, the limit of the process is kept as is
+	rlimit limit;
+	if ( getrlimit( RLIMIT_NOFILE, &limit ) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+		 static_cast<rlim_t>( count ) * 2 + 64 > limit.rlim_cur )
+		count = limit.rlim_cur > 64 ? static_cast<int>( ( limit.rlim_cur - 64 ) / 2 ) : 0;
+#endif
+	if ( count <= 0 )
+		UTEST_SKIP( "Not enough file descriptors" );
+
+	Clock clock;
+	SocketSelector selector;
+	LoopbackConnections conns;
+	ASSERT_TRUE( conns.open( count, selector ) );
+	Time connectTime = clock.getElapsedTimeAndReset();
+
+	const int rounds = 100;
+	const int messages = 100;
+	size_t received = 0;
+	for ( int round = 0; round < rounds; round++ ) {
+		for ( int i = 0; i < messages; i++ ) {
+			char data = 'x';
+			conns.clients[( round * messages + i * 37 ) % count]->send( &data, 1 );
+		}
+
+		size_t roundReceived = 0;
+		while ( roundReceived < messages && selector.wait( Seconds( 1 ) ) ) {
+			for ( Socket* socket : selector.getReadySockets() ) {
+				char buffer[128];
+				size_t size = 0;
+				static_cast<TcpSocket*>( socket )->receive( buffer, sizeof( buffer ), size );
+				roundReceived += size;
+			}
+		}
+		received += roundReceived;
+	}
+	Time waitTime = clock.getElapsedTime();
+
+	EXPECT_EQ( received, static_cast<size_t>( rounds * messages ) );
+
+	printf( "SocketSelector %d loopback connections: connect %s, %d waits with %d messages %s\n",
+			count, connectTime.toString().c_str(), rounds, messages, waitTime.toString().c_str() );
+}
+#endif
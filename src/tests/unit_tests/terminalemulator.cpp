@@ -0,0 +1,144 @@
+#include "utest.h"
+#include <eterm/system/iprocess.hpp>
+#include <eterm/terminal/ipseudoterminal.hpp>
+#include <eterm/terminal/iterminaldisplay.hpp>
+#include <eterm/terminal/terminalemulator.hpp>
+
+using namespace eterm::Terminal;
+
+static const int COLUMNS = 10;
+static const int ROWS = 4;
+
+/** Feeds the output to the emulator, without a shell */
+class TestPty : public IPseudoTerminal {
+  public:
+	std::string output;
+
+	int getNumColumns() const override { return COLUMNS; }
+
+	int getNumRows() const override { return ROWS; }
+
+	bool resize( int, int ) override { return true; }
+
+	bool waitForData( int ) override { return !output.empty(); }
+
+	void wakeUp() override {}
+
+	bool isTTY() const override { return true; }
+
+	int write( const char*, size_t n ) override { return (int)n; }
+
+	int read( char* buf, size_t n, bool ) override {
+		n = std::min( n, output.size() );
+		memcpy( buf, output.data(), n );
+		output.erase( 0, n );
+		return (int)n;
+	}
+};
+
+class TestProcess : public eterm::System::IProcess {
+  public:
+	void checkExitStatus() override {}
+
+	bool hasExited() const override { return false; }
+
+	int getExitCode() const override { return 0; }
+
+	void terminate() override {}
+
+	void waitForExit() override {}
+};
+
+/** Keeps a copy of the drawn cells and cursor */
+class TestDisplay : public ITerminalDisplay {
+  public:
+	std::vector<std::vector<TerminalGlyph>> rows{ ROWS };
+	int cursorX{ 0 };
+	int cursorY{ 0 };
+
+	bool drawBegin( Uint32, Uint32 ) override { return true; }
+
+	void drawLine( Line line, int x1, int y, int x2 ) override {
+		rows[y].assign( line + x1, line + x2 );
+	}
+
+	void drawCursor( int cx, int cy, TerminalGlyph, int, int, TerminalGlyph ) override {
+		cursorX = cx;
+		cursorY = cy;
+	}
+
+	void drawEnd() override {}
+};
+
+/** Runs the outputs through the ASCII runs or, with a selection started, through tputc */
+static std::shared_ptr<TestDisplay> run( const std::vector<std::string>& outputs, bool asciiRuns ) {
+	auto display = std::make_shared<TestDisplay>();
+	auto pty = std::make_unique<TestPty>();
+	TestPty* input = pty.get();
+	auto terminal =
+		TerminalEmulator::create( std::move( pty ), std::make_unique<TestProcess>(), display );
+
+	// An empty selection doesn't select anything, but disables the ASCII runs
+	if ( !asciiRuns )
+		terminal->selstart( 0, ROWS - 1, 0 );
+
+	for ( const auto& output : outputs ) {
+		input->output = output;
+		terminal->update();
+	}
+
+	terminal->redraw();
+	return display;
+}
+
+static std::string rowText( const TestDisplay& display, int row ) {
+	std::string text;
+	for ( const auto& glyph : display.rows[row] )
+		text += glyph.u ? (char)glyph.u : ' ';
+	return text;
+}
+
+static void expectSameAsTputc( int* utest_result, const std::vector<std::string>& outputs ) {
+	auto runs = run( outputs, true );
+	auto tputc = run( outputs, false );
+
+	for ( int y = 0; y < ROWS; y++ ) {
+		ASSERT_EQ( runs->rows[y].size(), tputc->rows[y].size() );
+		for ( size_t x = 0; x < runs->rows[y].size(); x++ ) {
+			EXPECT_EQ( runs->rows[y][x].u, tputc->rows[y][x].u );
+			EXPECT_EQ( runs->rows[y][x].mode, tputc->rows[y][x].mode );
+		}
+	}
+
+	EXPECT_EQ( runs->cursorX, tputc->cursorX );
+	EXPECT_EQ( runs->cursorY, tputc->cursorY );
+}
+
+UTEST( TerminalEmulator, asciiRunEndingOnTheLastColumnWraps ) {
+	auto display = run( { "0123456789abc" }, true );
+	EXPECT_TRUE( rowText( *display, 0 ) == "0123456789" );
+	EXPECT_TRUE( display->rows[0][COLUMNS - 1].mode & ATTR_WRAP );
+	EXPECT_FALSE( display->rows[0][0].mode & ATTR_WRAP );
+	EXPECT_TRUE( rowText( *display, 1 ) == "abc       " );
+	EXPECT_EQ( display->cursorX, 3 );
+	EXPECT_EQ( display->cursorY, 1 );
+
+	expectSameAsTputc( utest_result, { "0123456789abc" } );
+	// The wrap is pending between two reads
+	expectSameAsTputc( utest_result, { "0123456789", "abc" } );
+	expectSameAsTputc( utest_result, { "0123", "456789abc\r\nxyz" } );
+}
+
+UTEST( TerminalEmulator, asciiRunEndingOnTheLastColumnWithoutAutowrap ) {
+	// Without autowrap the characters after the last column overwrite it
+	auto display = run( { "\x1b[?7l0123456789abc" }, true );
+	EXPECT_TRUE( rowText( *display, 0 ) == "012345678c" );
+	EXPECT_FALSE( display->rows[0][COLUMNS - 1].mode & ATTR_WRAP );
+	EXPECT_TRUE( rowText( *display, 1 ) == "          " );
+	EXPECT_EQ( display->cursorX, COLUMNS - 1 );
+	EXPECT_EQ( display->cursorY, 0 );
+
+	expectSameAsTputc( utest_result, { "\x1b[?7l0123456789abc" } );
+	expectSameAsTputc( utest_result, { "\x1b[?7l0123456789", "abc" } );
+	expectSameAsTputc( utest_result, { "\x1b[?7l0123456789", "abc\r\nxyz" } );
+}
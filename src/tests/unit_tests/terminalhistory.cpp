@@ -0,0 +1,147 @@
+#include "utest.h"
+#include <eterm/terminal/terminalhistory.hpp>
+
+using namespace eterm::Terminal;
+
+static const int COLUMNS = 10;
+
+static std::vector<TerminalGlyph> makeRow( const std::string& text, bool wrap ) {
+	std::vector<TerminalGlyph> row( COLUMNS );
+	for ( int i = 0; i < COLUMNS; i++ )
+		row[i].u = i < (int)text.size() ? text[i] : ' ';
+	if ( wrap )
+		row[COLUMNS - 1].mode |= ATTR_WRAP;
+	return row;
+}
+
+static void push( TerminalHistory& history, const std::string& text, bool wrap = false ) {
+	history.push( makeRow( text, wrap ).data(), COLUMNS );
+}
+
+static std::string rowText( const TerminalHistory& history, int row ) {
+	Line line = history.getRow( row );
+	std::string text;
+	if ( line == nullptr )
+		return text;
+	for ( int i = 0; i < history.getColumns(); i++ )
+		text += (char)line[i].u;
+	while ( !text.empty() && text.back() == ' ' )
+		text.pop_back();
+	return text;
+}
+
+UTEST( TerminalHistory, pushPop ) {
+	TerminalHistory history( 100 );
+	push( history, "hello" );
+	push( history, "0123456789", true );
+	push( history, "abc" );
+	ASSERT_EQ( history.size(), 3 );
+	EXPECT_TRUE( rowText( history, 0 ) == "abc" );
+	EXPECT_TRUE( rowText( history, 1 ) == "0123456789" );
+	EXPECT_TRUE( rowText( history, 2 ) == "hello" );
+	EXPECT_TRUE( history.getRow( 1 )[COLUMNS - 1].mode & ATTR_WRAP );
+
+	// Pops the last row of the wrapped line, then the line itself
+	history.pop();
+	ASSERT_EQ( history.size(), 2 );
+	EXPECT_TRUE( rowText( history, 0 ) == "0123456789" );
+	EXPECT_FALSE( history.getRow( 0 )[COLUMNS - 1].mode & ATTR_WRAP );
+	history.pop();
+	ASSERT_EQ( history.size(), 1 );
+	EXPECT_TRUE( rowText( history, 0 ) == "hello" );
+
+	// A popped line doesn't continue
+	push( history, "xyz" );
+	EXPECT_EQ( history.size(), 2 );
+	EXPECT_TRUE( rowText( history, 0 ) == "xyz" );
+
+	history.pop();
+	history.pop();
+	EXPECT_TRUE( history.empty() );
+}
+
+UTEST( TerminalHistory, reflow ) {
+	TerminalHistory history( 100 );
+	push( history, "first" );
+	push( history, "0123456789", true );
+	push( history, "abcdefghij", true );
+	push( history, "ABCDE" );
+	ASSERT_EQ( history.size(), 4 );
+
+	history.setColumns( 5 );
+	ASSERT_EQ( history.size(), 6 );
+	EXPECT_TRUE( rowText( history, 5 ) == "first" );
+	EXPECT_TRUE( rowText( history, 4 ) == "01234" );
+	EXPECT_TRUE( rowText( history, 1 ) == "fghij" );
+	EXPECT_TRUE( rowText( history, 0 ) == "ABCDE" );
+
+	history.setColumns( 20 );
+	ASSERT_EQ( history.size(), 3 );
+	EXPECT_TRUE( rowText( history, 1 ) == "0123456789abcdefghij" );
+	EXPECT_TRUE( rowText( history, 0 ) == "ABCDE" );
+
+	// Rows pushed to an open line after a reflow continue its layout
+	history.setColumns( 7 );
+	push( history, "0123456789", true );
+	push( history, "0123456789", true );
+	push( history, "012" );
+	int rows = history.size();
+	history.setColumns( 20 );
+	history.setColumns( 7 );
+	EXPECT_EQ( history.size(), rows );
+	EXPECT_TRUE( rowText( history, 1 ) == "4567890" );
+	EXPECT_TRUE( rowText( history, 0 ) == "12" );
+}
+
+UTEST( TerminalHistory, search ) {
+	TerminalHistory history( 100 );
+	push( history, "foo bar" );
+	push( history, "xxxxxxxxfo", true );
+	push( history, "o end" );
+
+	auto matches = history.search( "foo" );
+	ASSERT_EQ( matches.size(), (size_t)2 );
+	EXPECT_EQ( matches[0].row, 2 );
+	EXPECT_EQ( matches[0].column, 0 );
+	EXPECT_EQ( matches[0].length, 3 );
+	// The second match continues in the next row
+	EXPECT_EQ( matches[1].row, 1 );
+	EXPECT_EQ( matches[1].column, 8 );
+	EXPECT_EQ( matches[1].length, 3 );
+
+	EXPECT_TRUE( history.search( "FOO" ).empty() );
+	EXPECT_EQ( history.search( "FOO", false ).size(), (size_t)2 );
+	EXPECT_EQ( history.search( "end" ).size(), (size_t)1 );
+	EXPECT_TRUE( history.search( "missing" ).empty() );
+}
+
+UTEST( TerminalHistory, evictsOpenLine ) {
+	TerminalHistory history( 4 );
+	push( history, "old" );
+
+	for ( int i = 0; i < 10; i++ )
+		push( history, std::string( COLUMNS, 'a' + i ), true );
+
+	// The open line alone exceeds the history, its oldest rows are dropped
+	ASSERT_EQ( history.size(), 4 );
+	EXPECT_TRUE( rowText( history, 0 ) == "jjjjjjjjjj" );
+	EXPECT_TRUE( rowText( history, 3 ) == "gggggggggg" );
+	EXPECT_TRUE( history.search( "old" ).empty() );
+
+	push( history, "end" );
+	ASSERT_EQ( history.size(), 4 );
+	EXPECT_TRUE( rowText( history, 0 ) == "end" );
+	EXPECT_TRUE( rowText( history, 1 ) == "jjjjjjjjjj" );
+
+	// The dropped rows are reclaimed while the line keeps growing
+	for ( int i = 0; i < 100000; i++ )
+		push( history, std::string( COLUMNS, 'a' + i % 26 ), true );
+	EXPECT_EQ( history.size(), 4 );
+	EXPECT_LT( history.getMemoryUsage(), (size_t)16384 );
+	EXPECT_TRUE( rowText( history, 0 ) == std::string( COLUMNS, 'a' + 99999 % 26 ) );
+
+	history.setColumns( 5 );
+	EXPECT_EQ( history.size(), 4 );
+	history.pop();
+	EXPECT_EQ( history.size(), 3 );
+}
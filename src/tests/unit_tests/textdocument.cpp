@@ -0,0 +1,122 @@
+#include "utest.h"
+#include <eepp/system/regex.hpp>
+#include <eepp/ui/doc/textdocument.hpp>
+
+using namespace EE::System;
+using namespace EE::UI::Doc;
+
+UTEST( TextDocument, replaceAll ) {
+	TextDocument doc;
+	doc.textInput( "foo bar Foo\nbaz foo\nnothing here\nfoofoo\n" );
+	doc.resetUndoRedo();
+	size_t linesCount = doc.linesCount();
+
+	EXPECT_EQ( doc.replaceAll( "foo", "qux" ), 4 );
+	EXPECT_TRUE( doc.line( 0 ).getText() == "qux bar Foo\n" );
+	EXPECT_TRUE( doc.line( 1 ).getText() == "baz qux\n" );
+	EXPECT_TRUE( doc.line( 2 ).getText() == "nothing here\n" );
+	EXPECT_TRUE( doc.line( 3 ).getText() == "quxqux\n" );
+
+	doc.undo();
+	EXPECT_TRUE( doc.line( 0 ).getText() == "foo bar Foo\n" );
+	EXPECT_TRUE( doc.line( 3 ).getText() == "foofoo\n" );
+	EXPECT_FALSE( doc.hasUndo() );
+
+	doc.redo();
+	EXPECT_TRUE( doc.line( 1 ).getText() == "baz qux\n" );
+	// Close the undo group, fast consecutive changes are merged
+	doc.resetUndoRedo();
+
+	EXPECT_EQ( doc.replaceAll( "FOO", "a\nb", false, true ), 1 );
+	EXPECT_EQ( doc.linesCount(), linesCount + 1 );
+	EXPECT_TRUE( doc.line( 0 ).getText() == "qux bar a\n" );
+	EXPECT_TRUE( doc.line( 1 ).getText() == "b\n" );
+
+	doc.undo();
+	EXPECT_EQ( doc.linesCount(), linesCount );
+	EXPECT_TRUE( doc.line( 0 ).getText() == "qux bar Foo\n" );
+}
+
+UTEST( TextDocument, replaceAllCaptures ) {
+	TextDocument doc;
+	doc.textInput( "a=1\nb=2\n" );
+	EXPECT_EQ( doc.replaceAll( "(\\w)=(\\d)", "$2=$1", true, false,
+							   TextDocument::FindReplaceType::RegEx ),
+			   2 );
+	EXPECT_TRUE( doc.line( 0 ).getText() == "1=a\n" );
+	EXPECT_TRUE( doc.line( 1 ).getText() == "2=b\n" );
+	RegExCache::destroySingleton();
+}
+
+UTEST( TextDocument, replaceAllParallel ) {
+	std::vector<TextDocumentLine> lines;
+	for ( int i = 0; i < 20000; i++ )
+		lines.emplace_back( String( i % 3 == 0 ? "foo bar foo\n" : "bar\n" ) );
+	TextDocument serial;
+	TextDocument parallel;
+	serial.setLines( std::vector<TextDocumentLine>( lines ) );
+	parallel.setLines( std::move( lines ) );
+	auto pool = ThreadPool::createShared( 4 );
+
+	int count = serial.replaceAll( "foo", "qux" );
+	EXPECT_EQ( count, 13334 );
+	EXPECT_EQ( parallel.replaceAll( "foo", "qux", true, false,
+									TextDocument::FindReplaceType::Normal, TextRange(), pool ),
+			   count );
+	ASSERT_EQ( parallel.linesCount(), serial.linesCount() );
+	for ( size_t i = 0; i < serial.linesCount(); i++ )
+		ASSERT_TRUE( parallel.line( i ).getText() == serial.line( i ).getText() );
+}
+
+UTEST( TextDocument, findAllParallel ) {
+	TextDocument doc;
+	std::vector<TextDocumentLine> lines;
+	for ( int i = 0; i < 20000; i++ )
+		lines.emplace_back( String( i % 3 == 0 ? "foo bar foo\n" : "bar\n" ) );
+	doc.setLines( std::move( lines ) );
+	auto pool = ThreadPool::createShared( 4 );
+
+	for ( const String& search : { String( "foo" ), String( "foo\nbar" ) } ) {
+		auto expected = doc.findAll( search );
+		size_t streamed = 0;
+		Mutex mutex;
+		auto res = doc.findAllParallel( pool, search, true, false,
+										TextDocument::FindReplaceType::Normal, TextRange(),
+										[&]( TextDocument::SearchResults&& batch ) {
+											Lock l( mutex );
+											streamed += batch.size();
+										} );
+		ASSERT_EQ( res.size(), expected.size() );
+		EXPECT_TRUE( res.ranges() == expected.ranges() );
+		EXPECT_TRUE( streamed >= res.size() );
+	}
+}
+
+UTEST( TextDocument, findAllParallelPatterns ) {
+	TextDocument doc;
+	std::vector<TextDocumentLine> lines;
+	for ( int i = 0; i < 20000; i++ )
+		lines.emplace_back( String( i % 3 == 0 ? "foo bar foo\n" : "bar\n" ) );
+	doc.setLines( std::move( lines ) );
+	auto pool = ThreadPool::createShared( 4 );
+
+	// Patterns searched in parallel and patterns that could match new lines ( searched serially )
+	const std::vector<std::pair<String, TextDocument::FindReplaceType>> patterns = {
+		{ "fo+", TextDocument::FindReplaceType::RegEx },
+		{ "foo\\s+", TextDocument::FindReplaceType::RegEx },
+		{ "ar\\nb", TextDocument::FindReplaceType::RegEx },
+		{ "(?s)o.", TextDocument::FindReplaceType::RegEx },
+		{ "fo+", TextDocument::FindReplaceType::LuaPattern },
+		{ "foo%s", TextDocument::FindReplaceType::LuaPattern },
+		{ "b.r", TextDocument::FindReplaceType::LuaPattern },
+	};
+
+	for ( const auto& pattern : patterns ) {
+		auto expected = doc.findAll( pattern.first, true, false, pattern.second );
+		auto res = doc.findAllParallel( pool, pattern.first, true, false, pattern.second );
+		ASSERT_EQ( res.size(), expected.size() );
+		EXPECT_TRUE( res.ranges() == expected.ranges() );
+	}
+
+	RegExCache::destroySingleton();
+}
@@ -0,0 +1,132 @@
+#include "utest.h"
+#include <eepp/system/clock.hpp>
+#include <eepp/ui/doc/textdocumentdiff.hpp>
+#include <random>
+
+using namespace EE::System;
+using namespace EE::UI::Doc;
+
+static TextDocumentDiff::Lines documentLines( const TextDocument& doc ) {
+	std::string text;
+	for ( size_t i = 0; i < doc.linesCount(); i++ ) {
+		if ( i > 0 )
+			text += '\n';
+		text += doc.line( i ).getTextWithoutNewLine().toUtf8();
+	}
+	return TextDocumentDiff::Lines( text );
+}
+
+UTEST( TextDocumentDiff, diff ) {
+	TextDocumentDiff::Lines base( "a\nb\nc\nd\ne\n" );
+	ASSERT_EQ( base.size(), 6u );
+
+	auto hunks = TextDocumentDiff::diff( base, TextDocumentDiff::Lines( "a\nx\nc\ne\nf\n" ) );
+	ASSERT_EQ( hunks.size(), 3u );
+	EXPECT_TRUE( hunks[0].type() == TextDocumentDiff::ChangeType::Modified );
+	EXPECT_EQ( hunks[0].newStart, 1 );
+	EXPECT_TRUE( hunks[1].type() == TextDocumentDiff::ChangeType::Removed );
+	EXPECT_EQ( hunks[1].oldStart, 3 );
+	EXPECT_EQ( hunks[1].newStart, 3 );
+	EXPECT_TRUE( hunks[2].type() == TextDocumentDiff::ChangeType::Added );
+	EXPECT_EQ( hunks[2].newStart, 4 );
+	EXPECT_EQ( hunks[2].newCount, 1 );
+
+	TextDocumentDiff::Lines crlf( "a\r\nb\r\nc\r\nd\r\ne\r\n" );
+	EXPECT_TRUE( TextDocumentDiff::diff( base, crlf ).empty() );
+}
+
+UTEST( TextDocumentDiff, incremental ) {
+	TextDocument doc;
+	doc.textInput( "one\ntwo\nthree\nfour\nfive\n" );
+	doc.resetUndoRedo();
+	TextDocumentDiff diff( &doc );
+	diff.setBase( "one\ntwo\nthree\nfour\nfive\n" );
+	EXPECT_TRUE( diff.getHunks().empty() );
+
+	doc.insert( 0, { 1, 3 }, "!" );
+	ASSERT_EQ( diff.getHunks().size(), 1u );
+	EXPECT_TRUE( diff.getLineHunk( 1 ) != nullptr );
+	EXPECT_TRUE( diff.getLineHunk( 2 ) == nullptr );
+
+	doc.insert( 0, { 3, 0 }, "new\nlines\n" );
+	doc.remove( 0, { { 6, 0 }, { 7, 0 } } );
+	TextDocumentDiff::Lines base( "one\ntwo\nthree\nfour\nfive\n" );
+	EXPECT_TRUE( diff.getHunks() == TextDocumentDiff::diff( base, documentLines( doc ) ) );
+	EXPECT_EQ( diff.nextChange( 1 ), 3 );
+	EXPECT_EQ( diff.prevChange( 3 ), 1 );
+	EXPECT_EQ( diff.nextChange( 6 ), -1 );
+
+	doc.undo();
+	doc.undo();
+	doc.undo();
+	EXPECT_TRUE( diff.getHunks().empty() );
+}
+
+UTEST( TextDocumentDiff, benchmark100kLines ) {
+	std::string base;
+	for ( int i = 0; i < 100000; i++ )
+		base += "line " + std::to_string( i ) + " of the benchmark file\n";
+
+	TextDocument doc;
+	doc.textInput( base );
+	for ( int i = 0; i < 100000; i += 97 )
+		doc.insert( 0, { i, 0 }, "changed " );
+
+	Clock clock;
+	TextDocumentDiff diff( &doc );
+	diff.setBase( base );
+	Time hashTime = clock.getElapsedTimeAndReset();
+	size_t hunksCount = diff.getHunks().size();
+	Time fullTime = clock.getElapsedTimeAndReset();
+	EXPECT_EQ( hunksCount, 1031u );
+
+	std::mt19937 rng( 100000 );
+	const int edits = 1000;
+	for ( int i = 0; i < edits; i++ ) {
+		Int64 line = rng() % doc.linesCount();
+		if ( i % 2 )
+			doc.insert( 0, { line, 0 }, "edit\n" );
+		else
+			doc.insert( 0, { line, 0 }, "edit " );
+		diff.getHunks();
+	}
+	Time incrementalTime = clock.getElapsedTimeAndReset();
+
+	TextDocumentDiff::Lines baseLines( base );
+	EXPECT_TRUE( diff.getHunks() == TextDocumentDiff::diff( baseLines, documentLines( doc ) ) );
+
+	printf( "TextDocumentDiff 100k lines: base hash %s, full diff %s, %d incremental updates %s\n",
+			hashTime.toString().c_str(), fullTime.toString().c_str(), edits,
+			incrementalTime.toString().c_str() );
+}
+
+UTEST( TextDocumentDiff, hashCollisions ) {
+	String line( "msaors\n" );
+	String collision( "nnkewr\n" );
+	ASSERT_EQ( line.getHash(), collision.getHash() );
+
+	TextDocumentDiff::Lines base( "first\nmsaors\nlast\n" );
+	EXPECT_EQ( base.find( line, line.getHash() ), 1u );
+	EXPECT_EQ( base.find( collision, collision.getHash() ), TextDocumentDiff::Lines::NoLine );
+
+	// A line with the same hash as the base one is still a change
+	auto hunks = TextDocumentDiff::diff( base, TextDocumentDiff::Lines( "first\nnnkewr\nlast\n" ) );
+	ASSERT_EQ( hunks.size(), 1u );
+	EXPECT_TRUE( hunks[0].type() == TextDocumentDiff::ChangeType::Modified );
+	EXPECT_EQ( hunks[0].newStart, 1 );
+
+	// Both colliding lines in the same base keep their own ids
+	TextDocumentDiff::Lines both( "msaors\nnnkewr\nmsaors\n" );
+	EXPECT_TRUE( both.getIds() == std::vector<Uint32>( { 0, 1, 0, 2 } ) );
+
+	TextDocument doc;
+	doc.textInput( "first\nmsaors\nlast\n" );
+	TextDocumentDiff diff( &doc );
+	diff.setBase( "first\nmsaors\nlast\n" );
+	EXPECT_TRUE( diff.getHunks().empty() );
+
+	doc.remove( 0, { { 1, 0 }, { 1, 6 } } );
+	doc.insert( 0, { 1, 0 }, "nnkewr" );
+	ASSERT_EQ( diff.getHunks().size(), 1u );
+	EXPECT_TRUE( diff.getLineHunk( 1 ) != nullptr );
+}
@@ -0,0 +1,210 @@
+#include "utest.h"
+#include <eepp/system/clock.hpp>
+#include <eepp/system/sys.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <numeric>
+
+using namespace EE;
+using namespace EE::System;
+
+/** Blocks the only worker of the pool until release() */
+struct PoolGate {
+	std::atomic<bool> started{ false };
+	std::atomic<bool> released{ false };
+
+	void block( ThreadPool& pool ) {
+		pool.run( [this] {
+			started = true;
+			while ( !released )
+				Sys::sleep( Milliseconds( 1 ) );
+		} );
+		while ( !started )
+			Sys::sleep( Milliseconds( 1 ) );
+	}
+
+	void release() { released = true; }
+};
+
+UTEST( ThreadPool, priorities ) {
+	auto pool = ThreadPool::createUnique( 1 );
+	PoolGate gate;
+	gate.block( *pool );
+
+	Mutex mutex;
+	std::string order;
+	auto push = [&]( char c ) {
+		Lock l( mutex );
+		order += c;
+	};
+	pool->run( [&] { push( 'l' ); }, ThreadPool::Priority::Low );
+	pool->run( [&] { push( 'n' ); } );
+	pool->run( [&] { push( 'h' ); }, ThreadPool::Priority::High );
+	pool->run( [&] { push( 'N' ); }, ThreadPool::Priority::Normal );
+	auto last = pool->async( [] { return 1; }, ThreadPool::Priority::Low );
+
+	gate.release();
+	EXPECT_EQ( last.get(), 1 );
+	EXPECT_STREQ( order.c_str(), "hnNl" );
+}
+
+UTEST( ThreadPool, removeAndCancel ) {
+	auto pool = ThreadPool::createUnique( 1 );
+	PoolGate gate;
+	gate.block( *pool );
+
+	std::atomic<int> runs{ 0 };
+	std::atomic<int> callbacks{ 0 };
+	auto count = [&] { runs++; };
+	auto done = [&]( const Uint64& ) { callbacks++; };
+	pool->run( count, done, 7 );
+	pool->run( count, done, 7 );
+	Uint64 id = pool->run( count, done, 8 );
+	auto removedFuture = pool->async( [] { return 1; }, ThreadPool::Priority::Normal, 7 );
+	ThreadPool::CancellationToken token;
+	auto cancelledFuture = pool->async( [] { return 2; }, ThreadPool::Priority::High, 0, &token );
+
+	EXPECT_TRUE( pool->existsTagInQueue( 7 ) );
+	EXPECT_TRUE( pool->existsIdInQueue( id ) );
+	EXPECT_TRUE( pool->removeWithTag( 7 ) );
+	EXPECT_FALSE( pool->existsTagInQueue( 7 ) );
+	EXPECT_FALSE( pool->removeWithTag( 7 ) );
+	EXPECT_TRUE( pool->removeId( id ) );
+	EXPECT_FALSE( pool->existsIdInQueue( id ) );
+	token.cancel();
+
+	auto future = pool->async( [] { return 3; } );
+	gate.release();
+	EXPECT_EQ( future.get(), 3 );
+	EXPECT_EQ( runs.load(), 0 );
+	EXPECT_EQ( callbacks.load(), 0 );
+
+	bool broken = false;
+	try {
+		removedFuture.get();
+	} catch ( const std::future_error& ) {
+		broken = true;
+	}
+	EXPECT_TRUE( broken );
+
+	broken = false;
+	try {
+		cancelledFuture.get();
+	} catch ( const std::future_error& ) {
+		broken = true;
+	}
+	EXPECT_TRUE( broken );
+}
+
+UTEST( ThreadPool, parallelFor ) {
+	auto pool = ThreadPool::createUnique( 4 );
+	std::vector<std::atomic<int>> visits( 10007 );
+	for ( auto& visit : visits )
+		visit = 0;
+
+	pool->parallelFor( 0, visits.size(), 100, [&]( size_t begin, size_t end ) {
+		for ( size_t i = begin; i < end; i++ )
+			visits[i]++;
+	} );
+	EXPECT_TRUE( std::all_of( visits.begin(), visits.end(),
+							  []( const std::atomic<int>& visit ) { return visit == 1; } ) );
+
+	Uint64 sum = pool->parallelReduce(
+		1, 100001, 1000, Uint64( 0 ),
+		[]( size_t begin, size_t end ) {
+			Uint64 partial = 0;
+			for ( size_t i = begin; i < end; i++ )
+				partial += i;
+			return partial;
+		},
+		[]( Uint64 a, Uint64 b ) { return a + b; } );
+	EXPECT_EQ( sum, Uint64( 100000 ) * 100001 / 2 );
+
+	// Nested in the pool tasks, every worker waits for its own loop
+	std::atomic<size_t> nested{ 0 };
+	std::vector<std::future<void>> futures;
+	for ( int i = 0; i < 8; i++ ) {
+		futures.emplace_back( pool->async( [&] {
+			pool->parallelFor( 0, 1000, 10,
+							   [&]( size_t begin, size_t end ) { nested += end - begin; } );
+		} ) );
+	}
+	for ( auto& future : futures )
+		future.get();
+	EXPECT_EQ( nested.load(), 8000u );
+
+	ThreadPool::CancellationToken token;
+	std::atomic<size_t> processed{ 0 };
+	pool->parallelFor(
+		0, 1000, 1,
+		[&]( size_t, size_t ) {
+			if ( ++processed == 10 )
+				token.cancel();
+		},
+		ThreadPool::Priority::High, &token );
+	EXPECT_LT( processed.load(), 1000u );
+}
+
+static void busyWait( const Time& time ) {
+	Clock clock;
+	while ( clock.getElapsedTime() < time )
+		;
+}
+
+UTEST( ThreadPool, benchmarkSchedulingLatency ) {
+	const Uint32 threads = 4;
+	const int bulkTasks = 4000;
+	const int probes = 10;
+	auto pool = ThreadPool::createUnique( threads );
+
+	// A project search: bulk tasks submitted from several threads at once, then the latency of a
+	// task submitted while the queues are full
+	auto measure = [&]( ThreadPool::Priority bulk, ThreadPool::Priority probe ) {
+		Time total;
+		for ( int p = 0; p < probes; p++ ) {
+			std::vector<std::unique_ptr<Thread>> submitters;
+			for ( int t = 0; t < 4; t++ ) {
+				submitters.emplace_back( std::make_unique<Thread>( [&, bulk] {
+					for ( int i = 0; i < bulkTasks / 4; i++ )
+						pool->run( [] { busyWait( Microseconds( 20 ) ); }, bulk );
+				} ) );
+				submitters.back()->launch();
+			}
+			for ( auto& submitter : submitters )
+				submitter->wait();
+
+			Clock clock;
+			total += pool->async( [&clock] { return clock.getElapsedTime(); }, probe ).get();
+
+			// Drain the bulk tasks
+			pool->async( [] {}, ThreadPool::Priority::Low ).wait();
+		}
+		return Microseconds( total.asMicroseconds() / probes );
+	};
+
+	Clock clock;
+	Time fifo = measure( ThreadPool::Priority::Normal, ThreadPool::Priority::Normal );
+	Time prioritized = measure( ThreadPool::Priority::Low, ThreadPool::Priority::High );
+
+	std::atomic<int> done{ 0 };
+	clock.restart();
+	std::vector<std::unique_ptr<Thread>> submitters;
+	for ( int t = 0; t < 8; t++ ) {
+		submitters.emplace_back( std::make_unique<Thread>( [&] {
+			for ( int i = 0; i < 25000; i++ )
+				pool->run( [&done] { done++; } );
+		} ) );
+		submitters.back()->launch();
+	}
+	for ( auto& submitter : submitters )
+		submitter->wait();
+	while ( done < 8 * 25000 )
+		Sys::sleep( Microseconds( 100 ) );
+	Time throughput = clock.getElapsedTime();
+
+	EXPECT_LT( prioritized.asMicroseconds(), fifo.asMicroseconds() );
+
+	printf( "ThreadPool latency behind %d bulk tasks: same priority %s, high priority %s; "
+			"200k empty tasks from 8 threads %s\n",
+			bulkTasks, fifo.toString().c_str(), prioritized.toString().c_str(),
+			throughput.toString().c_str() );
+}
@@ -0,0 +1,142 @@
+#include "utest.h"
+#include <eepp/graphics/textureregion.hpp>
+#include <eepp/maps/gameobjecttextureregion.hpp>
+#include <eepp/maps/gameobjectvirtual.hpp>
+#include <eepp/maps/tilemap.hpp>
+#include <eepp/maps/tilemaplayer.hpp>
+#include <eepp/system/clock.hpp>
+#include <memory>
+
+using namespace EE;
+using namespace EE::Graphics;
+using namespace EE::Maps;
+using namespace EE::System;
+
+/** A texture without GL texture, only its size is needed to bake the tiles */
+class TestTexture : public Texture {
+  public:
+	TestTexture( int width, int height ) {
+		mWidth = mImgWidth = width;
+		mHeight = mImgHeight = height;
+	}
+};
+
+/** An atlas of 16 tiles of 32x32. Never destroyed, it isn't registered in the TextureFactory. */
+static Texture* getAtlas() {
+	static Texture* atlas = eeNew( TestTexture, ( 128, 128 ) );
+	return atlas;
+}
+
+struct TestTiles {
+	std::vector<std::unique_ptr<TextureRegion>> regions;
+
+	TestTiles() {
+		for ( int i = 0; i < 16; i++ ) {
+			regions.emplace_back( TextureRegion::New(
+				getAtlas(), Rect( ( i % 4 ) * 32, ( i / 4 ) * 32, ( i % 4 + 1 ) * 32,
+								  ( i / 4 + 1 ) * 32 ) ) );
+		}
+	}
+
+	void addTile( TileMapLayer* layer, const Vector2i& pos ) {
+		layer->addGameObject( eeNew( GameObjectTextureRegion,
+									 ( 0, layer, regions[( pos.x * 7 + pos.y ) % 16].get() ) ),
+							  pos );
+	}
+
+	void addObject( TileMapLayer* layer, const Vector2i& pos ) {
+		layer->addGameObject( eeNew( GameObjectVirtual, ( 0u, layer ) ), pos );
+	}
+};
+
+UTEST( TileMapLayer, chunksKeepTheTilesOrder ) {
+	TestTiles tiles;
+	TileMap map;
+	map.create( Sizei( 16, 16 ), 1, Sizei( 32, 32 ) );
+	map.setViewSize( Sizef( 16 * 32, 16 * 32 ) );
+	TileMapLayer* layer =
+		static_cast<TileMapLayer*>( map.addLayer( MAP_LAYER_TILED, 0, "tiles" ) );
+	ASSERT_TRUE( layer != NULL );
+
+	for ( Int32 y = 0; y < 4; y++ )
+		tiles.addTile( layer, Vector2i( 0, y ) );
+
+	layer->setChunkedRendering( true );
+	EXPECT_EQ( layer->updateChunks(), 1u );
+
+	// The tiles after the object can't join the quads drawn before it
+	tiles.addObject( layer, Vector2i( 0, 2 ) );
+	EXPECT_EQ( layer->updateChunks(), 3u );
+
+	layer->removeGameObject( Vector2i( 0, 2 ) );
+	EXPECT_EQ( layer->updateChunks(), 1u );
+
+	// An object before the first tile goes into a batch without quads
+	layer->removeGameObjects( Rect( 0, 0, 16, 16 ) );
+	tiles.addObject( layer, Vector2i( 0, 0 ) );
+	tiles.addTile( layer, Vector2i( 0, 1 ) );
+	EXPECT_EQ( layer->updateChunks(), 2u );
+}
+
+UTEST( TileMapLayer, benchmarkChunkedRendering ) {
+	// Without a renderer only the CPU side of the chunked draw can be measured: the chunks
+	// building and the light colors refresh. The unchunked draw needs a GL context.
+	const Sizei mapSize( 512, 512 );
+	const int frames = 600;
+	TestTiles tiles;
+
+	for ( bool byVertex : { false, true } ) {
+		TileMap map;
+		map.create( mapSize, 1, Sizei( 32, 32 ),
+					MAP_FLAG_LIGHTS_ENABLED | ( byVertex ? MAP_FLAG_LIGHTS_BYVERTEX : 0 ) );
+		map.setViewSize( Sizef( 1920, 1080 ) );
+		TileMapLayer* layer = static_cast<TileMapLayer*>(
+			map.addLayer( MAP_LAYER_TILED, LAYER_FLAG_LIGHTS_ENABLED, "ground" ) );
+		ASSERT_TRUE( layer != NULL );
+
+		// A full ground with an animated object every 50 tiles
+		for ( Int32 x = 0; x < mapSize.x; x++ ) {
+			for ( Int32 y = 0; y < mapSize.y; y++ ) {
+				if ( ( x * mapSize.y + y ) % 50 == 0 ) {
+					tiles.addObject( layer, Vector2i( x, y ) );
+				} else {
+					tiles.addTile( layer, Vector2i( x, y ) );
+				}
+			}
+		}
+
+		layer->setChunkedRendering( true );
+		Clock clock;
+
+		// A camera panning across the map, building the chunks as they come into view
+		size_t viewTiles = 0;
+		size_t draws = 0;
+		for ( int f = 0; f < frames; f++ ) {
+			map.setOffset( Vector2f( -f * 16, -f * 9 ) );
+			draws += layer->updateChunks();
+			Vector2i viewSize( map.getEndTile() - map.getStartTile() );
+			viewTiles += viewSize.x * viewSize.y;
+		}
+		Time panTime = clock.getElapsedTimeAndReset();
+		EXPECT_LT( draws, viewTiles );
+
+		// A still camera, the chunks are only lit again
+		for ( int f = 0; f < frames; f++ )
+			layer->updateChunks();
+		Time stillTime = clock.getElapsedTimeAndReset();
+
+		// A tile edited on every frame rebuilds its chunk
+		Vector2i start( map.getStartTile() );
+		for ( int f = 0; f < frames; f++ ) {
+			tiles.addTile( layer, start + Vector2i( f % 8, f % 4 ) );
+			layer->updateChunks();
+		}
+		Time editTime = clock.getElapsedTimeAndReset();
+
+		printf( "TileMapLayer lights by %s, %d frames, %.0f tiles in view: %.0f draws per frame "
+				"chunked, panning %s, still %s, editing %s\n",
+				byVertex ? "vertex" : "tile", frames, (double)viewTiles / frames,
+				(double)draws / frames, panTime.toString().c_str(), stillTime.toString().c_str(),
+				editTime.toString().c_str() );
+	}
+}
@@ -0,0 +1,192 @@
+#include "utest.h"
+#include <eepp/maps/gameobjectvirtual.hpp>
+#include <eepp/maps/mapobjectlayer.hpp>
+#include <eepp/maps/tilemap.hpp>
+#include <eepp/maps/tilemaplayer.hpp>
+#include <eepp/maps/tilemapstreamer.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreamstring.hpp>
+#include <eepp/system/sys.hpp>
+
+using namespace EE;
+using namespace EE::Maps;
+using namespace EE::System;
+
+static const Uint32 TILE_TYPE = 1000;
+static const Uint32 OBJECT_TYPE = 1001;
+
+/** Without a renderer the maps are created without textures, and the objects are virtual
+ * objects that only keep their type and data id */
+static void setHeadless( TileMap& map ) {
+	map.setCreateGameObjectCallback( []( const Uint32& type, const Uint32& flags, MapLayer* layer,
+										 const Uint32& dataId ) -> GameObject* {
+		return eeNew( GameObjectVirtual, ( dataId, layer, flags, type ) );
+	} );
+}
+
+static Uint32 tileId( Int32 x, Int32 y ) {
+	return x * 1000 + y + 1;
+}
+
+static bool hasTile( Int32 x, Int32 y ) {
+	return x % 3 == 0 && y % 5 == 0;
+}
+
+/** A map of 100x70 tiles of 32x32 with a tile every few tiles and an object every 10 tiles */
+static void createMap( TileMap& map ) {
+	setHeadless( map );
+	map.create( Sizei( 100, 70 ), 2, Sizei( 32, 32 ) );
+	TileMapLayer* tiles =
+		static_cast<TileMapLayer*>( map.addLayer( MAP_LAYER_TILED, 0, "tiles" ) );
+	MapObjectLayer* objects =
+		static_cast<MapObjectLayer*>( map.addLayer( MAP_LAYER_OBJECT, 0, "objects" ) );
+
+	for ( Int32 x = 0; x < 100; x++ ) {
+		for ( Int32 y = 0; y < 70; y++ ) {
+			if ( hasTile( x, y ) ) {
+				tiles->addGameObject( eeNew( GameObjectVirtual,
+											 ( tileId( x, y ), tiles, 0, TILE_TYPE ) ),
+									  Vector2i( x, y ) );
+			}
+
+			if ( x % 10 == 0 && y % 10 == 0 ) {
+				GameObject* obj =
+					eeNew( GameObjectVirtual, ( tileId( x, y ), objects, 0, OBJECT_TYPE ) );
+				obj->setPosition( Vector2f( x * 32, y * 32 ) );
+				objects->addGameObject( obj );
+			}
+		}
+	}
+}
+
+static Uint32 getTileId( TileMap& map, Int32 x, Int32 y ) {
+	GameObject* obj = static_cast<TileMapLayer*>( map.getLayer( 0 ) )->getGameObject( { x, y } );
+	return NULL != obj ? obj->getDataId() : 0;
+}
+
+UTEST( TileMapStreamer, chunkedRoundTrip ) {
+	TileMap map;
+	createMap( map );
+
+	IOStreamString stream;
+	map.saveToChunkedStream( stream, 16 );
+	stream.seek( 0 );
+
+	TileMap loaded;
+	setHeadless( loaded );
+	ASSERT_TRUE( loaded.loadFromStream( stream ) );
+	ASSERT_EQ( loaded.getLayerCount(), 2u );
+	EXPECT_TRUE( loaded.getSize() == map.getSize() );
+	EXPECT_TRUE( loaded.getTileSize() == map.getTileSize() );
+	ASSERT_EQ( loaded.getLayer( 0 )->getType(), (Uint32)MAP_LAYER_TILED );
+	ASSERT_EQ( loaded.getLayer( 1 )->getType(), (Uint32)MAP_LAYER_OBJECT );
+
+	Uint32 mismatches = 0;
+	for ( Int32 x = 0; x < 100; x++ ) {
+		for ( Int32 y = 0; y < 70; y++ ) {
+			if ( getTileId( loaded, x, y ) != ( hasTile( x, y ) ? tileId( x, y ) : 0 ) )
+				mismatches++;
+		}
+	}
+	EXPECT_EQ( mismatches, 0u );
+
+	MapObjectLayer* objects = static_cast<MapObjectLayer*>( loaded.getLayer( 1 ) );
+	ASSERT_EQ( objects->getObjectCount(), 70u );
+	for ( GameObject* obj : objects->getObjectsInArea( Rectf( 0, 0, 3200, 2240 ) ) ) {
+		Vector2f pos( obj->getPosition() );
+		EXPECT_EQ( obj->getDataId(), tileId( pos.x / 32, pos.y / 32 ) );
+		EXPECT_EQ( static_cast<GameObjectVirtual*>( obj )->getRealType(), OBJECT_TYPE );
+	}
+}
+
+UTEST( TileMapStreamer, tileBlocks ) {
+	TileMap map;
+	setHeadless( map );
+	map.create( Sizei( 100, 70 ), 1, Sizei( 32, 32 ) );
+	TileMapLayer* tiles =
+		static_cast<TileMapLayer*>( map.addLayer( MAP_LAYER_TILED, 0, "tiles" ) );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 0u );
+
+	auto add = [&]( Int32 x, Int32 y ) {
+		tiles->addGameObject( eeNew( GameObjectVirtual, ( tileId( x, y ), tiles, 0, TILE_TYPE ) ),
+							  Vector2i( x, y ) );
+	};
+
+	// The blocks are allocated with their first tile
+	add( 0, 0 );
+	add( 31, 31 );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 1u );
+	add( 32, 0 );
+	add( 99, 69 );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 3u );
+	EXPECT_EQ( getTileId( map, 31, 31 ), tileId( 31, 31 ) );
+	EXPECT_EQ( getTileId( map, 99, 69 ), tileId( 99, 69 ) );
+	EXPECT_EQ( getTileId( map, 50, 50 ), 0u );
+
+	// A block is released only when it's left empty
+	tiles->removeGameObjects( Rect( 0, 0, 16, 16 ) );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 3u );
+	EXPECT_EQ( getTileId( map, 0, 0 ), 0u );
+	tiles->removeGameObjects( Rect( 16, 16, 48, 32 ) );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 2u );
+	EXPECT_EQ( getTileId( map, 32, 0 ), tileId( 32, 0 ) );
+	tiles->removeGameObjects( Rect( 0, 0, 100, 70 ) );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 0u );
+}
+
+UTEST( TileMapStreamer, loadsAndUnloadsAroundTheView ) {
+	std::string path( Sys::getTempPath() + "eepp-tilemapstreamer.eem" );
+	{
+		TileMap map;
+		createMap( map );
+		map.saveToChunkedFile( path, 16 );
+	}
+
+	TileMap map;
+	setHeadless( map );
+	ASSERT_TRUE( map.streamFromFile( path ) );
+	TileMapStreamer* streamer = map.getStreamer();
+	ASSERT_TRUE( streamer != NULL );
+	EXPECT_TRUE( streamer->getChunksSize() == Sizei( 7, 5 ) );
+	EXPECT_EQ( streamer->getLoadedCount(), 0u );
+
+	TileMapLayer* tiles = static_cast<TileMapLayer*>( map.getLayer( 0 ) );
+	MapObjectLayer* objects = static_cast<MapObjectLayer*>( map.getLayer( 1 ) );
+	streamer->setLoadRadius( 1 );
+	streamer->setUnloadMargin( 0 );
+
+	// The view covers the chunk 0,0, the radius adds its neighbours
+	map.setViewSize( Sizef( 256, 256 ) );
+	map.setOffset( Vector2f( 0, 0 ) );
+	streamer->update();
+	streamer->flush();
+	EXPECT_EQ( streamer->getPendingCount(), 0u );
+	EXPECT_EQ( streamer->getLoadedCount(), 4u );
+	EXPECT_TRUE( streamer->isChunkLoaded( { 1, 1 } ) );
+	EXPECT_FALSE( streamer->isChunkLoaded( { 2, 0 } ) );
+	EXPECT_EQ( getTileId( map, 30, 30 ), tileId( 30, 30 ) );
+	EXPECT_EQ( getTileId( map, 33, 0 ), 0u );
+	EXPECT_EQ( objects->getObjectCount(), 16u );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 1u );
+
+	// Moving the view to the chunk 5,3 unloads the previous chunks
+	map.setOffset( Vector2f( -80 * 32, -50 * 32 ) );
+	streamer->update();
+	streamer->flush();
+	EXPECT_EQ( streamer->getLoadedCount(), 9u );
+	EXPECT_FALSE( streamer->isChunkLoaded( { 0, 0 } ) );
+	EXPECT_TRUE( streamer->isChunkLoaded( { 4, 2 } ) );
+	EXPECT_TRUE( streamer->isChunkLoaded( { 6, 4 } ) );
+	EXPECT_EQ( getTileId( map, 30, 30 ), 0u );
+	EXPECT_EQ( getTileId( map, 81, 50 ), tileId( 81, 50 ) );
+	EXPECT_EQ( objects->getObjectCount(), 9u );
+	EXPECT_EQ( tiles->getAllocatedBlocks(), 4u );
+
+	// Everything is loaded in the calling thread
+	streamer->loadAll();
+	EXPECT_EQ( streamer->getLoadedCount(), 35u );
+	EXPECT_EQ( objects->getObjectCount(), 70u );
+	EXPECT_EQ( getTileId( map, 30, 30 ), tileId( 30, 30 ) );
+
+	FileSystem::fileRemove( path );
+}
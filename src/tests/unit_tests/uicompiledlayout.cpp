@@ -0,0 +1,131 @@
+#include "utest.h"
+#include <eepp/system/iostreamstring.hpp>
+#include <eepp/ui/css/stylesheetselectorrule.hpp>
+#include <eepp/ui/uicompiledlayout.hpp>
+#include <eepp/ui/uiscenenode.hpp>
+#include <eepp/ui/uitextview.hpp>
+#include <eepp/ui/uiwidgetcreator.hpp>
+#include <eepp/window/engine.hpp>
+#include <pugixml/pugixml.hpp>
+
+using namespace EE;
+using namespace EE::UI;
+using namespace EE::UI::CSS;
+using namespace EE::Window;
+
+class XmlNodeWidget : public UIWidget {
+  public:
+	static UIWidget* New() { return eeNew( XmlNodeWidget, () ); }
+
+	void loadFromXmlNode( const pugi::xml_node& node ) override {
+		UIWidget::loadFromXmlNode( node );
+		loadedFromXml = true;
+	}
+
+	bool loadedFromXml{ false };
+};
+
+static const char* sLayout = R"xml(
+<vbox id="root" layout_width="match_parent" layout_height="wrap_content" class="a b">
+	<TextView id="title" layout_width="wrap_content" layout_height="wrap_content" />
+	<TextView id="label" layout_width="match_parent" layout_height="24dp">label</TextView>
+	<hbox id="row" layout_width="match_parent" layout_height="wrap_content">
+		<Widget id="box" layout_width="10dp" layout_height="20dp" />
+		<PushButton id="button" text="ok" />
+		<XmlNodeWidget id="custom" layout_width="30dp" layout_height="40dp" />
+	</hbox>
+	<style>#box { margin-left: 2dp; }</style>
+</vbox>
+)xml";
+
+static void expectSameWidget( int* utest_result, UIWidget* xml, UIWidget* compiled ) {
+	ASSERT_TRUE( xml != NULL && compiled != NULL );
+	EXPECT_STREQ( xml->getId().c_str(), compiled->getId().c_str() );
+	EXPECT_EQ( xml->getType(), compiled->getType() );
+	EXPECT_EQ( xml->getLayoutWidthPolicy(), compiled->getLayoutWidthPolicy() );
+	EXPECT_EQ( xml->getLayoutHeightPolicy(), compiled->getLayoutHeightPolicy() );
+	EXPECT_TRUE( xml->getSize() == compiled->getSize() );
+	EXPECT_TRUE( xml->getClasses() == compiled->getClasses() );
+
+	if ( xml->isType( UI_TYPE_TEXTVIEW ) ) {
+		EXPECT_TRUE( xml->asType<UITextView>()->getText() ==
+					 compiled->asType<UITextView>()->getText() );
+	}
+
+	Node* xmlChild = xml->getFirstChild();
+	Node* compiledChild = compiled->getFirstChild();
+	while ( xmlChild && compiledChild ) {
+		if ( xmlChild->isWidget() && compiledChild->isWidget() )
+			expectSameWidget( utest_result, xmlChild->asType<UIWidget>(),
+							  compiledChild->asType<UIWidget>() );
+		xmlChild = xmlChild->getNextNode();
+		compiledChild = compiledChild->getNextNode();
+	}
+	EXPECT_TRUE( xmlChild == NULL && compiledChild == NULL );
+}
+
+UTEST( UICompiledLayout, sameAsXml ) {
+	EE::Window::Window* win = Engine::instance()->createWindow(
+		WindowSettings( 320, 240, "eepp - unit tests" ), ContextSettings( false ) );
+
+	if ( NULL == win || !win->isOpen() ) {
+		Engine::destroySingleton();
+		UTEST_SKIP( "A window is required" );
+	}
+
+	UIWidgetCreator::registerWidget( "xmlnodewidget", XmlNodeWidget::New );
+
+	UISceneNode* sceneNode = UISceneNode::New( win );
+	UIWidget* xmlRoot = sceneNode->loadLayoutFromString( sLayout );
+
+	pugi::xml_document doc;
+	ASSERT_TRUE( doc.load_string( sLayout ) );
+	UICompiledLayout layout( UICompiledLayout::compile( doc.first_child() ) );
+	UIWidget* compiledRoot = sceneNode->loadLayoutFromCompiled( layout );
+
+	expectSameWidget( utest_result, xmlRoot, compiledRoot );
+
+	// Custom widgets always receive their XML node, even without text or children
+	auto* xmlCustom = xmlRoot->find<XmlNodeWidget>( "custom" );
+	auto* compiledCustom = compiledRoot->find<XmlNodeWidget>( "custom" );
+	ASSERT_TRUE( xmlCustom != NULL && compiledCustom != NULL );
+	EXPECT_TRUE( xmlCustom->loadedFromXml );
+	EXPECT_TRUE( compiledCustom->loadedFromXml );
+
+	UIWidgetCreator::unregisterWidget( "xmlnodewidget" );
+	eeDelete( sceneNode );
+	Engine::destroySingleton();
+}
+
+UTEST( UICompiledLayout, parsedProperties ) {
+	pugi::xml_document doc;
+	ASSERT_TRUE( doc.load_string(
+		R"xml(<vbox layout_width="match_parent" padding="4dp" not-a-property="1" />)xml" ) );
+	UICompiledLayout layout( UICompiledLayout::compile( doc.first_child() ) );
+	ASSERT_EQ( layout.getAttributes().size(), (size_t)3 );
+
+	const auto& width = layout.getProperties( 0 );
+	ASSERT_EQ( width.size(), (size_t)1 );
+	EXPECT_STREQ( width[0].getName().c_str(), "layout_width" );
+	EXPECT_STREQ( width[0].getValue().c_str(), "match_parent" );
+	EXPECT_TRUE( width[0].getPropertyDefinition() != NULL );
+	EXPECT_EQ( width[0].getSpecificity(), (Uint32)StyleSheetSelectorRule::SpecificityInline );
+
+	// The shorthands are expanded when compiled
+	const auto& padding = layout.getProperties( 1 );
+	ASSERT_EQ( padding.size(), (size_t)4 );
+	for ( const auto& property : padding )
+		EXPECT_TRUE( property.getPropertyDefinition() != NULL );
+
+	// Left for loadInlineAttribute
+	EXPECT_TRUE( layout.getProperties( 2 ).empty() );
+
+	// And parsed again when loaded
+	IOStreamString stream;
+	ASSERT_TRUE( layout.saveToStream( stream ) );
+	UICompiledLayout loaded;
+	ASSERT_TRUE( loaded.loadFromMemory( stream.getStreamPointer(), stream.getSize() ) );
+	ASSERT_EQ( loaded.getProperties( 1 ).size(), padding.size() );
+	for ( size_t i = 0; i < padding.size(); i++ )
+		EXPECT_TRUE( loaded.getProperties( 1 )[i] == padding[i] );
+}
@@ -218,30 +218,36 @@ queryReject(cpShape *a, cpShape *b)
 	);
 }
 
-// Callback from the spatial hash.
-void
-cpSpaceCollideShapes(cpShape *a, cpShape *b, cpSpace *space)
+// Rejects the pairs that can't collide and orders the shapes as cpCollideShapes() requires.
+// It doesn't modify the space, so it can be called from several threads.
+cpBool
+cpSpaceCollisionPair(cpSpace *space, cpShape **a, cpShape **b)
 {
 	// Reject any of the simple cases
-	if(queryReject(a,b)) return;
+	if(queryReject(*a,*b)) return cpFalse;
 	
-	cpCollisionHandler *handler = cpSpaceLookupHandler(space, a->collision_type, b->collision_type);
+	cpCollisionHandler *handler = cpSpaceLookupHandler(space, (*a)->collision_type, (*b)->collision_type);
 	
-	cpBool sensor = a->sensor || b->sensor;
-	if(sensor && handler == &cpDefaultCollisionHandler) return;
+	cpBool sensor = (*a)->sensor || (*b)->sensor;
+	if(sensor && handler == &cpDefaultCollisionHandler) return cpFalse;
 	
 	// Shape 'a' should have the lower shape type. (required by cpCollideShapes() )
-	if(a->klass->type > b->klass->type){
-		cpShape *temp = a;
-		a = b;
-		b = temp;
+	if((*a)->klass->type > (*b)->klass->type){
+		cpShape *temp = *a;
+		*a = *b;
+		*b = temp;
 	}
 	
-	// Narrow-phase collision detection.
-	cpContact *contacts = cpContactBufferGetArray(space);
-	int numContacts = cpCollideShapes(a, b, contacts);
-	if(!numContacts) return; // Shapes are not colliding.
-	cpSpacePushContacts(space, numContacts);
+	return cpTrue;
+}
+
+// Updates the arbiter of a pair accepted by cpSpaceCollisionPair() with the contacts found by
+// cpCollideShapes(), already pushed to the contact buffer.
+void
+cpSpaceCollideContacts(cpSpace *space, cpShape *a, cpShape *b, cpContact *contacts, int numContacts)
+{
+	cpCollisionHandler *handler = cpSpaceLookupHandler(space, a->collision_type, b->collision_type);
+	cpBool sensor = a->sensor || b->sensor;
 	
 	// Get an arbiter from space->arbiterSet for the two shapes.
 	// This is where the persistant contact magic comes from.
@@ -279,6 +285,21 @@ cpSpaceCollideShapes(cpShape *a, cpShape *b, cpSpace *space)
 	arb->stamp = space->stamp;
 }
 
+// Callback from the spatial hash.
+void
+cpSpaceCollideShapes(cpShape *a, cpShape *b, cpSpace *space)
+{
+	if(!cpSpaceCollisionPair(space, &a, &b)) return;
+	
+	// Narrow-phase collision detection.
+	cpContact *contacts = cpContactBufferGetArray(space);
+	int numContacts = cpCollideShapes(a, b, contacts);
+	if(!numContacts) return; // Shapes are not colliding.
+	cpSpacePushContacts(space, numContacts);
+	
+	cpSpaceCollideContacts(space, a, b, contacts, numContacts);
+}
+
 // Hashset filter func to throw away old arbiters.
 cpBool
 cpSpaceArbiterSetFilter(cpArbiter *arb, cpSpace *space)
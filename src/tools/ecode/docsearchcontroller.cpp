@@ -388,7 +388,7 @@ int DocSearchController::replaceAll( SearchState& search, const String& replace
 	}
 
 	int count = doc.replaceAll( txt, repl, search.caseSensitive, search.wholeWord, search.type,
-								search.range );
+								search.range, search.editor->getUISceneNode()->getThreadPool() );
 	doc.setSelection( startedPosition );
 	return count;
 }
@@ -672,6 +672,11 @@ bool App::loadConfig( const LogLevel& logLevel, const Sizeu& displaySize, bool s
 #endif
 
 	Log::instance()->setKeepLog( true );
+#if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN
+	// Most of the verbose logs come from worker threads ( LSP, linters, git ), they are written by
+	// the log flusher thread instead
+	Log::instance()->setAsync( true );
+#endif
 
 	if ( !mArgs.empty() ) {
 		std::string strargs( String::join( mArgs ) );
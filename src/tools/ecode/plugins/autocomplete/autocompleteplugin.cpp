@@ -10,6 +10,7 @@
 #include <eepp/ui/uieventdispatcher.hpp>
 #include <eepp/ui/uiscenenode.hpp>
 #include <nlohmann/json.hpp>
+#include <unordered_set>
 using namespace EE::Graphics;
 using namespace EE::System;
 using json = nlohmann::json;
@@ -46,10 +47,64 @@ static json getURIAndPositionJSON( UICodeEditor* editor ) {
 	return data;
 }
 
+Uint64 AutoCompletePlugin::SymbolIndex::getCharMask( const std::string& str ) {
+	// Same case folding and space skipping than String::fuzzyMatch.
+	Uint64 mask = 0;
+	for ( const auto& ch : str ) {
+		if ( ch != ' ' )
+			mask |= 1ULL << ( static_cast<unsigned char>( ch >= 'A' && ch <= 'Z' ? ch + 32 : ch ) %
+							  64 );
+	}
+	return mask;
+}
+
+void AutoCompletePlugin::SymbolIndex::add( const std::string& symbol, const Uint32& count ) {
+	auto it = positions.find( symbol );
+	if ( it != positions.end() ) {
+		counts[it->second] += count;
+		return;
+	}
+	positions[symbol] = symbols.size();
+	symbols.emplace_back( symbol );
+	masks.emplace_back( getCharMask( symbol ) );
+	counts.emplace_back( count );
+}
+
+void AutoCompletePlugin::SymbolIndex::remove( const std::string& symbol, const Uint32& count ) {
+	auto it = positions.find( symbol );
+	if ( it == positions.end() )
+		return;
+	size_t pos = it->second;
+	if ( counts[pos] > count ) {
+		counts[pos] -= count;
+		return;
+	}
+	positions.erase( it );
+	size_t last = symbols.size() - 1;
+	if ( pos != last ) {
+		symbols[pos] = std::move( symbols[last] );
+		masks[pos] = masks[last];
+		counts[pos] = counts[last];
+		positions[symbols[pos].text] = pos;
+	}
+	symbols.pop_back();
+	masks.pop_back();
+	counts.pop_back();
+}
+
+void AutoCompletePlugin::SymbolIndex::clear() {
+	symbols.clear();
+	masks.clear();
+	counts.clear();
+	positions.clear();
+}
+
 static AutoCompletePlugin::SymbolsList
 fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& symbolsVec,
-				   const std::string& match, const size_t& max ) {
+				   const AutoCompletePlugin::SymbolIndex* index, const std::string& match,
+				   const size_t& max ) {
 	AutoCompletePlugin::SymbolsList matches;
+	std::unordered_set<std::string_view> matched;
 	matches.reserve( max );
 	int score = 0;
 	for ( const auto& symbols : symbolsVec ) {
@@ -58,7 +113,7 @@ fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& sy
 				 ( score = String::fuzzyMatch( symbol.text, match, false,
 											   symbol.kind != LSPCompletionItemKind::Text ) ) >
 					 0 ) {
-				if ( std::find( matches.begin(), matches.end(), symbol ) == matches.end() ) {
+				if ( matched.insert( symbol.text ).second ) {
 					symbol.setScore( score );
 					matches.push_back( symbol );
 				}
@@ -69,6 +124,24 @@ fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& sy
 			break;
 	}
 
+	if ( nullptr != index && matches.size() <= max ) {
+		Uint64 matchMask = AutoCompletePlugin::SymbolIndex::getCharMask( match );
+		for ( size_t i = 0; i < index->symbols.size(); ++i ) {
+			// Skip the symbols missing any of the pattern characters.
+			if ( ( matchMask & ~index->masks[i] ) != 0 )
+				continue;
+			const auto& symbol = index->symbols[i];
+			// Ignore the symbol if its only occurrence is the symbol being written
+			if ( index->counts[i] <= 1 && symbol.text == match )
+				continue;
+			if ( ( score = String::fuzzyMatch( symbol.text, match, false, false ) ) > 0 &&
+				 matched.insert( symbol.text ).second ) {
+				symbol.setScore( score );
+				matches.push_back( symbol );
+			}
+		}
+	}
+
 	std::sort( matches.begin(), matches.end(),
 			   []( const AutoCompletePlugin::Suggestion& left,
 				   const AutoCompletePlugin::Suggestion& right ) {
@@ -260,7 +333,7 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 			const DocEvent* docEvent = static_cast<const DocEvent*>( event );
 			TextDocument* doc = docEvent->getDoc();
 			mDocs.erase( doc );
-			mDocCache.erase( doc );
+			removeDocCache( doc );
 			mDirty = true;
 		} ) );
 
@@ -270,7 +343,7 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 			TextDocument* newDoc = editor->getDocumentRef().get();
 			Lock l( mDocMutex );
 			mDocs.erase( oldDoc );
-			mDocCache.erase( oldDoc );
+			removeDocCache( oldDoc );
 			mEditorDocs[editor] = newDoc;
 			mDirty = true;
 		} ) );
@@ -333,7 +406,7 @@ void AutoCompletePlugin::onUnregister( UICodeEditor* editor ) {
 		if ( ceditor.second == doc )
 			return;
 	mDocs.erase( doc );
-	mDocCache.erase( doc );
+	removeDocCache( doc );
 	mDirty = true;
 }
 
@@ -554,51 +627,106 @@ void AutoCompletePlugin::updateDocCache( TextDocument* doc ) {
 		} );
 
 	Clock clock;
-	std::unordered_map<TextDocument*, DocCache>::iterator docCache;
+	std::shared_ptr<DocCache> cache;
 	{
 		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
+		auto docCache = mDocCache.find( doc );
 		if ( docCache == mDocCache.end() || mShuttingDown )
 			return;
+		cache = docCache->second;
 	}
 
+	// The cache index is only modified by this function, and the document is never updated
+	// concurrently, so it can be scanned without locking.
 	auto changeId = doc->getCurrentChangeId();
-	auto symbols = getDocumentSymbols( doc );
+	LineSymbolsIndex::Scan scan;
+
+	if ( !doc->isHuge() ) {
+		std::vector<LineSymbolsIndex::Line> lines;
+		lines.reserve( doc->linesCount() );
+		for ( size_t i = 0; i < doc->linesCount(); i++ ) {
+			const auto& line = doc->line( i );
+			lines.push_back( { &line.getText(), line.getHash() } );
+		}
+
+		if ( !cache->index.scan(
+				 lines,
+				 [this]( const String& line ) { return getLineSymbols( line.toUtf8() ); }, scan,
+				 [this] { return mShuttingDown.load(); } ) )
+			return;
+	}
 
+	std::string langName( doc->getSyntaxDefinition().getLanguageName() );
+	size_t changedLines = 0;
+	bool langChanged = false;
 	{
 		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
-		if ( docCache == mDocCache.end() || mShuttingDown )
+		auto docCache = mDocCache.find( doc );
+		if ( docCache == mDocCache.end() || docCache->second != cache || mShuttingDown )
 			return;
-		auto& cache = docCache->second;
-		cache.changeId = changeId;
-		cache.symbols = std::move( symbols );
+
+		Lock l2( mLangSymbolsMutex );
+		auto& lang = mLangCache[cache->lang];
+
+		changedLines = cache->index.apply(
+			std::move( scan ), [&lang]( const std::string& symbol, Int64 delta ) {
+				if ( delta > 0 ) {
+					lang.add( symbol, delta );
+				} else {
+					lang.remove( symbol, -delta );
+				}
+			} );
+
+		cache->changeId = changeId;
+		langChanged = cache->lang != langName;
 	}
 
-	std::string langName( doc->getSyntaxDefinition().getLanguageName() );
+	if ( langChanged )
+		updateLangCache( langName );
+
+	Log::debug( "Dictionary for %s updated in: %.2fms (%zu lines changed)",
+				doc->getFilename().c_str(), clock.getElapsedTime().asMilliseconds(),
+				changedLines );
+}
+
+void AutoCompletePlugin::removeDocCache( TextDocument* doc ) {
+	auto docCache = mDocCache.find( doc );
+	if ( docCache == mDocCache.end() )
+		return;
 	{
 		Lock l( mLangSymbolsMutex );
-		auto& lang = mLangCache[langName];
-		lang.clear();
-		Lock l2( mDocMutex );
-		for ( const auto& d : mDocCache ) {
-			if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-				lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
+		auto& cache = docCache->second;
+		auto lang = mLangCache.find( cache->lang );
+		if ( lang != mLangCache.end() ) {
+			for ( const auto& symbol : cache->index.getSymbols() )
+				lang->second.remove( symbol.first, symbol.second );
 		}
 	}
-	Log::debug( "Dictionary for %s updated in: %.2fms", doc->getFilename().c_str(),
-				clock.getElapsedTime().asMilliseconds() );
+	mDocCache.erase( docCache );
 }
 
 void AutoCompletePlugin::updateLangCache( const std::string& langName ) {
 	Clock clock;
-	Lock l( mLangSymbolsMutex );
-	Lock l2( mDocMutex );
-	auto& lang = mLangCache[langName];
-	lang.clear();
+	Lock l( mDocMutex );
+	Lock l2( mLangSymbolsMutex );
+	std::set<std::string> langs{ langName };
+	// Documents that changed its language are moved to the new language index.
 	for ( const auto& d : mDocCache ) {
-		if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-			lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
+		if ( d.second->lang != langName &&
+			 d.first->getSyntaxDefinition().getLanguageName() == langName ) {
+			langs.insert( d.second->lang );
+			d.second->lang = langName;
+		}
+	}
+	for ( const auto& name : langs ) {
+		auto& lang = mLangCache[name];
+		lang.clear();
+		for ( const auto& d : mDocCache ) {
+			if ( d.second->lang == name ) {
+				for ( const auto& symbol : d.second->index.getSymbols() )
+					lang.add( symbol.first, symbol.second );
+			}
+		}
 	}
 	Log::debug( "Lang dictionary for %s updated in: %.2fms", langName.c_str(),
 				clock.getElapsedTime().asMilliseconds() );
@@ -790,7 +918,7 @@ AutoCompletePlugin::processCodeCompletion( const LSPCompletionList& completion )
 		{
 			Lock l2( mLangSymbolsMutex );
 			auto& symbols = mLangCache[lang];
-			fuzzySuggestions = fuzzyMatchSymbols( { &suggestions, &symbols }, symbol,
+			fuzzySuggestions = fuzzyMatchSymbols( { &suggestions }, &symbols, symbol,
 												  eemax<size_t>( 100UL, suggestions.size() ) );
 		}
 
@@ -903,7 +1031,12 @@ void AutoCompletePlugin::update( UICodeEditor* ) {
 		mDirty = false;
 		Lock l( mDocMutex );
 		for ( auto& doc : mDocs ) {
-			if ( !doc->isLoading() && mDocCache[doc].changeId != doc->getCurrentChangeId() ) {
+			auto& cache = mDocCache[doc];
+			if ( !cache ) {
+				cache = std::make_shared<DocCache>();
+				cache->lang = doc->getSyntaxDefinition().getLanguageName();
+			}
+			if ( !doc->isLoading() && cache->changeId != doc->getCurrentChangeId() ) {
 				{
 					Lock lu( mDocsUpdatingMutex );
 					auto du = mDocsUpdating.find( doc );
@@ -1300,34 +1433,20 @@ void AutoCompletePlugin::resetSignatureHelp() {
 	mSignatureHelpEditor = nullptr;
 }
 
-AutoCompletePlugin::SymbolsList AutoCompletePlugin::getDocumentSymbols( TextDocument* doc ) {
+std::vector<std::string> AutoCompletePlugin::getLineSymbols( const std::string& line ) {
 	LuaPattern pattern( mSymbolPattern );
-	AutoCompletePlugin::SymbolsList symbols;
-	if ( doc->linesCount() == 0 || doc->isHuge() || mShuttingDown )
-		return symbols;
-	std::string current( getPartialSymbol( doc ) );
-	TextPosition end = doc->getSelection().end();
-	for ( Int64 i = 0; i < static_cast<Int64>( doc->linesCount() ); i++ ) {
-		auto string = doc->line( i ).toUtf8();
-		for ( auto& match : pattern.gmatch( string ) ) {
-			std::string matchStr( match[0] );
-			// Ignore the symbol if is actually the current symbol being written
-			if ( matchStr.size() < 3 || ( end.line() == i && current == matchStr ) )
-				continue;
-			if ( std::none_of( symbols.begin(), symbols.end(),
-							   [matchStr]( const Suggestion& suggestion ) {
-								   return suggestion.text == matchStr;
-							   } ) )
-				symbols.push_back( std::move( matchStr ) );
-		}
-		if ( mShuttingDown )
-			break;
+	std::vector<std::string> symbols;
+	for ( auto& match : pattern.gmatch( line ) ) {
+		std::string matchStr( match[0] );
+		if ( matchStr.size() >= 3 &&
+			 std::find( symbols.begin(), symbols.end(), matchStr ) == symbols.end() )
+			symbols.emplace_back( std::move( matchStr ) );
 	}
 	return symbols;
 }
 
 void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
-											   const SymbolsList& symbols, UICodeEditor* editor ) {
+											   const SymbolIndex& symbols, UICodeEditor* editor ) {
 	{
 		{
 			Lock l( mSuggestionsEditorMutex );
@@ -1339,7 +1458,7 @@ void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
 			return;
 		Lock l( mLangSymbolsMutex );
 		Lock l2( mSuggestionsMutex );
-		mSuggestions = fuzzyMatchSymbols( { &symbols }, symbol, mSuggestionsMaxVisible );
+		mSuggestions = fuzzyMatchSymbols( {}, &symbols, symbol, mSuggestionsMaxVisible );
 	}
 	editor->runOnMainThread( [editor] { editor->invalidateDraw(); } );
 }
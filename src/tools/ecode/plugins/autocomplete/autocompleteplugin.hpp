@@ -4,6 +4,7 @@
 #include "../lsp/lspprotocol.hpp"
 #include "../plugin.hpp"
 #include "../pluginmanager.hpp"
+#include "linesymbolsindex.hpp"
 #include <eepp/config.hpp>
 #include <eepp/system/clock.hpp>
 #include <eepp/system/mutex.hpp>
@@ -57,6 +58,26 @@ class AutoCompletePlugin : public Plugin {
 	};
 	typedef std::vector<Suggestion> SymbolsList;
 
+	/** Ref-counted set of symbols, with a character signature per symbol used to discard the
+	 * symbols that can't fuzzy match a pattern. */
+	class SymbolIndex {
+	  public:
+		static Uint64 getCharMask( const std::string& str );
+
+		void add( const std::string& symbol, const Uint32& count = 1 );
+
+		void remove( const std::string& symbol, const Uint32& count = 1 );
+
+		void clear();
+
+		bool empty() const { return symbols.empty(); }
+
+		SymbolsList symbols;
+		std::vector<Uint64> masks;
+		std::vector<Uint32> counts;
+		std::unordered_map<std::string, size_t> positions;
+	};
+
 	static PluginDefinition Definition() {
 		return { "autocomplete",
 				 "Auto Complete",
@@ -130,10 +151,11 @@ class AutoCompletePlugin : public Plugin {
 	bool mHighlightSuggestions{ false };
 	struct DocCache {
 		Uint64 changeId{ static_cast<Uint64>( -1 ) };
-		SymbolsList symbols;
+		std::string lang;
+		LineSymbolsIndex index;
 	};
-	std::unordered_map<TextDocument*, DocCache> mDocCache;
-	std::unordered_map<std::string, SymbolsList> mLangCache;
+	std::unordered_map<TextDocument*, std::shared_ptr<DocCache>> mDocCache;
+	std::unordered_map<std::string, SymbolIndex> mLangCache;
 	std::vector<Suggestion> mSuggestions;
 	Mutex mSuggestionsEditorMutex;
 	Mutex mSignatureHelpEditorMutex;
@@ -168,13 +190,15 @@ class AutoCompletePlugin : public Plugin {
 
 	void updateSuggestions( const std::string& symbol, UICodeEditor* editor );
 
-	SymbolsList getDocumentSymbols( TextDocument* );
+	std::vector<std::string> getLineSymbols( const std::string& line );
 
 	void updateDocCache( TextDocument* doc );
 
+	void removeDocCache( TextDocument* doc );
+
 	std::string getPartialSymbol( TextDocument* doc );
 
-	void runUpdateSuggestions( const std::string& symbol, const SymbolsList& symbols,
+	void runUpdateSuggestions( const std::string& symbol, const SymbolIndex& symbols,
 							   UICodeEditor* editor );
 
 	void updateLangCache( const std::string& langName );
@@ -0,0 +1,110 @@
+#include "linesymbolsindex.hpp"
+#include <algorithm>
+
+namespace ecode {
+
+template <typename Lines>
+static auto findLine( Lines& lines, const LineSymbolsIndex::Line& line )
+	-> decltype( &lines.begin()->second.front() ) {
+	auto bucket = lines.find( line.hash );
+	if ( bucket == lines.end() )
+		return nullptr;
+	// Different lines can share a hash, the text decides.
+	for ( auto& indexed : bucket->second ) {
+		if ( indexed.text == *line.text )
+			return &indexed;
+	}
+	return nullptr;
+}
+
+bool LineSymbolsIndex::scan( const std::vector<Line>& lines, const GetSymbolsFn& getSymbols,
+							 Scan& scan, const std::function<bool()>& cancelled ) const {
+	for ( const auto& line : lines ) {
+		if ( const IndexedLine* indexed = findLine( mLines, line ) ) {
+			scan.mCounts[indexed]++;
+		} else if ( IndexedLine* newLine = findLine( scan.mNewLines, line ) ) {
+			newLine->count++;
+		} else {
+			if ( cancelled && cancelled() )
+				return false;
+			scan.mNewLines[line.hash].push_back( { *line.text, getSymbols( *line.text ), 1 } );
+		}
+	}
+
+	return true;
+}
+
+size_t LineSymbolsIndex::apply( Scan&& scan, const SymbolDeltaFn& onSymbolDelta ) {
+	size_t changedLines = 0;
+
+	for ( auto bucket = mLines.begin(); bucket != mLines.end(); ) {
+		auto& lines = bucket->second;
+
+		for ( auto& line : lines ) {
+			auto count = scan.mCounts.find( &line );
+			Uint32 newCount = count != scan.mCounts.end() ? count->second : 0;
+			if ( newCount == line.count )
+				continue;
+			addSymbols( line.symbols, static_cast<Int64>( newCount ) - line.count,
+						onSymbolDelta );
+			line.count = newCount;
+			changedLines++;
+		}
+
+		size_t linesCount = lines.size();
+		lines.erase( std::remove_if( lines.begin(), lines.end(),
+									 []( const IndexedLine& line ) { return line.count == 0; } ),
+					 lines.end() );
+		mLinesCount -= linesCount - lines.size();
+
+		if ( lines.empty() ) {
+			bucket = mLines.erase( bucket );
+		} else {
+			++bucket;
+		}
+	}
+
+	for ( auto& bucket : scan.mNewLines ) {
+		auto& lines = mLines[bucket.first];
+		for ( auto& line : bucket.second ) {
+			addSymbols( line.symbols, line.count, onSymbolDelta );
+			lines.emplace_back( std::move( line ) );
+			mLinesCount++;
+			changedLines++;
+		}
+	}
+
+	scan.mCounts.clear();
+	scan.mNewLines.clear();
+
+	return changedLines;
+}
+
+const std::unordered_map<std::string, Uint32>& LineSymbolsIndex::getSymbols() const {
+	return mSymbols;
+}
+
+size_t LineSymbolsIndex::getLinesCount() const {
+	return mLinesCount;
+}
+
+void LineSymbolsIndex::addSymbols( const std::vector<std::string>& symbols, Int64 delta,
+								   const SymbolDeltaFn& onSymbolDelta ) {
+	for ( const auto& symbol : symbols ) {
+		if ( delta > 0 ) {
+			mSymbols[symbol] += delta;
+		} else {
+			auto symbolIt = mSymbols.find( symbol );
+			if ( symbolIt != mSymbols.end() ) {
+				symbolIt->second -= eemin<Uint32>( symbolIt->second, -delta );
+				if ( symbolIt->second == 0 )
+					mSymbols.erase( symbolIt );
+			}
+		}
+
+		if ( onSymbolDelta )
+			onSymbolDelta( symbol, delta );
+	}
+}
+
+} // namespace ecode
@@ -0,0 +1,74 @@
+#ifndef ECODE_LINESYMBOLSINDEX_HPP
+#define ECODE_LINESYMBOLSINDEX_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/string.hpp>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace EE;
+
+namespace ecode {
+
+/** Counts the symbols of a document incrementally. Lines are indexed by their text ( bucketed by
+ * the line hash ), so only new or modified lines are scanned again, and identical lines share
+ * their symbols. */
+class LineSymbolsIndex {
+  public:
+	struct Line {
+		const String* text;
+		String::HashType hash;
+	};
+
+	using GetSymbolsFn = std::function<std::vector<std::string>( const String& line )>;
+
+	/** Called for every symbol whose count changed, with the count difference */
+	using SymbolDeltaFn = std::function<void( const std::string& symbol, Int64 delta )>;
+
+	/** The line counts of a document, produced by scan() and consumed by apply() */
+	class Scan;
+
+	/** Counts the document lines and extracts the symbols of the lines not indexed yet. It only
+	 * reads the index, so it can run while the symbols are being read from other threads.
+	 * @return False if it was cancelled */
+	bool scan( const std::vector<Line>& lines, const GetSymbolsFn& getSymbols, Scan& scan,
+			   const std::function<bool()>& cancelled = nullptr ) const;
+
+	/** Replaces the indexed document with the scanned one.
+	 * @return The number of distinct lines whose count changed */
+	size_t apply( Scan&& scan, const SymbolDeltaFn& onSymbolDelta = nullptr );
+
+	/** @return The symbols of the document and the number of lines containing each one */
+	const std::unordered_map<std::string, Uint32>& getSymbols() const;
+
+	/** @return The number of distinct lines indexed */
+	size_t getLinesCount() const;
+
+  protected:
+	struct IndexedLine {
+		String text;
+		std::vector<std::string> symbols;
+		Uint32 count{ 0 };
+	};
+
+	std::unordered_map<String::HashType, std::vector<IndexedLine>> mLines;
+	std::unordered_map<std::string, Uint32> mSymbols;
+	size_t mLinesCount{ 0 };
+
+	void addSymbols( const std::vector<std::string>& symbols, Int64 delta,
+					 const SymbolDeltaFn& onSymbolDelta );
+};
+
+class LineSymbolsIndex::Scan {
+  protected:
+	friend class LineSymbolsIndex;
+
+	std::unordered_map<const IndexedLine*, Uint32> mCounts;
+	std::unordered_map<String::HashType, std::vector<IndexedLine>> mNewLines;
+};
+
+} // namespace ecode
+
+#endif // ECODE_LINESYMBOLSINDEX_HPP
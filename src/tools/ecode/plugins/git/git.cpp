@@ -246,6 +246,13 @@ Git::Result Git::diff( const std::string& file, bool isStaged, const std::string
 					  projectDir );
 }
 
+Git::Result Git::showFile( const std::string& filePath, const std::string& revision ) {
+	// Resolved from the file folder, so it also works for the files inside submodules
+	return gitSimple(
+		String::format( "show \"%s:./%s\"", revision, FileSystem::fileNameFromPath( filePath ) ),
+		FileSystem::fileRemoveFileName( filePath ) );
+}
+
 Git::Result Git::createBranch( const std::string& branchName, bool _checkout,
 							   const std::string& projectDir ) {
 	auto res = gitSimple( String::format( "branch --no-track %s", branchName ), projectDir );
@@ -548,9 +555,18 @@ Git::Result Git::gitSimple( const std::string& cmd, const std::string& projectDi
 }
 
 Git::Status Git::status( bool recurseSubmodules, const std::string& projectDir ) {
-	static constexpr auto DIFF_CMD = "diff --numstat";
-	static constexpr auto DIFF_STAGED_CMD = "diff --numstat --staged";
-	static constexpr auto STATUS_CMD = "-c color.status=never status -b -u -s";
+	return status( recurseSubmodules, {}, projectDir );
+}
+
+Git::Status Git::status( bool recurseSubmodules, std::vector<std::string> pathspecs,
+						 const std::string& projectDir ) {
+	// Paths are not globs, and submodules are not recursed when restricting the status
+	std::string options( pathspecs.empty() ? "" : "--literal-pathspecs " );
+	std::string pathspec( pathspecs.empty() ? "" : " -- " + asList( pathspecs ) );
+	recurseSubmodules = recurseSubmodules && pathspec.empty();
+	const std::string DIFF_CMD = options + "diff --numstat" + pathspec;
+	const std::string DIFF_STAGED_CMD = options + "diff --numstat --staged" + pathspec;
+	const std::string STATUS_CMD = options + "-c color.status=never status -b -u -s" + pathspec;
 	Status s;
 	std::string buf;
 
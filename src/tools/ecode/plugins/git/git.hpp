@@ -250,6 +250,10 @@ class Git {
 
 	Status status( bool recurseSubmodules, const std::string& projectDir = "" );
 
+	/** Status restricted to the paths ( relative to the project directory ). */
+	Status status( bool recurseSubmodules, std::vector<std::string> pathspecs,
+				   const std::string& projectDir = "" );
+
 	Result add( std::vector<std::string> files, const std::string& projectDir = "" );
 
 	Result stash( std::vector<std::string> files, const std::string& projectDir = "" );
@@ -264,6 +268,9 @@ class Git {
 
 	Result diff( const std::string& file, bool isStaged, const std::string& projectDir = "" );
 
+	/** @return The contents of the file ( absolute path ) at the revision */
+	Result showFile( const std::string& filePath, const std::string& revision = "HEAD" );
+
 	Result createBranch( const std::string& branchName, bool checkout = false,
 						 const std::string& projectDir = "" );
 
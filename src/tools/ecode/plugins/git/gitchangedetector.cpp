@@ -0,0 +1,173 @@
+#include "gitchangedetector.hpp"
+#include <algorithm>
+#include <cctype>
+#include <eepp/core/string.hpp>
+#include <eepp/system/fileinfo.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/lock.hpp>
+
+namespace ecode {
+
+void GitChangeDetector::reset( const std::string& projectPath, const std::string& gitFolder ) {
+	Lock l( mMutex );
+	mProjectPath = projectPath;
+	mGitFolder = gitFolder;
+	if ( !mGitFolder.empty() )
+		FileSystem::dirAddSlashAtEnd( mGitFolder );
+	mPaths.clear();
+	mFull = true;
+	mRefs = true;
+	mSignature.clear();
+}
+
+bool GitChangeDetector::onFileEvent( const std::string& path ) {
+	Lock l( mMutex );
+
+	if ( !mGitFolder.empty() && String::startsWith( path, mGitFolder ) ) {
+		std::string gitPath( path.substr( mGitFolder.size() ) );
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		String::replaceAll( gitPath, "\\", "/" );
+#endif
+		if ( FileSystem::fileExtension( gitPath ) == "lock" )
+			return false;
+
+		// The remote branches and tags don't modify the status
+		if ( String::startsWith( gitPath, "refs/remotes/" ) ||
+			 String::startsWith( gitPath, "refs/tags/" ) || gitPath == "packed-refs" ) {
+			mRefs = true;
+			return true;
+		}
+
+		if ( String::startsWith( gitPath, "refs/" ) || String::endsWith( gitPath, "HEAD" ) ) {
+			mRefs = true;
+			mFull = true;
+			return true;
+		}
+
+		// Also the index of the submodules ( "modules/<name>/index" )
+		if ( gitPath == "index" || String::endsWith( gitPath, "/index" ) ) {
+			mFull = true;
+			return true;
+		}
+
+		// objects, logs, FETCH_HEAD, COMMIT_EDITMSG...
+		return false;
+	}
+
+	if ( mProjectPath.empty() || !String::startsWith( path, mProjectPath ) )
+		return false;
+
+	if ( mFull )
+		return true;
+
+	std::string relPath( path.substr( mProjectPath.size() ) );
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	String::replaceAll( relPath, "\\", "/" );
+#endif
+	if ( relPath.empty() )
+		return false;
+
+	mPaths.insert( std::move( relPath ) );
+
+	if ( mPaths.size() > MAX_PATHSPECS ) {
+		mPaths.clear();
+		mFull = true;
+	}
+
+	return true;
+}
+
+void GitChangeDetector::invalidate() {
+	Lock l( mMutex );
+	mFull = true;
+}
+
+GitChangeDetector::Changes GitChangeDetector::takeChanges() {
+	Lock l( mMutex );
+	Changes changes;
+
+	std::string signature( gitStateSignature() );
+	if ( signature != mSignature ) {
+		mSignature = std::move( signature );
+		mFull = true;
+		mRefs = true;
+	}
+
+	changes.full = mFull;
+	changes.refs = mRefs;
+	if ( !mFull )
+		changes.paths.assign( mPaths.begin(), mPaths.end() );
+
+	mPaths.clear();
+	mFull = false;
+	mRefs = false;
+	return changes;
+}
+
+bool GitChangeDetector::isInPathspecs( const std::string& file,
+									   const std::vector<std::string>& paths ) {
+	for ( const auto& path : paths ) {
+		if ( !path.empty() && String::startsWith( file, path ) &&
+			 ( file.size() == path.size() || path.back() == '/' || file[path.size()] == '/' ) )
+			return true;
+	}
+	return false;
+}
+
+void GitChangeDetector::mergeStatus( Git::Status& status, Git::Status&& pathsStatus,
+									 const std::vector<std::string>& paths ) {
+	for ( auto it = status.files.begin(); it != status.files.end(); ) {
+		auto& files = it->second;
+		files.erase( std::remove_if( files.begin(), files.end(),
+									 [&paths]( const Git::DiffFile& file ) {
+										 return isInPathspecs( file.file, paths );
+									 } ),
+					 files.end() );
+		it = files.empty() ? status.files.erase( it ) : std::next( it );
+	}
+
+	for ( auto& [repo, files] : pathsStatus.files ) {
+		auto& repoFiles = status.files[repo];
+		repoFiles.insert( repoFiles.end(), std::make_move_iterator( files.begin() ),
+						  std::make_move_iterator( files.end() ) );
+		std::stable_sort( repoFiles.begin(), repoFiles.end(),
+						  []( const Git::DiffFile& a, const Git::DiffFile& b ) {
+							  return a.file < b.file;
+						  } );
+	}
+
+	status.totalInserts = 0;
+	status.totalDeletions = 0;
+	for ( const auto& [_, files] : status.files ) {
+		for ( const auto& file : files ) {
+			status.totalInserts += file.inserts;
+			status.totalDeletions += file.deletes;
+		}
+	}
+}
+
+std::string GitChangeDetector::gitStateSignature() const {
+	// A .git file ( worktrees ) points to another folder, the events are the only source then
+	if ( mGitFolder.empty() || !FileSystem::isDirectory( mGitFolder ) )
+		return "";
+
+	std::vector<std::string> files{ "index", "HEAD", "packed-refs" };
+	std::string head;
+	if ( FileSystem::fileGet( mGitFolder + "HEAD", head ) && String::startsWith( head, "ref: " ) ) {
+		std::string ref( head.substr( 5 ) );
+		while ( !ref.empty() && std::isspace( (unsigned char)ref.back() ) )
+			ref.pop_back();
+		files.emplace_back( std::move( ref ) );
+	}
+
+	std::string signature;
+	for ( const auto& file : files ) {
+		FileInfo info( mGitFolder + file );
+		signature += String::format( "%s:%llu:%llu;", file.c_str(),
+									 (unsigned long long)info.getModificationTime(),
+									 (unsigned long long)info.getSize() );
+	}
+	return signature;
+}
+
+} // namespace ecode
@@ -0,0 +1,70 @@
+#ifndef ECODE_GITCHANGEDETECTOR_HPP
+#define ECODE_GITCHANGEDETECTOR_HPP
+
+#include "git.hpp"
+#include <eepp/config.hpp>
+#include <eepp/system/mutex.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace EE;
+using namespace EE::System;
+
+namespace ecode {
+
+/** Accumulates the file system events that can change the git status of a repository, so the
+ * status is only refreshed when something relevant changed, and only for the changed paths when
+ * the index and HEAD didn't change. */
+class GitChangeDetector {
+  public:
+	struct Changes {
+		/** The index, HEAD or the current branch changed, the whole status must be refreshed */
+		bool full{ false };
+		/** Any reference changed, the branches must be refreshed */
+		bool refs{ false };
+		/** Working tree paths ( relative to the project path ) that changed */
+		std::vector<std::string> paths;
+
+		bool empty() const { return !full && !refs && paths.empty(); }
+	};
+
+	/** Working tree paths accumulated before falling back to a full status */
+	static constexpr size_t MAX_PATHSPECS = 128;
+
+	void reset( const std::string& projectPath, const std::string& gitFolder );
+
+	/** @return True if the event can change the status or the branches. */
+	bool onFileEvent( const std::string& path );
+
+	/** Forces a full refresh on the next takeChanges. */
+	void invalidate();
+
+	/** @return The changes accumulated since the last call. The index and HEAD are also checked,
+	 * in case their events were not reported. */
+	Changes takeChanges();
+
+	/** @return True if the file is one of the paths or is inside one of them. */
+	static bool isInPathspecs( const std::string& file, const std::vector<std::string>& paths );
+
+	/** Replaces the status of the paths with their updated status. The git commands run in the
+	 * project path ( the repository root ), so the status files and the paths are both relative
+	 * to it. */
+	static void mergeStatus( Git::Status& status, Git::Status&& pathsStatus,
+							 const std::vector<std::string>& paths );
+
+  protected:
+	Mutex mMutex;
+	std::string mProjectPath;
+	std::string mGitFolder;
+	std::set<std::string> mPaths;
+	bool mFull{ true };
+	bool mRefs{ true };
+	std::string mSignature;
+
+	std::string gitStateSignature() const;
+};
+
+} // namespace ecode
+
+#endif
@@ -187,6 +187,13 @@ void GitPlugin::load( PluginManager* pluginManager ) {
 			updateConfigFile = true;
 		}
 
+		if ( config.contains( "editor_gutter_changes" ) )
+			mEditorGutterChanges = config.value( "editor_gutter_changes", true );
+		else {
+			config["editor_gutter_changes"] = mEditorGutterChanges;
+			updateConfigFile = true;
+		}
+
 		if ( config.contains( "silent" ) )
 			mSilence = config.value( "silent", true );
 		else {
@@ -197,11 +204,13 @@ void GitPlugin::load( PluginManager* pluginManager ) {
 
 	if ( mKeyBindings.empty() ) {
 		mKeyBindings["git-blame"] = "alt+shift+b";
+		mKeyBindings["git-next-change"] = "alt+f5";
+		mKeyBindings["git-prev-change"] = "alt+shift+f5";
 	}
 
 	if ( j.contains( "keybindings" ) ) {
 		auto& kb = j["keybindings"];
-		auto list = { "git-blame" };
+		auto list = { "git-blame", "git-next-change", "git-prev-change" };
 		for ( const auto& key : list ) {
 			if ( kb.contains( key ) ) {
 				if ( !kb[key].empty() )
@@ -225,6 +234,7 @@ void GitPlugin::load( PluginManager* pluginManager ) {
 	mGit->setLogLevel( mSilence ? LogLevel::Warning : LogLevel::Info );
 	mGitFound = !mGit->getGitPath().empty();
 	mProjectPath = mRepoSelected = mGit->getProjectPath();
+	mChangeDetector.reset( mGit->getProjectPath(), mGit->getGitFolder() );
 
 	if ( getUISceneNode() ) {
 		initModelStyler();
@@ -301,7 +311,8 @@ void GitPlugin::updateUI() {
 	if ( !mGit || !getUISceneNode() )
 		return;
 
-	getUISceneNode()->debounce( [this] { updateUINow(); }, mRefreshFreq, GIT_STATUS_UPDATE_TAG );
+	// The branches are updated by updateStatus when the references changed
+	getUISceneNode()->debounce( [this] { updateStatus(); }, mRefreshFreq, GIT_STATUS_UPDATE_TAG );
 }
 
 void GitPlugin::updateStatusBarSync() {
@@ -396,8 +407,19 @@ void GitPlugin::updateStatusBarSync() {
 }
 
 void GitPlugin::updateStatus( bool force ) {
-	if ( !mGit || !mGitFound || mRunningUpdateStatus )
+	if ( !mGit || !mGitFound )
 		return;
+
+	if ( force )
+		mChangeDetector.invalidate();
+
+	if ( mRunningUpdateStatus ) {
+		// The changes are kept by the detector until the next update
+		if ( getUISceneNode() )
+			updateUI();
+		return;
+	}
+
 	mRunningUpdateStatus++;
 	mThreadPool->run(
 		[this, force] {
@@ -406,13 +428,35 @@ void GitPlugin::updateStatus( bool force ) {
 				return;
 			}
 
+			auto changes = mChangeDetector.takeChanges();
+
+			// Operations update the branches by themselves
+			if ( changes.refs && !force )
+				updateBranches();
+
+			// HEAD might point to another commit
+			if ( changes.refs )
+				updateDocumentsBases();
+
+			if ( !changes.full && changes.paths.empty() )
+				return;
+
 			auto prevBranch = updateReposBranches();
 			Git::Status prevGitStatus;
 			{
 				Lock l( mGitStatusMutex );
 				prevGitStatus = mGitStatus;
 			}
-			Git::Status newGitStatus = mGit->status( mStatusRecurseSubmodules );
+
+			Git::Status newGitStatus;
+			if ( changes.full || mGit->hasSubmodules( mGit->getProjectPath() ) ) {
+				newGitStatus = mGit->status( mStatusRecurseSubmodules );
+			} else {
+				newGitStatus = prevGitStatus;
+				GitChangeDetector::mergeStatus(
+					newGitStatus, mGit->status( mStatusRecurseSubmodules, changes.paths ),
+					changes.paths );
+			}
 			UnorderedSet<std::string> cache;
 
 			for ( const auto& status : newGitStatus.files ) {
@@ -450,6 +494,7 @@ PluginRequestHandle GitPlugin::processMessage( const PluginMessage& msg ) {
 		case PluginMessageType::WorkspaceFolderChanged: {
 			if ( mGit ) {
 				mGit->setProjectPath( msg.asJSON()["folder"] );
+				mChangeDetector.reset( mGit->getProjectPath(), mGit->getGitFolder() );
 
 				{
 					Lock l( mGitBranchMutex );
@@ -491,6 +536,7 @@ PluginRequestHandle GitPlugin::processMessage( const PluginMessage& msg ) {
 		}
 		case ecode::PluginMessageType::UIThemeReloaded: {
 			mStatusCustomTokenizer.reset();
+			mGutterColorsLoaded = false;
 			updateUINow( true );
 			break;
 		}
@@ -509,15 +555,8 @@ void GitPlugin::onFileSystemEvent( const FileEvent& ev, const FileInfo& file ) {
 	if ( file.isDirectory() )
 		return;
 
-	auto inGitFolder = file.getFilepath().find( "/.git/" ) != std::string::npos;
-#if EE_PLATFORM == EE_PLATFORM_WIN
-	inGitFolder |= file.getFilepath().find( "\\.git\\" ) != std::string::npos;
-#endif
-
-	if ( inGitFolder && file.getExtension() == "lock" )
-		return;
-
-	updateUI();
+	if ( mChangeDetector.onFileEvent( file.getFilepath() ) )
+		updateUI();
 }
 
 void GitPlugin::displayTooltip( UICodeEditor* editor, const Git::Blame& blame,
@@ -629,6 +668,112 @@ void GitPlugin::onBeforeUnregister( UICodeEditor* editor ) {
 void GitPlugin::onUnregisterDocument( TextDocument* doc ) {
 	for ( auto& kb : mKeyBindings )
 		doc->removeCommand( kb.first );
+	mDocDiffs.erase( doc );
+}
+
+void GitPlugin::onRegisterDocument( TextDocument* doc ) {
+	if ( !mEditorGutterChanges )
+		return;
+	mDocDiffs[doc] = std::make_unique<TextDocumentDiff>( doc );
+	updateDocumentBase( doc );
+}
+
+void GitPlugin::onDocumentLoaded( TextDocument* doc ) {
+	if ( mDocDiffs.find( doc ) == mDocDiffs.end() )
+		onRegisterDocument( doc );
+	else
+		updateDocumentBase( doc );
+}
+
+void GitPlugin::onDocumentChanged( UICodeEditor* editor, TextDocument* ) {
+	if ( mDocDiffs.find( editor->getDocumentRef().get() ) == mDocDiffs.end() )
+		onRegisterDocument( editor->getDocumentRef().get() );
+}
+
+void GitPlugin::updateDocumentBase( TextDocument* doc ) {
+	if ( !mGitFound || !doc->hasFilepath() || mDocDiffs.find( doc ) == mDocDiffs.end() )
+		return;
+	std::string path( doc->getFilePath() );
+	mThreadPool->run( [this, doc, path] {
+		// Only fetched when the file is opened or HEAD changes, the edits are diffed in-process
+		auto res = mGit->showFile( path );
+		std::optional<TextDocumentDiff::Lines> base;
+		if ( res.success() )
+			base = TextDocumentDiff::Lines( res.result );
+		getUISceneNode()->runOnMainThread( [this, doc, path, base = std::move( base )]() mutable {
+			auto found = mDocDiffs.find( doc );
+			if ( found == mDocDiffs.end() || doc->getFilePath() != path )
+				return;
+			if ( base )
+				found->second->setBase( std::move( *base ) );
+			else
+				found->second->clearBase();
+			for ( auto& editor : mEditors ) {
+				if ( editor.first->getDocumentRef().get() == doc )
+					editor.first->invalidateDraw();
+			}
+		} );
+	} );
+}
+
+void GitPlugin::updateDocumentsBases() {
+	if ( !getUISceneNode() )
+		return;
+	getUISceneNode()->runOnMainThread( [this] {
+		for ( auto& docDiff : mDocDiffs )
+			updateDocumentBase( docDiff.first );
+	} );
+}
+
+void GitPlugin::goToChange( UICodeEditor* editor, bool next ) {
+	auto found = mDocDiffs.find( editor->getDocumentRef().get() );
+	if ( found == mDocDiffs.end() )
+		return;
+	auto& doc = editor->getDocument();
+	Int64 line = doc.getSelection().start().line();
+	Int64 changeLine = next ? found->second->nextChange( line ) : found->second->prevChange( line );
+	if ( changeLine < 0 )
+		return;
+	doc.setSelection( { changeLine, 0 } );
+	editor->scrollToCursor();
+}
+
+void GitPlugin::drawGutter( UICodeEditor* editor, const Int64& index, const Vector2f& screenStart,
+							const Float& lineHeight, const Float& gutterWidth, const Float& ) {
+	auto found = mDocDiffs.find( editor->getDocumentRef().get() );
+	if ( found == mDocDiffs.end() || !found->second->hasBase() )
+		return;
+
+	const auto* hunk = found->second->getLineHunk( index );
+	if ( hunk == nullptr )
+		return;
+
+	if ( !mGutterColorsLoaded ) {
+		mGutterAddedColor = getVarColor( "--theme-success" );
+		mGutterModifiedColor = getVarColor( "--theme-warning" );
+		mGutterRemovedColor = getVarColor( "--theme-error" );
+		mGutterColorsLoaded = true;
+	}
+
+	Primitives p;
+	switch ( hunk->type() ) {
+		case TextDocumentDiff::ChangeType::Added:
+		case TextDocumentDiff::ChangeType::Modified: {
+			p.setColor( hunk->type() == TextDocumentDiff::ChangeType::Added
+							? mGutterAddedColor
+							: mGutterModifiedColor );
+			p.drawRectangle( Rectf( screenStart, Sizef( gutterWidth, lineHeight ) ) );
+			break;
+		}
+		case TextDocumentDiff::ChangeType::Removed: {
+			// Marks the boundary between the lines where the lines were removed
+			Float height = eefloor( lineHeight * 0.25f );
+			Float y = hunk->newStart == 0 ? screenStart.y : screenStart.y + lineHeight - height;
+			p.setColor( mGutterRemovedColor );
+			p.drawRectangle( Rectf( { screenStart.x, y }, Sizef( gutterWidth, height ) ) );
+			break;
+		}
+	}
 }
 
 Color GitPlugin::getVarColor( const std::string& var ) {
@@ -1235,9 +1380,19 @@ void GitPlugin::onRegister( UICodeEditor* editor ) {
 	doc.setCommand( "git-push", [this] { push( projectPath() ); } );
 	doc.setCommand( "git-fetch", [this] { fetch( projectPath() ); } );
 	doc.setCommand( "git-commit", [this] { commit( projectPath() ); } );
+	doc.setCommand( "git-next-change", [this]( TextDocument::Client* client ) {
+		goToChange( static_cast<UICodeEditor*>( client ), true );
+	} );
+	doc.setCommand( "git-prev-change", [this]( TextDocument::Client* client ) {
+		goToChange( static_cast<UICodeEditor*>( client ), false );
+	} );
+
+	if ( mEditorGutterChanges )
+		editor->registerGutterSpace( this, PixelDensity::dpToPx( 3 ), 0 );
 }
 
 void GitPlugin::onUnregister( UICodeEditor* editor ) {
+	editor->unregisterGutterSpace( this );
 	PluginBase::onUnregister( editor );
 }
 
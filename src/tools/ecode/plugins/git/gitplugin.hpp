@@ -4,6 +4,8 @@
 #include "../plugin.hpp"
 #include "../pluginmanager.hpp"
 #include "git.hpp"
+#include "gitchangedetector.hpp"
+#include <eepp/ui/doc/textdocumentdiff.hpp>
 #include <eepp/ui/models/model.hpp>
 #include <eepp/ui/uilinearlayout.hpp>
 #include <optional>
@@ -65,6 +67,10 @@ class GitPlugin : public PluginBase {
 
 	bool onMouseLeave( UICodeEditor*, const Vector2i&, const Uint32& ) override;
 
+	void drawGutter( UICodeEditor* editor, const Int64& index, const Vector2f& screenStart,
+					 const Float& lineHeight, const Float& gutterWidth,
+					 const Float& fontSize ) override;
+
 	std::string gitBranch();
 
 	std::string statusTypeToString( Git::GitStatusType type );
@@ -79,6 +85,7 @@ class GitPlugin : public PluginBase {
 
   protected:
 	std::unique_ptr<Git> mGit;
+	GitChangeDetector mChangeDetector;
 	std::unordered_map<std::string, std::string> mGitBranches;
 	Git::Status mGitStatus;
 	std::vector<std::pair<std::string, std::string>> mRepos;
@@ -98,6 +105,13 @@ class GitPlugin : public PluginBase {
 	bool mOldUsingCustomStyling{ false };
 	bool mInitialized{ false };
 	bool mSilence{ true };
+	bool mEditorGutterChanges{ true };
+	bool mGutterColorsLoaded{ false };
+	Color mGutterAddedColor;
+	Color mGutterModifiedColor;
+	Color mGutterRemovedColor;
+	//! Diff of each open document against its HEAD version, only used from the main thread
+	std::unordered_map<TextDocument*, std::unique_ptr<TextDocumentDiff>> mDocDiffs;
 	Uint32 mOldTextStyle{ 0 };
 	Uint32 mOldTextAlign{ 0 };
 	Color mOldBackgroundColor;
@@ -151,6 +165,18 @@ class GitPlugin : public PluginBase {
 
 	void onUnregisterDocument( TextDocument* ) override;
 
+	void onRegisterDocument( TextDocument* ) override;
+
+	void onDocumentLoaded( TextDocument* ) override;
+
+	void onDocumentChanged( UICodeEditor*, TextDocument* oldDoc ) override;
+
+	void updateDocumentBase( TextDocument* doc );
+
+	void updateDocumentsBases();
+
+	void goToChange( UICodeEditor* editor, bool next );
+
 	Color getVarColor( const std::string& var );
 
 	void blame( UICodeEditor* editor );
@@ -15,7 +15,7 @@
 namespace ecode {
 
 #define CONTENT_LENGTH "Content-Length"
-#define CONTENT_LENGTH_HEADER "Content-Length:"
+#define LSP_ASYNC_PARSE_MIN_SIZE ( 256 * EE_1KB )
 
 static const char* MEMBER_ID = "id";
 static const char* MEMBER_METHOD = "method";
@@ -1209,6 +1209,15 @@ LSPClientServer::LSPClientServer( LSPClientServerManager* manager, const String:
 
 LSPClientServer::~LSPClientServer() {
 	shutdown();
+	std::future<void> parseTask;
+	{
+		std::lock_guard<std::mutex> l( mParseMutex );
+		mParseQueue.clear();
+		parseTask = std::move( mParseTask );
+	}
+	// A discarded task breaks its promise, so this only waits for a task that is running
+	if ( parseTask.valid() )
+		parseTask.wait();
 	std::unique_lock<std::mutex> lock( mShutdownMutex );
 	mShutdownCond.wait_for( lock, std::chrono::milliseconds( 275 ), [this]() { return !mReady; } );
 	eeSAFE_DELETE( mSocket );
@@ -1890,130 +1899,138 @@ void LSPClientServer::processRequest( const json& msg ) {
 void LSPClientServer::readStdOut( const char* bytes, size_t n ) {
 	if ( mEnded )
 		return;
-	mReceive.append( bytes, n );
-
-	std::string& buffer = mReceive;
-
-	while ( ( mUsingProcess && !mProcess.isShuttingDown() ) ||
-			( mUsingSocket && mSocket != nullptr ) ) {
-		auto index = buffer.find( CONTENT_LENGTH_HEADER );
-		if ( index == std::string::npos ) {
-			if ( buffer.size() > ( (Uint64)1 << 20 ) )
-				buffer.clear();
-			break;
-		}
 
-		index += std::strlen( CONTENT_LENGTH_HEADER );
-		auto endindex = buffer.find( "\r\n", index );
-		auto msgstart = buffer.find( "\r\n\r\n", index );
-		if ( endindex == std::string::npos || msgstart == std::string::npos )
-			break;
+	mReceive.append(
+		bytes, n,
+		[this]( std::string_view payload ) {
+			if ( !( mUsingProcess && !mProcess.isShuttingDown() ) &&
+				 !( mUsingSocket && mSocket != nullptr ) )
+				return;
 
-		msgstart += 4;
-		int length = 0;
-		std::string lengthStr( buffer.substr( index, endindex - index ) );
-		String::trimInPlace( lengthStr );
-		bool ok = String::fromString( length, lengthStr );
-
-		// FIXME perhaps detect if no reply for some time
-		// then again possibly better left to user to restart in such case
-		if ( !ok ) {
-			if ( !isSilent() )
-				Log::debug( "LSPClientServer::readStdOut server %s invalid " CONTENT_LENGTH,
-							mLSP.name.c_str() );
-			// flush and try to carry on to some next header
-			buffer.erase( 0, msgstart );
-			continue;
-		}
-		// sanity check to avoid extensive buffering
-		if ( length > ( 1 << 29 ) ) {
-			if ( !isSilent() )
-				Log::debug( "LSPClientServer::readStdOut server %s excessive size",
-							mLSP.name.c_str() );
-			buffer.clear();
-			continue;
-		}
-		if ( msgstart + length > buffer.length() ) {
-			break;
-		}
+			// Big payloads are parsed in the thread pool to keep reading the server output, the
+			// following messages are queued behind them to be processed in the same order
+			{
+				std::lock_guard<std::mutex> l( mParseMutex );
+				if ( mParsing || payload.size() >= LSP_ASYNC_PARSE_MIN_SIZE ) {
+					mParseQueue.emplace_back( payload );
+					// The task clears mParsing before it ends, if it's still set the pool
+					// discarded the task without running it
+					if ( mParsing && mParseTask.valid() &&
+						 mParseTask.wait_for( std::chrono::seconds( 0 ) ) ==
+							 std::future_status::ready )
+						mParsing = false;
+					if ( !mParsing ) {
+						mParsing = true;
+						mParseTask = getThreadPool()->async( [this] { processParseQueue(); } );
+					}
+					return;
+				}
+			}
 
-		// now onto payload
-		auto payload = buffer.substr( msgstart, length );
-		buffer.erase( 0, msgstart + length );
+			processMessage( payload );
+		},
+		[this]( LSPMessageFramer::Error error ) {
+			if ( isSilent() )
+				return;
+			switch ( error ) {
+				case LSPMessageFramer::Error::InvalidLength:
+					Log::debug( "LSPClientServer::readStdOut server %s invalid " CONTENT_LENGTH,
+								mLSP.name.c_str() );
+					break;
+				case LSPMessageFramer::Error::ExcessiveSize:
+					Log::debug( "LSPClientServer::readStdOut server %s excessive size",
+								mLSP.name.c_str() );
+					break;
+				case LSPMessageFramer::Error::EmptyPayload:
+					Log::debug( "LSPClientServer::readStdOut server %s empty payload",
+								mLSP.name.c_str() );
+					break;
+			}
+		} );
+}
 
-		if ( payload.empty() ) {
-			if ( !isSilent() )
-				Log::debug( "LSPClientServer::readStdOut server %s empty payload",
-							mLSP.name.c_str() );
-			continue;
+void LSPClientServer::processParseQueue() {
+	while ( true ) {
+		std::string payload;
+		{
+			std::lock_guard<std::mutex> l( mParseMutex );
+			if ( mParseQueue.empty() ) {
+				mParsing = false;
+				return;
+			}
+			payload = std::move( mParseQueue.front() );
+			mParseQueue.pop_front();
 		}
+		processMessage( payload );
+	}
+}
 
+void LSPClientServer::processMessage( std::string_view payload ) {
 #ifndef EE_DEBUG
-		try {
+	try {
 #endif
-			auto res = json::parse( payload );
+		auto res = json::parse( payload.begin(), payload.end() );
 
-			PluginIDType msgid;
-			if ( res.contains( MEMBER_ID ) ) {
-				msgid = getID( res );
-			} else {
-				processNotification( res );
-				continue;
-			}
+		PluginIDType msgid;
+		if ( res.contains( MEMBER_ID ) ) {
+			msgid = getID( res );
+		} else {
+			processNotification( res );
+			return;
+		}
 
-			if ( res.contains( MEMBER_METHOD ) ) {
-				processRequest( res );
-				continue;
-			}
+		if ( res.contains( MEMBER_METHOD ) ) {
+			processRequest( res );
+			return;
+		}
 
-			if ( !isSilent() ) {
-				std::string respd( res.dump() );
-				if ( trimLogs() && respd.size() > EE_1KB ) {
-					Log::debug( "LSPClientServer::readStdOut server %s said:", mLSP.name.c_str() );
-					if ( Log::instance()->getLogLevelThreshold() <= LogLevel::Debug )
-						Log::instance()->writel( std::string_view( respd ).substr( 0, EE_1KB ) );
-				} else {
-					Log::debug( "LSPClientServer::readStdOut server %s said:\n%s",
-								mLSP.name.c_str(), respd.c_str() );
-				}
+		if ( !isSilent() ) {
+			std::string respd( res.dump() );
+			if ( trimLogs() && respd.size() > EE_1KB ) {
+				Log::debug( "LSPClientServer::readStdOut server %s said:", mLSP.name.c_str() );
+				if ( Log::instance()->getLogLevelThreshold() <= LogLevel::Debug )
+					Log::instance()->writel( std::string_view( respd ).substr( 0, EE_1KB ) );
+			} else {
+				Log::debug( "LSPClientServer::readStdOut server %s said:\n%s", mLSP.name.c_str(),
+							respd.c_str() );
 			}
+		}
 
-			HandlersMap::iterator it;
-			HandlersMap::iterator itEnd;
-			JsonReplyHandler handlerOK;
-			JsonReplyHandler handlerErr;
-			bool handlerFound = false;
-			{
-				Lock l( mHandlersMutex );
-				it = mHandlers.find( msgid );
-				itEnd = mHandlers.end();
-				handlerFound = it != itEnd;
-				if ( handlerFound ) {
-					handlerOK = it->second.first;
-					handlerErr = it->second.second;
-					mHandlers.erase( it );
-				}
+		HandlersMap::iterator it;
+		HandlersMap::iterator itEnd;
+		JsonReplyHandler handlerOK;
+		JsonReplyHandler handlerErr;
+		bool handlerFound = false;
+		{
+			Lock l( mHandlersMutex );
+			it = mHandlers.find( msgid );
+			itEnd = mHandlers.end();
+			handlerFound = it != itEnd;
+			if ( handlerFound ) {
+				handlerOK = it->second.first;
+				handlerErr = it->second.second;
+				mHandlers.erase( it );
 			}
+		}
 
-			if ( handlerFound ) {
-				if ( res.contains( MEMBER_ERROR ) && handlerErr ) {
-					handlerErr( msgid, res[MEMBER_ERROR] );
-				} else {
-					handlerOK( msgid, res[MEMBER_RESULT] );
-				}
+		if ( handlerFound ) {
+			if ( res.contains( MEMBER_ERROR ) && handlerErr ) {
+				handlerErr( msgid, res[MEMBER_ERROR] );
 			} else {
-				if ( !isSilent() ) {
-					Log::debug( "LSPClientServer::readStdOut server %s unexpected reply id: %s",
-								mLSP.name.c_str(), msgid.toString().c_str() );
-				}
+				handlerOK( msgid, res[MEMBER_RESULT] );
+			}
+		} else {
+			if ( !isSilent() ) {
+				Log::debug( "LSPClientServer::readStdOut server %s unexpected reply id: %s",
+							mLSP.name.c_str(), msgid.toString().c_str() );
 			}
-#ifndef EE_DEBUG
-		} catch ( const json::exception& e ) {
-			Log::warning( "LSPClientServer::readStdOut server %s said: Coudln't parse json err: %s",
-						  mLSP.name.c_str(), e.what() );
 		}
-#endif
+#ifndef EE_DEBUG
+	} catch ( const json::exception& e ) {
+		Log::warning( "LSPClientServer::readStdOut server %s said: Coudln't parse json err: %s",
+					  mLSP.name.c_str(), e.what() );
 	}
+#endif
 }
 
 void LSPClientServer::notifyServerError() {
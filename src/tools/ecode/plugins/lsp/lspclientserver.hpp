@@ -4,13 +4,16 @@
 #include "../pluginmanager.hpp"
 #include "lspdefinition.hpp"
 #include "lspdocumentclient.hpp"
+#include "lspmessageframer.hpp"
 #include "lspprotocol.hpp"
 #include <atomic>
+#include <deque>
 #include <eepp/network/tcpsocket.hpp>
 #include <eepp/system/process.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/ui/uicodeeditor.hpp>
 #include <eepp/ui/uipopupmenu.hpp>
+#include <future>
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <queue>
@@ -279,7 +282,13 @@ class LSPClientServer {
 		JsonReplyHandler eh;
 	};
 	std::vector<QueueMessage> mQueuedMessages;
-	std::string mReceive;
+	LSPMessageFramer mReceive;
+	/** Payloads parsed in the thread pool, the ones behind a big payload wait in order */
+	std::deque<std::string> mParseQueue;
+	std::mutex mParseMutex;
+	/** Ready once the task draining mParseQueue ends, or if the pool discards it */
+	std::future<void> mParseTask;
+	bool mParsing{ false };
 	std::string mReceiveErr;
 	LSPServerCapabilities mCapabilities;
 	URI mWorkspaceFolder;
@@ -299,6 +308,10 @@ class LSPClientServer {
 
 	void readStdOut( const char* bytes, size_t n );
 
+	void processMessage( std::string_view payload );
+
+	void processParseQueue();
+
 	void readStdErr( const char* bytes, size_t n );
 
 	LSPRequestHandle write( json&& msg, const JsonReplyHandler& h = nullptr,
@@ -0,0 +1,124 @@
+#include "lspmessageframer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ecode {
+
+static constexpr std::string_view CONTENT_LENGTH_HEADER = "Content-Length:";
+static constexpr std::string_view HEADER_END = "\r\n\r\n";
+
+void LSPMessageFramer::append( const char* bytes, size_t n, const PayloadCb& onPayload,
+							   const ErrorCb& onError ) {
+	compact();
+	mBuffer.append( bytes, n );
+
+	while ( true ) {
+		if ( mPayloadStart == std::string::npos ) {
+			size_t headerEnd = mBuffer.find( HEADER_END.data(), std::max( mScan, mStart ),
+											 HEADER_END.size() );
+
+			if ( headerEnd == std::string::npos ) {
+				if ( getPendingSize() > MaxHeaderSize ) {
+					clear();
+				} else if ( mBuffer.size() >= HEADER_END.size() ) {
+					// The header end could be split between this chunk and the next one
+					mScan = std::max( mStart, mBuffer.size() - HEADER_END.size() + 1 );
+				}
+				return;
+			}
+
+			if ( !parseHeader( headerEnd, onError ) ) {
+				if ( mBuffer.empty() )
+					return;
+				continue;
+			}
+		}
+
+		if ( mBuffer.size() - mPayloadStart < mPayloadLength )
+			return;
+
+		std::string_view payload( mBuffer.data() + mPayloadStart, mPayloadLength );
+		mStart = mScan = mPayloadStart + mPayloadLength;
+		mPayloadStart = std::string::npos;
+
+		if ( payload.empty() ) {
+			if ( onError )
+				onError( Error::EmptyPayload );
+			continue;
+		}
+
+		onPayload( payload );
+	}
+}
+
+bool LSPMessageFramer::parseHeader( size_t headerEnd, const ErrorCb& onError ) {
+	std::string_view header( mBuffer.data() + mStart, headerEnd - mStart );
+	size_t bodyStart = headerEnd + HEADER_END.size();
+	size_t index = header.find( CONTENT_LENGTH_HEADER );
+	size_t length = 0;
+	bool ok = false;
+
+	if ( index != std::string_view::npos ) {
+		index += CONTENT_LENGTH_HEADER.size();
+		while ( index < header.size() && ( header[index] == ' ' || header[index] == '\t' ) )
+			index++;
+		while ( index < header.size() && header[index] >= '0' && header[index] <= '9' &&
+				length <= MaxPayloadSize ) {
+			length = length * 10 + ( header[index] - '0' );
+			ok = true;
+			index++;
+		}
+	}
+
+	if ( !ok ) {
+		if ( onError )
+			onError( Error::InvalidLength );
+		// Skip the header and try to carry on with the next one
+		mStart = mScan = bodyStart;
+		return false;
+	}
+
+	// Sanity check to avoid an extensive buffering
+	if ( length > MaxPayloadSize ) {
+		if ( onError )
+			onError( Error::ExcessiveSize );
+		clear();
+		return false;
+	}
+
+	mPayloadStart = bodyStart;
+	mPayloadLength = length;
+	return true;
+}
+
+void LSPMessageFramer::compact() {
+	if ( mStart == 0 )
+		return;
+
+	if ( mStart == mBuffer.size() ) {
+		mBuffer.clear();
+	} else if ( mStart >= mBuffer.size() - mStart ) {
+		mBuffer.erase( 0, mStart );
+	} else {
+		return;
+	}
+
+	mScan -= std::min( mScan, mStart );
+	if ( mPayloadStart != std::string::npos )
+		mPayloadStart -= mStart;
+	mStart = 0;
+}
+
+void LSPMessageFramer::clear() {
+	mBuffer.clear();
+	mStart = 0;
+	mScan = 0;
+	mPayloadStart = std::string::npos;
+	mPayloadLength = 0;
+}
+
+size_t LSPMessageFramer::getPendingSize() const {
+	return mBuffer.size() - mStart;
+}
+
+} // namespace ecode
@@ -0,0 +1,51 @@
+#ifndef ECODE_LSPMESSAGEFRAMER_HPP
+#define ECODE_LSPMESSAGEFRAMER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace ecode {
+
+/** Splits the LSP base protocol stream ( "Content-Length: N\r\n\r\n" + payload ) into the message
+ * payloads. The data is appended to a single buffer that is only compacted when the consumed part
+ * outgrows the pending one, and the header search resumes where the previous one stopped, so every
+ * received byte is scanned and moved a constant number of times. */
+class LSPMessageFramer {
+  public:
+	enum class Error { InvalidLength, ExcessiveSize, EmptyPayload };
+
+	/** The payload view is valid until the callback returns */
+	using PayloadCb = std::function<void( std::string_view payload )>;
+
+	using ErrorCb = std::function<void( Error error )>;
+
+	static constexpr size_t MaxPayloadSize = (size_t)1 << 29;
+
+	static constexpr size_t MaxHeaderSize = (size_t)1 << 20;
+
+	/** Appends the received data and reports every complete payload, in order. */
+	void append( const char* bytes, size_t n, const PayloadCb& onPayload,
+				 const ErrorCb& onError = nullptr );
+
+	void clear();
+
+	/** @return The number of bytes received that are not part of a reported payload yet */
+	size_t getPendingSize() const;
+
+  protected:
+	std::string mBuffer;
+	size_t mStart{ 0 };						  ///< First byte not consumed
+	size_t mScan{ 0 };						  ///< Where the header end search resumes
+	size_t mPayloadStart{ std::string::npos }; ///< Payload of the last parsed header
+	size_t mPayloadLength{ 0 };
+
+	void compact();
+
+	bool parseHeader( size_t headerEnd, const ErrorCb& onError );
+};
+
+} // namespace ecode
+
+#endif // ECODE_LSPMESSAGEFRAMER_HPP
@@ -322,7 +322,7 @@ void ProjectSearch::find( const std::vector<std::string> files, std::string stri
 							findData->res.push_back( { std::move( file ), std::move( fileRes ) } );
 						}
 					},
-					onSearchEnd );
+					ThreadPool::Priority::Low, onSearchEnd );
 			} else {
 				pool->run(
 					[findData, file, string, caseSensitive, wholeWord, occ, type] {
@@ -339,7 +339,7 @@ void ProjectSearch::find( const std::vector<std::string> files, std::string stri
 							findData->res.push_back( { std::move( file ), std::move( fileRes ) } );
 						}
 					},
-					onSearchEnd );
+					ThreadPool::Priority::Low, onSearchEnd );
 			}
 		}
 	} );
@@ -1,5 +1,6 @@
 #include <args/args.hxx>
 #include <eepp/ee.hpp>
+#include <eterm/system/processfactory.hpp>
 #include <eterm/terminal/terminaldisplay.hpp>
 #include <iostream>
 
@@ -29,6 +30,109 @@ void loadColorSchemes( const std::string& resPath ) {
 		terminalColorSchemes.insert( { colorScheme.getName(), colorScheme } );
 }
 
+static std::string generateAnsiCorpus( size_t size ) {
+	static const char* words[] = { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur",
+								   "eterm", "ñandú", "größe", "→", "█▓▒░", "日本語" };
+	std::string corpus;
+	corpus.reserve( size + 256 );
+	Uint32 line = 0;
+
+	while ( corpus.size() < size ) {
+		switch ( line % 8 ) {
+			case 0:
+				corpus += "\033[2K\033[1;3" + String::toString( ( line / 8 ) % 8 ) + "m";
+				break;
+			case 3:
+				corpus += "\033[38;5;" + String::toString( line % 256 ) + ";48;5;" +
+						  String::toString( ( line * 7 ) % 256 ) + "m";
+				break;
+			case 5:
+				corpus += "\033[" + String::toString( 1 + line % 24 ) + ";" +
+						  String::toString( 1 + line % 40 ) + "H";
+				break;
+			case 7:
+				corpus += "\033[38;2;" + String::toString( line % 256 ) + ";128;" +
+						  String::toString( 255 - line % 256 ) + "m\t";
+				break;
+		}
+
+		for ( size_t i = 0; i < 12; ++i ) {
+			corpus += words[( line + i * 5 ) % eeARRAY_SIZE( words )];
+			corpus += ' ';
+		}
+
+		corpus += "\033[0m\r\n";
+		++line;
+	}
+
+	return corpus;
+}
+
+/** Measures the emulator throughput parsing the output of a child process, without rendering.
+ * The child replays the corpus file if provided ( ex: a recorded vttest session ), otherwise a
+ * generated mixed ANSI corpus of the given size. */
+static int runThroughputBenchmark( size_t megabytes, bool threadedReader,
+								   const std::string& corpus ) {
+	bool generated = corpus.empty();
+	std::string corpusPath( generated ? Sys::getTempPath() + "eterm-benchmark-corpus.txt"
+									  : corpus );
+
+	if ( generated &&
+		 !FileSystem::fileWrite( corpusPath, generateAnsiCorpus( megabytes * 1024 * 1024 ) ) ) {
+		std::cerr << "Failed to write the benchmark corpus at " << corpusPath << std::endl;
+		return EXIT_FAILURE;
+	} else if ( !generated && !FileSystem::fileExists( corpusPath ) ) {
+		std::cerr << "Benchmark corpus not found: " << corpusPath << std::endl;
+		return EXIT_FAILURE;
+	}
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	std::string program( "cmd.exe" );
+	std::vector<std::string> args{ "/c", "type", corpusPath };
+#else
+	std::string program( "/bin/cat" );
+	std::vector<std::string> args{ corpusPath };
+#endif
+
+	ProcessFactory processFactory;
+	std::unique_ptr<IPseudoTerminal> pseudoTerminal = nullptr;
+	auto process = processFactory.createWithPseudoTerminal(
+		program, args, FileSystem::getCurrentWorkingDirectory(), 160, 48, pseudoTerminal );
+
+	if ( !pseudoTerminal || !process ) {
+		std::cerr << "Failed to spawn the benchmark process" << std::endl;
+		if ( generated )
+			FileSystem::fileRemove( corpusPath );
+		return EXIT_FAILURE;
+	}
+
+	auto emulator =
+		TerminalEmulator::create( std::move( pseudoTerminal ), std::move( process ), nullptr );
+	emulator->setThreadedReader( threadedReader );
+
+	Clock clock;
+
+	while ( !emulator->hasExited() ) {
+		emulator->update();
+		// The UI thread only picks up the dirty lines once per frame when the reader is threaded
+		if ( threadedReader )
+			Sys::sleep( Milliseconds( 16 ) );
+	}
+
+	double seconds = clock.getElapsedTime().asSeconds();
+	double mb = emulator->getBytesRead() / ( 1024.0 * 1024.0 );
+
+	std::cout << ( threadedReader ? "threaded reader: " : "main thread reader: " )
+			  << String::format( "%.2f MB in %.3f s, %.2f MB/s", mb, seconds,
+								 seconds > 0 ? mb / seconds : 0. )
+			  << std::endl;
+
+	emulator.reset();
+	if ( generated )
+		FileSystem::fileRemove( corpusPath );
+	return EXIT_SUCCESS;
+}
+
 void inputCallback( InputEvent* event ) {
 	if ( !terminal || event->Type == InputEvent::EventsSent )
 		return;
@@ -146,6 +250,18 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 	args::Flag benchmarkModeFlag(
 		parser, "benchmark-mode",
 		"Render as much as possible to measure the rendering performance.", { "benchmark-mode" } );
+	args::Flag threadedReader(
+		parser, "threaded-reader",
+		"Read and parse the terminal output in a dedicated thread, the UI thread only draws",
+		{ "threaded-reader" } );
+	args::ValueFlag<size_t> throughputBenchmark(
+		parser, "throughput-benchmark",
+		"Runs a headless benchmark parsing the given MB of mixed ANSI output from a child process",
+		{ "throughput-benchmark" } );
+	args::ValueFlag<std::string> throughputCorpus(
+		parser, "throughput-corpus",
+		"Output file replayed by the throughput benchmark instead of the generated corpus",
+		{ "throughput-corpus" } );
 
 	try {
 		parser.ParseCLI( argc, argv );
@@ -162,6 +278,10 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 		return EXIT_FAILURE;
 	}
 
+	if ( throughputBenchmark || throughputCorpus )
+		return runThroughputBenchmark( eemax<size_t>( 1, throughputBenchmark.Get() ),
+									   threadedReader.Get(), throughputCorpus.Get() );
+
 	DisplayManager* displayManager = Engine::instance()->getDisplayManager();
 	Display* currentDisplay = displayManager->getDisplayIndex( 0 );
 
@@ -264,6 +384,7 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 		}
 
 		terminal->getTerminal()->setAllowMemoryTrimnming( true );
+		terminal->getTerminal()->setThreadedReader( threadedReader.Get() );
 		terminal->pushEventCallback( [&closeOnExit]( const TerminalDisplay::Event& event ) {
 			if ( event.type == TerminalDisplay::EventType::TITLE ) {
 				windowStringData = event.eventData;